@@ -0,0 +1,415 @@
+// Benchmark.cpp : engine hot paths on synthetic heaps, reported as JSON.
+//
+// Internal-Engine-Bench.exe [--heap-mb N] [--density N] [--iterations N] [--threads N]
+//                           [--hooks N] [--out file]
+//
+// The heap is one VirtualAlloc'd block of random data with int32 values, pointers and a
+// code-like byte pattern planted at a given density (per MB). Every scan is limited to the
+// heap, so results only depend on the configuration and the machine, not on what else the
+// process has mapped. Compare two runs' "results" by name.
+#include <Windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "MemoryEngine.hpp"
+#include "ScanResultStore.hpp"
+#include "RegionMap.hpp"
+#include "BinaryProtocol.hpp"
+#include "DetoursLite.hpp"
+#include "Json.hpp"
+
+using namespace InternalEngine;
+
+static const char* BENCH_FORMAT_VERSION = "1";
+static const int32_t PLANTED_VALUE = 0x13571357;
+static const char PLANTED_PATTERN[] = "\x48\x8B\x05\x11\x22\x33\x44\x48\x85\xC0";
+static const char PLANTED_MASK[] = "xxx????xxx";
+
+struct BenchConfig {
+    size_t heapMb = 256;
+    size_t density = 1000;          // Planted int32 values per MB (pointers: 1/4, patterns: 1/16)
+    size_t iterations = 5;
+    size_t threads = 0;
+    size_t hooks = 64;
+    std::string outPath;
+};
+
+struct BenchResult {
+    std::string name;
+    std::vector<double> samplesMs;
+    size_t items = 0;               // Hits, reads, results encoded, hooks installed ...
+    size_t bytes = 0;               // Bytes processed per iteration (0 = no throughput)
+    size_t outputBytes = 0;         // Encoders: size of one encoded message
+};
+
+// 🎲 합성 힙
+class SyntheticHeap {
+public:
+    explicit SyntheticHeap(const BenchConfig& config) : size(config.heapMb * 1024 * 1024) {
+        base = static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+        if (!base) return;
+        RegionMap::Invalidate(reinterpret_cast<uintptr_t>(base), size);
+
+        // Random fill; a chance match of the planted value is counted like any other hit
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        uint64_t* words = reinterpret_cast<uint64_t*>(base);
+        for (size_t i = 0; i < size / sizeof(uint64_t); i++) {
+            words[i] = Next(state);
+        }
+
+        size_t valueCount = config.density * config.heapMb;
+        for (size_t i = 0; i < valueCount; i++) {
+            size_t offset = (Next(state) % (size / 4)) * 4;
+            memcpy(base + offset, &PLANTED_VALUE, sizeof(PLANTED_VALUE));
+            valueOffsets.push_back(offset);
+        }
+
+        pointerTarget = reinterpret_cast<uintptr_t>(base) + size / 2;
+        for (size_t i = 0; i < valueCount / 4; i++) {
+            size_t offset = (Next(state) % (size / sizeof(uintptr_t))) * sizeof(uintptr_t);
+            memcpy(base + offset, &pointerTarget, sizeof(pointerTarget));
+        }
+
+        for (size_t i = 0; i < valueCount / 16; i++) {
+            size_t offset = Next(state) % (size - sizeof(PLANTED_PATTERN));
+            memcpy(base + offset, PLANTED_PATTERN, sizeof(PLANTED_PATTERN) - 1);
+        }
+    }
+
+    ~SyntheticHeap() {
+        if (base) VirtualFree(base, 0, MEM_RELEASE);
+    }
+
+    bool IsValid() const { return base != nullptr; }
+    uintptr_t Start() const { return reinterpret_cast<uintptr_t>(base); }
+    uintptr_t End() const { return Start() + size; }
+    size_t Size() const { return size; }
+    uint8_t* Data() const { return base; }
+    uintptr_t PointerTarget() const { return pointerTarget; }
+    const std::vector<size_t>& ValueOffsets() const { return valueOffsets; }
+
+    static uint64_t Next(uint64_t& state) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+private:
+    uint8_t* base = nullptr;
+    size_t size;
+    uintptr_t pointerTarget = 0;
+    std::vector<size_t> valueOffsets;
+};
+
+// ⏱️ 측정
+// setup runs before every sample and is not timed; body returns the item count
+static BenchResult Measure(const std::string& name, size_t iterations, size_t bytes,
+                           const std::function<void()>& setup, const std::function<size_t()>& body) {
+    BenchResult result;
+    result.name = name;
+    result.bytes = bytes;
+
+    // One warm-up pass (page faults, region map, code index)
+    if (setup) setup();
+    body();
+
+    for (size_t i = 0; i < iterations; i++) {
+        if (setup) setup();
+        auto start = std::chrono::steady_clock::now();
+        result.items = body();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        result.samplesMs.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+    return result;
+}
+
+static ScanOptions HeapScanOptions(const SyntheticHeap& heap, const BenchConfig& config) {
+    ScanOptions options;
+    options.startAddress = heap.Start();
+    options.endAddress = heap.End();
+    options.alignment = 4;
+    options.threadCount = config.threads;
+    return options;
+}
+
+// 🔍 스캔
+static void BenchScans(const SyntheticHeap& heap, const BenchConfig& config, std::vector<BenchResult>& results) {
+    ScanOptions options = HeapScanOptions(heap, config);
+    std::string value = std::to_string(PLANTED_VALUE);
+
+    results.push_back(Measure("FirstScan.int32", config.iterations, heap.Size(), nullptr, [&] {
+        return MemoryEngine::FirstScan(value, "int32", options).size();
+    }));
+
+    ScanResultStore first;
+    results.push_back(Measure("FirstScan.int32.store", config.iterations, heap.Size(), nullptr, [&] {
+        MemoryEngine::FirstScan(value, "int32", options, first);
+        return first.Count();
+    }));
+
+    // Half of the planted values go up by one; the next scan keeps those
+    for (size_t i = 0; i < heap.ValueOffsets().size(); i += 2) {
+        int32_t increased = PLANTED_VALUE + 1;
+        memcpy(heap.Data() + heap.ValueOffsets()[i], &increased, sizeof(increased));
+    }
+
+    NextScanQuery increased;
+    increased.scanType = "increased";
+    ScanResultStore filtered;
+    results.push_back(Measure("NextScan.increased", config.iterations, first.Count() * sizeof(int32_t),
+        [&] { filtered = first; },
+        [&] {
+            MemoryEngine::NextScan(increased, filtered);
+            return filtered.Count();
+        }));
+
+    // Restore the planted values for the pointer and pattern scans that follow
+    for (size_t offset : heap.ValueOffsets()) {
+        memcpy(heap.Data() + offset, &PLANTED_VALUE, sizeof(PLANTED_VALUE));
+    }
+
+    ScanOptions pointerOptions = options;
+    pointerOptions.alignment = sizeof(uintptr_t);
+    results.push_back(Measure("FindPointersTo", config.iterations, heap.Size(), nullptr, [&] {
+        return MemoryEngine::FindPointersTo(heap.PointerTarget(), pointerOptions).size();
+    }));
+
+    std::string pattern(PLANTED_PATTERN, sizeof(PLANTED_PATTERN) - 1);
+    ScanOptions control;
+    control.threadCount = config.threads;
+    results.push_back(Measure("PatternScanAll", config.iterations, heap.Size(), nullptr, [&] {
+        return MemoryEngine::PatternScanAll(pattern, PLANTED_MASK, heap.Start(), heap.End(), &control).size();
+    }));
+}
+
+// 📖 안전한 읽기 (random 64-byte reads, the memory viewer / watch path)
+static void BenchReads(const SyntheticHeap& heap, const BenchConfig& config, std::vector<BenchResult>& results) {
+    const size_t READS = 100000;
+    const size_t READ_SIZE = 64;
+
+    std::vector<uintptr_t> addresses(READS);
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    for (auto& address : addresses) {
+        address = heap.Start() + SyntheticHeap::Next(state) % (heap.Size() - READ_SIZE);
+    }
+
+    results.push_back(Measure("SafeReadBytes.64", config.iterations, READS * READ_SIZE, nullptr, [&] {
+        size_t ok = 0;
+        for (uintptr_t address : addresses) {
+            if (MemoryEngine::SafeReadBytes(address, READ_SIZE).size() == READ_SIZE) ok++;
+        }
+        return ok;
+    }));
+}
+
+// 📦 인코딩 (scan results as the JSON responses write them vs BinaryProtocol)
+static void BenchEncoding(const BenchConfig& config, std::vector<BenchResult>& results) {
+    const size_t COUNT = 100000;
+
+    std::vector<uint64_t> addresses(COUNT);
+    std::vector<int32_t> values(COUNT);
+    uint64_t state = 0xD1B54A32D192ED03ULL;
+    for (size_t i = 0; i < COUNT; i++) {
+        addresses[i] = 0x7FF600000000ULL + i * 16;
+        values[i] = static_cast<int32_t>(SyntheticHeap::Next(state));
+    }
+
+    size_t jsonSize = 0;
+    BenchResult json = Measure("Encode.json", config.iterations, 0, nullptr, [&] {
+        std::string out;
+        out.reserve(COUNT * 48);
+        JsonWriter writer(out);
+        writer.BeginArray();
+        for (size_t i = 0; i < COUNT; i++) {
+            writer.BeginObject();
+            writer.Key("address").Hex(addresses[i]);
+            writer.Key("value").Int(values[i]);
+            writer.Key("type").String("int32");
+            writer.EndObject();
+        }
+        writer.EndArray();
+        jsonSize = out.size();
+        return COUNT;
+    });
+    json.outputBytes = jsonSize;
+    results.push_back(json);
+
+    size_t binarySize = 0;
+    BenchResult binary = Measure("Encode.binary", config.iterations, 0, nullptr, [&] {
+        auto message = BinaryProtocol::EncodeScanResults(1, DataType::INT32, sizeof(int32_t), addresses.data(),
+                                                         reinterpret_cast<const uint8_t*>(values.data()), static_cast<uint32_t>(COUNT));
+        binarySize = message.size();
+        return COUNT;
+    });
+    binary.outputBytes = binarySize;
+    results.push_back(binary);
+}
+
+// 🪝 후킹 (synthetic functions with an ordinary prologue in an executable page)
+static void BenchHooks(const BenchConfig& config, std::vector<BenchResult>& results) {
+#ifdef _WIN64
+    // mov [rsp+8], rbx / push rdi / sub rsp, 20h / xor eax, eax / add rsp, 20h / pop rdi / ret
+    static const uint8_t STUB[] = { 0x48, 0x89, 0x5C, 0x24, 0x08, 0x57, 0x48, 0x83, 0xEC, 0x20,
+                                    0x31, 0xC0, 0x48, 0x83, 0xC4, 0x20, 0x5F, 0xC3 };
+#else
+    // push ebp / mov ebp, esp / sub esp, 8 / xor eax, eax / mov esp, ebp / pop ebp / ret
+    static const uint8_t STUB[] = { 0x55, 0x8B, 0xEC, 0x83, 0xEC, 0x08, 0x31, 0xC0, 0x8B, 0xE5, 0x5D, 0xC3 };
+#endif
+    const size_t STUB_STRIDE = 32;
+    size_t count = config.hooks + 1;   // The last stub is the detour
+
+    uint8_t* code = static_cast<uint8_t*>(VirtualAlloc(nullptr, count * STUB_STRIDE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+    if (!code) return;
+    memset(code, 0xCC, count * STUB_STRIDE);
+    for (size_t i = 0; i < count; i++) {
+        memcpy(code + i * STUB_STRIDE, STUB, sizeof(STUB));
+    }
+    uintptr_t detour = reinterpret_cast<uintptr_t>(code + config.hooks * STUB_STRIDE);
+
+    auto removeAll = [&] {
+        for (size_t i = 0; i < config.hooks; i++) {
+            DetoursLite::RemoveHook(reinterpret_cast<uintptr_t>(code + i * STUB_STRIDE));
+        }
+    };
+
+    results.push_back(Measure("DetoursLite.InstallHook", config.iterations, 0, removeAll, [&] {
+        size_t installed = 0;
+        for (size_t i = 0; i < config.hooks; i++) {
+            uintptr_t original = 0;
+            if (DetoursLite::InstallHook(reinterpret_cast<uintptr_t>(code + i * STUB_STRIDE), detour, &original)) installed++;
+        }
+        return installed;
+    }));
+
+    std::vector<DetoursLite::HookRequest> requests(config.hooks);
+    for (size_t i = 0; i < config.hooks; i++) {
+        requests[i].targetFunction = reinterpret_cast<uintptr_t>(code + i * STUB_STRIDE);
+        requests[i].detourFunction = detour;
+    }
+    results.push_back(Measure("DetoursLite.InstallHooks", config.iterations, 0, removeAll, [&] {
+        std::vector<uintptr_t> originals;
+        return DetoursLite::InstallHooks(requests, originals);
+    }));
+
+    removeAll();
+    VirtualFree(code, 0, MEM_RELEASE);
+    RegionMap::Invalidate(reinterpret_cast<uintptr_t>(code), count * STUB_STRIDE);
+}
+
+// 🧾 출력
+static std::string WriteReport(const BenchConfig& config, const std::vector<BenchResult>& results) {
+    std::string out;
+    JsonWriter json(out);
+    json.BeginObject();
+    json.Key("format").String(BENCH_FORMAT_VERSION);
+#ifdef _WIN64
+    json.Key("platform").String("x64");
+#else
+    json.Key("platform").String("x86");
+#endif
+
+    SYSTEM_INFO system;
+    GetSystemInfo(&system);
+    json.Key("processors").UInt(system.dwNumberOfProcessors);
+
+    json.Key("config").BeginObject();
+    json.Key("heapMb").UInt(config.heapMb);
+    json.Key("density").UInt(config.density);
+    json.Key("iterations").UInt(config.iterations);
+    json.Key("threads").UInt(config.threads);
+    json.Key("hooks").UInt(config.hooks);
+    json.EndObject();
+
+    json.Key("results").BeginArray();
+    for (const auto& result : results) {
+        std::vector<double> sorted = result.samplesMs;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0;
+        for (double sample : sorted) total += sample;
+        double median = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+
+        json.BeginObject();
+        json.Key("name").String(result.name);
+        json.Key("items").UInt(result.items);
+        json.Key("minMs").Double(sorted.empty() ? 0 : sorted.front());
+        json.Key("medianMs").Double(median);
+        json.Key("meanMs").Double(sorted.empty() ? 0 : total / sorted.size());
+        json.Key("maxMs").Double(sorted.empty() ? 0 : sorted.back());
+        if (result.bytes > 0 && median > 0) {
+            json.Key("mbPerSecond").Double(result.bytes / (1024.0 * 1024.0) / (median / 1000.0));
+        }
+        if (result.items > 0 && median > 0) {
+            json.Key("nsPerItem").Double(median * 1e6 / result.items);
+        }
+        if (result.outputBytes > 0) {
+            json.Key("outputBytes").UInt(result.outputBytes);
+        }
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    return out;
+}
+
+static bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+
+        if (arg == "--out") {
+            config.outPath = value;
+            continue;
+        }
+
+        size_t number = strtoull(value.c_str(), nullptr, 10);
+        if (arg == "--heap-mb" && number > 0) config.heapMb = number;
+        else if (arg == "--density") config.density = number;
+        else if (arg == "--iterations" && number > 0) config.iterations = number;
+        else if (arg == "--threads") config.threads = number;
+        else if (arg == "--hooks" && number > 0) config.hooks = number;
+        else return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!ParseArguments(argc, argv, config)) {
+        fprintf(stderr, "usage: %s [--heap-mb N] [--density N] [--iterations N] [--threads N] [--hooks N] [--out file]\n", argv[0]);
+        return 2;
+    }
+
+    SyntheticHeap heap(config);
+    if (!heap.IsValid()) {
+        fprintf(stderr, "Failed to allocate a %zu MB heap\n", config.heapMb);
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+    BenchScans(heap, config, results);
+    BenchReads(heap, config, results);
+    BenchEncoding(config, results);
+    BenchHooks(config, results);
+
+    std::string report = WriteReport(config, results);
+    if (config.outPath.empty()) {
+        printf("%s\n", report.c_str());
+        return 0;
+    }
+
+    std::ofstream file(config.outPath, std::ios::binary | std::ios::trunc);
+    file.write(report.data(), static_cast<std::streamsize>(report.size()));
+    if (!file) {
+        fprintf(stderr, "Cannot write %s\n", config.outPath.c_str());
+        return 1;
+    }
+    return 0;
+}
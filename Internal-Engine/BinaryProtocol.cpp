@@ -122,6 +122,87 @@ std::vector<uint8_t> BinaryProtocol::EncodeBulkUpdate(const std::vector<std::pai
     return message;
 }
 
+std::vector<uint8_t> BinaryProtocol::EncodeMessage(BinaryOpcode opcode, uint32_t requestId, uint8_t flags, const uint8_t* payload, size_t payloadSize) {
+    std::vector<uint8_t> message;
+    message.reserve(sizeof(BinaryHeader) + payloadSize);
+
+    WriteHeader(message, opcode, flags, static_cast<uint32_t>(payloadSize), requestId);
+    if (payloadSize > 0) {
+        message.insert(message.end(), payload, payload + payloadSize);
+    }
+
+    return message;
+}
+
+std::vector<uint8_t> BinaryProtocol::EncodeMemoryReadResponse(uint32_t requestId, uint64_t address, DataType type, const std::vector<uint8_t>& value) {
+    std::vector<uint8_t> message;
+    size_t payloadSize = sizeof(ValueUpdateNotification) + value.size();
+    message.reserve(sizeof(BinaryHeader) + payloadSize);
+
+    WriteHeader(message, BinaryOpcode::MEMORY_READ, 0, static_cast<uint32_t>(payloadSize), requestId);
+    WriteUInt64(message, address);
+    message.push_back(static_cast<uint8_t>(type));
+    WriteUInt32(message, static_cast<uint32_t>(value.size()));
+    message.insert(message.end(), value.begin(), value.end());
+
+    return message;
+}
+
+std::vector<uint8_t> BinaryProtocol::EncodeBulkRead(uint32_t requestId, const std::vector<MemoryReadRequest>& requests, const std::vector<std::vector<uint8_t>>& values, uint8_t flags) {
+    std::vector<uint8_t> message;
+
+    // Unreadable entries keep their slot with valueSize 0
+    size_t payloadSize = sizeof(BulkUpdateNotification);
+    for (size_t i = 0; i < requests.size(); i++) {
+        payloadSize += sizeof(ValueUpdateNotification) + values[i].size();
+    }
+    message.reserve(sizeof(BinaryHeader) + payloadSize);
+
+    WriteHeader(message, BinaryOpcode::BULK_UPDATE, flags, static_cast<uint32_t>(payloadSize), requestId);
+    WriteUInt32(message, static_cast<uint32_t>(requests.size()));
+    for (size_t i = 0; i < requests.size(); i++) {
+        WriteUInt64(message, requests[i].address);
+        message.push_back(static_cast<uint8_t>(requests[i].type));
+        WriteUInt32(message, static_cast<uint32_t>(values[i].size()));
+        message.insert(message.end(), values[i].begin(), values[i].end());
+    }
+
+    return message;
+}
+
+std::vector<uint8_t> BinaryProtocol::EncodeScanProgress(uint32_t streamId, uint32_t chunksDone, uint32_t chunksTotal, uint64_t resultsFound, bool finished) {
+    std::vector<uint8_t> message;
+    message.reserve(sizeof(BinaryHeader) + SCAN_PROGRESS_PAYLOAD_SIZE);
+
+    WriteHeader(message, BinaryOpcode::SCAN_PROGRESS, finished ? BINARY_FLAG_FINAL : 0,
+                static_cast<uint32_t>(SCAN_PROGRESS_PAYLOAD_SIZE), streamId);
+    WriteUInt32(message, chunksDone);
+    WriteUInt32(message, chunksTotal);
+    WriteUInt64(message, resultsFound);
+
+    return message;
+}
+
+std::vector<uint8_t> BinaryProtocol::EncodeScanResults(uint32_t streamId, DataType type, uint16_t valueSize, const uint64_t* addresses, const uint8_t* values, uint32_t count) {
+    std::vector<uint8_t> message;
+    size_t payloadSize = SCAN_RESULTS_PREFIX_SIZE + static_cast<size_t>(count) * (sizeof(uint64_t) + valueSize);
+    message.reserve(sizeof(BinaryHeader) + payloadSize);
+
+    WriteHeader(message, BinaryOpcode::SCAN_RESULTS, 0, static_cast<uint32_t>(payloadSize), streamId);
+    WriteUInt32(message, count);
+    message.push_back(static_cast<uint8_t>(type));
+    message.push_back(0);
+    WriteUInt16(message, valueSize);
+
+    for (uint32_t i = 0; i < count; i++) {
+        WriteUInt64(message, addresses[i]);
+        const uint8_t* value = values + static_cast<size_t>(i) * valueSize;
+        message.insert(message.end(), value, value + valueSize);
+    }
+
+    return message;
+}
+
 bool BinaryProtocol::DecodeHeader(const std::vector<uint8_t>& data, BinaryHeader& header) {
     if (data.size() < sizeof(BinaryHeader)) {
         return false;
@@ -149,7 +230,7 @@ bool BinaryProtocol::DecodeMemoryWrite(const std::vector<uint8_t>& payload, Memo
     
     memcpy(&request, payload.data(), sizeof(MemoryWriteRequest));
     
-    if (payload.size() < sizeof(MemoryWriteRequest) + request.dataSize) {
+    if (payload.size() - sizeof(MemoryWriteRequest) < request.dataSize) {
         return false;
     }
     
@@ -159,6 +240,50 @@ bool BinaryProtocol::DecodeMemoryWrite(const std::vector<uint8_t>& payload, Memo
     return true;
 }
 
+bool BinaryProtocol::DecodeBulkRead(const std::vector<uint8_t>& payload, std::vector<MemoryReadRequest>& requests) {
+    if (payload.size() < sizeof(BulkReadRequest)) {
+        return false;
+    }
+
+    uint32_t count = ReadUInt32(payload.data());
+    if ((payload.size() - sizeof(BulkReadRequest)) / sizeof(MemoryReadRequest) < count) {
+        return false;
+    }
+
+    requests.resize(count);
+    memcpy(requests.data(), payload.data() + sizeof(BulkReadRequest), count * sizeof(MemoryReadRequest));
+    return true;
+}
+
+bool BinaryProtocol::DecodeMemoryScan(const std::vector<uint8_t>& payload, MemoryScanRequest& request, std::vector<uint8_t>& value,
+                                      std::string& filter) {
+    if (payload.size() < sizeof(MemoryScanRequest)) {
+        return false;
+    }
+
+    memcpy(&request, payload.data(), sizeof(MemoryScanRequest));
+
+    if (request.valueSize == 0 || payload.size() - sizeof(MemoryScanRequest) < request.valueSize) {
+        return false;
+    }
+
+    value.assign(payload.begin() + sizeof(MemoryScanRequest), payload.begin() + sizeof(MemoryScanRequest) + request.valueSize);
+
+    // The filter is optional; a length that runs past the payload is malformed
+    size_t offset = sizeof(MemoryScanRequest) + request.valueSize;
+    filter.clear();
+    if (payload.size() - offset >= sizeof(uint16_t)) {
+        uint16_t filterLength;
+        memcpy(&filterLength, payload.data() + offset, sizeof(filterLength));
+        offset += sizeof(filterLength);
+        if (payload.size() - offset < filterLength) {
+            return false;
+        }
+        filter.assign(reinterpret_cast<const char*>(payload.data() + offset), filterLength);
+    }
+    return true;
+}
+
 std::string BinaryProtocol::DataTypeToString(DataType type) {
     switch (type) {
         case DataType::INT32: return "int32";
@@ -191,6 +316,20 @@ std::string BinaryProtocol::AddressToString(uint64_t address) {
     return std::string(buffer);
 }
 
+void BinaryProtocol::WriteHeader(std::vector<uint8_t>& buffer, BinaryOpcode opcode, uint8_t flags, uint32_t payloadSize, uint32_t requestId) {
+    WriteUInt32(buffer, 0x494E544C);
+    WriteUInt16(buffer, 0x0001);
+    buffer.push_back(static_cast<uint8_t>(opcode));
+    buffer.push_back(flags);
+    WriteUInt32(buffer, payloadSize);
+    WriteUInt32(buffer, requestId);
+}
+
+void BinaryProtocol::WriteUInt16(std::vector<uint8_t>& buffer, uint16_t value) {
+    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
+    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+}
+
 void BinaryProtocol::WriteUInt32(std::vector<uint8_t>& buffer, uint32_t value) {
     buffer.push_back(static_cast<uint8_t>(value & 0xFF));
     buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
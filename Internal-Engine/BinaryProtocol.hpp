@@ -17,9 +17,19 @@ enum class BinaryOpcode : uint8_t {
     PROCESS_INFO = 0x06,
     MODULE_LIST = 0x07,
     PING = 0x08,
-    PONG = 0x09
+    PONG = 0x09,
+    SCAN_PROGRESS = 0x0A,
+    SCAN_RESULTS = 0x0B,
+    HOOK_STATS = 0x0C,
+    ENGINE_METRICS = 0x0D,
+    VIEWER_UPDATE = 0x0E
 };
 
+// Header flags
+static const uint8_t BINARY_FLAG_FINAL = 0x01;  // Last frame of a stream
+static const uint8_t BINARY_FLAG_ERROR = 0x02;  // Response to a request that failed
+static const uint8_t BINARY_FLAG_WATCH = 0x04;  // Watch change set (requestId = watch id)
+
 enum class DataType : uint8_t {
     INT32 = 0x01,
     INT64 = 0x02,
@@ -29,6 +39,9 @@ enum class DataType : uint8_t {
     BYTES = 0x06
 };
 
+// Wire structs are packed so they match the WebUI client byte for byte
+#pragma pack(push, 1)
+
 struct BinaryHeader {
     uint32_t magic = 0x494E544C; // 'INTL' for Internal Engine
     uint16_t version = 0x0001;
@@ -63,6 +76,32 @@ struct BulkUpdateNotification {
     // Followed by count * ValueUpdateNotification
 };
 
+struct BulkReadRequest {
+    uint32_t count;
+    // Followed by count * MemoryReadRequest; answered with a BULK_UPDATE in the same order
+};
+
+struct MemoryScanRequest {
+    DataType type;
+    uint8_t alignment;
+    uint32_t valueSize;
+    // Followed by value bytes, then optionally filterLength u16 and a scan filter expression
+    // (UTF-8, see ScanFilter); results stream back as SCAN_RESULTS / SCAN_PROGRESS
+};
+
+#pragma pack(pop)
+
+// Streamed scan frames (little-endian, no padding; requestId = client stream id)
+// SCAN_PROGRESS: chunksDone u32, chunksTotal u32, resultsFound u64 (FINAL flag when done)
+// SCAN_RESULTS:  count u32, type u8, reserved u8, valueSize u16,
+//                then count * (address u64 + valueSize value bytes)
+static const size_t SCAN_PROGRESS_PAYLOAD_SIZE = 16;
+static const size_t SCAN_RESULTS_PREFIX_SIZE = 8;
+
+// HOOK_STATS (requestId = hook.stats subscription id): layout in HookStatsPublisher::EncodeFrame
+// ENGINE_METRICS (requestId = engine.metrics subscription id): layout in MetricsPublisher::EncodeFrame
+// VIEWER_UPDATE (requestId = viewer.subscribe subscription id): layout in ViewerManager::EncodeFrame
+
 class BinaryProtocol {
 public:
     // Encode binary message
@@ -70,11 +109,19 @@ public:
     static std::vector<uint8_t> EncodeMemoryWrite(uint32_t requestId, uint64_t address, DataType type, const std::vector<uint8_t>& data);
     static std::vector<uint8_t> EncodeValueUpdate(uint64_t address, DataType type, const std::vector<uint8_t>& value);
     static std::vector<uint8_t> EncodeBulkUpdate(const std::vector<std::pair<uint64_t, std::vector<uint8_t>>>& updates);
+    static std::vector<uint8_t> EncodeMessage(BinaryOpcode opcode, uint32_t requestId, uint8_t flags, const uint8_t* payload = nullptr, size_t payloadSize = 0);
+    static std::vector<uint8_t> EncodeMemoryReadResponse(uint32_t requestId, uint64_t address, DataType type, const std::vector<uint8_t>& value);
+    static std::vector<uint8_t> EncodeBulkRead(uint32_t requestId, const std::vector<MemoryReadRequest>& requests, const std::vector<std::vector<uint8_t>>& values, uint8_t flags = 0);
+    static std::vector<uint8_t> EncodeScanProgress(uint32_t streamId, uint32_t chunksDone, uint32_t chunksTotal, uint64_t resultsFound, bool finished);
+    static std::vector<uint8_t> EncodeScanResults(uint32_t streamId, DataType type, uint16_t valueSize, const uint64_t* addresses, const uint8_t* values, uint32_t count);
     
     // Decode binary message
     static bool DecodeHeader(const std::vector<uint8_t>& data, BinaryHeader& header);
     static bool DecodeMemoryRead(const std::vector<uint8_t>& payload, MemoryReadRequest& request);
     static bool DecodeMemoryWrite(const std::vector<uint8_t>& payload, MemoryWriteRequest& request, std::vector<uint8_t>& data);
+    static bool DecodeBulkRead(const std::vector<uint8_t>& payload, std::vector<MemoryReadRequest>& requests);
+    static bool DecodeMemoryScan(const std::vector<uint8_t>& payload, MemoryScanRequest& request, std::vector<uint8_t>& value,
+                                 std::string& filter);
     
     // Utility functions
     static std::string DataTypeToString(DataType type);
@@ -83,6 +130,8 @@ public:
     static std::string AddressToString(uint64_t address);
     
 private:
+    static void WriteHeader(std::vector<uint8_t>& buffer, BinaryOpcode opcode, uint8_t flags, uint32_t payloadSize, uint32_t requestId);
+    static void WriteUInt16(std::vector<uint8_t>& buffer, uint16_t value);
     static void WriteUInt32(std::vector<uint8_t>& buffer, uint32_t value);
     static void WriteUInt64(std::vector<uint8_t>& buffer, uint64_t value);
     static uint32_t ReadUInt32(const uint8_t* data);
@@ -0,0 +1,255 @@
+#include "ChangeTracker.hpp"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+
+namespace InternalEngine {
+
+// Shared by every tracker holding the page
+struct TrackedPage {
+    uint64_t lastWrite = 0;             // Epoch during which the last write was seen
+    uint32_t refCount = 0;              // Tracker ids holding the page
+};
+
+struct TrackerState {
+    std::vector<uintptr_t> pages;       // Sorted, every one held in g_pages
+    uint64_t since;                     // Epoch of the previous Collect, UNTRUSTED before it
+};
+
+static const uint64_t UNTRUSTED = ~0ULL;
+
+static uint64_t g_epoch = 1;
+static std::mutex g_trackerMutex;
+static std::unordered_map<uintptr_t, TrackedPage> g_pages;
+static std::unordered_map<uint32_t, TrackerState> g_trackers;
+static uint32_t g_nextTrackerId = 1;
+static std::atomic<size_t> g_activePages{ 0 };
+
+// Pages written since the last reset get the stamp; failures count as written.
+// Caller holds g_trackerMutex.
+static void QueryWriteWatch(const std::vector<uintptr_t>& pages, uint64_t stamp) {
+    std::vector<PVOID> written;
+
+    size_t i = 0;
+    while (i < pages.size()) {
+        auto entry = g_pages.find(pages[i]);
+        if (entry == g_pages.end()) {
+            i++;
+            continue;
+        }
+
+        size_t runEnd = i + 1;
+        while (runEnd < pages.size() && pages[runEnd] == pages[runEnd - 1] + ChangeTracker::PAGE_SIZE) {
+            auto next = g_pages.find(pages[runEnd]);
+            if (next == g_pages.end()) break;
+            runEnd++;
+        }
+
+        written.resize(runEnd - i);
+        ULONG_PTR count = written.size();
+        ULONG granularity = 0;
+        if (GetWriteWatch(WRITE_WATCH_FLAG_RESET, reinterpret_cast<PVOID>(pages[i]), (runEnd - i) * ChangeTracker::PAGE_SIZE,
+                          written.data(), &count, &granularity) == 0) {
+            for (ULONG_PTR w = 0; w < count; w++) {
+                uintptr_t page = reinterpret_cast<uintptr_t>(written[w]) & ~(ChangeTracker::PAGE_SIZE - 1);
+                auto hit = g_pages.find(page);
+                if (hit != g_pages.end()) hit->second.lastWrite = stamp;
+            }
+        } else {
+            for (size_t p = i; p < runEnd; p++) {
+                auto hit = g_pages.find(pages[p]);
+                if (hit != g_pages.end()) hit->second.lastWrite = stamp;
+            }
+        }
+        i = runEnd;
+    }
+}
+
+// Caller holds g_trackerMutex
+static void ReleasePages(const std::vector<uintptr_t>& pages) {
+    for (uintptr_t page : pages) {
+        auto entry = g_pages.find(page);
+        if (entry == g_pages.end()) continue;
+        if (--entry->second.refCount == 0) {
+            g_pages.erase(entry);
+            g_activePages--;
+        }
+    }
+}
+
+// Write watch is a property of the whole allocation; probed on one committed page
+static bool IsWriteWatchAllocation(uintptr_t probePage) {
+    PVOID written = nullptr;
+    ULONG_PTR count = 1;
+    ULONG granularity = 0;
+    return GetWriteWatch(0, reinterpret_cast<PVOID>(probePage), ChangeTracker::PAGE_SIZE,
+                         &written, &count, &granularity) == 0;
+}
+
+static bool IsReadableProtection(DWORD protect) {
+    if (protect & (PAGE_GUARD | PAGE_NOACCESS)) return false;
+    return (protect & (PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY |
+                       PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) != 0;
+}
+
+uint32_t ChangeTracker::Track(const std::vector<uintptr_t>& pages) {
+    std::lock_guard<std::mutex> lock(g_trackerMutex);
+
+    TrackerState state;
+    state.since = UNTRUSTED;
+    state.pages.reserve(pages.size());
+
+    std::unordered_map<uintptr_t, bool> writeWatchAllocations;
+    MEMORY_BASIC_INFORMATION mbi = {};
+    uintptr_t regionStart = 0;
+    uintptr_t regionEnd = 0;
+
+    for (uintptr_t page : pages) {
+        if (page % PAGE_SIZE != 0 || (!state.pages.empty() && page <= state.pages.back())) continue;
+
+        // Already held by another tracker
+        auto existing = g_pages.find(page);
+        if (existing != g_pages.end()) {
+            existing->second.refCount++;
+            state.pages.push_back(page);
+            continue;
+        }
+        if (g_activePages.load() >= MAX_TRACKED_PAGES) break; // The remaining pages stay untracked
+
+        if (page < regionStart || page >= regionEnd) {
+            if (VirtualQuery(reinterpret_cast<void*>(page), &mbi, sizeof(mbi)) == 0) continue;
+            regionStart = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
+            regionEnd = regionStart + mbi.RegionSize;
+        }
+        if (mbi.State != MEM_COMMIT || !IsReadableProtection(mbi.Protect)) continue;
+
+        uintptr_t allocationBase = reinterpret_cast<uintptr_t>(mbi.AllocationBase);
+        auto allocation = writeWatchAllocations.find(allocationBase);
+        if (allocation == writeWatchAllocations.end()) {
+            allocation = writeWatchAllocations.emplace(allocationBase, IsWriteWatchAllocation(page)).first;
+        }
+        if (!allocation->second) continue;  // Nothing proves such a page clean
+
+        TrackedPage& entry = g_pages[page];
+        entry.refCount = 1;
+        g_activePages++;
+        state.pages.push_back(page);
+    }
+
+    if (state.pages.empty()) return 0;
+
+    // The first Collect resets the write watch and reports nothing clean
+    uint32_t trackerId = g_nextTrackerId++;
+    if (g_nextTrackerId == 0) g_nextTrackerId = 1;
+    g_trackers[trackerId] = std::move(state);
+    return trackerId;
+}
+
+void ChangeTracker::Retain(uint32_t trackerId, const std::vector<uintptr_t>& pages) {
+    std::lock_guard<std::mutex> lock(g_trackerMutex);
+    auto it = g_trackers.find(trackerId);
+    if (it == g_trackers.end()) return;
+    TrackerState& state = it->second;
+
+    // Both lists are sorted: walk them together
+    std::vector<uintptr_t> kept;
+    std::vector<uintptr_t> dropped;
+    kept.reserve(min(state.pages.size(), pages.size()));
+
+    size_t wanted = 0;
+    for (size_t i = 0; i < state.pages.size(); i++) {
+        while (wanted < pages.size() && pages[wanted] < state.pages[i]) wanted++;
+        if (wanted < pages.size() && pages[wanted] == state.pages[i]) {
+            kept.push_back(state.pages[i]);
+        } else {
+            dropped.push_back(state.pages[i]);
+        }
+    }
+    if (dropped.empty()) return;
+
+    state.pages.swap(kept);
+    ReleasePages(dropped);
+}
+
+void ChangeTracker::Untrack(uint32_t trackerId) {
+    std::lock_guard<std::mutex> lock(g_trackerMutex);
+    auto it = g_trackers.find(trackerId);
+    if (it == g_trackers.end()) return;
+
+    std::vector<uintptr_t> pages;
+    pages.swap(it->second.pages);
+    g_trackers.erase(it);
+    ReleasePages(pages);
+}
+
+bool ChangeTracker::CollectClean(uint32_t trackerId, std::vector<uintptr_t>& cleanPages) {
+    std::lock_guard<std::mutex> lock(g_trackerMutex);
+    cleanPages.clear();
+
+    auto it = g_trackers.find(trackerId);
+    if (it == g_trackers.end()) return false;
+    TrackerState& state = it->second;
+
+    // Advance first: any write reported after this point is stamped with the new epoch or later
+    uint64_t epoch = ++g_epoch;
+    QueryWriteWatch(state.pages, epoch - 1);
+
+    for (uintptr_t page : state.pages) {
+        auto entry = g_pages.find(page);
+        if (entry == g_pages.end()) continue;
+
+        if (state.since != UNTRUSTED && entry->second.lastWrite < state.since) {
+            cleanPages.push_back(page);
+        }
+    }
+
+    state.since = epoch;
+    return true;
+}
+
+void ChangeTracker::Invalidate(uint32_t trackerId) {
+    std::lock_guard<std::mutex> lock(g_trackerMutex);
+    auto it = g_trackers.find(trackerId);
+    if (it != g_trackers.end()) {
+        it->second.since = UNTRUSTED;
+    }
+}
+
+void ChangeTracker::NotifyWrite(uintptr_t address, size_t size) {
+    // Freezes write many times a second - skip the lock while nothing is tracked
+    if (size == 0 || g_activePages.load(std::memory_order_relaxed) == 0) return;
+
+    std::lock_guard<std::mutex> lock(g_trackerMutex);
+    uintptr_t last = (address + size - 1) & ~(PAGE_SIZE - 1);
+    for (uintptr_t page = address & ~(PAGE_SIZE - 1); page <= last; page += PAGE_SIZE) {
+        auto entry = g_pages.find(page);
+        if (entry != g_pages.end()) {
+            entry->second.lastWrite = g_epoch;
+        }
+    }
+}
+
+void ChangeTracker::Shutdown() {
+    std::lock_guard<std::mutex> lock(g_trackerMutex);
+    g_trackers.clear();
+    g_pages.clear();
+    g_activePages = 0;
+}
+
+size_t ChangeTracker::GetTrackedPageCount() {
+    return g_activePages.load();
+}
+
+bool ChangeTracker::IsRangeClean(const std::vector<uintptr_t>& cleanPages, uintptr_t address, size_t size) {
+    if (cleanPages.empty()) return false;
+
+    uintptr_t last = (address + max(size, static_cast<size_t>(1)) - 1) & ~(PAGE_SIZE - 1);
+    for (uintptr_t page = address & ~(PAGE_SIZE - 1); page <= last; page += PAGE_SIZE) {
+        if (!std::binary_search(cleanPages.begin(), cleanPages.end(), page)) return false;
+    }
+    return true;
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,53 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace InternalEngine {
+
+// 🛰️ 페이지 변경 추적
+// Tells next scans which pages cannot have changed since the previous scan, so their
+// candidates are re-checked against the stored values instead of being read again.
+//
+// Nothing is ever protected: only pages of allocations made with MEM_WRITE_WATCH are
+// tracked, and GetWriteWatch proves them clean. Every other page is left out and its
+// candidates are read again on each next scan. Writes made by the engine (memory.write,
+// freezes) are reported through NotifyWrite.
+//
+// Each tracker id is an independent consumer with its own "since" point and hashes.
+class ChangeTracker {
+public:
+    static const size_t PAGE_SIZE = 4096;
+    static const size_t MAX_TRACKED_PAGES = 1 << 19;    // 2 GB of 4 KB pages, over every tracker
+
+    // Starts tracking pages (sorted page bases). Pages that cannot be tracked (outside write
+    // watch memory, unreadable) are skipped and always count as dirty. Returns the tracker
+    // id, 0 if no page could be tracked.
+    static uint32_t Track(const std::vector<uintptr_t>& pages);
+
+    // Shrinks the page set to pages (sorted); pages no longer needed are released
+    static void Retain(uint32_t trackerId, const std::vector<uintptr_t>& pages);
+
+    static void Untrack(uint32_t trackerId);
+
+    // Returns (sorted) the tracker's pages not written since the previous Collect and starts
+    // the next interval. The first Collect after Track or Invalidate reports no clean pages.
+    static bool CollectClean(uint32_t trackerId, std::vector<uintptr_t>& cleanPages);
+
+    // Values stored by the consumer are no longer the ones read after the last Collect
+    static void Invalidate(uint32_t trackerId);
+
+    // Writes made by the engine itself; the pages count as dirty for every tracker
+    static void NotifyWrite(uintptr_t address, size_t size);
+
+    // Drops every tracker
+    static void Shutdown();
+
+    static size_t GetTrackedPageCount();
+
+    // True if every page of [address, address + size) is in cleanPages (sorted)
+    static bool IsRangeClean(const std::vector<uintptr_t>& cleanPages, uintptr_t address, size_t size);
+};
+
+} // namespace InternalEngine
@@ -0,0 +1,588 @@
+#include "CodeIndex.hpp"
+#include "MemoryEngine.hpp"
+#include "RegionReader.hpp"
+#include "SimdScan.hpp"
+#include "X86Decoder.hpp"
+#include <Psapi.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace InternalEngine {
+
+static const size_t BIGRAM_COUNT = 65536;
+static const size_t DECODE_BATCH = 65536;
+static const uint16_t NO_ENTRY = 0xFFFF;
+static const size_t DISPATCH_CHUNK_SIZE = 1024 * 1024;
+
+struct IndexedRegion {
+    uintptr_t start;
+    uintptr_t end;
+};
+
+struct PackedReference {
+    uintptr_t target;
+    uint32_t from;              // Offset from the module base
+    CodeReferenceKind kind;
+};
+
+struct ModuleIndex {
+    uintptr_t base = 0;
+    size_t size = 0;
+    std::vector<IndexedRegion> regions;         // Executable regions, sorted
+    std::vector<uint32_t> bigramCounts;         // Occurrences of each 2-byte sequence (first byte low)
+    std::vector<uint32_t> bigramStart;          // Postings of bigram b: [bigramStart[b], bigramStart[b + 1])
+    std::vector<uint32_t> postings;             // Module offsets, ascending per bigram; rare bigrams only
+    std::vector<PackedReference> references;    // Sorted by target, then source
+    size_t codeBytes = 0;
+};
+
+using ModuleIndexPtr = std::shared_ptr<const ModuleIndex>;
+
+struct ModuleSpan {
+    uintptr_t base;
+    size_t size;
+};
+
+// 📡 로더 알림 (LdrRegisterDllNotification)
+struct LoaderNotificationData {
+    ULONG flags;
+    const void* fullDllName;
+    const void* baseDllName;
+    PVOID dllBase;
+    ULONG sizeOfImage;
+};
+
+static const ULONG LOADER_REASON_UNLOADED = 2;
+static const size_t MAX_PENDING_DROPS = 64;
+
+typedef VOID (CALLBACK* LoaderNotificationFunction)(ULONG reason, const LoaderNotificationData* data, PVOID context);
+typedef LONG (NTAPI* LdrRegisterDllNotificationFunction)(ULONG flags, LoaderNotificationFunction callback, PVOID context, PVOID* cookie);
+typedef LONG (NTAPI* LdrUnregisterDllNotificationFunction)(PVOID cookie);
+
+static std::mutex g_indexMutex;
+static std::mutex g_buildMutex;                 // One build at a time; a racing query waits and reuses it
+static std::map<uintptr_t, ModuleIndexPtr> g_indexes;
+static std::vector<ModuleSpan> g_modules;       // Loaded modules as of g_seenGeneration
+static PVOID g_notificationCookie = nullptr;
+static bool g_notificationTried = false;
+static uint32_t g_seenGeneration = 0;
+
+// Written by the loader callback, which runs under the loader lock and must not take our
+// locks, and by NotifyWrite, which may run with every other thread suspended. A pending
+// drop is an address whose module index goes at the next sync: an unloaded module's base
+// or code that was written over.
+static std::atomic<uint32_t> g_loaderGeneration{1};
+static std::atomic<uint32_t> g_pendingDropCount{0};
+static std::atomic<uintptr_t> g_pendingDrops[MAX_PENDING_DROPS];
+
+static void QueueDrop(uintptr_t address) {
+    uint32_t slot = g_pendingDropCount.fetch_add(1);
+    if (slot < MAX_PENDING_DROPS) {
+        g_pendingDrops[slot].store(address);
+    }
+    g_loaderGeneration.fetch_add(1);
+}
+
+static VOID CALLBACK OnLoaderNotification(ULONG reason, const LoaderNotificationData* data, PVOID) {
+    if (reason == LOADER_REASON_UNLOADED && data) {
+        QueueDrop(reinterpret_cast<uintptr_t>(data->dllBase));
+    } else {
+        g_loaderGeneration.fetch_add(1);
+    }
+}
+
+// Caller holds g_indexMutex
+static void RegisterLoaderNotification() {
+    if (g_notificationTried) return;
+    g_notificationTried = true;
+
+    HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+    if (!ntdll) return;
+    auto registerNotification = reinterpret_cast<LdrRegisterDllNotificationFunction>(
+        GetProcAddress(ntdll, "LdrRegisterDllNotification"));
+    if (!registerNotification || registerNotification(0, OnLoaderNotification, nullptr, &g_notificationCookie) != 0) {
+        g_notificationCookie = nullptr;
+    }
+}
+
+static std::vector<ModuleSpan> EnumerateModules() {
+    std::vector<ModuleSpan> modules;
+    std::vector<HMODULE> handles(256);
+    DWORD needed = 0;
+
+    HANDLE process = GetCurrentProcess();
+    while (true) {
+        DWORD capacity = static_cast<DWORD>(handles.size() * sizeof(HMODULE));
+        if (!EnumProcessModules(process, handles.data(), capacity, &needed)) return modules;
+        if (needed <= capacity) break;
+        handles.resize(needed / sizeof(HMODULE) + 16);
+    }
+    handles.resize(needed / sizeof(HMODULE));
+
+    for (HMODULE handle : handles) {
+        MODULEINFO info;
+        if (GetModuleInformation(process, handle, &info, sizeof(info))) {
+            modules.push_back({ reinterpret_cast<uintptr_t>(info.lpBaseOfDll), info.SizeOfImage });
+        }
+    }
+    std::sort(modules.begin(), modules.end(), [](const ModuleSpan& a, const ModuleSpan& b) { return a.base < b.base; });
+    return modules;
+}
+
+// Applies unloads reported since the last call and refreshes the module list.
+// Without the loader notification the list is re-read on every query instead.
+// Caller holds g_indexMutex.
+static void SyncWithLoader() {
+    uint32_t generation = g_loaderGeneration.load();
+    if (g_notificationCookie && generation == g_seenGeneration) return;
+    g_seenGeneration = generation;
+
+    uint32_t drops = g_pendingDropCount.exchange(0);
+    bool dropAll = drops > MAX_PENDING_DROPS;
+    for (uint32_t i = 0; i < min(drops, static_cast<uint32_t>(MAX_PENDING_DROPS)); i++) {
+        uintptr_t address = g_pendingDrops[i].exchange(0);
+        if (address == 0) {
+            dropAll = true;     // Writer still between count and store
+            continue;
+        }
+        auto it = g_indexes.upper_bound(address);
+        if (it == g_indexes.begin()) continue;
+        --it;
+        if (address < it->first + it->second->size) g_indexes.erase(it);
+    }
+    if (dropAll) g_indexes.clear();
+
+    g_modules = EnumerateModules();
+
+    // A module that moved or changed size is not the one that was indexed
+    for (auto it = g_indexes.begin(); it != g_indexes.end();) {
+        auto module = std::lower_bound(g_modules.begin(), g_modules.end(), it->first,
+                                       [](const ModuleSpan& m, uintptr_t base) { return m.base < base; });
+        if (module == g_modules.end() || module->base != it->first || module->size != it->second->size) {
+            it = g_indexes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// SEH 전용 헬퍼 함수 (C++ 객체 없음)
+static bool SafeMatch(const uint8_t* address, const uint8_t* pattern, const char* mask, size_t length) {
+    __try {
+        for (size_t i = 0; i < length; i++) {
+            if (mask[i] == 'x' && address[i] != pattern[i]) return false;
+        }
+        return true;
+    }
+    __except(EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+static std::vector<IndexedRegion> QueryExecutableRegions(uintptr_t base, size_t size) {
+    std::vector<IndexedRegion> regions;
+    const DWORD executable = PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+
+    uintptr_t address = base;
+    while (address < base + size) {
+        MEMORY_BASIC_INFORMATION mbi;
+        if (VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) == 0) break;
+
+        uintptr_t regionStart = max(reinterpret_cast<uintptr_t>(mbi.BaseAddress), base);
+        uintptr_t regionEnd = min(reinterpret_cast<uintptr_t>(mbi.BaseAddress) + mbi.RegionSize, base + size);
+        if (mbi.State == MEM_COMMIT && (mbi.Protect & executable) && !(mbi.Protect & PAGE_GUARD)) {
+            if (!regions.empty() && regions.back().end == regionStart) {
+                regions.back().end = regionEnd;
+            } else {
+                regions.push_back({ regionStart, regionEnd });
+            }
+        }
+        address = regionEnd;
+    }
+    return regions;
+}
+
+static void CollectReferences(const X86Instruction& inst, uintptr_t base, bool is64bit, std::vector<PackedReference>& out) {
+    if (inst.flags & X86_FLAG_INVALID) return;
+
+    PackedReference ref;
+    ref.from = static_cast<uint32_t>(inst.address - base);
+
+    if (inst.flags & X86_FLAG_RELATIVE) {
+        ref.target = inst.target;
+        ref.kind = (inst.flags & X86_FLAG_CALL) ? CodeReferenceKind::Call : CodeReferenceKind::Jump;
+        out.push_back(ref);
+        return;
+    }
+
+    ref.kind = CodeReferenceKind::Data;
+    if (inst.flags & X86_FLAG_RIP_RELATIVE) {
+        ref.target = inst.target;
+    } else if (inst.map == X86OpcodeMap::Primary && inst.opcode >= 0xA0 && inst.opcode <= 0xA3) {
+        ref.target = static_cast<uintptr_t>(inst.immediate);     // mov with moffs
+    } else if (!is64bit && (inst.flags & X86_FLAG_MODRM) && inst.addressSize == 4 && (inst.modrm >> 6) == 0) {
+        // [disp32] directly or through a SIB with neither base nor index
+        bool absolute = (inst.modrm & 7) == 5 ||
+                        ((inst.flags & X86_FLAG_SIB) && (inst.sib & 7) == 5 && ((inst.sib >> 3) & 7) == 4);
+        if (!absolute) return;
+        ref.target = static_cast<uint32_t>(inst.displacement);
+    } else {
+        return;
+    }
+    if (ref.target != 0) out.push_back(ref);
+}
+
+static ModuleIndexPtr BuildModuleIndex(const ModuleSpan& module) {
+    auto index = std::make_shared<ModuleIndex>();
+    index->base = module.base;
+    index->size = module.size;
+    index->regions = QueryExecutableRegions(module.base, module.size);
+    index->bigramCounts.assign(BIGRAM_COUNT, 0);
+
+    const bool is64bit = sizeof(void*) == 8;
+    std::vector<std::vector<uint8_t>> code;
+    std::vector<X86Instruction> instructions;
+    instructions.reserve(DECODE_BATCH);
+
+    // Pass 1: bigram counts and references, one read per region
+    for (auto it = index->regions.begin(); it != index->regions.end();) {
+        std::vector<uint8_t> bytes = MemoryEngine::SafeReadBytes(it->start, it->end - it->start);
+        if (bytes.empty()) {
+            it = index->regions.erase(it);
+            continue;
+        }
+
+        for (size_t i = 0; i + 1 < bytes.size(); i++) {
+            index->bigramCounts[bytes[i] | (bytes[i + 1] << 8)]++;
+        }
+
+        // Linear sweep: data between functions decodes as junk, which only adds references
+        // nobody asks for; the decoder resynchronizes within a few instructions
+        size_t offset = 0;
+        while (offset < bytes.size()) {
+            instructions.clear();
+            offset += X86Decoder::DecodeRange(bytes.data() + offset, bytes.size() - offset, it->start + offset,
+                                              is64bit, instructions, DECODE_BATCH);
+            for (const auto& inst : instructions) {
+                CollectReferences(inst, module.base, is64bit, index->references);
+            }
+        }
+
+        index->codeBytes += bytes.size();
+        code.push_back(std::move(bytes));
+        ++it;
+    }
+
+    // Pass 2: positions of the rare bigrams (regions ascend, so postings do too)
+    index->bigramStart.assign(BIGRAM_COUNT + 1, 0);
+    for (size_t b = 0; b < BIGRAM_COUNT; b++) {
+        uint32_t count = index->bigramCounts[b];
+        index->bigramStart[b + 1] = index->bigramStart[b] + (count <= CodeIndex::RARE_BIGRAM_LIMIT ? count : 0);
+    }
+    index->postings.resize(index->bigramStart[BIGRAM_COUNT]);
+
+    std::vector<uint32_t> fill(index->bigramStart.begin(), index->bigramStart.end() - 1);
+    for (size_t r = 0; r < code.size(); r++) {
+        const std::vector<uint8_t>& bytes = code[r];
+        uint32_t regionOffset = static_cast<uint32_t>(index->regions[r].start - module.base);
+        for (size_t i = 0; i + 1 < bytes.size(); i++) {
+            uint32_t bigram = bytes[i] | (bytes[i + 1] << 8);
+            if (index->bigramCounts[bigram] <= CodeIndex::RARE_BIGRAM_LIMIT) {
+                index->postings[fill[bigram]++] = regionOffset + static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    std::sort(index->references.begin(), index->references.end(), [](const PackedReference& a, const PackedReference& b) {
+        return a.target != b.target ? a.target < b.target : a.from < b.from;
+    });
+    index->references.shrink_to_fit();
+    return index;
+}
+
+// Indexes of the modules overlapping [start, end), built on first use
+static std::vector<ModuleIndexPtr> AcquireIndexes(uintptr_t start, uintptr_t end) {
+    std::vector<ModuleIndexPtr> indexes;
+    std::vector<ModuleSpan> missing;
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(g_indexMutex);
+        RegisterLoaderNotification();
+        SyncWithLoader();
+        generation = g_seenGeneration;
+
+        for (const ModuleSpan& module : g_modules) {
+            if (module.base >= end || module.base + module.size <= start) continue;
+            auto it = g_indexes.find(module.base);
+            if (it != g_indexes.end()) {
+                indexes.push_back(it->second);
+            } else {
+                missing.push_back(module);
+            }
+        }
+    }
+
+    for (const ModuleSpan& module : missing) {
+        std::lock_guard<std::mutex> build(g_buildMutex);
+        {
+            std::lock_guard<std::mutex> lock(g_indexMutex);
+            auto it = g_indexes.find(module.base);
+            if (it != g_indexes.end() && it->second->size == module.size) {
+                indexes.push_back(it->second);
+                continue;
+            }
+        }
+
+        ModuleIndexPtr index = BuildModuleIndex(module);
+        indexes.push_back(index);
+
+        // A module unloaded while it was being read is used for this query only
+        std::lock_guard<std::mutex> lock(g_indexMutex);
+        if (g_loaderGeneration.load() == generation && g_seenGeneration == generation) {
+            g_indexes[module.base] = index;
+        }
+    }
+    return indexes;
+}
+
+// Pattern offset of the fixed byte pair with the fewest occurrences; false if there is none
+static bool PickAnchor(const ModuleIndex& index, const CodePattern& pattern, size_t& anchor, uint32_t& count) {
+    bool found = false;
+    for (size_t i = 0; i + 1 < pattern.mask.size(); i++) {
+        if (pattern.mask[i] != 'x' || pattern.mask[i + 1] != 'x') continue;
+        uint32_t bigram = static_cast<uint8_t>(pattern.pattern[i]) | (static_cast<uint8_t>(pattern.pattern[i + 1]) << 8);
+        uint32_t occurrences = index.bigramCounts[bigram];
+        if (!found || occurrences < count) {
+            found = true;
+            anchor = i;
+            count = occurrences;
+        }
+    }
+    return found;
+}
+
+struct DispatchEntry {
+    size_t pattern;
+    size_t anchor;
+    uint16_t next;
+};
+
+// One read of each region for every pattern without a rare anchor
+static void DispatchScan(const ModuleIndex& index, const std::vector<CodePattern>& patterns,
+                         const std::vector<DispatchEntry>& entries, const std::vector<uint16_t>& heads,
+                         const std::vector<size_t>& unanchored, size_t maxLength,
+                         uintptr_t start, uintptr_t end, std::vector<std::vector<uintptr_t>>& matches) {
+    std::vector<std::pair<size_t, uintptr_t>> found;
+    std::vector<size_t> offsets;
+
+    for (const IndexedRegion& region : index.regions) {
+        uintptr_t scanStart = max(region.start, start);
+        uintptr_t scanEnd = min(region.end, end);
+
+        for (uintptr_t chunkStart = scanStart; chunkStart < scanEnd; chunkStart += DISPATCH_CHUNK_SIZE) {
+            // Matches starting inside the chunk may extend up to the region end
+            size_t candidates = min(static_cast<size_t>(scanEnd - chunkStart), DISPATCH_CHUNK_SIZE);
+            size_t readSize = min(candidates + maxLength - 1, static_cast<size_t>(region.end - chunkStart));
+
+            found.clear();
+            RegionReader::Visit(chunkStart, candidates, readSize, 1,
+                                [&](const uint8_t* data, size_t dataSize, size_t runCandidates, size_t runOffset) {
+                uintptr_t runStart = chunkStart + runOffset;
+
+                for (size_t q = 0; !entries.empty() && q + 1 < dataSize; q++) {
+                    uint16_t entry = heads[data[q] | (data[q + 1] << 8)];
+                    while (entry != NO_ENTRY) {
+                        const DispatchEntry& e = entries[entry];
+                        entry = e.next;
+                        if (q < e.anchor) continue;
+
+                        size_t offset = q - e.anchor;
+                        const CodePattern& p = patterns[e.pattern];
+                        if (offset >= runCandidates || offset + p.mask.size() > dataSize) continue;
+
+                        bool match = true;
+                        for (size_t i = 0; i < p.mask.size() && match; i++) {
+                            match = p.mask[i] != 'x' || data[offset + i] == static_cast<uint8_t>(p.pattern[i]);
+                        }
+                        if (match) found.push_back({ e.pattern, runStart + offset });
+                    }
+                }
+
+                // No fixed byte pair at all: the plain kernel on the same bytes
+                for (size_t patternIndex : unanchored) {
+                    const CodePattern& p = patterns[patternIndex];
+                    offsets.clear();
+                    SimdScan::FindPattern(data, dataSize, runCandidates, reinterpret_cast<const uint8_t*>(p.pattern.data()),
+                                          p.mask.data(), p.mask.size(), offsets);
+                    for (size_t offset : offsets) {
+                        found.push_back({ patternIndex, runStart + offset });
+                    }
+                }
+            });
+
+            for (const auto& match : found) {
+                matches[match.first].push_back(match.second);
+            }
+        }
+    }
+}
+
+void CodeIndex::FindPatterns(const std::vector<CodePattern>& patterns, uintptr_t start, uintptr_t end,
+                             std::vector<std::vector<uintptr_t>>& matches,
+                             std::vector<std::pair<uintptr_t, uintptr_t>>& covered) {
+    matches.assign(patterns.size(), {});
+    if (patterns.empty() || start >= end) return;
+
+    for (const ModuleIndexPtr& indexPtr : AcquireIndexes(start, end)) {
+        const ModuleIndex& index = *indexPtr;
+
+        std::vector<DispatchEntry> entries;
+        std::vector<uint16_t> heads;
+        std::vector<size_t> unanchored;
+        size_t maxLength = 0;
+
+        for (size_t p = 0; p < patterns.size(); p++) {
+            const CodePattern& pattern = patterns[p];
+            if (pattern.mask.empty() || pattern.pattern.size() < pattern.mask.size()) continue;
+
+            size_t anchor = 0;
+            uint32_t count = 0;
+            if (!PickAnchor(index, pattern, anchor, count)) {
+                unanchored.push_back(p);
+                maxLength = max(maxLength, pattern.mask.size());
+                continue;
+            }
+            if (count == 0) continue;
+
+            uint32_t bigram = static_cast<uint8_t>(pattern.pattern[anchor]) | (static_cast<uint8_t>(pattern.pattern[anchor + 1]) << 8);
+            if (count <= RARE_BIGRAM_LIMIT) {
+                // Posting lookup: only positions where the rarest pair occurs
+                auto region = index.regions.begin();
+                for (uint32_t i = index.bigramStart[bigram]; i < index.bigramStart[bigram + 1]; i++) {
+                    uintptr_t position = index.base + index.postings[i];
+                    if (position < anchor) continue;
+                    uintptr_t candidate = position - anchor;
+                    if (candidate < start || candidate >= end) continue;
+
+                    while (region != index.regions.end() && region->end <= position) ++region;
+                    if (region == index.regions.end()) break;
+                    if (candidate < region->start || candidate + pattern.mask.size() > region->end) continue;
+
+                    if (SafeMatch(reinterpret_cast<const uint8_t*>(candidate), reinterpret_cast<const uint8_t*>(pattern.pattern.data()),
+                                  pattern.mask.data(), pattern.mask.size())) {
+                        matches[p].push_back(candidate);
+                    }
+                }
+            } else if (entries.size() < NO_ENTRY) {
+                if (heads.empty()) heads.assign(BIGRAM_COUNT, NO_ENTRY);
+                entries.push_back({ p, anchor, heads[bigram] });
+                heads[bigram] = static_cast<uint16_t>(entries.size() - 1);
+                maxLength = max(maxLength, pattern.mask.size());
+            } else {
+                unanchored.push_back(p);
+                maxLength = max(maxLength, pattern.mask.size());
+            }
+        }
+
+        if (!entries.empty() || !unanchored.empty()) {
+            DispatchScan(index, patterns, entries, heads, unanchored, maxLength, start, end, matches);
+        }
+
+        for (const IndexedRegion& region : index.regions) {
+            uintptr_t spanStart = max(region.start, start);
+            uintptr_t spanEnd = min(region.end, end);
+            if (spanStart < spanEnd) covered.push_back({ spanStart, spanEnd });
+        }
+    }
+
+    for (auto& list : matches) {
+        std::sort(list.begin(), list.end());
+    }
+    std::sort(covered.begin(), covered.end());
+}
+
+std::vector<CodeReference> CodeIndex::FindReferencesInRange(uintptr_t targetStart, uintptr_t targetEnd, uintptr_t start, uintptr_t end) {
+    std::vector<CodeReference> results;
+    if (targetStart >= targetEnd || start >= end) return results;
+
+    for (const ModuleIndexPtr& indexPtr : AcquireIndexes(start, end)) {
+        const ModuleIndex& index = *indexPtr;
+        auto it = std::lower_bound(index.references.begin(), index.references.end(), targetStart,
+                                   [](const PackedReference& ref, uintptr_t target) { return ref.target < target; });
+        for (; it != index.references.end() && it->target < targetEnd; ++it) {
+            uintptr_t from = index.base + it->from;
+            if (from < start || from >= end) continue;
+
+            CodeReference ref;
+            ref.from = from;
+            ref.target = it->target;
+            ref.kind = it->kind;
+            results.push_back(ref);
+        }
+    }
+
+    std::sort(results.begin(), results.end(), [](const CodeReference& a, const CodeReference& b) { return a.from < b.from; });
+    return results;
+}
+
+std::vector<CodeReference> CodeIndex::FindReferences(uintptr_t target, uintptr_t start, uintptr_t end) {
+    return FindReferencesInRange(target, target + 1, start, end);
+}
+
+void CodeIndex::NotifyWrite(uintptr_t address, size_t size) {
+    if (size == 0) return;
+
+    // Only image memory is ever indexed; heap writes cost one VirtualQuery
+    uintptr_t last = address + size - 1;
+    MEMORY_BASIC_INFORMATION mbi;
+    if (VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) == sizeof(mbi) && mbi.Type == MEM_IMAGE) {
+        QueueDrop(address);
+    }
+    // A write across a page boundary may end in the next module
+    uintptr_t pageMask = ~static_cast<uintptr_t>(RegionReader::PAGE_SIZE - 1);
+    if ((last & pageMask) != (address & pageMask)) {
+        if (VirtualQuery(reinterpret_cast<void*>(last), &mbi, sizeof(mbi)) == sizeof(mbi) && mbi.Type == MEM_IMAGE) {
+            QueueDrop(last);
+        }
+    }
+}
+
+void CodeIndex::Invalidate() {
+    std::lock_guard<std::mutex> lock(g_indexMutex);
+    g_indexes.clear();
+}
+
+void CodeIndex::Shutdown() {
+    std::lock_guard<std::mutex> lock(g_indexMutex);
+    if (g_notificationCookie) {
+        HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+        auto unregisterNotification = ntdll ? reinterpret_cast<LdrUnregisterDllNotificationFunction>(
+            GetProcAddress(ntdll, "LdrUnregisterDllNotification")) : nullptr;
+        if (unregisterNotification) unregisterNotification(g_notificationCookie);
+        g_notificationCookie = nullptr;
+    }
+    g_notificationTried = false;
+    g_indexes.clear();
+    g_modules.clear();
+}
+
+CodeIndexStats CodeIndex::GetStats() {
+    std::lock_guard<std::mutex> lock(g_indexMutex);
+    CodeIndexStats stats;
+    for (const auto& pair : g_indexes) {
+        const ModuleIndex& index = *pair.second;
+        stats.modules++;
+        stats.codeBytes += index.codeBytes;
+        stats.references += index.references.size();
+        stats.postings += index.postings.size();
+        stats.memoryBytes += (index.bigramCounts.size() + index.bigramStart.size() + index.postings.size()) * sizeof(uint32_t) +
+                             index.references.size() * sizeof(PackedReference) +
+                             index.regions.size() * sizeof(IndexedRegion);
+    }
+    return stats;
+}
+
+} // namespace InternalEngine
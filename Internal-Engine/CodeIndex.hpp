@@ -0,0 +1,84 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace InternalEngine {
+
+// Byte signature: pattern bytes and a mask of the same length ('x' = must match, '?' = any)
+struct CodePattern {
+    std::string pattern;
+    std::string mask;
+};
+
+enum class CodeReferenceKind : uint8_t {
+    Call,       // call rel32
+    Jump,       // jmp/jcc/loop/jrcxz (short or near)
+    Data        // RIP-relative (x64) or absolute (x86) memory operand, lea included
+};
+
+struct CodeReference {
+    uintptr_t from = 0;         // Address of the referencing instruction
+    uintptr_t target = 0;
+    CodeReferenceKind kind = CodeReferenceKind::Call;
+};
+
+struct CodeIndexStats {
+    size_t modules = 0;             // Modules with a built index
+    size_t codeBytes = 0;           // Executable bytes covered
+    size_t references = 0;
+    size_t postings = 0;            // Indexed 2-byte positions
+    size_t memoryBytes = 0;         // Heap held by the tables
+};
+
+// 🧭 코드 인덱스
+// Signature resolution and "find references" over executable module code without a full
+// scan per lookup. A module is indexed the first time a query touches it, in one pass over
+// its executable regions:
+//  - Bigram table: the position of every 2-byte sequence that occurs at most
+//    RARE_BIGRAM_LIMIT times. A signature is checked only at the positions of its rarest
+//    fixed byte pair; signatures without a rare pair share one dispatch pass over the code
+//    (one read, bigram -> signatures lookup per position) instead of one scan each.
+//  - Reference table: every relative call/jump and RIP-relative (x86: absolute) memory
+//    operand from a linear sweep with X86Decoder, sorted by target.
+// Candidates are verified against live memory. Writes through the engine (memory.write,
+// patches, NOPs, DetoursLite hooks) report themselves with NotifyWrite, which drops the
+// written module's index, so matches gained or lost by them are found like a scan would.
+// Code changed behind the engine's back only loses matches; the reference table reflects
+// the code as it was when the module was indexed. Indexes are also dropped when the loader
+// reports a module load or unload.
+class CodeIndex {
+public:
+    static const size_t RARE_BIGRAM_LIMIT = 4096;
+
+    // Matches of every pattern (matches[i] sorted, for patterns[i]) that start inside
+    // indexed executable code of [start, end) and end inside the same region. The regions
+    // answered are appended to covered as sorted [begin, end) spans; the caller scans the
+    // rest of the range the usual way.
+    static void FindPatterns(const std::vector<CodePattern>& patterns, uintptr_t start, uintptr_t end,
+                             std::vector<std::vector<uintptr_t>>& matches,
+                             std::vector<std::pair<uintptr_t, uintptr_t>>& covered);
+
+    // References to target from code inside [start, end), sorted by source address
+    static std::vector<CodeReference> FindReferences(uintptr_t target, uintptr_t start, uintptr_t end);
+
+    // References to any address in [targetStart, targetEnd) (e.g. a whole function)
+    static std::vector<CodeReference> FindReferencesInRange(uintptr_t targetStart, uintptr_t targetEnd, uintptr_t start, uintptr_t end);
+
+    // Drops every module index (rebuilt on the next query)
+    static void Invalidate();
+
+    // Marks the module index covering [address, address + size) stale; it is dropped at the
+    // next query. Takes no lock and never allocates, so it is safe with threads suspended.
+    static void NotifyWrite(uintptr_t address, size_t size);
+
+    // Unregisters the loader notification and frees the indexes
+    static void Shutdown();
+
+    static CodeIndexStats GetStats();
+};
+
+} // namespace InternalEngine
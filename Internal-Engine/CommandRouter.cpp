@@ -1,11 +1,22 @@
 #include "CommandRouter.hpp"
 #include "MemoryEngine.hpp"
 #include "HookManager.hpp"
+#include "WebSocketServer.hpp"
+#include "Json.hpp"
+#include "X86Decoder.hpp"
+#include "CodeIndex.hpp"
+#include "SignatureCache.hpp"
+#include "ModuleMap.hpp"
+#include "ScanFilter.hpp"
+#include "WorkStealingPool.hpp"
 #include <sstream>
 #include <iomanip>
 #include <Psapi.h>
 #include <TlHelp32.h>
 #include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <unordered_map>
 #include <Shlwapi.h>
 #pragma comment(lib, "shlwapi.lib")
 
@@ -16,57 +27,67 @@ namespace InternalEngine {
 // Global instance
 CommandRouter* g_CommandRouter = nullptr;
 
-// Simple JSON parser helpers (minimal implementation)
-std::string ExtractJsonValue(const std::string& json, const std::string& key) {
-    size_t keyPos = json.find("\"" + key + "\"");
-    if (keyPos == std::string::npos) return "";
-    
-    size_t colonPos = json.find(":", keyPos);
-    if (colonPos == std::string::npos) return "";
-    
-    size_t valueStart = json.find_first_not_of(" \t\n\r", colonPos + 1);
-    if (valueStart == std::string::npos) return "";
-    
-    if (json[valueStart] == '"') {
-        size_t valueEnd = json.find("\"", valueStart + 1);
-        if (valueEnd == std::string::npos) return "";
-        return json.substr(valueStart + 1, valueEnd - valueStart - 1);
-    } else {
-        size_t valueEnd = json.find_first_of(",}", valueStart);
-        if (valueEnd == std::string::npos) valueEnd = json.length();
-        return json.substr(valueStart, valueEnd - valueStart);
+// Request being dispatched on this thread, tokenized once (see RequestScope)
+static thread_local const JsonObject* t_request = nullptr;
+
+static bool IsCurrentRequest(const std::string& json) {
+    return t_request && t_request->Source().data() == json.data() && t_request->Source().size() == json.size();
+}
+
+// Tokenizes json for the duration of a command. The outermost request reuses the thread's
+// member storage, so dispatching a small request does not allocate for parsing.
+class RequestScope {
+public:
+    explicit RequestScope(const std::string& json) : previous(t_request) {
+        if (IsCurrentRequest(json)) return;
+        static thread_local JsonObject threadStorage;
+        JsonObject& request = previous ? nested : threadStorage;
+        request.Parse(json);
+        t_request = &request;
     }
+    ~RequestScope() { t_request = previous; }
+
+private:
+    const JsonObject* previous;
+    JsonObject nested;
+};
+
+// Top-level member of json (strings unescaped, other values as raw text), or "" if missing.
+// Lookups on the request being dispatched read its token list; anything else (e.g. one
+// element of an array parameter) is scanned only up to the key.
+static JsonValue LookupJsonMember(const std::string& json, const std::string& key) {
+    if (IsCurrentRequest(json)) {
+        return t_request->Get(key);
+    }
+    return FindJsonMember(json, key);
 }
 
-// Helper function to escape JSON strings
-std::string EscapeJsonString(const std::string& input) {
-    std::string output;
-    output.reserve(input.length() * 2);
+std::string ExtractJsonValue(const std::string& json, const std::string& key) {
+    return LookupJsonMember(json, key).ToString();
+}
+
+// Array value for key (brackets included), or "" if missing
+std::string ExtractJsonArray(const std::string& json, const std::string& key) {
+    JsonValue value = LookupJsonMember(json, key);
+    return value.type == JsonType::Array ? std::string(value.raw) : std::string();
+}
+
+static std::string Base64Encode(const uint8_t* data, size_t size) {
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result;
+    result.reserve((size + 2) / 3 * 4);
     
-    for (char c : input) {
-        switch (c) {
-            case '"':  output += "\\\""; break;
-            case '\\': output += "\\\\"; break;
-            case '\b': output += "\\b"; break;
-            case '\f': output += "\\f"; break;
-            case '\n': output += "\\n"; break;
-            case '\r': output += "\\r"; break;
-            case '\t': output += "\\t"; break;
-            default:
-                if (c < 0x20) {
-                    output += "\\u";
-                    output += "0123456789abcdef"[(c >> 12) & 0xF];
-                    output += "0123456789abcdef"[(c >> 8) & 0xF];
-                    output += "0123456789abcdef"[(c >> 4) & 0xF];
-                    output += "0123456789abcdef"[c & 0xF];
-                } else {
-                    output += c;
-                }
-                break;
-        }
+    for (size_t i = 0; i < size; i += 3) {
+        uint32_t triple = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < size) triple |= static_cast<uint32_t>(data[i + 1]) << 8;
+        if (i + 2 < size) triple |= data[i + 2];
+        
+        result.push_back(chars[(triple >> 18) & 0x3F]);
+        result.push_back(chars[(triple >> 12) & 0x3F]);
+        result.push_back(i + 1 < size ? chars[(triple >> 6) & 0x3F] : '=');
+        result.push_back(i + 2 < size ? chars[triple & 0x3F] : '=');
     }
-    
-    return output;
+    return result;
 }
 
 CommandRouter::CommandRouter() {
@@ -76,15 +97,128 @@ CommandRouter::CommandRouter() {
 CommandRouter::~CommandRouter() {
 }
 
+void CommandRouter::OnConnectionClosed(WebSocketConnection* conn) {
+    CancelConnectionCommands(conn);
+    watches.UnsubscribeOwner(conn);
+    viewers.UnsubscribeOwner(conn);
+    hookStats.UnsubscribeOwner(conn);
+    metricsPublisher.UnsubscribeOwner(conn);
+    pageDeltas.DropOwner(conn);
+    scanSessions.CloseOwner(conn);
+}
+
+void CommandRouter::CancelConnectionCommands(WebSocketConnection* conn) {
+    std::lock_guard<std::mutex> lock(activeCommandsMutex);
+    for (auto it = activeCommands.lower_bound(ActiveCommandKey(conn, std::string()));
+         it != activeCommands.end() && it->first.first == conn; ++it) {
+        it->second->store(true);
+    }
+}
+
+bool CommandRouter::CancelCommand(WebSocketConnection* origin, const std::string& id) {
+    std::lock_guard<std::mutex> lock(activeCommandsMutex);
+    auto it = activeCommands.find(ActiveCommandKey(origin, id));
+    if (it == activeCommands.end()) return false;
+    it->second->store(true);
+    return true;
+}
+
+void CommandRouter::Shutdown() {
+    watches.Stop();
+    viewers.Stop();
+    hookStats.Stop();
+    metricsPublisher.Stop();
+    freezes.Stop();
+    
+    // Sessions release their trackers before the tracker state is dropped
+    scanSessions.CloseAll();
+    ChangeTracker::Shutdown();
+    
+    // Scans are done; the pool threads run code from this module
+    WorkStealingPool::Shutdown();
+    
+    // The loader callbacks live in this module
+    CodeIndex::Shutdown();
+    ModuleMap::Shutdown();
+    
+    std::string cacheError;
+    SignatureCache::Flush(cacheError);
+}
+
 void CommandRouter::RegisterCommand(const std::string& command, CommandHandler handler) {
-    commands[command] = handler;
+    RegisteredCommand registered;
+    registered.handler = handler;
+    registered.metrics = EngineMetrics::ForCommand(command);
+    commands[command] = std::move(registered);
 }
 
 void CommandRouter::UnregisterCommand(const std::string& command) {
     commands.erase(command);
 }
 
+// Connection whose request is being handled on this thread (null for IPC requests)
+static thread_local WebSocketConnection* t_originConnection = nullptr;
+
+// Id of that request and its cancel flag (null when the request has no id to cancel by)
+static thread_local const std::string* t_commandId = nullptr;
+static thread_local const std::atomic<bool>* t_cancelFlag = nullptr;
+
+// Outcome of the handler running on this thread: every response goes through CreateResponse,
+// which records its success flag here for the command metrics
+static thread_local bool* t_commandFailed = nullptr;
+
+// Requests run concurrently on the server's workers; an id that is already running keeps the
+// first registration, so a cancel never hits the wrong request
+struct CommandRouter::CommandScope {
+    CommandRouter* router;
+    ActiveCommandKey key;
+    std::shared_ptr<std::atomic<bool>> cancel;
+    bool registered = false;
+    WebSocketConnection* previousOrigin;
+    const std::string* previousId;
+    const std::atomic<bool>* previousCancel;
+    
+    CommandScope(CommandRouter* router, WebSocketConnection* conn, const std::string& id)
+        : router(router), key(conn, id), cancel(std::make_shared<std::atomic<bool>>(false)),
+          previousOrigin(t_originConnection), previousId(t_commandId), previousCancel(t_cancelFlag) {
+        if (!id.empty()) {
+            std::lock_guard<std::mutex> lock(router->activeCommandsMutex);
+            registered = router->activeCommands.emplace(key, cancel).second;
+        }
+        t_originConnection = conn;
+        t_commandId = &key.second;
+        t_cancelFlag = registered ? cancel.get() : nullptr;
+    }
+    ~CommandScope() {
+        t_originConnection = previousOrigin;
+        t_commandId = previousId;
+        t_cancelFlag = previousCancel;
+        if (registered) {
+            std::lock_guard<std::mutex> lock(router->activeCommandsMutex);
+            router->activeCommands.erase(key);
+        }
+    }
+    
+    CommandScope(const CommandScope&) = delete;
+    CommandScope& operator=(const CommandScope&) = delete;
+};
+
+std::string CommandRouter::ExecuteCommand(const std::string& jsonRequest, WebSocketConnection* origin) {
+    RequestScope request(jsonRequest);
+    CommandScope scope(this, origin, origin ? ExtractJsonValue(jsonRequest, "id") : "");
+    
+    return ExecuteCommand(jsonRequest);
+}
+
+std::string CommandRouter::ExecuteControlCommand(const std::string& jsonRequest, WebSocketConnection* origin) {
+    if (ExtractJsonValue(jsonRequest, "command") != "command.cancel") {
+        return "";
+    }
+    return HandleCommandCancel(jsonRequest, origin);
+}
+
 std::string CommandRouter::ExecuteCommand(const std::string& jsonRequest) {
+    RequestScope request(jsonRequest);
     try {
         std::string command = ExtractJsonValue(jsonRequest, "command");
         std::string id = ExtractJsonValue(jsonRequest, "id");
@@ -98,15 +232,36 @@ std::string CommandRouter::ExecuteCommand(const std::string& jsonRequest) {
             return CreateResponse(false, "", "Unknown command: " + command, id);
         }
         
-        // Execute the command and get the response
-        std::string response = it->second(jsonRequest);
+        // Execute the command and get the response; a throwing handler counts as an error
+        struct StatusScope {
+            bool failed = false;
+            bool* previous;
+            StatusScope() : previous(t_commandFailed) { t_commandFailed = &failed; }
+            ~StatusScope() { t_commandFailed = previous; }
+        };
+        uint64_t started = EngineMetrics::Now();
+        std::string response;
+        bool failed = false;
+        try {
+            StatusScope status;
+            response = it->second.handler(jsonRequest);
+            failed = status.failed;
+        } catch (...) {
+            EngineMetrics::RecordCommand(it->second.metrics, EngineMetrics::MicrosSince(started), true);
+            throw;
+        }
+        EngineMetrics::RecordCommand(it->second.metrics, EngineMetrics::MicrosSince(started), failed);
         
-        // Add the ID to the response if it's not already there
-        if (!id.empty() && response.find("\"id\"") == std::string::npos) {
+        // Add the ID to the response if it's not already there (CreateResponse puts it first,
+        // so only the prefix needs checking - not the whole, possibly large, response)
+        if (!id.empty() && response.compare(0, 6, "{\"id\":") != 0) {
             // Insert the ID at the beginning of the JSON object
             size_t openBrace = response.find('{');
             if (openBrace != std::string::npos) {
-                response.insert(openBrace + 1, "\"id\":\"" + id + "\",");
+                std::string member = "\"id\":\"";
+                AppendJsonEscaped(member, id);
+                member += "\",";
+                response.insert(openBrace + 1, member);
             }
         }
         
@@ -121,10 +276,28 @@ void CommandRouter::RegisterBuiltinCommands() {
     RegisterCommand("memory.read", [this](const std::string& p) { return HandleMemoryRead(p); });
     RegisterCommand("memory.write", [this](const std::string& p) { return HandleMemoryWrite(p); });
     RegisterCommand("memory.scan", [this](const std::string& p) { return HandleMemoryScan(p); });
+    RegisterCommand("scan.session.create", [this](const std::string& p) { return HandleScanSessionCreate(p); });
+    RegisterCommand("scan.session.next", [this](const std::string& p) { return HandleScanSessionNext(p); });
+    RegisterCommand("scan.session.undo", [this](const std::string& p) { return HandleScanSessionUndo(p); });
+    RegisterCommand("scan.session.close", [this](const std::string& p) { return HandleScanSessionClose(p); });
+    RegisterCommand("scan.session.results", [this](const std::string& p) { return HandleScanSessionResults(p); });
+    RegisterCommand("command.cancel", [this](const std::string& p) { return HandleCommandCancel(p, t_originConnection); });
+    RegisterCommand("watch.subscribe", [this](const std::string& p) { return HandleWatchSubscribe(p); });
+    RegisterCommand("watch.unsubscribe", [this](const std::string& p) { return HandleWatchUnsubscribe(p); });
+    RegisterCommand("viewer.subscribe", [this](const std::string& p) { return HandleViewerSubscribe(p); });
+    RegisterCommand("viewer.unsubscribe", [this](const std::string& p) { return HandleViewerUnsubscribe(p); });
+    RegisterCommand("freeze.set", [this](const std::string& p) { return HandleFreezeSet(p); });
+    RegisterCommand("freeze.clear", [this](const std::string& p) { return HandleFreezeClear(p); });
+    RegisterCommand("freeze.list", [this](const std::string& p) { return HandleFreezeList(p); });
     RegisterCommand("memory.regions", [this](const std::string& p) { return HandleMemoryRegions(p); });
     RegisterCommand("memory.validate", [this](const std::string& p) { return HandleMemoryValidate(p); });
     RegisterCommand("pattern.scan", [this](const std::string& p) { return HandlePatternScan(p); });
     RegisterCommand("pattern.scanall", [this](const std::string& p) { return HandlePatternScanAll(p); });
+    RegisterCommand("pattern.scanbatch", [this](const std::string& p) { return HandlePatternScanBatch(p); });
+    RegisterCommand("code.xrefs", [this](const std::string& p) { return HandleCodeReferences(p); });
+    RegisterCommand("code.index", [this](const std::string& p) { return HandleCodeIndexInfo(p); });
+    RegisterCommand("cache.info", [this](const std::string& p) { return HandleCacheInfo(p); });
+    RegisterCommand("cache.clear", [this](const std::string& p) { return HandleCacheClear(p); });
     RegisterCommand("module.list", [this](const std::string& p) { return HandleModuleList(p); });
     RegisterCommand("module.info", [this](const std::string& p) { return HandleModuleInfo(p); });
     RegisterCommand("process.info", [this](const std::string& p) { return HandleProcessInfo(p); });
@@ -132,37 +305,62 @@ void CommandRouter::RegisterBuiltinCommands() {
     RegisterCommand("hook.remove", [this](const std::string& p) { return HandleHookRemove(p); });
     RegisterCommand("hook.list", [this](const std::string& p) { return HandleHookList(p); });
     RegisterCommand("hook.toggle", [this](const std::string& p) { return HandleHookToggle(p); });
+    RegisterCommand("hook.profile", [this](const std::string& p) { return HandleHookProfile(p); });
+    RegisterCommand("hook.stats", [this](const std::string& p) { return HandleHookStats(p); });
+    RegisterCommand("hook.stats.subscribe", [this](const std::string& p) { return HandleHookStatsSubscribe(p); });
+    RegisterCommand("hook.stats.unsubscribe", [this](const std::string& p) { return HandleHookStatsUnsubscribe(p); });
+    RegisterCommand("engine.metrics", [this](const std::string& p) { return HandleEngineMetrics(p); });
+    RegisterCommand("engine.metrics.subscribe", [this](const std::string& p) { return HandleEngineMetricsSubscribe(p); });
+    RegisterCommand("engine.metrics.unsubscribe", [this](const std::string& p) { return HandleEngineMetricsUnsubscribe(p); });
     RegisterCommand("memory.allocate", [this](const std::string& p) { return HandleAllocateMemory(p); });
     RegisterCommand("memory.free", [this](const std::string& p) { return HandleFreeMemory(p); });
     RegisterCommand("memory.patch", [this](const std::string& p) { return HandleMemoryPatch(p); });
     RegisterCommand("memory.nop", [this](const std::string& p) { return HandleMemoryNop(p); });
     RegisterCommand("pointer.chain", [this](const std::string& p) { return HandlePointerChain(p); });
     RegisterCommand("pointer.find", [this](const std::string& p) { return HandlePointerFind(p); });
+    RegisterCommand("pointer.chain.save", [this](const std::string& p) { return HandlePointerChainSave(p); });
+    RegisterCommand("pointer.chain.load", [this](const std::string& p) { return HandlePointerChainLoad(p); });
+    RegisterCommand("pointer.map.create", [this](const std::string& p) { return HandlePointerMapCreate(p); });
+    RegisterCommand("pointer.map.save", [this](const std::string& p) { return HandlePointerMapSave(p); });
+    RegisterCommand("pointer.map.load", [this](const std::string& p) { return HandlePointerMapLoad(p); });
+    RegisterCommand("pointer.map.close", [this](const std::string& p) { return HandlePointerMapClose(p); });
+    RegisterCommand("pointer.scan", [this](const std::string& p) { return HandlePointerScan(p); });
+    RegisterCommand("pointer.results", [this](const std::string& p) { return HandlePointerResults(p); });
+    RegisterCommand("pointer.results.close", [this](const std::string& p) { return HandlePointerResultsClose(p); });
     
     // New enhanced commands
     RegisterCommand("memory.read_value", [this](const std::string& p) { return HandleMemoryReadValue(p); });
     RegisterCommand("memory.disassemble", [this](const std::string& p) { return HandleMemoryDisassemble(p); });
+    RegisterCommand("memory.read_bulk", [this](const std::string& p) { return HandleMemoryReadBulk(p); });
     RegisterCommand("module.from_address", [this](const std::string& p) { return HandleModuleFromAddress(p); });
 }
 
 std::string CommandRouter::CreateResponse(bool success, const std::string& data, const std::string& error, const std::string& id) {
-    std::stringstream ss;
-    ss << "{";
+    if (t_commandFailed) {
+        *t_commandFailed = !success;
+    }
+    
+    // Sized once up front; data is usually the bulk of the response
+    std::string response;
+    response.reserve(48 + id.size() + data.size() + error.size());
+    
+    JsonWriter json(response);
+    json.BeginObject();
     
     // Add ID first if provided
     if (!id.empty()) {
-        ss << "\"id\":\"" << id << "\",";
+        json.Key("id").String(id);
     }
     
-    ss << "\"success\":" << (success ? "true" : "false");
+    json.Key("success").Bool(success);
     if (!data.empty()) {
-        ss << ",\"data\":" << data;
+        json.Key("data").Raw(data);
     }
     if (!error.empty()) {
-        ss << ",\"error\":\"" << error << "\"";
+        json.Key("error").String(error);
     }
-    ss << "}";
-    return ss.str();
+    json.EndObject();
+    return response;
 }
 
 std::string CommandRouter::HandleMemoryRead(const std::string& params) {
@@ -195,14 +393,36 @@ std::string CommandRouter::HandleMemoryRead(const std::string& params) {
                 return CreateResponse(false, "", "Failed to read memory - access denied or invalid address", id);
             }
             
-            std::stringstream ss;
-            ss << "[";
-            for (size_t i = 0; i < bytes.size(); i++) {
-                if (i > 0) ss << ",";
-                ss << static_cast<int>(bytes[i]);
+            // 🔁 뷰어 새로고침: XOR against the page this connection received last time
+            if (ExtractJsonValue(params, "delta") == "true" && t_originConnection) {
+                std::string baseIdStr = ExtractJsonValue(params, "baseId");
+                uint32_t baseId = baseIdStr.empty() ? 0 : static_cast<uint32_t>(std::stoul(baseIdStr));
+                
+                std::vector<uint8_t> encoded;
+                bool isDelta = false;
+                uint32_t pageId = pageDeltas.Encode(t_originConnection, address, bytes, baseId, encoded, isDelta);
+                
+                std::string data;
+                data.reserve(80 + (encoded.size() + 2) / 3 * 4);
+                JsonWriter json(data);
+                json.BeginObject();
+                json.Key("pageId").UInt(pageId);
+                json.Key("baseId").UInt(isDelta ? baseId : 0);
+                json.Key("encoding").String(isDelta ? "xor" : "raw");
+                json.Key("data").String(Base64Encode(encoded.data(), encoded.size()));
+                json.EndObject();
+                return CreateResponse(true, data, "", id);
+            }
+            
+            std::string data;
+            data.reserve(bytes.size() * 4 + 2);
+            JsonWriter json(data);
+            json.BeginArray();
+            for (uint8_t byte : bytes) {
+                json.UInt(byte);
             }
-            ss << "]";
-            return CreateResponse(true, ss.str(), "", id);
+            json.EndArray();
+            return CreateResponse(true, data, "", id);
         } else if (typeStr == "int") {
             auto value = MemoryEngine::SafeRead<int32_t>(address);
             if (!value.has_value()) {
@@ -238,7 +458,9 @@ std::string CommandRouter::HandleMemoryRead(const std::string& params) {
             }
             
             std::string result(reinterpret_cast<char*>(bytes.data()), nullPos);
-            return CreateResponse(true, "\"" + EscapeJsonString(result) + "\"", "", id);
+            std::string data;
+            JsonWriter(data).String(result);
+            return CreateResponse(true, data, "", id);
         }
         
         return CreateResponse(false, "", "Unknown type: " + typeStr, id);
@@ -279,62 +501,286 @@ std::string CommandRouter::HandleMemoryWrite(const std::string& params) {
     }
 }
 
-// Cached module information
-struct ModuleRange {
-    uintptr_t base;
-    uintptr_t end;
-    std::string name;
-};
+// 🛑 취소 / 진행 상황
+static bool IsCommandCancelled() {
+    return t_cancelFlag && t_cancelFlag->load();
+}
 
-static std::vector<ModuleRange> g_moduleCache;
-static DWORD g_lastModuleCacheUpdate = 0;
-static const DWORD MODULE_CACHE_VALIDITY_MS = 5000; // 5 seconds
-
-// Update module cache
-void UpdateModuleCache() {
-    DWORD currentTime = GetTickCount();
-    if (currentTime - g_lastModuleCacheUpdate < MODULE_CACHE_VALIDITY_MS && !g_moduleCache.empty()) {
-        return; // Cache is still valid
-    }
-
-    g_moduleCache.clear();
-    HANDLE hProcess = GetCurrentProcess();
-    HMODULE hModules[1024];
-    DWORD cbNeeded;
-
-    if (EnumProcessModules(hProcess, hModules, sizeof(hModules), &cbNeeded)) {
-        for (DWORD i = 0; i < (cbNeeded / sizeof(HMODULE)); i++) {
-            MODULEINFO modInfo;
-            if (GetModuleInformation(hProcess, hModules[i], &modInfo, sizeof(modInfo))) {
-                char moduleName[MAX_PATH];
-                if (GetModuleFileNameExA(hProcess, hModules[i], moduleName, MAX_PATH)) {
-                    ModuleRange range;
-                    range.base = reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll);
-                    range.end = range.base + modInfo.SizeOfImage;
-                    range.name = PathFindFileNameA(moduleName);
-                    g_moduleCache.push_back(range);
-                }
+// "progress": true on a WebSocket request that does not stream its results. Sends
+// {"type":"progress","commandId","done","total","found"} text messages at most every
+// PROGRESS_NOTIFY_INTERVAL_MS and always for the last step. The field is commandId, not
+// id, so clients never take a notification for the response itself.
+static const DWORD PROGRESS_NOTIFY_INTERVAL_MS = 200;
+
+static std::function<void(size_t, size_t, size_t)> CreateProgressNotifier(const std::string& params) {
+    if (!t_originConnection || !t_commandId || t_commandId->empty() || ExtractJsonValue(params, "progress") != "true") {
+        return nullptr;
+    }
+
+    WebSocketConnection* connection = t_originConnection;
+    std::string commandId = *t_commandId;
+    auto lastTick = std::make_shared<DWORD>(0);
+
+    // Scan callbacks are serialized, so the throttle needs no lock
+    return [connection, commandId, lastTick](size_t done, size_t total, size_t found) {
+        DWORD now = GetTickCount();
+        if (done < total && now - *lastTick < PROGRESS_NOTIFY_INTERVAL_MS) return;
+        *lastTick = now;
+
+        std::string message;
+        message.reserve(96 + commandId.size());
+        JsonWriter json(message);
+        json.BeginObject();
+        json.Key("type").String("progress");
+        json.Key("commandId").String(commandId);
+        json.Key("done").UInt(done);
+        json.Key("total").UInt(total);
+        json.Key("found").UInt(found);
+        json.EndObject();
+        connection->SendText(message);
+    };
+}
+
+// Lets command.cancel stop the scan and, unless a streamer already reports progress,
+// adds progress notifications
+static void AttachCommandControl(ScanOptions& options, const std::string& params) {
+    options.cancel = t_cancelFlag;
+    if (!options.onProgress) {
+        options.onProgress = CreateProgressNotifier(params);
+    }
+}
+
+static const char* const CANCELLED_DATA = "{\"cancelled\":true}";
+
+// Worker count for scans and pointer maps: decimal, 0 = one per hardware thread
+static size_t ParseThreadCount(const std::string& text, const char* name) {
+    size_t value = 0;
+    auto parsed = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (parsed.ec != std::errc() || parsed.ptr != text.data() + text.size() || value > WorkStealingPool::MAX_THREADS) {
+        throw std::invalid_argument(std::string(name) + " must be between 0 and " + std::to_string(WorkStealingPool::MAX_THREADS));
+    }
+    return value;
+}
+
+// Scan options shared by memory.scan and scan.session.create
+static ScanOptions ParseScanOptions(const std::string& params) {
+    ScanOptions options;
+
+    std::string startStr = ExtractJsonValue(params, "startAddress");
+    std::string endStr = ExtractJsonValue(params, "endAddress");
+    if (!startStr.empty()) options.startAddress = std::stoull(startStr, nullptr, 16);
+    if (!endStr.empty()) options.endAddress = std::stoull(endStr, nullptr, 16);
+
+    auto parseTriState = [](const std::string& s) {
+        if (s == "yes") return TriState::Yes;
+        if (s == "no") return TriState::No;
+        return TriState::Any;
+    };
+    options.filterWritable = parseTriState(ExtractJsonValue(params, "writable"));
+    options.filterExecutable = parseTriState(ExtractJsonValue(params, "executable"));
+    options.filterCopyOnWrite = parseTriState(ExtractJsonValue(params, "copyOnWrite"));
+
+    std::string threadCountStr = ExtractJsonValue(params, "threadCount");
+    if (!threadCountStr.empty()) options.threadCount = ParseThreadCount(threadCountStr, "threadCount");
+
+    options.trackChanges = ExtractJsonValue(params, "trackChanges") == "true";
+
+    return options;
+}
+
+// JSON array of scan results: [{"address","value","previousValue"?,"module"?}, ...]
+// "module" is "name+0xoffset". With moduleTable the names go into the table instead, once
+// each, and results carry "moduleIndex" (position in the table) and "moduleOffset".
+static std::string SerializeScanResults(const std::vector<ScanResult>& results, bool includePrevious,
+                                        std::vector<std::string>* moduleTable = nullptr) {
+    std::string output;
+    output.reserve(results.size() * 64 + 2);
+    JsonWriter json(output);
+    json.BeginArray();
+
+    ModuleMap::Snapshot modules = ModuleMap::GetSnapshot();
+    std::unordered_map<uint32_t, uint32_t> tableIndex;   // nameId -> position in moduleTable
+    const ModuleRange* lastModule = nullptr;
+    std::string moduleInfo;
+
+    for (const auto& result : results) {
+        json.BeginObject();
+        json.Key("address").Hex(result.address);
+        json.Key("value").String(MemoryEngine::ValueToString(result.value, result.type));
+        if (includePrevious && !result.previousValue.empty()) {
+            json.Key("previousValue").String(MemoryEngine::ValueToString(result.previousValue, result.type));
+        }
+
+        // Results are mostly sorted, so the previous module usually matches again
+        const ModuleRange* module = lastModule;
+        if (!module || result.address < module->base || result.address >= module->end) {
+            module = modules->Find(result.address);
+        }
+        if (module) {
+            lastModule = module;
+            uintptr_t offset = result.address - module->base;
+            if (moduleTable) {
+                auto entry = tableIndex.emplace(module->nameId, static_cast<uint32_t>(moduleTable->size()));
+                if (entry.second) moduleTable->push_back(modules->NameOf(*module));
+                json.Key("moduleIndex").UInt(entry.first->second);
+                json.Key("moduleOffset").Hex(offset);
+            } else {
+                char hex[24];
+                auto end = std::to_chars(hex, hex + sizeof(hex), static_cast<uint64_t>(offset), 16).ptr;
+                moduleInfo.assign(modules->NameOf(*module));
+                moduleInfo += "+0x";
+                moduleInfo.append(hex, end - hex);
+                json.Key("module").String(moduleInfo);
             }
         }
+
+        json.EndObject();
     }
-    
-    g_lastModuleCacheUpdate = currentTime;
+
+    json.EndArray();
+    return output;
 }
 
-// Fast module lookup using cache
-std::string GetModuleInfoForAddress(uintptr_t address) {
-    UpdateModuleCache();
-    
-    for (const auto& module : g_moduleCache) {
-        if (address >= module.base && address < module.end) {
-            uintptr_t offset = address - module.base;
-            std::stringstream ss;
-            ss << module.name << "+0x" << std::hex << offset;
-            return ss.str();
+// 📡 스캔 결과 스트리밍
+// Sends results to the requesting connection as SCAN_RESULTS binary frames of batchSize
+// entries while the scan is still running, plus SCAN_PROGRESS frames at most every
+// PROGRESS_INTERVAL_MS. Sends block while the socket send buffer is full, which holds the
+// scan workers back; after a failed send the rest of the stream is dropped.
+class ScanResultStreamer {
+public:
+    static const size_t DEFAULT_BATCH_SIZE = 1000;
+    static const DWORD PROGRESS_INTERVAL_MS = 100;
+
+    ScanResultStreamer(WebSocketConnection* connection, uint32_t streamId, const std::string& type, size_t batchSize)
+        : connection(connection), streamId(streamId),
+          dataType(BinaryProtocol::StringToDataType(type == "int" ? "int32" : type)),
+          batchSize(batchSize == 0 ? DEFAULT_BATCH_SIZE : batchSize) {
+        addresses.reserve(this->batchSize);
+    }
+
+    // Routes the scan callbacks into this streamer (the streamer must outlive the scan)
+    void Attach(ScanOptions& options) {
+        options.onResults = [this](const std::vector<ScanResult>& batch) { Add(batch); };
+        options.onProgress = [this](size_t done, size_t total, size_t found) { Progress(done, total, found); };
+    }
+
+    void Add(const std::vector<ScanResult>& results) {
+        for (const auto& result : results) {
+            if (failed) return;
+
+            // Frames carry one fixed value size; start a new batch if it changes
+            if (!addresses.empty() && result.value.size() != valueSize) Flush();
+            if (addresses.empty()) valueSize = min(result.value.size(), static_cast<size_t>(UINT16_MAX));
+
+            addresses.push_back(result.address);
+            values.insert(values.end(), result.value.begin(), result.value.begin() + valueSize);
+            if (addresses.size() >= batchSize) Flush();
         }
     }
-    
-    return ""; // Not found in any module
+
+    void Progress(size_t chunksDone, size_t chunksTotal, size_t resultsFound) {
+        DWORD now = GetTickCount();
+        if (failed || now - lastProgressTick < PROGRESS_INTERVAL_MS) return;
+        lastProgressTick = now;
+
+        // Results found so far go out first so progress never runs ahead of the list
+        Flush();
+        Send(BinaryProtocol::EncodeScanProgress(streamId, static_cast<uint32_t>(chunksDone),
+                                                static_cast<uint32_t>(chunksTotal), resultsFound, false));
+    }
+
+    // Flushes the last batch and sends the final progress frame
+    void Finish(size_t resultsFound) {
+        Flush();
+        Send(BinaryProtocol::EncodeScanProgress(streamId, 0, 0, resultsFound, true));
+    }
+
+    size_t SentCount() const { return sentCount; }
+    bool Failed() const { return failed; }
+
+private:
+    void Flush() {
+        if (addresses.empty()) return;
+        auto frame = BinaryProtocol::EncodeScanResults(streamId, dataType, static_cast<uint16_t>(valueSize),
+                                                       addresses.data(), values.data(), static_cast<uint32_t>(addresses.size()));
+        if (Send(frame)) sentCount += addresses.size();
+        addresses.clear();
+        values.clear();
+    }
+
+    bool Send(const std::vector<uint8_t>& frame) {
+        if (failed) return false;
+        if (!connection->SendBinary(frame)) failed = true;
+        return !failed;
+    }
+
+    WebSocketConnection* connection;
+    uint32_t streamId;
+    DataType dataType;
+    size_t batchSize;
+
+    std::vector<uint64_t> addresses;
+    std::vector<uint8_t> values;
+    size_t valueSize = 0;
+
+    DWORD lastProgressTick = 0;
+    size_t sentCount = 0;
+    bool failed = false;
+};
+
+// "stream": true on a WebSocket request; streamId is echoed in every frame so the client
+// can match frames to its request (ids of JSON requests are strings)
+static std::unique_ptr<ScanResultStreamer> CreateScanStreamer(const std::string& params, const std::string& type) {
+    if (!t_originConnection || ExtractJsonValue(params, "stream") != "true") {
+        return nullptr;
+    }
+
+    std::string streamIdStr = ExtractJsonValue(params, "streamId");
+    std::string batchSizeStr = ExtractJsonValue(params, "batchSize");
+    uint32_t streamId = streamIdStr.empty() ? 0 : static_cast<uint32_t>(std::stoul(streamIdStr));
+    size_t batchSize = batchSizeStr.empty() ? 0 : std::stoull(batchSizeStr);
+
+    return std::make_unique<ScanResultStreamer>(t_originConnection, streamId, type, batchSize);
+}
+
+// Response data for a streamed scan (the results themselves went out as binary frames)
+static std::string StreamSummary(const ScanResultStreamer& streamer, size_t count) {
+    std::string data;
+    JsonWriter json(data);
+    json.BeginObject();
+    json.Key("streamed").Bool(true);
+    json.Key("count").UInt(count);
+    json.Key("sent").UInt(streamer.SentCount());
+    json.Key("complete").Bool(!streamer.Failed());
+    json.EndObject();
+    return data;
+}
+
+// Next scan parameters: "value" (exact/rounded value, increasedby/decreasedby amount, between
+// lower bound), "value2" (between upper bound), "epsilon" (float tolerance) and "filter"
+static NextScanQuery ParseNextScanQuery(const std::string& params, std::string& error) {
+    NextScanQuery query;
+    query.scanType = ExtractJsonValue(params, "scanType");
+    query.value = ExtractJsonValue(params, "value");
+    query.value2 = ExtractJsonValue(params, "value2");
+    query.epsilon = ExtractJsonValue(params, "epsilon");
+    query.filter = ExtractJsonValue(params, "filter");
+
+    bool needsValue = query.scanType == "exact" || query.scanType == "rounded" ||
+                      query.scanType == "increasedby" || query.scanType == "decreasedby" || query.scanType == "between";
+    if (needsValue && query.value.empty()) {
+        error = "Scan type '" + query.scanType + "' needs a value";
+    } else if (query.scanType == "between" && query.value2.empty()) {
+        error = "Scan type 'between' needs value2 (upper bound)";
+    }
+    return query;
+}
+
+// First scan "filter" expression; throws std::invalid_argument on a compile error
+static ScanFilter CompileScanFilter(const std::string& params, const std::string& valueType) {
+    std::string expression = ExtractJsonValue(params, "filter");
+    if (expression.empty()) return ScanFilter();
+    return ScanFilter::Compile(expression, ScanResultStore::ParseValueKind(valueType));
 }
 
 std::string CommandRouter::HandleMemoryScan(const std::string& params) {
@@ -346,22 +792,10 @@ std::string CommandRouter::HandleMemoryScan(const std::string& params) {
         
         bool isFirstScan = (ExtractJsonValue(params, "firstScan") == "true");
 
-        ScanOptions options;
+        ScanOptions options = ParseScanOptions(params);
         options.isFirstScan = isFirstScan;
-
-        std::string startStr = ExtractJsonValue(params, "startAddress");
-        std::string endStr = ExtractJsonValue(params, "endAddress");
-        if (!startStr.empty()) options.startAddress = std::stoull(startStr, nullptr, 16);
-        if (!endStr.empty()) options.endAddress = std::stoull(endStr, nullptr, 16);
-
-        auto parseTriState = [](const std::string& s) {
-            if (s == "yes") return TriState::Yes;
-            if (s == "no") return TriState::No;
-            return TriState::Any;
-        };
-        options.filterWritable = parseTriState(ExtractJsonValue(params, "writable"));
-        options.filterExecutable = parseTriState(ExtractJsonValue(params, "executable"));
-        options.filterCopyOnWrite = parseTriState(ExtractJsonValue(params, "copyOnWrite"));
+        
+        auto streamer = CreateScanStreamer(params, typeStr);
         
         std::vector<ScanResult> results;
         std::vector<ScanResult> previousResults;
@@ -369,105 +803,70 @@ std::string CommandRouter::HandleMemoryScan(const std::string& params) {
         if (!isFirstScan) {
             // For Next Scan, we need to read current values of previous scan results
             // and filter them based on scan criteria
-            std::string prevResultsStr = ExtractJsonValue(params, "previousResults");
-            
-            // Parse previous results from JSON array
-            prevResultsStr.erase(0, prevResultsStr.find_first_not_of(" \t\r\n"));
-            if (!prevResultsStr.empty() && prevResultsStr.front() == '[') prevResultsStr.erase(0, 1);
-            if (!prevResultsStr.empty() && prevResultsStr.back() == ']') prevResultsStr.pop_back();
-
-            size_t pos = 0;
-            while ((pos = prevResultsStr.find('{', pos)) != std::string::npos) {
-                size_t endPos = prevResultsStr.find('}', pos);
-                if (endPos == std::string::npos) break;
-
-                std::string objStr = prevResultsStr.substr(pos, endPos - pos + 1);
+            JsonArrayReader previousList(LookupJsonMember(params, "previousResults"));
+            JsonValue element;
+            while (previousList.Next(element)) {
+                if (element.type != JsonType::Object) continue;
                 
-                std::string addrStr = ExtractJsonValue(objStr, "address");
-                std::string valStr = ExtractJsonValue(objStr, "value");
+                std::string addrStr = FindJsonMember(element.raw, "address").ToString();
+                std::string valStr = FindJsonMember(element.raw, "value").ToString();
                 
                 if (!addrStr.empty()) {
                     try {
-                        uintptr_t address = std::stoull(addrStr, nullptr, 16);
-                        
-                        // Read current value at this address
-                        auto currentValueOpt = MemoryEngine::ReadValueAtAddress(address, typeStr);
-                        if (currentValueOpt.has_value()) {
-                            auto currentValue = currentValueOpt.value();
-                            auto previousValue = MemoryEngine::StringToValue(valStr, typeStr);
-                            
-                            bool include = false;
-                            
-                            // Apply scan filter
-                            if (scanTypeStr == "exact") {
-                                auto targetValue = MemoryEngine::StringToValue(valueStr, typeStr);
-                                include = (currentValue == targetValue);
-                            }
-                            else if (scanTypeStr == "changed") {
-                                include = (currentValue != previousValue);
-                            }
-                            else if (scanTypeStr == "unchanged") {
-                                include = (currentValue == previousValue);
-                            }
-                            else if (scanTypeStr == "increased") {
-                                include = MemoryEngine::CompareValues(currentValue, previousValue, typeStr) > 0;
-                            }
-                            else if (scanTypeStr == "decreased") {
-                                include = MemoryEngine::CompareValues(currentValue, previousValue, typeStr) < 0;
-                            }
-                            else {
-                                include = true; // Unknown scan type, include all
-                            }
-                            
-                            if (include) {
-                                ScanResult result;
-                                result.address = address;
-                                result.value = currentValue;
-                                result.previousValue = previousValue;
-                                result.type = typeStr;
-                                results.push_back(result);
-                            }
+                        ScanResult previous;
+                        previous.address = std::stoull(addrStr, nullptr, 16);
+                        previous.value = MemoryEngine::StringToValue(valStr, typeStr);
+                        previous.type = typeStr;
+                        if (!previous.value.empty()) {
+                            previousResults.push_back(std::move(previous));
                         }
                     } catch (...) {
                         // Skip invalid addresses
                     }
                 }
-                pos = endPos + 1;
             }
+
+            std::string queryError;
+            NextScanQuery query = ParseNextScanQuery(params, queryError);
+            if (!queryError.empty()) {
+                return CreateResponse(false, "", queryError, id);
+            }
+
+            options.previousResults = &previousResults;
+            AttachCommandControl(options, params);
+            results = MemoryEngine::NextScan(query, options);
+            
+            // Filtering has no chunk order to follow, so the survivors stream afterwards
+            if (streamer) streamer->Add(results);
         } else {
+            if (scanTypeStr == "unknown") {
+                return CreateResponse(false, "", "Unknown initial value scans keep a snapshot in the DLL - use scan.session.create", id);
+            }
             if (valueStr.empty() || typeStr.empty()) {
                 return CreateResponse(false, "", "Missing value or type for first scan", id);
             }
+            ScanFilter filter = CompileScanFilter(params, typeStr);
+            if (!filter.IsEmpty()) options.filter = &filter;
+            
+            if (streamer) streamer->Attach(options);
+            AttachCommandControl(options, params);
             results = MemoryEngine::FirstScan(valueStr, typeStr, options);
         }
 
-        std::stringstream ss;
-        ss << "[";
-        size_t maxResults = results.size(); // No limit - stream all results
-        
-        for (size_t i = 0; i < maxResults; i++) {
-            if (i > 0) ss << ",";
-            ss << "{";
-            ss << "\"address\":\"0x" << std::hex << results[i].address << "\",";
-            ss << "\"value\":\"" << MemoryEngine::ValueToString(results[i].value, results[i].type) << "\"";
-            if (!isFirstScan && !results[i].previousValue.empty()) {
-                ss << ",\"previousValue\":\"" << MemoryEngine::ValueToString(results[i].previousValue, results[i].type) << "\"";
-            }
-            
-            // Add module information
-            std::string moduleInfo = GetModuleInfoForAddress(results[i].address);
-            if (!moduleInfo.empty()) {
-                ss << ",\"module\":\"" << EscapeJsonString(moduleInfo) << "\"";
-            }
-            
-            ss << "}";
+        if (IsCommandCancelled()) {
+            if (streamer) streamer->Finish(results.size());
+            return CreateResponse(false, CANCELLED_DATA, "Command cancelled", id);
         }
-        
-        ss << "]";
-        
+
+        if (streamer) {
+            streamer->Finish(results.size());
+            std::string message = "Found " + std::to_string(results.size()) + " results (streamed)";
+            return CreateResponse(true, StreamSummary(*streamer, results.size()), message, id);
+        }
+
         std::string message = "Found " + std::to_string(results.size()) + " results (all displayed)";
         
-        return CreateResponse(true, ss.str(), message, id);
+        return CreateResponse(true, SerializeScanResults(results, !isFirstScan), message, id);
     } catch (const std::exception& e) {
         return CreateResponse(false, "", std::string("Scan error: ") + e.what(), id);
     } catch (...) {
@@ -475,138 +874,790 @@ std::string CommandRouter::HandleMemoryScan(const std::string& params) {
     }
 }
 
-std::string CommandRouter::HandleMemoryRegions(const std::string& params) {
+// 🗂️ 스캔 세션 (후보 목록은 DLL 내부에 유지)
+std::string CommandRouter::HandleScanSessionCreate(const std::string& params) {
     std::string id = ExtractJsonValue(params, "id");
-    std::string filterStr = ExtractJsonValue(params, "filter"); // "readable", "writable", "executable"
-    
     try {
-        auto regions = MemoryEngine::GetMemoryRegions();
-        
-        // 필터 적용
-        if (!filterStr.empty()) {
-            auto filteredRegions = regions;
-            regions.clear();
-            
-            for (const auto& region : filteredRegions) {
-                if (filterStr == "readable" && region.readable) {
-                    regions.push_back(region);
-                } else if (filterStr == "writable" && region.writable) {
-                    regions.push_back(region);
-                } else if (filterStr == "executable" && region.executable) {
-                    regions.push_back(region);
-                }
+        std::string scanTypeStr = ExtractJsonValue(params, "scanType");
+        std::string valueStr = ExtractJsonValue(params, "value");
+        std::string typeStr = ExtractJsonValue(params, "valueType");
+        if (typeStr.empty() || (valueStr.empty() && scanTypeStr != "unknown")) {
+            return CreateResponse(false, "", "Missing value or valueType parameter", id);
+        }
+        if (scanTypeStr == "unknown" && MemoryEngine::GetValueSize(typeStr) == 0) {
+            return CreateResponse(false, "", "Unknown initial value scans need a fixed-size valueType", id);
+        }
+
+        ScanOptions options = ParseScanOptions(params);
+        ScanFilter filter = CompileScanFilter(params, typeStr);
+        if (!filter.IsEmpty()) {
+            if (scanTypeStr == "unknown") {
+                return CreateResponse(false, "", "Unknown initial value scans take their filter on scan.session.next", id);
             }
+            options.filter = &filter;
         }
         
-        std::stringstream ss;
-        ss << "[";
+        auto streamer = CreateScanStreamer(params, typeStr);
+        if (streamer) streamer->Attach(options);
+        AttachCommandControl(options, params);
         
-        for (size_t i = 0; i < regions.size(); i++) {
-            if (i > 0) ss << ",";
-            
-            ss << "{";
-            ss << "\"baseAddress\":\"0x" << std::hex << regions[i].baseAddress << "\",";
-            ss << "\"size\":" << std::dec << regions[i].size << ",";
-            ss << "\"protection\":" << regions[i].protection << ",";
-            ss << "\"readable\":" << (regions[i].readable ? "true" : "false") << ",";
-            ss << "\"writable\":" << (regions[i].writable ? "true" : "false") << ",";
-            ss << "\"executable\":" << (regions[i].executable ? "true" : "false") << ",";
-            ss << "\"moduleName\":\"" << EscapeJsonString(regions[i].moduleName) << "\"";
-            ss << "}";
+        size_t resultCount = 0;
+        uint32_t sessionId = scanSessions.Create(scanTypeStr, valueStr, typeStr, options, resultCount, t_originConnection);
+        if (streamer) streamer->Finish(resultCount);
+        if (sessionId == 0) {
+            return CreateResponse(false, CANCELLED_DATA, "Command cancelled", id);
         }
-        
-        ss << "]";
-        
-        return CreateResponse(true, ss.str(), "", id);
+
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("sessionId").UInt(sessionId);
+        json.Key("count").UInt(resultCount);
+        if (streamer) {
+            json.Key("streamed").Bool(true);
+            json.Key("sent").UInt(streamer->SentCount());
+        }
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Scan error: ") + e.what(), id);
     } catch (...) {
-        return CreateResponse(false, "", "Failed to get memory regions", id);
+        return CreateResponse(false, "", "Unknown error during scan", id);
     }
 }
 
-std::string CommandRouter::HandleMemoryValidate(const std::string& params) {
-    std::string addressStr = ExtractJsonValue(params, "address");
-    std::string sizeStr = ExtractJsonValue(params, "size");
+std::string CommandRouter::HandleScanSessionNext(const std::string& params) {
     std::string id = ExtractJsonValue(params, "id");
-    
-    if (addressStr.empty()) {
-        return CreateResponse(false, "", "Missing address parameter", id);
-    }
-    
     try {
-        uintptr_t address = std::stoull(addressStr, nullptr, 16);
-        size_t size = sizeStr.empty() ? 1 : std::stoull(sizeStr);
-        
-        bool isValid = MemoryEngine::IsAddressValid(address, size);
-        bool isReadable = MemoryEngine::IsAddressReadable(address, size);
-        bool isWritable = MemoryEngine::IsAddressWritable(address, size);
-        
-        auto region = MemoryEngine::GetMemoryRegion(address);
-        
-        std::stringstream ss;
-        ss << "{";
-        ss << "\"valid\":" << (isValid ? "true" : "false") << ",";
-        ss << "\"readable\":" << (isReadable ? "true" : "false") << ",";
-        ss << "\"writable\":" << (isWritable ? "true" : "false");
-        
-        if (region.has_value()) {
-            ss << ",\"region\":{";
-            ss << "\"baseAddress\":\"0x" << std::hex << region->baseAddress << "\",";
-            ss << "\"size\":" << std::dec << region->size << ",";
-            ss << "\"protection\":" << region->protection << ",";
-            ss << "\"moduleName\":\"" << EscapeJsonString(region->moduleName) << "\"";
-            ss << "}";
+        std::string sessionStr = ExtractJsonValue(params, "sessionId");
+        std::string queryError;
+        NextScanQuery query = ParseNextScanQuery(params, queryError);
+        if (sessionStr.empty() || query.scanType.empty()) {
+            return CreateResponse(false, "", "Missing sessionId or scanType parameter", id);
         }
-        
-        ss << "}";
-        
-        return CreateResponse(true, ss.str(), "", id);
+        if (!queryError.empty()) {
+            return CreateResponse(false, "", queryError, id);
+        }
+
+        uint32_t sessionId = static_cast<uint32_t>(std::stoul(sessionStr));
+        size_t resultCount = 0;
+        size_t cleanPages = 0;
+        bool cancelled = false;
+        ScanOptions control;
+        AttachCommandControl(control, params);
+        if (!scanSessions.Next(sessionId, query, resultCount, &cleanPages, &control, &cancelled)) {
+            return CreateResponse(false, "", "Unknown scan session", id);
+        }
+        if (cancelled) {
+            return CreateResponse(false, CANCELLED_DATA, "Command cancelled", id);
+        }
+
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("sessionId").UInt(sessionId);
+        json.Key("count").UInt(resultCount);
+        json.Key("cleanPages").UInt(cleanPages);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Scan error: ") + e.what(), id);
     } catch (...) {
-        return CreateResponse(false, "", "Failed to validate address", id);
+        return CreateResponse(false, "", "Unknown error during scan", id);
     }
 }
 
-std::string CommandRouter::HandlePatternScanAll(const std::string& params) {
-    std::string pattern = ExtractJsonValue(params, "pattern");
-    std::string startStr = ExtractJsonValue(params, "start");
-    std::string endStr = ExtractJsonValue(params, "end");
+std::string CommandRouter::HandleScanSessionUndo(const std::string& params) {
     std::string id = ExtractJsonValue(params, "id");
-    
-    if (pattern.empty()) {
-        return CreateResponse(false, "", "Missing pattern parameter", id);
-    }
-    
     try {
-        uintptr_t start = startStr.empty() ? 0 : std::stoull(startStr, nullptr, 16);
-        uintptr_t end = endStr.empty() ? 0 : std::stoull(endStr, nullptr, 16);
-        
-        auto results = MemoryEngine::AOBScanAll(pattern, start, end);
-        
-        std::stringstream ss;
-        ss << "[";
-        
-        size_t maxResults = min(results.size(), static_cast<size_t>(100));
-        for (size_t i = 0; i < maxResults; i++) {
-            if (i > 0) ss << ",";
-            ss << "\"0x" << std::hex << results[i] << "\"";
+        std::string sessionStr = ExtractJsonValue(params, "sessionId");
+        if (sessionStr.empty()) {
+            return CreateResponse(false, "", "Missing sessionId parameter", id);
         }
-        
-        ss << "]";
-        
-        std::string message = "Found " + std::to_string(results.size()) + " matches";
-        if (results.size() > maxResults) {
-            message += " (showing first " + std::to_string(maxResults) + ")";
+
+        uint32_t sessionId = static_cast<uint32_t>(std::stoul(sessionStr));
+        size_t resultCount = 0;
+        if (!scanSessions.Undo(sessionId, resultCount)) {
+            return CreateResponse(false, "", "Nothing to undo or unknown scan session", id);
         }
-        
-        return CreateResponse(true, ss.str(), message, id);
-    } catch (...) {
-        return CreateResponse(false, "", "Pattern scan failed", id);
+
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("sessionId").UInt(sessionId);
+        json.Key("count").UInt(resultCount);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Undo error: ") + e.what(), id);
     }
 }
 
-std::string CommandRouter::HandleModuleInfo(const std::string& params) {
-    std::string moduleName = ExtractJsonValue(params, "name");
+std::string CommandRouter::HandleScanSessionClose(const std::string& params) {
     std::string id = ExtractJsonValue(params, "id");
-    
+    try {
+        std::string sessionStr = ExtractJsonValue(params, "sessionId");
+        if (sessionStr.empty()) {
+            return CreateResponse(false, "", "Missing sessionId parameter", id);
+        }
+
+        if (!scanSessions.Close(static_cast<uint32_t>(std::stoul(sessionStr)))) {
+            return CreateResponse(false, "", "Unknown scan session", id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Close error: ") + e.what(), id);
+    }
+}
+
+// Paged results: offset (default 0), limit (default 1000)
+std::string CommandRouter::HandleScanSessionResults(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string sessionStr = ExtractJsonValue(params, "sessionId");
+        std::string offsetStr = ExtractJsonValue(params, "offset");
+        std::string limitStr = ExtractJsonValue(params, "limit");
+        if (sessionStr.empty()) {
+            return CreateResponse(false, "", "Missing sessionId parameter", id);
+        }
+
+        uint32_t sessionId = static_cast<uint32_t>(std::stoul(sessionStr));
+        size_t offset = offsetStr.empty() ? 0 : std::stoull(offsetStr);
+        size_t limit = limitStr.empty() ? 1000 : std::stoull(limitStr);
+
+        std::vector<ScanResult> page;
+        size_t totalCount = 0;
+        if (!scanSessions.GetResults(sessionId, offset, limit, page, totalCount)) {
+            return CreateResponse(false, "", "Unknown scan session", id);
+        }
+
+        std::vector<std::string> moduleTable;
+        std::string results = SerializeScanResults(page, true, &moduleTable);
+
+        std::string body;
+        JsonWriter json(body);
+        json.BeginObject();
+        json.Key("sessionId").UInt(sessionId);
+        json.Key("total").UInt(totalCount);
+        json.Key("offset").UInt(offset);
+        json.Key("modules").BeginArray();
+        for (const auto& name : moduleTable) json.String(name);
+        json.EndArray();
+        json.Key("results").Raw(results);
+        json.EndObject();
+        return CreateResponse(true, body, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Results error: ") + e.what(), id);
+    }
+}
+
+// Largest single value served by bulk reads and watches
+static const size_t MAX_BULK_ENTRY_SIZE = 4096;
+
+// Offsets list such as ["0x10", "0x8"] or [16, 8] (bare numbers are hex as in pointer.chain)
+static std::vector<uintptr_t> ParseOffsetList(const std::string& arrayStr) {
+    std::vector<uintptr_t> offsets;
+    std::string clean = arrayStr;
+    if (!clean.empty() && clean.front() == '[') clean.erase(0, 1);
+    if (!clean.empty() && clean.back() == ']') clean.pop_back();
+    
+    std::istringstream iss(clean);
+    std::string offset;
+    while (std::getline(iss, offset, ',')) {
+        offset.erase(std::remove_if(offset.begin(), offset.end(), [](char c) {
+            return c == '"' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }), offset.end());
+        if (!offset.empty()) {
+            offsets.push_back(std::stoull(offset, nullptr, 16));
+        }
+    }
+    return offsets;
+}
+
+// 🛑 command.cancel: targetId is the id of a running request from the same connection.
+// Scans stop at the next chunk boundary and answer {"cancelled":true} with success false.
+std::string CommandRouter::HandleCommandCancel(const std::string& params, WebSocketConnection* origin) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string targetId = ExtractJsonValue(params, "targetId");
+        if (targetId.empty()) {
+            return CreateResponse(false, "", "Missing targetId parameter", id);
+        }
+
+        bool cancelled = origin && CancelCommand(origin, targetId);
+        return CreateResponse(true, std::string("{\"cancelled\":") + (cancelled ? "true" : "false") + "}", "", id);
+    } catch (...) {
+        return CreateResponse(false, "", "Failed to cancel command", id);
+    }
+}
+
+// 👁️ 감시 목록: addresses [{address, type, size?, offsets?}], rate (Hz, default 60)
+// Changes are pushed as BULK_UPDATE frames (see WatchManager)
+std::string CommandRouter::HandleWatchSubscribe(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    if (!t_originConnection) {
+        return CreateResponse(false, "", "Subscriptions need a WebSocket connection", id);
+    }
+    try {
+        JsonValue list = LookupJsonMember(params, "addresses");
+        if (list.type != JsonType::Array) {
+            return CreateResponse(false, "", "Missing addresses parameter", id);
+        }
+        
+        std::vector<WatchEntry> entries;
+        JsonArrayReader reader(list);
+        JsonValue element;
+        while (reader.Next(element)) {
+            if (element.type != JsonType::Object) continue;
+            
+            std::string addrStr = FindJsonMember(element.raw, "address").ToString();
+            std::string typeStr = FindJsonMember(element.raw, "type").ToString();
+            std::string sizeStr = FindJsonMember(element.raw, "size").ToString();
+            JsonValue offsets = FindJsonMember(element.raw, "offsets");
+            
+            WatchEntry entry;
+            entry.address = addrStr.empty() ? 0 : std::stoull(addrStr, nullptr, 16);
+            entry.offsets = ParseOffsetList(offsets.type == JsonType::Array ? std::string(offsets.raw) : std::string());
+            entry.size = sizeStr.empty() ? MemoryEngine::GetValueSize(typeStr) : std::stoull(sizeStr);
+            if (entry.size == 0 || entry.size > MAX_BULK_ENTRY_SIZE) entry.size = 4;
+            entry.type = BinaryProtocol::StringToDataType(typeStr == "int" ? "int32" : typeStr);
+            entries.push_back(entry);
+        }
+        
+        std::string rateStr = ExtractJsonValue(params, "rate");
+        uint32_t rate = rateStr.empty() ? WatchManager::DEFAULT_RATE_HZ : static_cast<uint32_t>(std::stoul(rateStr));
+        
+        size_t count = entries.size();
+        uint32_t watchId = watches.Subscribe(std::move(entries), rate, t_originConnection);
+        
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("watchId").UInt(watchId);
+        json.Key("count").UInt(count);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Watch error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleWatchUnsubscribe(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string watchStr = ExtractJsonValue(params, "watchId");
+        if (watchStr.empty()) {
+            return CreateResponse(false, "", "Missing watchId parameter", id);
+        }
+        
+        if (!watches.Unsubscribe(static_cast<uint32_t>(std::stoul(watchStr)))) {
+            return CreateResponse(false, "", "Unknown watch", id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Watch error: ") + e.what(), id);
+    }
+}
+
+// 🔭 메모리 뷰어 구독
+// viewer.subscribe {"address","length","rate"} - the response carries the first sample (base64,
+// zero-filled where unreadable); VIEWER_UPDATE frames after it only carry changed ranges
+std::string CommandRouter::HandleViewerSubscribe(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    if (!t_originConnection) {
+        return CreateResponse(false, "", "Subscriptions need a WebSocket connection", id);
+    }
+    try {
+        std::string addressStr = ExtractJsonValue(params, "address");
+        std::string lengthStr = ExtractJsonValue(params, "length");
+        if (addressStr.empty() || lengthStr.empty()) {
+            return CreateResponse(false, "", "Missing address or length parameter", id);
+        }
+        
+        uintptr_t address = std::stoull(addressStr, nullptr, 16);
+        size_t length = std::stoull(lengthStr);
+        if (length == 0 || length > ViewerManager::MAX_LENGTH || address + length < address) {
+            return CreateResponse(false, "", "Length must be between 1 and " + std::to_string(ViewerManager::MAX_LENGTH), id);
+        }
+        
+        std::string rateStr = ExtractJsonValue(params, "rate");
+        uint32_t rate = rateStr.empty() ? ViewerManager::DEFAULT_RATE_HZ : static_cast<uint32_t>(std::stoul(rateStr));
+        
+        std::vector<uint8_t> initial;
+        std::vector<ByteRange> unreadable;
+        uint32_t subscriptionId = viewers.Subscribe(address, length, rate, t_originConnection, initial, unreadable);
+        
+        std::string data;
+        JsonWriter writer(data);
+        writer.BeginObject();
+        writer.Key("subscriptionId").UInt(subscriptionId);
+        writer.Key("address").Hex(address);
+        writer.Key("length").UInt(length);
+        writer.Key("sequence").UInt(0);
+        writer.Key("data").String(Base64Encode(initial.data(), initial.size()));
+        writer.Key("unreadable").BeginArray();
+        for (const auto& range : unreadable) {
+            writer.BeginArray().UInt(range.offset).UInt(range.length).EndArray();
+        }
+        writer.EndArray().EndObject();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Viewer error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleViewerUnsubscribe(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string subscriptionStr = ExtractJsonValue(params, "subscriptionId");
+        if (subscriptionStr.empty()) {
+            return CreateResponse(false, "", "Missing subscriptionId parameter", id);
+        }
+        
+        if (!viewers.Unsubscribe(static_cast<uint32_t>(std::stoul(subscriptionStr)))) {
+            return CreateResponse(false, "", "Unknown subscription", id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Viewer error: ") + e.what(), id);
+    }
+}
+
+// ❄️ 값 고정
+// freeze.set {"entries":[{"address","type","value"}], "rate"} - type/value as in memory.write;
+// an address that is already frozen gets the new value. rate (Hz) applies to every entry.
+std::string CommandRouter::HandleFreezeSet(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        JsonValue list = LookupJsonMember(params, "entries");
+        if (list.type != JsonType::Array) {
+            return CreateResponse(false, "", "Missing entries parameter", id);
+        }
+        
+        std::vector<std::pair<uintptr_t, std::vector<uint8_t>>> parsed;
+        JsonArrayReader reader(list);
+        JsonValue element;
+        while (reader.Next(element)) {
+            if (element.type != JsonType::Object) continue;
+            
+            std::string addrStr = FindJsonMember(element.raw, "address").ToString();
+            std::string typeStr = FindJsonMember(element.raw, "type").ToString();
+            std::string valueStr = FindJsonMember(element.raw, "value").ToString();
+            if (addrStr.empty() || typeStr.empty() || valueStr.empty()) {
+                return CreateResponse(false, "", "Each entry needs address, type and value", id);
+            }
+            
+            uintptr_t address = std::stoull(addrStr, nullptr, 16);
+            std::vector<uint8_t> bytes = MemoryEngine::StringToValue(valueStr, typeStr);
+            if (bytes.empty() || !MemoryEngine::IsAddressValid(address, bytes.size())) {
+                return CreateResponse(false, "", "Invalid freeze entry at " + addrStr, id);
+            }
+            parsed.emplace_back(address, std::move(bytes));
+        }
+        
+        // Validated first, so a bad entry leaves the freeze list untouched
+        std::string rateStr = ExtractJsonValue(params, "rate");
+        if (!rateStr.empty()) {
+            freezes.SetRate(static_cast<uint32_t>(std::stoul(rateStr)));
+        }
+        for (auto& entry : parsed) {
+            freezes.Set(entry.first, std::move(entry.second));
+        }
+        
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("count").UInt(freezes.List().size());
+        json.Key("rate").UInt(freezes.GetRate());
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Freeze error: ") + e.what(), id);
+    }
+}
+
+// freeze.clear {"addresses":["..."]} unfreezes those addresses; without addresses, everything
+std::string CommandRouter::HandleFreezeClear(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        JsonValue list = LookupJsonMember(params, "addresses");
+        size_t cleared = 0;
+        if (list.type == JsonType::Array) {
+            JsonArrayReader reader(list);
+            JsonValue element;
+            while (reader.Next(element)) {
+                std::string addrStr = element.ToString();
+                if (addrStr.empty()) continue;
+                if (freezes.Clear(std::stoull(addrStr, nullptr, 16))) cleared++;
+            }
+        } else {
+            cleared = freezes.ClearAll();
+        }
+        
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("cleared").UInt(cleared);
+        json.Key("count").UInt(freezes.List().size());
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Freeze error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleFreezeList(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        auto entries = freezes.List();
+        
+        std::string data;
+        data.reserve(32 + entries.size() * 64);
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("rate").UInt(freezes.GetRate());
+        json.Key("entries").BeginArray();
+        for (const auto& entry : entries) {
+            json.BeginObject();
+            json.Key("address").Hex(entry.address);
+            json.Key("size").UInt(entry.size);
+            json.Key("active").Bool(entry.active);
+            json.EndObject();
+        }
+        json.EndArray();
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Freeze error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleMemoryRegions(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    std::string filterStr = ExtractJsonValue(params, "filter"); // "readable", "writable", "executable"
+    
+    try {
+        auto regions = MemoryEngine::GetMemoryRegions();
+        
+        // 필터 적용
+        if (!filterStr.empty()) {
+            auto filteredRegions = regions;
+            regions.clear();
+            
+            for (const auto& region : filteredRegions) {
+                if (filterStr == "readable" && region.readable) {
+                    regions.push_back(region);
+                } else if (filterStr == "writable" && region.writable) {
+                    regions.push_back(region);
+                } else if (filterStr == "executable" && region.executable) {
+                    regions.push_back(region);
+                }
+            }
+        }
+        
+        std::string data;
+        data.reserve(2 + regions.size() * 160);
+        JsonWriter json(data);
+        json.BeginArray();
+        for (const auto& region : regions) {
+            json.BeginObject();
+            json.Key("baseAddress").Hex(region.baseAddress);
+            json.Key("size").UInt(region.size);
+            json.Key("protection").UInt(region.protection);
+            json.Key("readable").Bool(region.readable);
+            json.Key("writable").Bool(region.writable);
+            json.Key("executable").Bool(region.executable);
+            json.Key("moduleName").String(region.moduleName);
+            json.EndObject();
+        }
+        json.EndArray();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (...) {
+        return CreateResponse(false, "", "Failed to get memory regions", id);
+    }
+}
+
+std::string CommandRouter::HandleMemoryValidate(const std::string& params) {
+    std::string addressStr = ExtractJsonValue(params, "address");
+    std::string sizeStr = ExtractJsonValue(params, "size");
+    std::string id = ExtractJsonValue(params, "id");
+    
+    if (addressStr.empty()) {
+        return CreateResponse(false, "", "Missing address parameter", id);
+    }
+    
+    try {
+        uintptr_t address = std::stoull(addressStr, nullptr, 16);
+        size_t size = sizeStr.empty() ? 1 : std::stoull(sizeStr);
+        
+        bool isValid = MemoryEngine::IsAddressValid(address, size);
+        bool isReadable = MemoryEngine::IsAddressReadable(address, size);
+        bool isWritable = MemoryEngine::IsAddressWritable(address, size);
+        
+        auto region = MemoryEngine::GetMemoryRegion(address);
+        
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("valid").Bool(isValid);
+        json.Key("readable").Bool(isReadable);
+        json.Key("writable").Bool(isWritable);
+        
+        if (region.has_value()) {
+            json.Key("region").BeginObject();
+            json.Key("baseAddress").Hex(region->baseAddress);
+            json.Key("size").UInt(region->size);
+            json.Key("protection").UInt(region->protection);
+            json.Key("moduleName").String(region->moduleName);
+            json.EndObject();
+        }
+        
+        json.EndObject();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (...) {
+        return CreateResponse(false, "", "Failed to validate address", id);
+    }
+}
+
+// Signature lookups go through SignatureCache unless the request says "cache": false;
+// new results reach the file with the core thread's periodic SignatureCache::FlushIfDue
+static std::vector<std::vector<uintptr_t>> ResolveSignatures(const std::vector<CodePattern>& patterns, uintptr_t start, uintptr_t end,
+                                                             const ScanOptions* control, const std::string& params) {
+    if (ExtractJsonValue(params, "cache") == "false") {
+        return MemoryEngine::PatternScanBatch(patterns, start, end, control);
+    }
+    
+    return SignatureCache::Resolve(patterns, start, end, control);
+}
+
+std::string CommandRouter::HandlePatternScanAll(const std::string& params) {
+    std::string pattern = ExtractJsonValue(params, "pattern");
+    std::string startStr = ExtractJsonValue(params, "start");
+    std::string endStr = ExtractJsonValue(params, "end");
+    std::string id = ExtractJsonValue(params, "id");
+    
+    if (pattern.empty()) {
+        return CreateResponse(false, "", "Missing pattern parameter", id);
+    }
+    
+    try {
+        uintptr_t start = startStr.empty() ? 0 : std::stoull(startStr, nullptr, 16);
+        uintptr_t end = endStr.empty() ? 0 : std::stoull(endStr, nullptr, 16);
+        
+        ScanOptions control;
+        AttachCommandControl(control, params);
+        auto results = ResolveSignatures({ MemoryEngine::AOBToPattern(pattern) }, start, end, &control, params)[0];
+        if (IsCommandCancelled()) {
+            return CreateResponse(false, CANCELLED_DATA, "Command cancelled", id);
+        }
+        
+        size_t maxResults = min(results.size(), static_cast<size_t>(100));
+        std::string data;
+        data.reserve(2 + maxResults * 21);
+        JsonWriter json(data);
+        json.BeginArray();
+        for (size_t i = 0; i < maxResults; i++) {
+            json.Hex(results[i]);
+        }
+        json.EndArray();
+        
+        std::string message = "Found " + std::to_string(results.size()) + " matches";
+        if (results.size() > maxResults) {
+            message += " (showing first " + std::to_string(maxResults) + ")";
+        }
+        
+        return CreateResponse(true, data, message, id);
+    } catch (...) {
+        return CreateResponse(false, "", "Pattern scan failed", id);
+    }
+}
+
+// 🧭 시그니처 일괄 검색: patterns ["48 8B ?? ...", ...], start/end (default: main module)
+std::string CommandRouter::HandlePatternScanBatch(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        JsonValue list = LookupJsonMember(params, "patterns");
+        if (list.type != JsonType::Array) {
+            return CreateResponse(false, "", "Missing patterns parameter", id);
+        }
+        
+        std::vector<std::string> patterns;
+        JsonArrayReader reader(list);
+        JsonValue element;
+        while (reader.Next(element)) {
+            patterns.push_back(element.ToString());
+        }
+        
+        std::string startStr = ExtractJsonValue(params, "start");
+        std::string endStr = ExtractJsonValue(params, "end");
+        std::string maxStr = ExtractJsonValue(params, "maxResults");
+        uintptr_t start = startStr.empty() ? 0 : std::stoull(startStr, nullptr, 16);
+        uintptr_t end = endStr.empty() ? 0 : std::stoull(endStr, nullptr, 16);
+        size_t maxResults = maxStr.empty() ? 100 : std::stoull(maxStr);
+        
+        std::vector<CodePattern> converted;
+        for (const auto& pattern : patterns) {
+            converted.push_back(MemoryEngine::AOBToPattern(pattern));
+        }
+        
+        ScanOptions control;
+        AttachCommandControl(control, params);
+        auto results = ResolveSignatures(converted, start, end, &control, params);
+        if (IsCommandCancelled()) {
+            return CreateResponse(false, CANCELLED_DATA, "Command cancelled", id);
+        }
+        
+        std::string data;
+        JsonWriter json(data);
+        json.BeginArray();
+        for (size_t i = 0; i < results.size(); i++) {
+            json.BeginObject();
+            json.Key("pattern").String(patterns[i]);
+            json.Key("count").UInt(results[i].size());
+            json.Key("matches").BeginArray();
+            for (size_t j = 0; j < min(results[i].size(), maxResults); j++) {
+                json.Hex(results[i][j]);
+            }
+            json.EndArray();
+            json.EndObject();
+        }
+        json.EndArray();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Pattern batch error: ") + e.what(), id);
+    }
+}
+
+static const char* CodeReferenceKindName(CodeReferenceKind kind) {
+    switch (kind) {
+        case CodeReferenceKind::Call: return "call";
+        case CodeReferenceKind::Jump: return "jump";
+        default: return "data";
+    }
+}
+
+// 🔗 참조 검색: address (or address + size for a range), start/end (default: main module)
+std::string CommandRouter::HandleCodeReferences(const std::string& params) {
+    std::string addressStr = ExtractJsonValue(params, "address");
+    std::string id = ExtractJsonValue(params, "id");
+    
+    if (addressStr.empty()) {
+        return CreateResponse(false, "", "Missing address parameter", id);
+    }
+    
+    try {
+        std::string sizeStr = ExtractJsonValue(params, "size");
+        std::string startStr = ExtractJsonValue(params, "start");
+        std::string endStr = ExtractJsonValue(params, "end");
+        std::string kindStr = ExtractJsonValue(params, "kind");
+        std::string maxStr = ExtractJsonValue(params, "maxResults");
+        
+        uintptr_t address = std::stoull(addressStr, nullptr, 16);
+        size_t size = sizeStr.empty() ? 1 : max(std::stoull(sizeStr), 1ull);
+        uintptr_t start = startStr.empty() ? MemoryEngine::GetModuleBase() : std::stoull(startStr, nullptr, 16);
+        uintptr_t end = endStr.empty() ? start + MemoryEngine::GetModuleSize() : std::stoull(endStr, nullptr, 16);
+        size_t maxResults = maxStr.empty() ? 1000 : std::stoull(maxStr);
+        
+        auto references = CodeIndex::FindReferencesInRange(address, address + size, start, end);
+        
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("references").BeginArray();
+        size_t count = 0;
+        for (const auto& ref : references) {
+            const char* kind = CodeReferenceKindName(ref.kind);
+            if (!kindStr.empty() && kindStr != kind) continue;
+            if (count++ >= maxResults) continue;
+            
+            json.BeginObject();
+            json.Key("from").Hex(ref.from);
+            json.Key("target").Hex(ref.target);
+            json.Key("kind").String(kind);
+            json.EndObject();
+        }
+        json.EndArray();
+        json.Key("count").UInt(count);
+        json.EndObject();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Reference lookup error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleCodeIndexInfo(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        if (ExtractJsonValue(params, "invalidate") == "true") {
+            CodeIndex::Invalidate();
+        }
+        
+        CodeIndexStats stats = CodeIndex::GetStats();
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("modules").UInt(stats.modules);
+        json.Key("codeBytes").UInt(stats.codeBytes);
+        json.Key("references").UInt(stats.references);
+        json.Key("postings").UInt(stats.postings);
+        json.Key("memoryBytes").UInt(stats.memoryBytes);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Code index error: ") + e.what(), id);
+    }
+}
+
+// 💾 시그니처 캐시: path (optional) switches to another file name next to the DLL
+std::string CommandRouter::HandleCacheInfo(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string path = ExtractJsonValue(params, "path");
+        std::string error;
+        if (!path.empty() && !SignatureCache::SetFileName(path, error)) {
+            return CreateResponse(false, "", error, id);
+        }
+        
+        SignatureCacheStats stats = SignatureCache::GetStats();
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("path").String(SignatureCache::GetPath());
+        json.Key("signatures").UInt(stats.signatures);
+        json.Key("chains").UInt(stats.chains);
+        json.Key("hits").UInt(stats.hits);
+        json.Key("misses").UInt(stats.misses);
+        json.Key("dirty").Bool(stats.dirty);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Cache error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleCacheClear(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        SignatureCache::Clear();
+        std::string error;
+        if (!SignatureCache::Flush(error)) {
+            return CreateResponse(false, "", error, id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Cache error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleModuleInfo(const std::string& params) {
+    std::string moduleName = ExtractJsonValue(params, "name");
+    std::string id = ExtractJsonValue(params, "id");
+    
     if (moduleName.empty()) {
         return CreateResponse(false, "", "Missing module name parameter", id);
     }
@@ -620,20 +1671,21 @@ std::string CommandRouter::HandleModuleInfo(const std::string& params) {
         uintptr_t base = MemoryEngine::GetModuleBase(moduleName);
         size_t size = MemoryEngine::GetModuleSize(moduleName);
         
-        std::stringstream ss;
-        ss << "{";
-        ss << "\"name\":\"" << EscapeJsonString(moduleName) << "\",";
-        ss << "\"baseAddress\":\"0x" << std::hex << base << "\",";
-        ss << "\"size\":" << std::dec << size << ",";
-        ss << "\"endAddress\":\"0x" << std::hex << (base + size) << "\",";
-        ss << "\"protection\":" << region->protection << ",";
-        ss << "\"readable\":" << (region->readable ? "true" : "false") << ",";
-        ss << "\"writable\":" << (region->writable ? "true" : "false") << ",";
-        ss << "\"executable\":" << (region->executable ? "true" : "false") << ",";
-        ss << "\"path\":\"" << EscapeJsonString(region->moduleName) << "\"";
-        ss << "}";
-        
-        return CreateResponse(true, ss.str(), "", id);
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("name").String(moduleName);
+        json.Key("baseAddress").Hex(base);
+        json.Key("size").UInt(size);
+        json.Key("endAddress").Hex(base + size);
+        json.Key("protection").UInt(region->protection);
+        json.Key("readable").Bool(region->readable);
+        json.Key("writable").Bool(region->writable);
+        json.Key("executable").Bool(region->executable);
+        json.Key("path").String(region->moduleName);
+        json.EndObject();
+        
+        return CreateResponse(true, data, "", id);
     } catch (...) {
         return CreateResponse(false, "", "Failed to get module info", id);
     }
@@ -722,9 +1774,9 @@ std::string CommandRouter::HandlePointerChain(const std::string& params) {
         auto result = MemoryEngine::FollowPointerChain(baseAddress, offsets);
         
         if (result.has_value()) {
-            std::stringstream ss;
-            ss << "\"0x" << std::hex << result.value() << "\"";
-            return CreateResponse(true, ss.str(), "Pointer chain followed successfully", id);
+            std::string data;
+            JsonWriter(data).Hex(result.value());
+            return CreateResponse(true, data, "Pointer chain followed successfully", id);
         } else {
             return CreateResponse(false, "", "Failed to follow pointer chain - invalid address encountered", id);
         }
@@ -733,6 +1785,69 @@ std::string CommandRouter::HandlePointerChain(const std::string& params) {
     }
 }
 
+// 💾 이름 붙은 포인터 체인: name, module, offset (module offset), offsets
+std::string CommandRouter::HandlePointerChainSave(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string name = ExtractJsonValue(params, "name");
+        std::string moduleName = ExtractJsonValue(params, "module");
+        std::string offsetStr = ExtractJsonValue(params, "offset");
+        if (name.empty() || offsetStr.empty()) {
+            return CreateResponse(false, "", "Missing name or offset parameter", id);
+        }
+        
+        JsonValue offsets = LookupJsonMember(params, "offsets");
+        std::string error;
+        if (!SignatureCache::StoreChain(name, moduleName, std::stoull(offsetStr, nullptr, 16),
+                                        ParseOffsetList(offsets.type == JsonType::Array ? std::string(offsets.raw) : std::string()), error)) {
+            return CreateResponse(false, "", error, id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Chain save error: ") + e.what(), id);
+    }
+}
+
+// Follows a saved chain; fails if it was saved for another build of its module
+std::string CommandRouter::HandlePointerChainLoad(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string name = ExtractJsonValue(params, "name");
+        if (name.empty()) {
+            return CreateResponse(false, "", "Missing name parameter", id);
+        }
+        
+        CachedPointerChain chain;
+        if (!SignatureCache::FindChain(name, chain)) {
+            return CreateResponse(false, "", "No chain saved under this name for the loaded module build", id);
+        }
+        
+        uintptr_t base = MemoryEngine::GetModuleBase(chain.module) + chain.moduleOffset;
+        auto result = MemoryEngine::FollowPointerChain(base, chain.offsets);
+        
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("module").String(chain.module);
+        json.Key("base").Hex(base);
+        json.Key("offsets").BeginArray();
+        for (uintptr_t offset : chain.offsets) {
+            json.Hex(offset);
+        }
+        json.EndArray();
+        if (result.has_value()) {
+            json.Key("address").Hex(result.value());
+        } else {
+            json.Key("address").Null();
+        }
+        json.EndObject();
+        
+        return CreateResponse(result.has_value(), data, result.has_value() ? "" : "Invalid address encountered", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Chain load error: ") + e.what(), id);
+    }
+}
+
 std::string CommandRouter::HandlePointerFind(const std::string& params) {
     std::string targetStr = ExtractJsonValue(params, "target");
     std::string startStr = ExtractJsonValue(params, "start");
@@ -750,30 +1865,305 @@ std::string CommandRouter::HandlePointerFind(const std::string& params) {
         if (!startStr.empty()) options.startAddress = std::stoull(startStr, nullptr, 16);
         if (!endStr.empty()) options.endAddress = std::stoull(endStr, nullptr, 16);
         
-        auto pointers = MemoryEngine::FindPointersTo(targetAddress, options);
+        AttachCommandControl(options, params);
         
-        std::stringstream ss;
-        ss << "[";
+        auto pointers = MemoryEngine::FindPointersTo(targetAddress, options);
+        if (IsCommandCancelled()) {
+            return CreateResponse(false, CANCELLED_DATA, "Command cancelled", id);
+        }
         
         size_t maxResults = min(pointers.size(), static_cast<size_t>(100));
+        std::string data;
+        data.reserve(2 + maxResults * 21);
+        JsonWriter json(data);
+        json.BeginArray();
         for (size_t i = 0; i < maxResults; i++) {
-            if (i > 0) ss << ",";
-            ss << "\"0x" << std::hex << pointers[i] << "\"";
+            json.Hex(pointers[i]);
         }
-        
-        ss << "]";
+        json.EndArray();
         
         std::string message = "Found " + std::to_string(pointers.size()) + " pointers";
         if (pointers.size() > maxResults) {
             message += " (showing first " + std::to_string(maxResults) + ")";
         }
         
-        return CreateResponse(true, ss.str(), message, id);
+        return CreateResponse(true, data, message, id);
     } catch (...) {
         return CreateResponse(false, "", "Pointer search failed", id);
     }
 }
 
+// 🧭 포인터 맵 / 다단계 포인터 스캔
+// Chains deeper than this are never stable enough to be worth the search cost
+static const size_t MAX_POINTER_SCAN_DEPTH = 16;
+
+// Members only, so a caller can add its own before closing the object
+static void WritePointerMapInfo(JsonWriter& json, uint32_t mapId, const PointerMap& map) {
+    json.Key("mapId").UInt(mapId);
+    json.Key("count").UInt(map.Count());
+    json.Key("roots").UInt(map.GetRoots().size());
+    json.Key("memoryUsage").UInt(map.MemoryUsage());
+}
+
+// Params: threads (optional). Roots are the modules currently loaded.
+std::string CommandRouter::HandlePointerMapCreate(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string threadsStr = ExtractJsonValue(params, "threads");
+        size_t threadCount = threadsStr.empty() ? 0 : ParseThreadCount(threadsStr, "threads");
+
+        ModuleMap::Snapshot modules = ModuleMap::GetSnapshot();
+        std::vector<PointerRoot> roots;
+        roots.reserve(modules->modules.size());
+        for (const auto& module : modules->modules) {
+            roots.push_back({ module.base, module.end, modules->NameOf(module) });
+        }
+
+        DWORD startTime = GetTickCount();
+        auto map = PointerMap::Build(std::move(roots), threadCount, t_cancelFlag);
+        DWORD elapsed = GetTickCount() - startTime;
+        if (IsCommandCancelled()) {
+            return CreateResponse(false, CANCELLED_DATA, "Command cancelled", id);
+        }
+
+        uint32_t mapId = pointerScans.AddMap(map);
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        WritePointerMapInfo(json, mapId, *map);
+        json.Key("elapsedMs").UInt(elapsed);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Pointer map error: ") + e.what(), id);
+    } catch (...) {
+        return CreateResponse(false, "", "Unknown error while building pointer map", id);
+    }
+}
+
+std::string CommandRouter::HandlePointerMapSave(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string mapStr = ExtractJsonValue(params, "mapId");
+        std::string path = ExtractJsonValue(params, "path");
+        if (mapStr.empty() || path.empty()) {
+            return CreateResponse(false, "", "Missing mapId or path parameter", id);
+        }
+
+        auto map = pointerScans.GetMap(static_cast<uint32_t>(std::stoul(mapStr)));
+        if (!map) {
+            return CreateResponse(false, "", "Unknown pointer map", id);
+        }
+
+        std::string error;
+        if (!map->Save(path, error)) {
+            return CreateResponse(false, "", "Save failed: " + error, id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Save error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandlePointerMapLoad(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string path = ExtractJsonValue(params, "path");
+        if (path.empty()) {
+            return CreateResponse(false, "", "Missing path parameter", id);
+        }
+
+        std::string error;
+        auto map = PointerMap::Load(path, error);
+        if (!map) {
+            return CreateResponse(false, "", "Load failed: " + error, id);
+        }
+
+        uint32_t mapId = pointerScans.AddMap(map);
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        WritePointerMapInfo(json, mapId, *map);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Load error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandlePointerMapClose(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string mapStr = ExtractJsonValue(params, "mapId");
+        if (mapStr.empty()) {
+            return CreateResponse(false, "", "Missing mapId parameter", id);
+        }
+
+        if (!pointerScans.CloseMap(static_cast<uint32_t>(std::stoul(mapStr)))) {
+            return CreateResponse(false, "", "Unknown pointer map", id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Close error: ") + e.what(), id);
+    }
+}
+
+// Params: mapId, target (hex), maxDepth, maxOffset (decimal or 0x-prefixed), maxResults,
+// threads, intersect (resultId of an earlier scan - only chains found by both are kept)
+std::string CommandRouter::HandlePointerScan(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string mapStr = ExtractJsonValue(params, "mapId");
+        std::string targetStr = ExtractJsonValue(params, "target");
+        std::string depthStr = ExtractJsonValue(params, "maxDepth");
+        std::string offsetStr = ExtractJsonValue(params, "maxOffset");
+        std::string resultsStr = ExtractJsonValue(params, "maxResults");
+        std::string threadsStr = ExtractJsonValue(params, "threads");
+        std::string intersectStr = ExtractJsonValue(params, "intersect");
+        if (mapStr.empty() || targetStr.empty()) {
+            return CreateResponse(false, "", "Missing mapId or target parameter", id);
+        }
+
+        auto map = pointerScans.GetMap(static_cast<uint32_t>(std::stoul(mapStr)));
+        if (!map) {
+            return CreateResponse(false, "", "Unknown pointer map", id);
+        }
+
+        std::shared_ptr<PointerScanResult> previous;
+        if (!intersectStr.empty()) {
+            previous = pointerScans.GetResult(static_cast<uint32_t>(std::stoul(intersectStr)));
+            if (!previous) {
+                return CreateResponse(false, "", "Unknown pointer scan result to intersect with", id);
+            }
+        }
+
+        PointerScanOptions options;
+        options.target = std::stoull(targetStr, nullptr, 16);
+        if (!depthStr.empty()) options.maxDepth = std::stoull(depthStr);
+        if (!offsetStr.empty()) options.maxOffset = std::stoull(offsetStr, nullptr, 0);
+        if (!resultsStr.empty()) options.maxResults = std::stoull(resultsStr);
+        if (!threadsStr.empty()) options.threadCount = ParseThreadCount(threadsStr, "threads");
+        if (options.maxDepth == 0 || options.maxDepth > MAX_POINTER_SCAN_DEPTH) {
+            return CreateResponse(false, "", "maxDepth must be between 1 and " + std::to_string(MAX_POINTER_SCAN_DEPTH), id);
+        }
+
+        options.cancel = t_cancelFlag;
+        options.onProgress = CreateProgressNotifier(params);
+
+        DWORD startTime = GetTickCount();
+        auto result = PointerScanner::Scan(*map, options);
+        if (result->cancelled) {
+            return CreateResponse(false, CANCELLED_DATA, "Command cancelled", id);
+        }
+        if (previous) {
+            PointerScanner::Intersect(*result, *previous);
+        }
+        DWORD elapsed = GetTickCount() - startTime;
+
+        uint32_t resultId = pointerScans.AddResult(result);
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("resultId").UInt(resultId);
+        json.Key("count").UInt(result->chains.size());
+        json.Key("truncated").Bool(result->truncated);
+        json.Key("elapsedMs").UInt(elapsed);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Pointer scan error: ") + e.what(), id);
+    } catch (...) {
+        return CreateResponse(false, "", "Unknown error during pointer scan", id);
+    }
+}
+
+// Paged chains: offset (default 0), limit (default 1000). "address" is the chain resolved
+// against the modules loaded now (null when a module is missing or a pointer is broken).
+std::string CommandRouter::HandlePointerResults(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string resultStr = ExtractJsonValue(params, "resultId");
+        std::string offsetStr = ExtractJsonValue(params, "offset");
+        std::string limitStr = ExtractJsonValue(params, "limit");
+        if (resultStr.empty()) {
+            return CreateResponse(false, "", "Missing resultId parameter", id);
+        }
+
+        uint32_t resultId = static_cast<uint32_t>(std::stoul(resultStr));
+        auto result = pointerScans.GetResult(resultId);
+        if (!result) {
+            return CreateResponse(false, "", "Unknown pointer scan result", id);
+        }
+
+        size_t offset = offsetStr.empty() ? 0 : std::stoull(offsetStr);
+        size_t limit = limitStr.empty() ? 1000 : std::stoull(limitStr);
+        size_t end = offset < result->chains.size() ? min(result->chains.size(), offset + limit) : offset;
+
+        // Current base of each root module, looked up by name
+        ModuleMap::Snapshot modules = ModuleMap::GetSnapshot();
+        std::vector<uintptr_t> liveBases(result->roots.size(), 0);
+        for (size_t i = 0; i < result->roots.size(); i++) {
+            const ModuleRange* module = modules->FindByName(result->roots[i].name);
+            if (module) liveBases[i] = module->base;
+        }
+
+        std::string data;
+        data.reserve(96 + (end - offset) * 128);
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("resultId").UInt(resultId);
+        json.Key("target").Hex(result->target);
+        json.Key("total").UInt(result->chains.size());
+        json.Key("offset").UInt(offset);
+        json.Key("results").BeginArray();
+        for (size_t i = offset; i < end; i++) {
+            const PointerChain& chain = result->chains[i];
+            json.BeginObject();
+            json.Key("module").String(result->roots[chain.rootIndex].name);
+            json.Key("moduleOffset").Hex(chain.moduleOffset);
+            json.Key("offsets").BeginArray();
+            for (uintptr_t chainOffset : chain.offsets) {
+                json.Hex(chainOffset);
+            }
+            json.EndArray();
+
+            std::optional<uintptr_t> resolved;
+            if (liveBases[chain.rootIndex] != 0) {
+                resolved = MemoryEngine::FollowPointerChain(liveBases[chain.rootIndex] + chain.moduleOffset, chain.offsets);
+            }
+            json.Key("address");
+            if (resolved.has_value()) {
+                json.Hex(resolved.value());
+            } else {
+                json.Null();
+            }
+            json.EndObject();
+        }
+        json.EndArray();
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Results error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandlePointerResultsClose(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string resultStr = ExtractJsonValue(params, "resultId");
+        if (resultStr.empty()) {
+            return CreateResponse(false, "", "Missing resultId parameter", id);
+        }
+
+        if (!pointerScans.CloseResult(static_cast<uint32_t>(std::stoul(resultStr)))) {
+            return CreateResponse(false, "", "Unknown pointer scan result", id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Close error: ") + e.what(), id);
+    }
+}
+
 std::string CommandRouter::HandlePatternScan(const std::string& params) {
     std::string pattern = ExtractJsonValue(params, "pattern");
     std::string startStr = ExtractJsonValue(params, "start");
@@ -788,12 +2178,12 @@ std::string CommandRouter::HandlePatternScan(const std::string& params) {
         uintptr_t start = startStr.empty() ? 0 : std::stoull(startStr, nullptr, 16);
         uintptr_t end = endStr.empty() ? 0 : std::stoull(endStr, nullptr, 16);
         
-        auto result = MemoryEngine::AOBScanFirst(pattern, start, end);
+        auto results = ResolveSignatures({ MemoryEngine::AOBToPattern(pattern) }, start, end, nullptr, params)[0];
         
-        if (result.has_value()) {
-            std::stringstream ss;
-            ss << "\"0x" << std::hex << result.value() << "\"";
-            return CreateResponse(true, ss.str(), "", id);
+        if (!results.empty()) {
+            std::string data;
+            JsonWriter(data).Hex(results[0]);
+            return CreateResponse(true, data, "", id);
         } else {
             return CreateResponse(false, "", "Pattern not found", id);
         }
@@ -814,28 +2204,23 @@ std::string CommandRouter::HandleModuleList(const std::string& params) {
         MODULEENTRY32 me32;
         me32.dwSize = sizeof(MODULEENTRY32);
         
-        std::stringstream ss;
-        ss << "[";
-        
-        bool first = true;
+        std::string data;
+        JsonWriter json(data);
+        json.BeginArray();
         if (Module32First(hSnap, &me32)) {
             do {
-                if (!first) ss << ",";
-                first = false;
-                
-                ss << "{";
-                ss << "\"name\":\"" << EscapeJsonString(me32.szModule) << "\",";
-                ss << "\"path\":\"" << EscapeJsonString(me32.szExePath) << "\",";
-                ss << "\"base\":\"0x" << std::hex << reinterpret_cast<uintptr_t>(me32.modBaseAddr) << "\",";
-                ss << "\"size\":" << std::dec << me32.modBaseSize;
-                ss << "}";
+                json.BeginObject();
+                json.Key("name").String(me32.szModule);
+                json.Key("path").String(me32.szExePath);
+                json.Key("base").Hex(reinterpret_cast<uintptr_t>(me32.modBaseAddr));
+                json.Key("size").UInt(me32.modBaseSize);
+                json.EndObject();
             } while (Module32Next(hSnap, &me32));
         }
-        
-        ss << "]";
+        json.EndArray();
         CloseHandle(hSnap);
         
-        return CreateResponse(true, ss.str(), "", id);
+        return CreateResponse(true, data, "", id);
     } catch (...) {
         return CreateResponse(false, "", "Failed to list modules", id);
     }
@@ -855,79 +2240,302 @@ std::string CommandRouter::HandleProcessInfo(const std::string& params) {
         BOOL isWow64 = FALSE;
         IsWow64Process(hProcess, &isWow64);
         
-        #ifdef _WIN64
-        std::string platform = "x64";
-        int addressWidth = 64;
-        #else
-        std::string platform = isWow64 ? "x86 (WoW64)" : "x86";
-        int addressWidth = 32;
-        #endif
+        #ifdef _WIN64
+        std::string platform = "x64";
+        int addressWidth = 64;
+        #else
+        std::string platform = isWow64 ? "x86 (WoW64)" : "x86";
+        int addressWidth = 32;
+        #endif
+        
+        HMODULE hModule = GetModuleHandle(nullptr);
+        MODULEINFO modInfo = {0};
+        GetModuleInformation(hProcess, hModule, &modInfo, sizeof(MODULEINFO));
+
+        auto regions = MemoryEngine::GetMemoryRegions();
+        size_t totalSize = 0, writableSize = 0, executableSize = 0;
+        for(const auto& region : regions) {
+            totalSize += region.size;
+            if(region.writable) writableSize += region.size;
+            if(region.executable) executableSize += region.size;
+        }
+
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("pid").UInt(pid);
+        json.Key("name").String(processNameOnly);
+        json.Key("platform").String(platform);
+        json.Key("addressWidth").Int(addressWidth);
+        json.Key("mainModule").BeginObject();
+        json.Key("baseAddress").UInt(reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll));
+        json.Key("size").UInt(modInfo.SizeOfImage);
+        json.EndObject();
+        json.Key("memoryMetrics").BeginObject();
+        json.Key("total").UInt(totalSize);
+        json.Key("writable").UInt(writableSize);
+        json.Key("executable").UInt(executableSize);
+        json.EndObject();
+        json.EndObject();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (...) {
+        return CreateResponse(false, "", "Failed to get process info", id);
+    }
+}
+
+std::string CommandRouter::HandleHookList(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    if (!g_HookManager) {
+        return CreateResponse(false, "", "Hook manager not initialized", id);
+    }
+    
+    try {
+        auto hooks = g_HookManager->GetAllHooks();
+        
+        std::string data;
+        data.reserve(2 + hooks.size() * 128);
+        JsonWriter json(data);
+        json.BeginArray();
+        for (const auto& hook : hooks) {
+            json.BeginObject();
+            json.Key("name").String(hook.name);
+            json.Key("target").Hex(hook.targetAddress);
+            json.Key("detour").Hex(hook.detourAddress);
+            json.Key("original").Hex(hook.originalAddress);
+            json.Key("active").Bool(hook.isActive);
+            json.EndObject();
+        }
+        json.EndArray();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (...) {
+        return CreateResponse(false, "", "Failed to list hooks", id);
+    }
+}
+
+std::string CommandRouter::HandleHookProfile(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    if (!g_HookManager) {
+        return CreateResponse(false, "", "Hook manager not initialized", id);
+    }
+    
+    try {
+        std::string name = ExtractJsonValue(params, "name");
+        if (name.empty()) {
+            return CreateResponse(false, "", "Missing name parameter", id);
+        }
+        
+        bool enabled = ExtractJsonValue(params, "enabled") != "false";
+        if (!g_HookManager->SetProfiling(name, enabled)) {
+            return CreateResponse(false, "", "Failed to change profiling for hook", id);
+        }
+        return CreateResponse(true, enabled ? "{\"enabled\":true}" : "{\"enabled\":false}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Hook profile error: ") + e.what(), id);
+    }
+}
+
+// 📈 훅 통계 조회
+// calls comes from the call counter stub of every hook. The cycle fields and histograms are
+// only recorded by detours that open a HOOK_PROFILE_SCOPE (the trampoline does not time
+// anything), so a hook whose detour lacks it reports timedCalls 0; latencySource says so.
+std::string CommandRouter::HandleHookStats(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    if (!g_HookManager) {
+        return CreateResponse(false, "", "Hook manager not initialized", id);
+    }
+    
+    try {
+        std::string name = ExtractJsonValue(params, "name");
+        bool reset = ExtractJsonValue(params, "reset") == "true";
+        bool withHistogram = ExtractJsonValue(params, "histogram") == "true";
+        
+        auto stats = g_HookManager->GetHookStats(name, reset);
+        
+        std::string data;
+        JsonWriter writer(data);
+        writer.BeginObject();
+        writer.Key("latencySource").String("HOOK_PROFILE_SCOPE");
+        writer.Key("hooks").BeginArray();
+        for (const auto& hook : stats) {
+            writer.BeginObject();
+            writer.Key("name").String(hook.name);
+            writer.Key("target").Hex(hook.targetAddress);
+            writer.Key("enabled").Bool(hook.enabled);
+            writer.Key("calls").UInt(hook.calls);
+            writer.Key("timedCalls").UInt(hook.timedCalls);
+            writer.Key("totalCycles").UInt(hook.totalCycles);
+            writer.Key("meanCycles").UInt(hook.timedCalls ? hook.totalCycles / hook.timedCalls : 0);
+            writer.Key("maxCycles").UInt(hook.maxCycles);
+            writer.Key("p50").UInt(hook.p50);
+            writer.Key("p90").UInt(hook.p90);
+            writer.Key("p99").UInt(hook.p99);
+            writer.Key("p999").UInt(hook.p999);
+            
+            // Non-empty buckets as [lowerBound, upperBound, count]
+            if (withHistogram) {
+                writer.Key("histogram").BeginArray();
+                for (uint32_t i = 0; i < hook.histogram.size(); i++) {
+                    if (hook.histogram[i] == 0) continue;
+                    writer.BeginArray();
+                    writer.UInt(CycleHistogram::BucketLowerBound(i));
+                    writer.UInt(CycleHistogram::BucketUpperBound(i));
+                    writer.UInt(hook.histogram[i]);
+                    writer.EndArray();
+                }
+                writer.EndArray();
+            }
+            writer.EndObject();
+        }
+        writer.EndArray().EndObject();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Hook stats error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleHookStatsSubscribe(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    if (!t_originConnection) {
+        return CreateResponse(false, "", "Subscriptions need a WebSocket connection", id);
+    }
+    try {
+        std::string rateStr = ExtractJsonValue(params, "rate");
+        uint32_t rate = rateStr.empty() ? HookStatsPublisher::DEFAULT_RATE_HZ : static_cast<uint32_t>(std::stoul(rateStr));
+        
+        uint32_t subscriptionId = hookStats.Subscribe(rate, t_originConnection);
         
-        HMODULE hModule = GetModuleHandle(nullptr);
-        MODULEINFO modInfo = {0};
-        GetModuleInformation(hProcess, hModule, &modInfo, sizeof(MODULEINFO));
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("subscriptionId").UInt(subscriptionId);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Hook stats error: ") + e.what(), id);
+    }
+}
 
-        auto regions = MemoryEngine::GetMemoryRegions();
-        size_t totalSize = 0, writableSize = 0, executableSize = 0;
-        for(const auto& region : regions) {
-            totalSize += region.size;
-            if(region.writable) writableSize += region.size;
-            if(region.executable) executableSize += region.size;
+std::string CommandRouter::HandleHookStatsUnsubscribe(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string subscriptionStr = ExtractJsonValue(params, "subscriptionId");
+        if (subscriptionStr.empty()) {
+            return CreateResponse(false, "", "Missing subscriptionId parameter", id);
+        }
+        
+        if (!hookStats.Unsubscribe(static_cast<uint32_t>(std::stoul(subscriptionStr)))) {
+            return CreateResponse(false, "", "Unknown subscription", id);
         }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Hook stats error: ") + e.what(), id);
+    }
+}
 
-        std::stringstream ss;
-        ss << "{";
-        ss << "\"pid\":" << pid << ",";
-        ss << "\"name\":\"" << EscapeJsonString(processNameOnly) << "\",";
-        ss << "\"platform\":\"" << platform << "\",";
-        ss << "\"addressWidth\":" << addressWidth << ",";
-        ss << "\"mainModule\":{";
-        ss << "\"baseAddress\":" << reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll) << ",";
-        ss << "\"size\":" << modInfo.SizeOfImage;
-        ss << "},";
-        ss << "\"memoryMetrics\":{";
-        ss << "\"total\":" << totalSize << ",";
-        ss << "\"writable\":" << writableSize << ",";
-        ss << "\"executable\":" << executableSize;
-        ss << "}";
-        ss << "}";
-        
-        return CreateResponse(true, ss.str(), "", id);
-    } catch (...) {
-        return CreateResponse(false, "", "Failed to get process info", id);
+// 📊 엔진 메트릭 조회
+std::string CommandRouter::HandleEngineMetrics(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        bool reset = ExtractJsonValue(params, "reset") == "true";
+        bool includeIdle = ExtractJsonValue(params, "all") == "true";
+        
+        EngineMetricsSnapshot metrics = EngineMetrics::Snapshot(reset, includeIdle);
+        
+        std::string data;
+        JsonWriter writer(data);
+        writer.BeginObject();
+        writer.Key("uptimeMs").UInt(metrics.uptimeMs);
+        writer.Key("intervalMs").UInt(metrics.intervalMs);
+        
+        writer.Key("scan").BeginObject();
+        writer.Key("bytesScanned").UInt(metrics.bytesScanned);
+        writer.Key("results").UInt(metrics.scanResults);
+        writer.Key("bytesPerSec").Double(metrics.bytesScannedPerSec);
+        writer.Key("resultsPerSec").Double(metrics.resultsPerSec);
+        writer.EndObject();
+        
+        writer.Key("workers").BeginObject();
+        writer.Key("count").UInt(WebSocketServer::COMMAND_WORKER_COUNT);
+        writer.Key("queueDepth").UInt(metrics.queueDepth);
+        writer.Key("running").UInt(metrics.running);
+        writer.Key("commands").UInt(metrics.commands);
+        writer.Key("errors").UInt(metrics.commandErrors);
+        writer.EndObject();
+        
+        writer.Key("websocket").BeginObject();
+        writer.Key("connections").UInt(metrics.connections);
+        writer.Key("accepted").UInt(metrics.connectionsAccepted);
+        writer.Key("framesIn").UInt(metrics.framesIn);
+        writer.Key("framesOut").UInt(metrics.framesOut);
+        writer.Key("bytesIn").UInt(metrics.bytesIn);
+        writer.Key("bytesOut").UInt(metrics.bytesOut);
+        writer.Key("sendStalls").UInt(metrics.sendStalls);
+        writer.Key("sendStallMicros").UInt(metrics.sendStallMicros);
+        writer.EndObject();
+        
+        // Latencies in microseconds
+        writer.Key("commands").BeginArray();
+        for (const auto& command : metrics.commandStats) {
+            writer.BeginObject();
+            writer.Key("name").String(command.name);
+            writer.Key("calls").UInt(command.calls);
+            writer.Key("errors").UInt(command.errors);
+            writer.Key("totalMicros").UInt(command.totalMicros);
+            writer.Key("meanMicros").UInt(command.calls ? command.totalMicros / command.calls : 0);
+            writer.Key("maxMicros").UInt(command.maxMicros);
+            writer.Key("p50").UInt(command.p50);
+            writer.Key("p90").UInt(command.p90);
+            writer.Key("p99").UInt(command.p99);
+            writer.Key("p999").UInt(command.p999);
+            writer.EndObject();
+        }
+        writer.EndArray().EndObject();
+        
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Engine metrics error: ") + e.what(), id);
     }
 }
 
-std::string CommandRouter::HandleHookList(const std::string& params) {
-    if (!g_HookManager) {
-        return CreateResponse(false, "", "Hook manager not initialized", params);
+std::string CommandRouter::HandleEngineMetricsSubscribe(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    if (!t_originConnection) {
+        return CreateResponse(false, "", "Subscriptions need a WebSocket connection", id);
     }
-    
     try {
-        auto hooks = g_HookManager->GetAllHooks();
+        std::string rateStr = ExtractJsonValue(params, "rate");
+        uint32_t rate = rateStr.empty() ? MetricsPublisher::DEFAULT_RATE_HZ : static_cast<uint32_t>(std::stoul(rateStr));
         
-        std::stringstream ss;
-        ss << "[";
+        uint32_t subscriptionId = metricsPublisher.Subscribe(rate, t_originConnection);
         
-        bool first = true;
-        for (const auto& hook : hooks) {
-            if (!first) ss << ",";
-            first = false;
-            
-            ss << "{";
-            ss << "\"name\":\"" << EscapeJsonString(hook.name) << "\",";
-            ss << "\"target\":\"0x" << std::hex << hook.targetAddress << "\",";
-            ss << "\"detour\":\"0x" << std::hex << hook.detourAddress << "\",";
-            ss << "\"original\":\"0x" << std::hex << hook.originalAddress << "\",";
-            ss << "\"active\":" << (hook.isActive ? "true" : "false");
-            ss << "}";
+        std::string data;
+        JsonWriter json(data);
+        json.BeginObject();
+        json.Key("subscriptionId").UInt(subscriptionId);
+        json.EndObject();
+        return CreateResponse(true, data, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Engine metrics error: ") + e.what(), id);
+    }
+}
+
+std::string CommandRouter::HandleEngineMetricsUnsubscribe(const std::string& params) {
+    std::string id = ExtractJsonValue(params, "id");
+    try {
+        std::string subscriptionStr = ExtractJsonValue(params, "subscriptionId");
+        if (subscriptionStr.empty()) {
+            return CreateResponse(false, "", "Missing subscriptionId parameter", id);
         }
         
-        ss << "]";
-        
-        return CreateResponse(true, ss.str(), "", params);
-    } catch (...) {
-        return CreateResponse(false, "", "Failed to list hooks", params);
+        if (!metricsPublisher.Unsubscribe(static_cast<uint32_t>(std::stoul(subscriptionStr)))) {
+            return CreateResponse(false, "", "Unknown subscription", id);
+        }
+        return CreateResponse(true, "{}", "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Engine metrics error: ") + e.what(), id);
     }
 }
 
@@ -951,9 +2559,9 @@ std::string CommandRouter::HandleAllocateMemory(const std::string& params) {
         uintptr_t address = MemoryEngine::AllocateMemory(size, protection);
         
         if (address) {
-            std::stringstream ss;
-            ss << "\"0x" << std::hex << address << "\"";
-            return CreateResponse(true, ss.str(), "", id);
+            std::string data;
+            JsonWriter(data).Hex(address);
+            return CreateResponse(true, data, "", id);
         } else {
             return CreateResponse(false, "", "Failed to allocate memory", id);
         }
@@ -1070,7 +2678,9 @@ std::string CommandRouter::HandleMemoryReadValue(const std::string& params) {
             }
             
             std::string result(reinterpret_cast<char*>(bytes.data()), nullPos);
-            return CreateResponse(true, "\"" + EscapeJsonString(result) + "\"", "", id);
+            std::string data;
+            JsonWriter(data).String(result);
+            return CreateResponse(true, data, "", id);
         }
         else if (typeStr == "bytes") {
             auto bytes = MemoryEngine::SafeReadBytes(address, 16);
@@ -1078,12 +2688,15 @@ std::string CommandRouter::HandleMemoryReadValue(const std::string& params) {
                 return CreateResponse(false, "", "Failed to read bytes", id);
             }
             
-            std::stringstream ss;
+            static const char hexDigits[] = "0123456789ABCDEF";
+            std::string data = "\"";
             for (size_t i = 0; i < bytes.size(); i++) {
-                if (i > 0) ss << " ";
-                ss << std::hex << std::uppercase << std::setfill('0') << std::setw(2) << static_cast<int>(bytes[i]);
+                if (i > 0) data += ' ';
+                data += hexDigits[bytes[i] >> 4];
+                data += hexDigits[bytes[i] & 0xF];
             }
-            return CreateResponse(true, "\"" + ss.str() + "\"", "", id);
+            data += '"';
+            return CreateResponse(true, data, "", id);
         }
         
         return CreateResponse(false, "", "Unknown type: " + typeStr, id);
@@ -1093,514 +2706,103 @@ std::string CommandRouter::HandleMemoryReadValue(const std::string& params) {
 }
 
 // Get module information for a given address
-std::string CommandRouter::HandleModuleFromAddress(const std::string& params) {
-    std::string addressStr = ExtractJsonValue(params, "address");
+// 📚 일괄 읽기: addresses [{address, type, size?}] -> one base64 buffer with every value
+// packed back to back in request order, plus a '0'/'1' readable flag per entry
+std::string CommandRouter::HandleMemoryReadBulk(const std::string& params) {
     std::string id = ExtractJsonValue(params, "id");
-    
-    if (addressStr.empty()) {
-        return CreateResponse(false, "", "Missing address parameter", id);
-    }
-    
     try {
-        uintptr_t address = std::stoull(addressStr, nullptr, 16);
-        
-        HANDLE hProcess = GetCurrentProcess();
-        HMODULE hModules[1024];
-        DWORD cbNeeded;
-        
-        if (EnumProcessModules(hProcess, hModules, sizeof(hModules), &cbNeeded)) {
-            for (DWORD i = 0; i < (cbNeeded / sizeof(HMODULE)); i++) {
-                MODULEINFO modInfo;
-                if (GetModuleInformation(hProcess, hModules[i], &modInfo, sizeof(modInfo))) {
-                    uintptr_t moduleBase = reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll);
-                    uintptr_t moduleEnd = moduleBase + modInfo.SizeOfImage;
-                    
-                    if (address >= moduleBase && address < moduleEnd) {
-                        char moduleName[MAX_PATH];
-                        if (GetModuleFileNameExA(hProcess, hModules[i], moduleName, MAX_PATH)) {
-                            // Extract just the filename
-                            char* fileName = PathFindFileNameA(moduleName);
-                            uintptr_t offset = address - moduleBase;
-                            
-                            std::stringstream ss;
-                            ss << "{";
-                            ss << "\"moduleName\":\"" << fileName << "\",";
-                            ss << "\"baseAddress\":\"0x" << std::hex << moduleBase << "\",";
-                            ss << "\"offset\":\"0x" << std::hex << offset << "\",";
-                            ss << "\"displayName\":\"" << fileName << "+0x" << std::hex << offset << "\"";
-                            ss << "}";
-                            
-                            return CreateResponse(true, ss.str(), "", id);
-                        }
-                    }
-                }
-            }
+        JsonValue list = LookupJsonMember(params, "addresses");
+        if (list.type != JsonType::Array) {
+            return CreateResponse(false, "", "Missing addresses parameter", id);
         }
         
-        return CreateResponse(false, "", "Address not found in any loaded module", id);
-    } catch (...) {
-        return CreateResponse(false, "", "Failed to get module information", id);
-    }
-}
-
-// Advanced x86/x64 instruction analysis
-struct DisasmInstruction {
-    uintptr_t address;
-    std::vector<uint8_t> bytes;
-    std::string mnemonic;
-    std::string operands;
-    size_t length;
-    bool isJump;
-    bool isCall;
-    bool isRet;
-    uintptr_t targetAddress; // For jumps/calls
-};
-
-// Basic x86/x64 instruction decoder (simplified implementation)
-class SimpleDisassembler {
-public:
-    static std::vector<DisasmInstruction> Disassemble(uintptr_t address, const std::vector<uint8_t>& bytes, bool is64bit) {
-        std::vector<DisasmInstruction> instructions;
-        size_t offset = 0;
-        
-        while (offset < bytes.size() && instructions.size() < 100) { // Limit to 100 instructions
-            DisasmInstruction inst;
-            inst.address = address + offset;
+        std::vector<BulkReadEntry> entries;
+        JsonArrayReader reader(list);
+        JsonValue element;
+        while (reader.Next(element)) {
+            if (element.type != JsonType::Object) continue;
             
-            size_t instLen = DecodeInstruction(bytes, offset, inst, is64bit);
-            if (instLen == 0) {
-                // Unknown instruction, treat as single byte
-                inst.bytes.push_back(bytes[offset]);
-                inst.mnemonic = "db";
-                inst.operands = "0x" + std::to_string(bytes[offset]);
-                inst.length = 1;
-                instLen = 1;
-            }
+            std::string addrStr = FindJsonMember(element.raw, "address").ToString();
+            std::string sizeStr = FindJsonMember(element.raw, "size").ToString();
             
-            instructions.push_back(inst);
-            offset += instLen;
-        }
-        
-        return instructions;
-    }
-    
-private:
-    static size_t DecodeInstruction(const std::vector<uint8_t>& bytes, size_t offset, DisasmInstruction& inst, bool is64bit) {
-        if (offset >= bytes.size()) return 0;
-        
-        uint8_t opcode = bytes[offset];
-        inst.bytes.clear();
-        inst.bytes.push_back(opcode);
-        inst.isJump = inst.isCall = inst.isRet = false;
-        inst.targetAddress = 0;
-        
-        // Simple x86/x64 instruction decoding
-        switch (opcode) {
-            case 0x90: // NOP
-                inst.mnemonic = "nop";
-                inst.operands = "";
-                inst.length = 1;
-                return 1;
-                
-            case 0xC3: // RET
-                inst.mnemonic = "ret";
-                inst.operands = "";
-                inst.isRet = true;
-                inst.length = 1;
-                return 1;
-                
-            case 0x55: // PUSH EBP/RBP
-                inst.mnemonic = "push";
-                inst.operands = is64bit ? "rbp" : "ebp";
-                inst.length = 1;
-                return 1;
-                
-            case 0x5D: // POP EBP/RBP
-                inst.mnemonic = "pop";
-                inst.operands = is64bit ? "rbp" : "ebp";
-                inst.length = 1;
-                return 1;
-                
-            case 0x50: case 0x51: case 0x52: case 0x53: case 0x54: case 0x56: case 0x57: // PUSH reg
-                inst.mnemonic = "push";
-                inst.operands = GetRegisterName(opcode - 0x50, is64bit, true);
-                inst.length = 1;
-                return 1;
-                
-            case 0x58: case 0x59: case 0x5A: case 0x5B: case 0x5C: case 0x5E: case 0x5F: // POP reg
-                inst.mnemonic = "pop";
-                inst.operands = GetRegisterName(opcode - 0x58, is64bit, true);
-                inst.length = 1;
-                return 1;
-                
-            case 0x8B: // MOV reg, r/m
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "mov";
-                    inst.operands = DecodeModRM(modrm, is64bit);
-                    inst.length = 2;
-                    return 2;
-                }
-                break;
-                
-            case 0x89: // MOV r/m, reg
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "mov";
-                    inst.operands = DecodeModRM(modrm, is64bit, true); // Reverse operands
-                    inst.length = 2;
-                    return 2;
-                }
-                break;
-                
-            case 0xE8: // CALL rel32
-                if (offset + 4 < bytes.size()) {
-                    for (int i = 1; i <= 4; i++) inst.bytes.push_back(bytes[offset + i]);
-                    int32_t rel32 = *reinterpret_cast<const int32_t*>(&bytes[offset + 1]);
-                    inst.mnemonic = "call";
-                    inst.targetAddress = inst.address + 5 + rel32;
-                    std::stringstream addrStream;
-                    addrStream << std::hex << std::uppercase << inst.targetAddress;
-                    inst.operands = "0x" + addrStream.str();
-                    inst.isCall = true;
-                    inst.length = 5;
-                    return 5;
-                }
-                break;
-                
-            case 0xE9: // JMP rel32
-                if (offset + 4 < bytes.size()) {
-                    for (int i = 1; i <= 4; i++) inst.bytes.push_back(bytes[offset + i]);
-                    int32_t rel32 = *reinterpret_cast<const int32_t*>(&bytes[offset + 1]);
-                    inst.mnemonic = "jmp";
-                    inst.targetAddress = inst.address + 5 + rel32;
-                    std::stringstream addrStream;
-                    addrStream << std::hex << std::uppercase << inst.targetAddress;
-                    inst.operands = "0x" + addrStream.str();
-                    inst.isJump = true;
-                    inst.length = 5;
-                    return 5;
-                }
-                break;
-                
-            case 0xCC: // INT3 (breakpoint)
-                inst.mnemonic = "int3";
-                inst.operands = "";
-                inst.length = 1;
-                return 1;
-                
-            case 0xCB: // RET far
-                inst.mnemonic = "retf";
-                inst.operands = "";
-                inst.isRet = true;
-                inst.length = 1;
-                return 1;
-                
-            case 0xC2: // RET near imm16
-                if (offset + 2 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    inst.bytes.push_back(bytes[offset + 2]);
-                    uint16_t imm16 = *reinterpret_cast<const uint16_t*>(&bytes[offset + 1]);
-                    inst.mnemonic = "ret";
-                    inst.operands = "0x" + std::to_string(imm16);
-                    inst.isRet = true;
-                    inst.length = 3;
-                    return 3;
-                }
-                break;
-                
-            case 0x6A: // PUSH imm8
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    int8_t imm8 = static_cast<int8_t>(bytes[offset + 1]);
-                    inst.mnemonic = "push";
-                    inst.operands = "0x" + std::to_string(imm8);
-                    inst.length = 2;
-                    return 2;
-                }
-                break;
-                
-            case 0x68: // PUSH imm32
-                if (offset + 4 < bytes.size()) {
-                    for (int i = 1; i <= 4; i++) inst.bytes.push_back(bytes[offset + i]);
-                    int32_t imm32 = *reinterpret_cast<const int32_t*>(&bytes[offset + 1]);
-                    inst.mnemonic = "push";
-                    inst.operands = "0x" + std::to_string(imm32);
-                    inst.length = 5;
-                    return 5;
-                }
-                break;
-                
-            case 0xB0: case 0xB1: case 0xB2: case 0xB3: case 0xB4: case 0xB5: case 0xB6: case 0xB7: // MOV reg8, imm8
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t imm8 = bytes[offset + 1];
-                    inst.mnemonic = "mov";
-                    inst.operands = GetRegisterName8(opcode - 0xB0) + ", 0x" + std::to_string(imm8);
-                    inst.length = 2;
-                    return 2;
-                }
-                break;
-                
-            case 0xB8: case 0xB9: case 0xBA: case 0xBB: case 0xBC: case 0xBD: case 0xBE: case 0xBF: // MOV reg, imm32
-                if (offset + 4 < bytes.size()) {
-                    for (int i = 1; i <= 4; i++) inst.bytes.push_back(bytes[offset + i]);
-                    uint32_t imm32 = *reinterpret_cast<const uint32_t*>(&bytes[offset + 1]);
-                    inst.mnemonic = "mov";
-                    inst.operands = GetRegisterName(opcode - 0xB8, is64bit, true) + ", 0x" + std::to_string(imm32);
-                    inst.length = 5;
-                    return 5;
-                }
-                break;
-                
-            case 0x01: // ADD r/m, reg
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "add";
-                    inst.operands = DecodeModRM(modrm, is64bit, true);
-                    inst.length = 2 + GetModRMExtraBytes(modrm, bytes, offset + 2);
-                    return inst.length;
-                }
-                break;
-                
-            case 0x03: // ADD reg, r/m
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "add";
-                    inst.operands = DecodeModRM(modrm, is64bit);
-                    inst.length = 2 + GetModRMExtraBytes(modrm, bytes, offset + 2);
-                    return inst.length;
-                }
-                break;
-                
-            case 0x29: // SUB r/m, reg
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "sub";
-                    inst.operands = DecodeModRM(modrm, is64bit, true);
-                    inst.length = 2 + GetModRMExtraBytes(modrm, bytes, offset + 2);
-                    return inst.length;
-                }
-                break;
-                
-            case 0x2B: // SUB reg, r/m
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "sub";
-                    inst.operands = DecodeModRM(modrm, is64bit);
-                    inst.length = 2 + GetModRMExtraBytes(modrm, bytes, offset + 2);
-                    return inst.length;
-                }
-                break;
-                
-            case 0x39: // CMP r/m, reg
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "cmp";
-                    inst.operands = DecodeModRM(modrm, is64bit, true);
-                    inst.length = 2 + GetModRMExtraBytes(modrm, bytes, offset + 2);
-                    return inst.length;
-                }
-                break;
-                
-            case 0x3B: // CMP reg, r/m
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "cmp";
-                    inst.operands = DecodeModRM(modrm, is64bit);
-                    inst.length = 2 + GetModRMExtraBytes(modrm, bytes, offset + 2);
-                    return inst.length;
-                }
-                break;
-                
-            case 0x85: // TEST r/m, reg
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    inst.mnemonic = "test";
-                    inst.operands = DecodeModRM(modrm, is64bit, true);
-                    inst.length = 2 + GetModRMExtraBytes(modrm, bytes, offset + 2);
-                    return inst.length;
-                }
-                break;
-                
-            case 0xFF: // CALL/JMP r/m (based on ModR/M reg field)
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    uint8_t modrm = bytes[offset + 1];
-                    int reg = (modrm >> 3) & 7;
-                    if (reg == 2) { // CALL r/m
-                        inst.mnemonic = "call";
-                        inst.isCall = true;
-                    } else if (reg == 4) { // JMP r/m
-                        inst.mnemonic = "jmp";
-                        inst.isJump = true;
-                    } else {
-                        inst.mnemonic = "???";
-                    }
-                    inst.operands = DecodeModRMOperand(modrm, is64bit);
-                    inst.length = 2 + GetModRMExtraBytes(modrm, bytes, offset + 2);
-                    return inst.length;
-                }
-                break;
-                
-            case 0xEB: // JMP rel8
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    int8_t rel8 = static_cast<int8_t>(bytes[offset + 1]);
-                    inst.mnemonic = "jmp";
-                    inst.targetAddress = inst.address + 2 + rel8;
-                    std::stringstream addrStream;
-                    addrStream << std::hex << std::uppercase << inst.targetAddress;
-                    inst.operands = "0x" + addrStream.str();
-                    inst.isJump = true;
-                    inst.length = 2;
-                    return 2;
-                }
-                break;
-                
-            case 0x0F: // Two-byte opcodes
-                if (offset + 1 < bytes.size()) {
-                    uint8_t opcode2 = bytes[offset + 1];
-                    inst.bytes.push_back(opcode2);
-                    
-                    // Conditional jumps (near form) 0x0F 0x8x
-                    if ((opcode2 & 0xF0) == 0x80) {
-                        if (offset + 5 < bytes.size()) {
-                            for (int i = 2; i <= 5; i++) inst.bytes.push_back(bytes[offset + i]);
-                            int32_t rel32 = *reinterpret_cast<const int32_t*>(&bytes[offset + 2]);
-                            inst.mnemonic = GetConditionalJumpName(opcode2 - 0x10); // Convert 0x8x to 0x7x
-                            inst.targetAddress = inst.address + 6 + rel32;
-                            std::stringstream addrStream;
-                            addrStream << std::hex << std::uppercase << inst.targetAddress;
-                            inst.operands = "0x" + addrStream.str();
-                            inst.isJump = true;
-                            inst.length = 6;
-                            return 6;
-                        }
-                    }
-                    
-                    // Other two-byte instructions can be added here
-                    inst.mnemonic = "db";
-                    inst.operands = "0x0F, 0x" + std::to_string(opcode2);
-                    inst.length = 2;
-                    return 2;
-                }
-                break;
-                
-            // Conditional jumps (short form) - Enhanced to support all conditional jumps
-            case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x76: case 0x77:
-            case 0x78: case 0x79: case 0x7A: case 0x7B: case 0x7C: case 0x7D: case 0x7E: case 0x7F:
-                if (offset + 1 < bytes.size()) {
-                    inst.bytes.push_back(bytes[offset + 1]);
-                    int8_t rel8 = static_cast<int8_t>(bytes[offset + 1]);
-                    inst.mnemonic = GetConditionalJumpName(opcode);
-                    inst.targetAddress = inst.address + 2 + rel8;
-                    std::stringstream addrStream;
-                    addrStream << std::hex << std::uppercase << inst.targetAddress;
-                    inst.operands = "0x" + addrStream.str();
-                    inst.isJump = true;
-                    inst.length = 2;
-                    return 2;
-                }
-                break;
+            // Every entry keeps its slot so the client can locate values by index
+            BulkReadEntry entry;
+            entry.address = addrStr.empty() ? 0 : std::stoull(addrStr, nullptr, 16);
+            entry.size = sizeStr.empty() ? MemoryEngine::GetValueSize(FindJsonMember(element.raw, "type").ToString()) : std::stoull(sizeStr);
+            if (entry.size > MAX_BULK_ENTRY_SIZE) entry.size = 0;
+            entries.push_back(entry);
         }
         
-        return 0; // Unknown instruction
-    }
-    
-    static std::string GetRegisterName(int reg, bool is64bit, bool fullSize = false) {
-        const char* regs32[] = {"eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi"};
-        const char* regs64[] = {"rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi"};
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> readable;
+        MemoryEngine::ReadBulk(entries, data, readable);
         
-        if (reg < 0 || reg > 7) return "???";
-        return fullSize ? (is64bit ? regs64[reg] : regs32[reg]) : regs32[reg];
-    }
-    
-    static std::string GetConditionalJumpName(uint8_t opcode) {
-        switch (opcode) {
-            case 0x70: return "jo";
-            case 0x71: return "jno";
-            case 0x72: return "jb";
-            case 0x73: return "jae";
-            case 0x74: return "je";
-            case 0x75: return "jne";
-            case 0x76: return "jbe";
-            case 0x77: return "ja";
-            case 0x78: return "js";
-            case 0x79: return "jns";
-            case 0x7A: return "jp";
-            case 0x7B: return "jnp";
-            case 0x7C: return "jl";
-            case 0x7D: return "jge";
-            case 0x7E: return "jle";
-            case 0x7F: return "jg";
-            default: return "jcc";
+        std::string flags(readable.size(), '0');
+        for (size_t i = 0; i < readable.size(); i++) {
+            if (readable[i]) flags[i] = '1';
         }
-    }
-    
-    static std::string GetRegisterName8(int reg) {
-        const char* regs8[] = {"al", "cl", "dl", "bl", "ah", "ch", "dh", "bh"};
-        if (reg < 0 || reg > 7) return "???";
-        return regs8[reg];
-    }
-    
-    static size_t GetModRMExtraBytes(uint8_t modrm, const std::vector<uint8_t>& bytes, size_t offset) {
-        int mod = (modrm >> 6) & 3;
-        int rm = modrm & 7;
         
-        if (mod == 0) {
-            if (rm == 5) return 4; // [disp32]
-            if (rm == 4) return 1; // SIB byte
-        } else if (mod == 1) {
-            return (rm == 4) ? 2 : 1; // [reg + disp8] or [SIB + disp8]
-        } else if (mod == 2) {
-            return (rm == 4) ? 5 : 4; // [reg + disp32] or [SIB + disp32]
-        }
-        return 0; // mod == 3 (register)
+        std::string body;
+        body.reserve(48 + (data.size() + 2) / 3 * 4 + flags.size());
+        JsonWriter json(body);
+        json.BeginObject();
+        json.Key("count").UInt(entries.size());
+        json.Key("data").String(Base64Encode(data.data(), data.size()));
+        json.Key("readable").String(flags);
+        json.EndObject();
+        return CreateResponse(true, body, "", id);
+    } catch (const std::exception& e) {
+        return CreateResponse(false, "", std::string("Bulk read error: ") + e.what(), id);
     }
+}
+
+std::string CommandRouter::HandleModuleFromAddress(const std::string& params) {
+    std::string addressStr = ExtractJsonValue(params, "address");
+    std::string id = ExtractJsonValue(params, "id");
     
-    static std::string DecodeModRMOperand(uint8_t modrm, bool is64bit) {
-        int mod = (modrm >> 6) & 3;
-        int rm = modrm & 7;
-        
-        if (mod == 3) {
-            return GetRegisterName(rm, is64bit);
-        } else {
-            return "[" + GetRegisterName(rm, is64bit) + "]";
-        }
+    if (addressStr.empty()) {
+        return CreateResponse(false, "", "Missing address parameter", id);
     }
     
-    static std::string DecodeModRM(uint8_t modrm, bool is64bit, bool reverse = false) {
-        int mod = (modrm >> 6) & 3;
-        int reg = (modrm >> 3) & 7;
-        int rm = modrm & 7;
-        
-        std::string regName = GetRegisterName(reg, is64bit);
-        std::string rmName;
-        
-        if (mod == 3) {
-            rmName = GetRegisterName(rm, is64bit);
-        } else {
-            rmName = "[" + GetRegisterName(rm, is64bit) + "]";
+    try {
+        uintptr_t address = std::stoull(addressStr, nullptr, 16);
+
+        ModuleMap::Snapshot modules = ModuleMap::GetSnapshot();
+        const ModuleRange* module = modules->Find(address);
+        if (module) {
+            const std::string& fileName = modules->NameOf(*module);
+            uintptr_t offset = address - module->base;
+
+            char offsetText[24];
+            snprintf(offsetText, sizeof(offsetText), "+0x%llx", static_cast<unsigned long long>(offset));
+
+            std::string data;
+            JsonWriter json(data);
+            json.BeginObject();
+            json.Key("moduleName").String(fileName);
+            json.Key("baseAddress").Hex(module->base);
+            json.Key("offset").Hex(offset);
+            json.Key("displayName").String(fileName + offsetText);
+            json.EndObject();
+
+            return CreateResponse(true, data, "", id);
         }
-        
-        return reverse ? (rmName + ", " + regName) : (regName + ", " + rmName);
+
+        return CreateResponse(false, "", "Address not found in any loaded module", id);
+    } catch (...) {
+        return CreateResponse(false, "", "Failed to get module information", id);
     }
-};
+}
+
+// Rows per memory.disassemble response unless the request asks for fewer
+static const size_t DEFAULT_DISASSEMBLY_ROWS = 100;
+static const size_t MAX_DISASSEMBLY_ROWS = 4096;
 
 // Enhanced disassembly command
 std::string CommandRouter::HandleMemoryDisassemble(const std::string& params) {
     std::string addressStr = ExtractJsonValue(params, "address");
     std::string sizeStr = ExtractJsonValue(params, "size");
+    std::string countStr = ExtractJsonValue(params, "count");
     std::string id = ExtractJsonValue(params, "id");
     
     if (addressStr.empty() || sizeStr.empty()) {
@@ -1610,6 +2812,8 @@ std::string CommandRouter::HandleMemoryDisassemble(const std::string& params) {
     try {
         uintptr_t address = std::stoull(addressStr, nullptr, 16);
         size_t size = std::stoull(sizeStr);
+        size_t count = countStr.empty() ? DEFAULT_DISASSEMBLY_ROWS : std::stoull(countStr);
+        count = min(count, MAX_DISASSEMBLY_ROWS);
         
         // Validate address
         if (!MemoryEngine::IsAddressValid(address, size)) {
@@ -1628,46 +2832,225 @@ std::string CommandRouter::HandleMemoryDisassemble(const std::string& params) {
         // Detect architecture (simplified check)
         bool is64bit = sizeof(void*) == 8;
         
-        // Disassemble instructions
-        auto instructions = SimpleDisassembler::Disassemble(address, bytes, is64bit);
-        
-        std::stringstream ss;
-        ss << "[";
-        
-        for (size_t i = 0; i < instructions.size(); i++) {
-            if (i > 0) ss << ",";
+        // Decode only the rows being returned; text is formatted per row into stack buffers
+        std::vector<X86Instruction> instructions;
+        instructions.reserve(min(count, bytes.size()));
+        X86Decoder::DecodeRange(bytes.data(), bytes.size(), address, is64bit, instructions, count);
+        
+        std::string data;
+        data.reserve(instructions.size() * 192);
+        JsonWriter json(data);
+        json.BeginArray();
+        
+        static const char hexDigits[] = "0123456789ABCDEF";
+        X86Text text;
+        char bytesText[X86Decoder::MAX_INSTRUCTION_LENGTH * 3];
+        for (const auto& inst : instructions) {
+            X86Decoder::Format(inst, text);
             
-            const auto& inst = instructions[i];
-            ss << "{";
-            ss << "\"address\":\"0x" << std::hex << inst.address << "\",";
-            
-            // Format bytes
-            std::stringstream bytesStr;
-            for (size_t j = 0; j < inst.bytes.size(); j++) {
-                if (j > 0) bytesStr << " ";
-                bytesStr << std::hex << std::setfill('0') << std::setw(2) << std::uppercase << static_cast<int>(inst.bytes[j]);
+            size_t offset = inst.address - address;
+            size_t textLength = 0;
+            for (size_t j = 0; j < inst.length; j++) {
+                if (j > 0) bytesText[textLength++] = ' ';
+                bytesText[textLength++] = hexDigits[bytes[offset + j] >> 4];
+                bytesText[textLength++] = hexDigits[bytes[offset + j] & 0xF];
             }
-            ss << "\"bytes\":\"" << bytesStr.str() << "\",";
-            
-            ss << "\"mnemonic\":\"" << inst.mnemonic << "\",";
-            ss << "\"operands\":\"" << EscapeJsonString(inst.operands) << "\",";
-            ss << "\"length\":" << inst.length << ",";
-            ss << "\"isJump\":" << (inst.isJump ? "true" : "false") << ",";
-            ss << "\"isCall\":" << (inst.isCall ? "true" : "false") << ",";
-            ss << "\"isRet\":" << (inst.isRet ? "true" : "false");
             
-            if (inst.targetAddress != 0) {
-                ss << ",\"target\":\"0x" << std::hex << inst.targetAddress << "\"";
+            json.BeginObject();
+            json.Key("address").Hex(inst.address);
+            json.Key("bytes").String(std::string_view(bytesText, textLength));
+            json.Key("mnemonic").String(text.mnemonic);
+            json.Key("operands").String(text.operands);
+            json.Key("length").UInt(inst.length);
+            json.Key("isJump").Bool((inst.flags & X86_FLAG_JUMP) != 0);
+            json.Key("isCall").Bool((inst.flags & X86_FLAG_CALL) != 0);
+            json.Key("isRet").Bool((inst.flags & X86_FLAG_RET) != 0);
+            if (inst.flags & X86_FLAG_RELATIVE) {
+                json.Key("target").Hex(inst.target);
             }
-            
-            ss << "}";
+            json.EndObject();
         }
         
-        ss << "]";
-        return CreateResponse(true, ss.str(), "", id);
+        json.EndArray();
+        return CreateResponse(true, data, "", id);
     } catch (...) {
         return CreateResponse(false, "", "Disassembly failed", id);
     }
 }
 
+// ⚡ 바이너리 프로토콜 명령
+// Limits keep a single request from building an unbounded response frame
+static const uint32_t MAX_BINARY_READ_SIZE = 16 * 1024 * 1024;
+static const uint32_t MAX_BULK_READ_COUNT = 65536;
+
+static std::vector<uint8_t> BinaryError(const BinaryHeader& header) {
+    return BinaryProtocol::EncodeMessage(header.opcode, header.requestId, BINARY_FLAG_ERROR);
+}
+
+// Binary requests are counted per opcode under "binary.<opcode>"; the lookup is cached per opcode
+static CommandMetrics* BinaryCommandMetrics(BinaryOpcode opcode) {
+    static std::atomic<CommandMetrics*> cache[256] = {};
+    std::atomic<CommandMetrics*>& slot = cache[static_cast<uint8_t>(opcode)];
+    CommandMetrics* metrics = slot.load(std::memory_order_acquire);
+    if (!metrics) {
+        const char* name = "binary.unknown";
+        switch (opcode) {
+            case BinaryOpcode::PING: name = "binary.ping"; break;
+            case BinaryOpcode::MEMORY_READ: name = "binary.memory.read"; break;
+            case BinaryOpcode::MEMORY_WRITE: name = "binary.memory.write"; break;
+            case BinaryOpcode::BULK_UPDATE: name = "binary.memory.readBulk"; break;
+            case BinaryOpcode::MEMORY_SCAN: name = "binary.memory.scan"; break;
+            default: break;
+        }
+        metrics = EngineMetrics::ForCommand(name);
+        slot.store(metrics, std::memory_order_release);
+    }
+    return metrics;
+}
+
+std::vector<uint8_t> CommandRouter::ExecuteBinaryCommand(const std::vector<uint8_t>& message, WebSocketConnection* origin) {
+    BinaryHeader header;
+    if (!BinaryProtocol::DecodeHeader(message, header)) {
+        return {};
+    }
+
+    // Trust the frame length over the header's payloadSize
+    size_t available = message.size() - sizeof(BinaryHeader);
+    size_t payloadSize = min(available, static_cast<size_t>(header.payloadSize));
+    std::vector<uint8_t> payload(message.begin() + sizeof(BinaryHeader), message.begin() + sizeof(BinaryHeader) + payloadSize);
+
+    CommandMetrics* metrics = BinaryCommandMetrics(header.opcode);
+    uint64_t started = EngineMetrics::Now();
+    std::vector<uint8_t> response;
+
+    try {
+        switch (header.opcode) {
+            case BinaryOpcode::PING:
+                response = BinaryProtocol::EncodeMessage(BinaryOpcode::PONG, header.requestId, 0);
+                break;
+            case BinaryOpcode::MEMORY_READ:
+                response = HandleBinaryMemoryRead(header, payload);
+                break;
+            case BinaryOpcode::MEMORY_WRITE:
+                response = HandleBinaryMemoryWrite(header, payload);
+                break;
+            case BinaryOpcode::BULK_UPDATE:
+                response = HandleBinaryBulkRead(header, payload);
+                break;
+            case BinaryOpcode::MEMORY_SCAN:
+                response = HandleBinaryMemoryScan(header, payload, origin);
+                break;
+            default:
+                response = BinaryError(header);
+                break;
+        }
+    } catch (...) {
+        response = BinaryError(header);
+    }
+
+    // Timed like JSON commands; a response flagged BINARY_FLAG_ERROR counts as an error
+    bool failed = response.size() >= sizeof(BinaryHeader) && (response[offsetof(BinaryHeader, flags)] & BINARY_FLAG_ERROR) != 0;
+    EngineMetrics::RecordCommand(metrics, EngineMetrics::MicrosSince(started), failed);
+    return response;
+}
+
+std::vector<uint8_t> CommandRouter::HandleBinaryMemoryRead(const BinaryHeader& header, const std::vector<uint8_t>& payload) {
+    MemoryReadRequest request;
+    if (!BinaryProtocol::DecodeMemoryRead(payload, request) || request.size == 0 || request.size > MAX_BINARY_READ_SIZE) {
+        return BinaryError(header);
+    }
+
+    auto bytes = MemoryEngine::SafeReadBytes(static_cast<uintptr_t>(request.address), request.size);
+    if (bytes.empty()) {
+        return BinaryError(header);
+    }
+
+    return BinaryProtocol::EncodeMemoryReadResponse(header.requestId, request.address, request.type, bytes);
+}
+
+std::vector<uint8_t> CommandRouter::HandleBinaryMemoryWrite(const BinaryHeader& header, const std::vector<uint8_t>& payload) {
+    MemoryWriteRequest request;
+    std::vector<uint8_t> data;
+    if (!BinaryProtocol::DecodeMemoryWrite(payload, request, data) || data.empty()) {
+        return BinaryError(header);
+    }
+
+    if (!MemoryEngine::SafeWriteBytes(static_cast<uintptr_t>(request.address), data)) {
+        return BinaryError(header);
+    }
+
+    return BinaryProtocol::EncodeMessage(BinaryOpcode::MEMORY_WRITE, header.requestId, 0);
+}
+
+// Monitoring poll: count * MemoryReadRequest in, one BULK_UPDATE with every value out
+std::vector<uint8_t> CommandRouter::HandleBinaryBulkRead(const BinaryHeader& header, const std::vector<uint8_t>& payload) {
+    std::vector<MemoryReadRequest> requests;
+    if (!BinaryProtocol::DecodeBulkRead(payload, requests) || requests.size() > MAX_BULK_READ_COUNT) {
+        return BinaryError(header);
+    }
+
+    std::vector<BulkReadEntry> entries(requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+        entries[i].address = static_cast<uintptr_t>(requests[i].address);
+        entries[i].size = requests[i].size > MAX_BULK_ENTRY_SIZE ? 0 : requests[i].size;
+    }
+    
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> readable;
+    MemoryEngine::ReadBulk(entries, data, readable);
+    
+    std::vector<std::vector<uint8_t>> values(requests.size());
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (readable[i]) {
+            values[i].assign(data.begin() + offset, data.begin() + offset + entries[i].size);
+        }
+        offset += entries[i].size;
+    }
+
+    return BinaryProtocol::EncodeBulkRead(header.requestId, requests, values);
+}
+
+// Exact-value first scan; results go out as SCAN_RESULTS frames and the final
+// SCAN_PROGRESS frame (FINAL flag) doubles as the response. Hits are kept in a
+// ScanResultStore while they stream, never as one ScanResult each. The scan can be stopped
+// with command.cancel {"targetId":"binary:<requestId>"} or by closing the connection; a
+// cancelled or invalid request ends with an error frame instead.
+std::vector<uint8_t> CommandRouter::HandleBinaryMemoryScan(const BinaryHeader& header, const std::vector<uint8_t>& payload, WebSocketConnection* origin) {
+    MemoryScanRequest request;
+    std::vector<uint8_t> value;
+    std::string expression;
+    if (!origin || !BinaryProtocol::DecodeMemoryScan(payload, request, value, expression)) {
+        return BinaryError(header);
+    }
+
+    std::string type = BinaryProtocol::DataTypeToString(request.type);
+    ScanOptions options;
+    options.alignment = max(static_cast<size_t>(request.alignment), static_cast<size_t>(1));
+
+    ScanFilter filter;
+    if (!expression.empty()) {
+        try {
+            filter = ScanFilter::Compile(expression, ScanResultStore::ParseValueKind(type));
+        } catch (const std::invalid_argument&) {
+            return BinaryError(header);
+        }
+        options.filter = &filter;
+    }
+
+    CommandScope scope(this, origin, "binary:" + std::to_string(header.requestId));
+    options.cancel = t_cancelFlag;
+
+    ScanResultStreamer streamer(origin, header.requestId, type, 0);
+    streamer.Attach(options);
+
+    ScanResultStore results;
+    MemoryEngine::FirstScan(value, type, options, results);
+    if (IsCommandCancelled()) {
+        return BinaryError(header);
+    }
+    streamer.Finish(results.Count());
+    return {};
+}
+
 } // namespace InternalEngine
\ No newline at end of file
@@ -3,9 +3,24 @@
 #include <functional>
 #include <unordered_map>
 #include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include "ScanSession.hpp"
+#include "BinaryProtocol.hpp"
+#include "WatchManager.hpp"
+#include "HookProfiler.hpp"
+#include "PointerScanner.hpp"
+#include "PageDelta.hpp"
+#include "FreezeManager.hpp"
+#include "EngineMetrics.hpp"
+#include "ViewerManager.hpp"
 
 namespace InternalEngine {
 
+class WebSocketConnection;
+
 // Command handler function type
 using CommandHandler = std::function<std::string(const std::string& params)>;
 
@@ -21,11 +36,55 @@ public:
     // Command execution
     std::string ExecuteCommand(const std::string& jsonRequest);
     
+    // origin receives streamed binary frames (e.g. scan results) ahead of the response.
+    // While it runs, the request can be cancelled by its id from the same connection.
+    std::string ExecuteCommand(const std::string& jsonRequest, WebSocketConnection* origin);
+    
+    // Commands answered on the I/O thread without queueing behind running commands
+    // (currently only command.cancel); returns empty for every other request
+    std::string ExecuteControlCommand(const std::string& jsonRequest, WebSocketConnection* origin);
+    
+    // Binary protocol message (BinaryHeader + payload); returns the encoded response or empty
+    std::vector<uint8_t> ExecuteBinaryCommand(const std::vector<uint8_t>& message, WebSocketConnection* origin);
+    
     // Built-in commands
     void RegisterBuiltinCommands();
+    
+    // Connection lifecycle (drops per-connection state such as watch subscriptions)
+    void OnConnectionClosed(WebSocketConnection* conn);
+    
+    // Cancels every command still running for conn (called as soon as it starts closing)
+    void CancelConnectionCommands(WebSocketConnection* conn);
+    
+    // Stops background engine threads; call before the WebSocket server is destroyed
+    void Shutdown();
 
 private:
-    std::unordered_map<std::string, CommandHandler> commands;
+    // Latency counters are looked up once at registration, not per request
+    struct RegisteredCommand {
+        CommandHandler handler;
+        CommandMetrics* metrics = nullptr;
+    };
+    
+    std::unordered_map<std::string, RegisteredCommand> commands;
+    ScanSessionManager scanSessions;
+    WatchManager watches;
+    ViewerManager viewers;
+    HookStatsPublisher hookStats;
+    PointerScanManager pointerScans;
+    PageDeltaCache pageDeltas;
+    FreezeManager freezes;
+    MetricsPublisher metricsPublisher;
+    
+    // Cancel flags of running WebSocket commands, keyed by (connection, request id)
+    using ActiveCommandKey = std::pair<WebSocketConnection*, std::string>;
+    std::map<ActiveCommandKey, std::shared_ptr<std::atomic<bool>>> activeCommands;
+    std::mutex activeCommandsMutex;
+    
+    bool CancelCommand(WebSocketConnection* origin, const std::string& id);
+    
+    // Makes a request cancellable by id and current on this thread while it runs
+    struct CommandScope;
     
     // JSON parsing helpers
     std::string ParseCommand(const std::string& json);
@@ -36,12 +95,30 @@ private:
     std::string HandleMemoryRead(const std::string& params);
     std::string HandleMemoryWrite(const std::string& params);
     std::string HandleMemoryScan(const std::string& params);
+    std::string HandleScanSessionCreate(const std::string& params);
+    std::string HandleScanSessionNext(const std::string& params);
+    std::string HandleScanSessionUndo(const std::string& params);
+    std::string HandleScanSessionClose(const std::string& params);
+    std::string HandleScanSessionResults(const std::string& params);
+    std::string HandleCommandCancel(const std::string& params, WebSocketConnection* origin);
+    std::string HandleWatchSubscribe(const std::string& params);
+    std::string HandleWatchUnsubscribe(const std::string& params);
+    std::string HandleViewerSubscribe(const std::string& params);
+    std::string HandleViewerUnsubscribe(const std::string& params);
+    std::string HandleFreezeSet(const std::string& params);
+    std::string HandleFreezeClear(const std::string& params);
+    std::string HandleFreezeList(const std::string& params);
     std::string HandleMemoryRegions(const std::string& params);
     std::string HandleMemoryValidate(const std::string& params);
     std::string HandleMemoryPatch(const std::string& params);
     std::string HandleMemoryNop(const std::string& params);
     std::string HandlePatternScan(const std::string& params);
     std::string HandlePatternScanAll(const std::string& params);
+    std::string HandlePatternScanBatch(const std::string& params);
+    std::string HandleCodeReferences(const std::string& params);
+    std::string HandleCodeIndexInfo(const std::string& params);
+    std::string HandleCacheInfo(const std::string& params);
+    std::string HandleCacheClear(const std::string& params);
     std::string HandleModuleList(const std::string& params);
     std::string HandleModuleInfo(const std::string& params);
     std::string HandleProcessInfo(const std::string& params);
@@ -49,16 +126,38 @@ private:
     std::string HandleHookRemove(const std::string& params);
     std::string HandleHookList(const std::string& params);
     std::string HandleHookToggle(const std::string& params);
+    std::string HandleHookProfile(const std::string& params);
+    std::string HandleHookStats(const std::string& params);
+    std::string HandleHookStatsSubscribe(const std::string& params);
+    std::string HandleHookStatsUnsubscribe(const std::string& params);
+    std::string HandleEngineMetrics(const std::string& params);
+    std::string HandleEngineMetricsSubscribe(const std::string& params);
+    std::string HandleEngineMetricsUnsubscribe(const std::string& params);
     std::string HandleAllocateMemory(const std::string& params);
     std::string HandleFreeMemory(const std::string& params);
     std::string HandlePointerChain(const std::string& params);
     std::string HandlePointerFind(const std::string& params);
+    std::string HandlePointerChainSave(const std::string& params);
+    std::string HandlePointerChainLoad(const std::string& params);
+    std::string HandlePointerMapCreate(const std::string& params);
+    std::string HandlePointerMapSave(const std::string& params);
+    std::string HandlePointerMapLoad(const std::string& params);
+    std::string HandlePointerMapClose(const std::string& params);
+    std::string HandlePointerScan(const std::string& params);
+    std::string HandlePointerResults(const std::string& params);
+    std::string HandlePointerResultsClose(const std::string& params);
     
     // New enhanced commands
     std::string HandleMemoryReadValue(const std::string& params);
     std::string HandleMemoryReadBulk(const std::string& params);
     std::string HandleMemoryDisassemble(const std::string& params);
     std::string HandleModuleFromAddress(const std::string& params);
+    
+    // Binary protocol handlers (no JSON on either side)
+    std::vector<uint8_t> HandleBinaryMemoryRead(const BinaryHeader& header, const std::vector<uint8_t>& payload);
+    std::vector<uint8_t> HandleBinaryMemoryWrite(const BinaryHeader& header, const std::vector<uint8_t>& payload);
+    std::vector<uint8_t> HandleBinaryBulkRead(const BinaryHeader& header, const std::vector<uint8_t>& payload);
+    std::vector<uint8_t> HandleBinaryMemoryScan(const BinaryHeader& header, const std::vector<uint8_t>& payload, WebSocketConnection* origin);
 };
 
 // Global command router instance
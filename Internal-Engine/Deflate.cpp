@@ -0,0 +1,599 @@
+#include "Deflate.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace InternalEngine {
+
+namespace {
+
+const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const uint16_t DIST_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+const uint8_t DIST_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+// Order in which code length code lengths are sent
+const uint8_t CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+const size_t LITERAL_CODES = 286;
+const size_t DISTANCE_CODES = 30;
+const size_t CODE_LENGTH_CODES = 19;
+const unsigned MAX_CODE_BITS = 15;
+const unsigned MAX_CODE_LENGTH_BITS = 7;
+const uint16_t END_OF_BLOCK = 256;
+
+const size_t MIN_MATCH = 3;
+const size_t MAX_MATCH = 258;
+const unsigned HASH_BITS = 15;
+const size_t MAX_CHAIN = 8;         // Candidates tried per position (the "fast level")
+const size_t INSERT_LIMIT = 32;     // Positions inside longer matches are not hashed
+
+// 🔧 압축 (LZ77 + dynamic Huffman)
+
+// Literal (dist == 0) or match
+struct Symbol {
+    uint16_t litLen;
+    uint16_t dist;
+};
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    // LSB first, as DEFLATE packs everything but Huffman codes (which are stored reversed)
+    void Put(uint32_t value, unsigned count) {
+        bitBuffer |= static_cast<uint64_t>(value & ((1ULL << count) - 1)) << bitCount;
+        bitCount += count;
+        while (bitCount >= 8) {
+            out.push_back(static_cast<uint8_t>(bitBuffer));
+            bitBuffer >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    void AlignToByte() {
+        if (bitCount > 0) Put(0, 8 - bitCount);
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t bitBuffer = 0;
+    unsigned bitCount = 0;
+};
+
+inline size_t LengthCode(size_t length) {
+    return static_cast<size_t>(std::upper_bound(LENGTH_BASE, LENGTH_BASE + 29, length) - LENGTH_BASE) - 1;
+}
+
+inline size_t DistanceCode(size_t distance) {
+    return static_cast<size_t>(std::upper_bound(DIST_BASE, DIST_BASE + 30, distance) - DIST_BASE) - 1;
+}
+
+inline uint16_t ReverseBits(uint16_t code, unsigned length) {
+    uint16_t reversed = 0;
+    for (unsigned i = 0; i < length; i++) {
+        reversed = static_cast<uint16_t>((reversed << 1) | (code & 1));
+        code >>= 1;
+    }
+    return reversed;
+}
+
+// Huffman code lengths for freq, none longer than maxBits (0 = symbol unused). Overlong
+// codes are fixed up the way zlib does: move leaves down the tree until it fits.
+void BuildLengths(const uint32_t* freq, size_t count, unsigned maxBits, uint8_t* lengths) {
+    memset(lengths, 0, count);
+    std::vector<uint32_t> weights(freq, freq + count);
+    std::vector<uint16_t> used;
+    for (size_t i = 0; i < count; i++) {
+        if (weights[i]) used.push_back(static_cast<uint16_t>(i));
+    }
+
+    // A complete code needs at least two symbols
+    for (size_t i = 0; used.size() < 2 && i < count; i++) {
+        if (!weights[i]) {
+            weights[i] = 1;
+            used.push_back(static_cast<uint16_t>(i));
+        }
+    }
+    std::sort(used.begin(), used.end(), [&](uint16_t a, uint16_t b) {
+        return weights[a] != weights[b] ? weights[a] < weights[b] : a < b;
+    });
+
+    // Two-queue Huffman: sorted leaves [0, n), internal nodes [n, 2n - 1) in creation order
+    size_t n = used.size();
+    std::vector<uint64_t> weight(2 * n - 1);
+    std::vector<size_t> parent(2 * n - 1, 0);
+    for (size_t i = 0; i < n; i++) weight[i] = weights[used[i]];
+
+    size_t nextLeaf = 0;
+    size_t nextInternal = n;
+    auto takeLightest = [&](size_t created) {
+        if (nextLeaf < n && (nextInternal >= created || weight[nextLeaf] <= weight[nextInternal])) return nextLeaf++;
+        return nextInternal++;
+    };
+    for (size_t node = n; node < 2 * n - 1; node++) {
+        size_t a = takeLightest(node);
+        size_t b = takeLightest(node);
+        weight[node] = weight[a] + weight[b];
+        parent[a] = node;
+        parent[b] = node;
+    }
+
+    // Parents always come after their children
+    std::vector<unsigned> depth(2 * n - 1, 0);
+    unsigned bitCounts[MAX_CODE_BITS + 2] = { 0 };
+    int overflow = 0;
+    for (size_t node = 2 * n - 1; node-- > 0;) {
+        if (node == 2 * n - 2) continue;
+        depth[node] = depth[parent[node]] + 1;
+        if (node < n) {
+            unsigned bits = depth[node];
+            if (bits > maxBits) {
+                bits = maxBits;
+                overflow++;
+            }
+            bitCounts[bits]++;
+        }
+    }
+
+    while (overflow > 0) {
+        unsigned bits = maxBits - 1;
+        while (bitCounts[bits] == 0) bits--;
+        bitCounts[bits]--;
+        bitCounts[bits + 1] += 2;
+        bitCounts[maxBits]--;
+        overflow -= 2;
+    }
+
+    // Longest codes go to the rarest symbols
+    size_t next = 0;
+    for (unsigned bits = maxBits; bits >= 1; bits--) {
+        for (unsigned k = 0; k < bitCounts[bits]; k++) {
+            lengths[used[next++]] = static_cast<uint8_t>(bits);
+        }
+    }
+}
+
+// Canonical codes (RFC 1951 3.2.2), bit-reversed for the LSB-first writer
+void BuildCodes(const uint8_t* lengths, size_t count, uint16_t* codes) {
+    uint16_t bitCounts[MAX_CODE_BITS + 1] = { 0 };
+    for (size_t i = 0; i < count; i++) {
+        if (lengths[i]) bitCounts[lengths[i]]++;
+    }
+
+    uint16_t nextCode[MAX_CODE_BITS + 1] = { 0 };
+    uint16_t code = 0;
+    for (unsigned bits = 1; bits <= MAX_CODE_BITS; bits++) {
+        code = static_cast<uint16_t>((code + bitCounts[bits - 1]) << 1);
+        nextCode[bits] = code;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        codes[i] = lengths[i] ? ReverseBits(nextCode[lengths[i]]++, lengths[i]) : 0;
+    }
+}
+
+struct CodeLengthSymbol {
+    uint8_t symbol;     // 0-15 literal length, 16 repeat previous, 17/18 repeat zero
+    uint8_t extra;
+};
+
+void RunLengthEncode(const std::vector<uint8_t>& lengths, std::vector<CodeLengthSymbol>& out) {
+    size_t i = 0;
+    while (i < lengths.size()) {
+        uint8_t length = lengths[i];
+        size_t run = 1;
+        while (i + run < lengths.size() && lengths[i + run] == length) run++;
+        i += run;
+
+        if (length == 0) {
+            while (run >= 11) {
+                size_t take = std::min(run, static_cast<size_t>(138));
+                out.push_back({ 18, static_cast<uint8_t>(take - 11) });
+                run -= take;
+            }
+            if (run >= 3) {
+                out.push_back({ 17, static_cast<uint8_t>(run - 3) });
+                run = 0;
+            }
+        } else {
+            out.push_back({ length, 0 });
+            run--;
+            while (run >= 3) {
+                size_t take = std::min(run, static_cast<size_t>(6));
+                out.push_back({ 16, static_cast<uint8_t>(take - 3) });
+                run -= take;
+            }
+        }
+        for (; run > 0; run--) out.push_back({ length, 0 });
+    }
+}
+
+// One non-final block with its own Huffman tables
+void WriteBlock(BitWriter& writer, const std::vector<Symbol>& symbols) {
+    uint32_t literalFreq[LITERAL_CODES] = { 0 };
+    uint32_t distanceFreq[DISTANCE_CODES] = { 0 };
+    for (const Symbol& symbol : symbols) {
+        if (symbol.dist == 0) {
+            literalFreq[symbol.litLen]++;
+        } else {
+            literalFreq[257 + LengthCode(symbol.litLen)]++;
+            distanceFreq[DistanceCode(symbol.dist)]++;
+        }
+    }
+    literalFreq[END_OF_BLOCK]++;
+
+    uint8_t literalLengths[LITERAL_CODES];
+    uint8_t distanceLengths[DISTANCE_CODES];
+    BuildLengths(literalFreq, LITERAL_CODES, MAX_CODE_BITS, literalLengths);
+    BuildLengths(distanceFreq, DISTANCE_CODES, MAX_CODE_BITS, distanceLengths);
+
+    size_t literalCount = LITERAL_CODES;
+    while (literalCount > 257 && literalLengths[literalCount - 1] == 0) literalCount--;
+    size_t distanceCount = DISTANCE_CODES;
+    while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0) distanceCount--;
+
+    // Both length tables are sent as one run-length encoded sequence
+    std::vector<uint8_t> allLengths(literalLengths, literalLengths + literalCount);
+    allLengths.insert(allLengths.end(), distanceLengths, distanceLengths + distanceCount);
+    std::vector<CodeLengthSymbol> encoded;
+    RunLengthEncode(allLengths, encoded);
+
+    uint32_t codeLengthFreq[CODE_LENGTH_CODES] = { 0 };
+    for (const auto& entry : encoded) codeLengthFreq[entry.symbol]++;
+    uint8_t codeLengthLengths[CODE_LENGTH_CODES];
+    BuildLengths(codeLengthFreq, CODE_LENGTH_CODES, MAX_CODE_LENGTH_BITS, codeLengthLengths);
+
+    size_t codeLengthCount = CODE_LENGTH_CODES;
+    while (codeLengthCount > 4 && codeLengthLengths[CODE_LENGTH_ORDER[codeLengthCount - 1]] == 0) codeLengthCount--;
+
+    uint16_t literalCodes[LITERAL_CODES];
+    uint16_t distanceCodes[DISTANCE_CODES];
+    uint16_t codeLengthCodes[CODE_LENGTH_CODES];
+    BuildCodes(literalLengths, LITERAL_CODES, literalCodes);
+    BuildCodes(distanceLengths, DISTANCE_CODES, distanceCodes);
+    BuildCodes(codeLengthLengths, CODE_LENGTH_CODES, codeLengthCodes);
+
+    writer.Put(0, 1);   // BFINAL
+    writer.Put(2, 2);   // Dynamic Huffman
+    writer.Put(static_cast<uint32_t>(literalCount - 257), 5);
+    writer.Put(static_cast<uint32_t>(distanceCount - 1), 5);
+    writer.Put(static_cast<uint32_t>(codeLengthCount - 4), 4);
+    for (size_t i = 0; i < codeLengthCount; i++) {
+        writer.Put(codeLengthLengths[CODE_LENGTH_ORDER[i]], 3);
+    }
+    for (const auto& entry : encoded) {
+        writer.Put(codeLengthCodes[entry.symbol], codeLengthLengths[entry.symbol]);
+        if (entry.symbol == 16) writer.Put(entry.extra, 2);
+        else if (entry.symbol == 17) writer.Put(entry.extra, 3);
+        else if (entry.symbol == 18) writer.Put(entry.extra, 7);
+    }
+
+    for (const Symbol& symbol : symbols) {
+        if (symbol.dist == 0) {
+            writer.Put(literalCodes[symbol.litLen], literalLengths[symbol.litLen]);
+            continue;
+        }
+        size_t lengthCode = LengthCode(symbol.litLen);
+        writer.Put(literalCodes[257 + lengthCode], literalLengths[257 + lengthCode]);
+        writer.Put(static_cast<uint32_t>(symbol.litLen - LENGTH_BASE[lengthCode]), LENGTH_EXTRA[lengthCode]);
+
+        size_t distanceCode = DistanceCode(symbol.dist);
+        writer.Put(distanceCodes[distanceCode], distanceLengths[distanceCode]);
+        writer.Put(static_cast<uint32_t>(symbol.dist - DIST_BASE[distanceCode]), DIST_EXTRA[distanceCode]);
+    }
+    writer.Put(literalCodes[END_OF_BLOCK], literalLengths[END_OF_BLOCK]);
+}
+
+// 🔓 압축 해제
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    // count <= 16; reading past the end sets overrun and returns 0 bits
+    uint32_t Get(unsigned count) {
+        while (bitCount < count) {
+            if (position >= size) {
+                overrun = true;
+                return 0;
+            }
+            bitBuffer |= static_cast<uint32_t>(data[position++]) << bitCount;
+            bitCount += 8;
+        }
+        uint32_t value = bitBuffer & ((1U << count) - 1);
+        bitBuffer >>= count;
+        bitCount -= count;
+        return value;
+    }
+
+    // Fewer than 8 bits are ever buffered, so this only drops the current byte's padding
+    void AlignToByte() {
+        bitBuffer = 0;
+        bitCount = 0;
+    }
+
+    bool CopyBytes(std::vector<uint8_t>& out, size_t count) {
+        if (size - position < count) {
+            overrun = true;
+            return false;
+        }
+        out.insert(out.end(), data + position, data + position + count);
+        position += count;
+        return true;
+    }
+
+    // Only padding bits of the last byte are left
+    bool AtEnd() const { return position >= size; }
+    bool Overrun() const { return overrun; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t position = 0;
+    uint32_t bitBuffer = 0;
+    unsigned bitCount = 0;
+    bool overrun = false;
+};
+
+// Canonical decoding table: symbols sorted by code length (as in zlib's puff)
+struct HuffmanTable {
+    uint16_t count[MAX_CODE_BITS + 1];
+    uint16_t symbol[288];
+};
+
+bool BuildTable(HuffmanTable& table, const uint8_t* lengths, size_t count) {
+    memset(table.count, 0, sizeof(table.count));
+    for (size_t i = 0; i < count; i++) table.count[lengths[i]]++;
+    table.count[0] = 0;
+
+    // Over-subscribed codes are invalid; incomplete ones are allowed
+    int left = 1;
+    for (unsigned bits = 1; bits <= MAX_CODE_BITS; bits++) {
+        left <<= 1;
+        left -= table.count[bits];
+        if (left < 0) return false;
+    }
+
+    uint16_t offsets[MAX_CODE_BITS + 2] = { 0 };
+    for (unsigned bits = 1; bits <= MAX_CODE_BITS; bits++) {
+        offsets[bits + 1] = static_cast<uint16_t>(offsets[bits] + table.count[bits]);
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (lengths[i]) table.symbol[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+    }
+    return true;
+}
+
+int DecodeSymbol(BitReader& reader, const HuffmanTable& table) {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (unsigned bits = 1; bits <= MAX_CODE_BITS; bits++) {
+        code |= static_cast<int>(reader.Get(1));
+        if (reader.Overrun()) return -1;
+        int count = table.count[bits];
+        if (code - count < first) return table.symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+bool InflateCodes(BitReader& reader, const HuffmanTable& literals, const HuffmanTable& distances,
+                  std::vector<uint8_t>& out, size_t maxOutput) {
+    while (true) {
+        int symbol = DecodeSymbol(reader, literals);
+        if (symbol < 0) return false;
+        if (symbol < 256) {
+            if (out.size() >= maxOutput) return false;
+            out.push_back(static_cast<uint8_t>(symbol));
+            continue;
+        }
+        if (symbol == END_OF_BLOCK) return true;
+
+        symbol -= 257;
+        if (symbol >= 29) return false;
+        size_t length = LENGTH_BASE[symbol] + reader.Get(LENGTH_EXTRA[symbol]);
+
+        int distanceSymbol = DecodeSymbol(reader, distances);
+        if (distanceSymbol < 0 || distanceSymbol >= 30) return false;
+        size_t distance = DIST_BASE[distanceSymbol] + reader.Get(DIST_EXTRA[distanceSymbol]);
+        if (reader.Overrun() || distance > out.size() || length > maxOutput - out.size()) return false;
+
+        // Overlapping copies repeat the bytes just written
+        size_t from = out.size() - distance;
+        size_t to = out.size();
+        out.resize(to + length);
+        for (size_t k = 0; k < length; k++) {
+            out[to + k] = out[from + k];
+        }
+    }
+}
+
+bool ReadDynamicTables(BitReader& reader, HuffmanTable& literals, HuffmanTable& distances) {
+    size_t literalCount = reader.Get(5) + 257;
+    size_t distanceCount = reader.Get(5) + 1;
+    size_t codeLengthCount = reader.Get(4) + 4;
+    if (literalCount > LITERAL_CODES || distanceCount > DISTANCE_CODES) return false;
+
+    uint8_t codeLengthLengths[CODE_LENGTH_CODES] = { 0 };
+    for (size_t i = 0; i < codeLengthCount; i++) {
+        codeLengthLengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(reader.Get(3));
+    }
+    HuffmanTable codeLengths;
+    if (reader.Overrun() || !BuildTable(codeLengths, codeLengthLengths, CODE_LENGTH_CODES)) return false;
+
+    uint8_t lengths[LITERAL_CODES + DISTANCE_CODES] = { 0 };
+    size_t total = literalCount + distanceCount;
+    size_t index = 0;
+    while (index < total) {
+        int symbol = DecodeSymbol(reader, codeLengths);
+        if (symbol < 0) return false;
+        if (symbol < 16) {
+            lengths[index++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+
+        uint8_t repeated = 0;
+        size_t run = 0;
+        if (symbol == 16) {
+            if (index == 0) return false;
+            repeated = lengths[index - 1];
+            run = 3 + reader.Get(2);
+        } else if (symbol == 17) {
+            run = 3 + reader.Get(3);
+        } else {
+            run = 11 + reader.Get(7);
+        }
+        if (reader.Overrun() || index + run > total) return false;
+        memset(lengths + index, repeated, run);
+        index += run;
+    }
+
+    // A block without an end-of-block code could never finish
+    if (lengths[END_OF_BLOCK] == 0) return false;
+    return BuildTable(literals, lengths, literalCount) && BuildTable(distances, lengths + literalCount, distanceCount);
+}
+
+void FixedTables(HuffmanTable& literals, HuffmanTable& distances) {
+    uint8_t lengths[288];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+    BuildTable(literals, lengths, 288);
+
+    memset(lengths, 5, DISTANCE_CODES);
+    BuildTable(distances, lengths, DISTANCE_CODES);
+}
+
+} // namespace
+
+void Deflate::Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out, size_t windowBits) {
+    windowBits = std::max(static_cast<size_t>(8), std::min(windowBits, MAX_WINDOW_BITS));
+    const size_t windowSize = static_cast<size_t>(1) << windowBits;
+    const size_t windowMask = windowSize - 1;
+
+    BitWriter writer(out);
+    std::vector<Symbol> symbols;
+    symbols.reserve(std::min(size, BLOCK_SYMBOLS));
+
+    // head: last position per hash; prev: previous position with the same hash (ring)
+    std::vector<int32_t> head(static_cast<size_t>(1) << HASH_BITS, -1);
+    std::vector<int32_t> prev(windowSize, -1);
+    auto hashAt = [&](size_t position) {
+        uint32_t value = data[position] | (data[position + 1] << 8) | (data[position + 2] << 16);
+        return (value * 2654435761U) >> (32 - HASH_BITS);
+    };
+    auto insert = [&](size_t position) {
+        if (position + MIN_MATCH > size) return;
+        uint32_t hash = hashAt(position);
+        prev[position & windowMask] = head[hash];
+        head[hash] = static_cast<int32_t>(position);
+    };
+
+    size_t position = 0;
+    while (position < size) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+
+        if (position + MIN_MATCH <= size) {
+            size_t maxLength = std::min(MAX_MATCH, size - position);
+            uint32_t hash = hashAt(position);
+            int32_t candidate = head[hash];
+            for (size_t chain = 0; candidate >= 0 && chain < MAX_CHAIN; chain++) {
+                size_t distance = position - static_cast<size_t>(candidate);
+                if (distance > windowSize) break;
+
+                // Only a candidate that could beat the best so far is compared in full
+                if (data[candidate + bestLength] == data[position + bestLength]) {
+                    size_t length = 0;
+                    while (length < maxLength && data[candidate + length] == data[position + length]) length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = distance;
+                        if (length == maxLength) break;
+                    }
+                }
+
+                int32_t next = prev[candidate & windowMask];
+                if (next >= candidate) break;   // Slot reused by a newer position
+                candidate = next;
+            }
+            prev[position & windowMask] = head[hash];
+            head[hash] = static_cast<int32_t>(position);
+        }
+
+        if (bestLength >= MIN_MATCH) {
+            symbols.push_back({ static_cast<uint16_t>(bestLength), static_cast<uint16_t>(bestDistance) });
+            if (bestLength <= INSERT_LIMIT) {
+                for (size_t p = position + 1; p < position + bestLength; p++) insert(p);
+            }
+            position += bestLength;
+        } else {
+            symbols.push_back({ data[position], 0 });
+            position++;
+        }
+
+        if (symbols.size() >= BLOCK_SYMBOLS) {
+            WriteBlock(writer, symbols);
+            symbols.clear();
+        }
+    }
+    if (!symbols.empty()) {
+        WriteBlock(writer, symbols);
+    }
+
+    // Sync flush: an empty non-final stored block. Its LEN/NLEN bytes (00 00 FF FF) are
+    // the tail permessage-deflate leaves off, so only the header bits are written.
+    writer.Put(0, 3);
+    writer.AlignToByte();
+}
+
+bool Deflate::Inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out, size_t maxOutput) {
+    out.clear();
+    BitReader reader(data, size);
+    HuffmanTable literals;
+    HuffmanTable distances;
+
+    bool final = false;
+    while (!final && !reader.AtEnd()) {
+        final = reader.Get(1) != 0;
+        uint32_t type = reader.Get(2);
+        if (reader.Overrun()) return false;
+
+        if (type == 0) {
+            reader.AlignToByte();
+            uint32_t length = reader.Get(16);
+            uint32_t inverted = reader.Get(16);
+            if (reader.Overrun() || length != (~inverted & 0xFFFF)) return false;
+            if (length > maxOutput - out.size() || !reader.CopyBytes(out, length)) return false;
+            continue;
+        }
+
+        if (type == 1) {
+            FixedTables(literals, distances);
+        } else if (type == 2) {
+            if (!ReadDynamicTables(reader, literals, distances)) return false;
+        } else {
+            return false;
+        }
+        if (!InflateCodes(reader, literals, distances, out, maxOutput)) return false;
+    }
+    return !reader.Overrun();
+}
+
+} // namespace InternalEngine
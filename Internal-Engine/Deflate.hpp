@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace InternalEngine {
+
+// 🗜️ DEFLATE (RFC 1951, raw - no zlib/gzip wrapper)
+// Just enough for WebSocket permessage-deflate (RFC 7692) without pulling in zlib:
+//  - Compress: greedy LZ77 over a hash table with a short chain (a fast level, in the
+//    spirit of zlib level 1-2) and one dynamic Huffman block per BLOCK_SYMBOLS symbols.
+//    The output ends with an empty stored block (a sync flush) whose 00 00 FF FF tail is
+//    left off, which is the message format permessage-deflate expects.
+//  - Inflate: stored, fixed and dynamic blocks, stopping at the end of input or the final
+//    block. RFC 7692 messages must get 00 00 FF FF appended before they are inflated.
+// Both work on one message at a time (no context takeover).
+class Deflate {
+public:
+    static const size_t MAX_WINDOW_BITS = 15;
+    static const size_t BLOCK_SYMBOLS = 64 * 1024;
+
+    // Appends the compressed form of data to out; matches reach back at most 1 << windowBits
+    static void Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out, size_t windowBits = MAX_WINDOW_BITS);
+
+    // Replaces out with the inflated data; false on malformed input or output above maxOutput
+    static bool Inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out, size_t maxOutput);
+};
+
+} // namespace InternalEngine
@@ -1,14 +1,253 @@
 #include "DetoursLite.hpp"
+#include "CodeIndex.hpp"
+#include <TlHelp32.h>
 #include <algorithm>
 #include <cstring>
+#include <unordered_set>
 
 namespace InternalEngine {
 
 // Static member definitions
-std::vector<DetoursLite::Trampoline> DetoursLite::trampolines;
+std::unordered_map<uintptr_t, DetoursLite::Trampoline> DetoursLite::trampolines;
 CRITICAL_SECTION DetoursLite::criticalSection;
 bool DetoursLite::initialized = false;
 
+// Trampoline slot layout: relocated original bytes + jump back, then (at RELAY_OFFSET) a
+// relay jump to the detour on x64 or the FF 25 address cell on x86
+static const size_t TRAMPOLINE_SLOT_SIZE = 64;
+static const size_t RELAY_OFFSET = 48;
+static const size_t MAX_STOLEN_BYTES = RELAY_OFFSET - 14;
+
+// 🧱 트램펄린 슬랩 할당기
+// Slots are carved from 64 KB slabs (one allocation granule) instead of one VirtualAlloc per
+// hook. On x64 a slab only serves targets within MAX_SLAB_DISTANCE, so every rel32 between
+// the target and its slot fits; a new slab is placed in the nearest free granule.
+// Slots that were ever reachable from hooked code are retired rather than freed: a thread
+// preempted inside the trampoline or the call counter stub, or returning into a relocated
+// call, still runs the old bytes, so the slot is only overwritten after QUARANTINE_MS.
+// Guarded by DetoursLite's critical section.
+class TrampolineSlabs {
+public:
+    static const size_t SLAB_SIZE = 64 * 1024;
+    static const size_t SLOTS_PER_SLAB = SLAB_SIZE / TRAMPOLINE_SLOT_SIZE;
+    static const ULONGLONG QUARANTINE_MS = 5000;
+
+    // Slot near target when possible (any slot otherwise); 0 when out of memory
+    uintptr_t Allocate(uintptr_t target) {
+        ReleaseRetired();
+        for (auto& slab : slabs) {
+            if (!slab.freeSlots.empty() && IsNear(slab.base, target)) {
+                return TakeSlot(slab);
+            }
+        }
+
+        uintptr_t base = AllocateSlabNear(target);
+        if (!base) {
+            // Far slot: the hook falls back to an absolute jump
+            for (auto& slab : slabs) {
+                if (!slab.freeSlots.empty()) return TakeSlot(slab);
+            }
+            base = reinterpret_cast<uintptr_t>(VirtualAlloc(nullptr, SLAB_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+            if (!base) return 0;
+        }
+
+        Slab slab;
+        slab.base = base;
+        slab.freeSlots.reserve(SLOTS_PER_SLAB);
+        for (size_t i = SLOTS_PER_SLAB; i > 0; i--) {
+            slab.freeSlots.push_back(static_cast<uint16_t>(i - 1));
+        }
+        slabs.push_back(std::move(slab));
+        return TakeSlot(slabs.back());
+    }
+
+    // Slot no thread can have entered (its patch was never written)
+    void Free(uintptr_t slot) {
+        for (size_t i = 0; i < slabs.size(); i++) {
+            Slab& slab = slabs[i];
+            if (slot < slab.base || slot >= slab.base + SLAB_SIZE) continue;
+
+            memset(reinterpret_cast<void*>(slot), 0xCC, TRAMPOLINE_SLOT_SIZE);
+            slab.freeSlots.push_back(static_cast<uint16_t>((slot - slab.base) / TRAMPOLINE_SLOT_SIZE));
+
+            // Give the granule back once every slot is free again
+            if (slab.freeSlots.size() == SLOTS_PER_SLAB) {
+                VirtualFree(reinterpret_cast<void*>(slab.base), 0, MEM_RELEASE);
+                slabs.erase(slabs.begin() + i);
+            }
+            return;
+        }
+    }
+
+    // Slot of a removed hook: kept intact until the quarantine is over
+    void Retire(uintptr_t slot) {
+        retired.push_back(RetiredSlot{ slot, GetTickCount64() });
+    }
+
+    // Every byte of the slab is reachable from target with a rel32 (always true on x86)
+    static bool IsNear(uintptr_t slabBase, uintptr_t target) {
+#ifdef _WIN64
+        int64_t distance = static_cast<int64_t>(slabBase - target);
+        return distance > -MAX_SLAB_DISTANCE && distance < MAX_SLAB_DISTANCE - static_cast<int64_t>(SLAB_SIZE);
+#else
+        (void)slabBase;
+        (void)target;
+        return true;
+#endif
+    }
+
+private:
+    // A little under 2 GB, leaving room for the stolen bytes on either side
+    static const int64_t MAX_SLAB_DISTANCE = 0x7FF00000;
+
+    struct Slab {
+        uintptr_t base;
+        std::vector<uint16_t> freeSlots;
+    };
+
+    struct RetiredSlot {
+        uintptr_t slot;
+        ULONGLONG retiredAt;
+    };
+
+    std::vector<Slab> slabs;
+    std::vector<RetiredSlot> retired;   // Oldest first
+
+    void ReleaseRetired() {
+        ULONGLONG now = GetTickCount64();
+        size_t expired = 0;
+        while (expired < retired.size() && now - retired[expired].retiredAt >= QUARANTINE_MS) {
+            Free(retired[expired].slot);
+            expired++;
+        }
+        retired.erase(retired.begin(), retired.begin() + expired);
+    }
+
+    static uintptr_t TakeSlot(Slab& slab) {
+        uint16_t index = slab.freeSlots.back();
+        slab.freeSlots.pop_back();
+        return slab.base + index * TRAMPOLINE_SLOT_SIZE;
+    }
+
+    static uintptr_t TryAllocateAt(uintptr_t address) {
+        MEMORY_BASIC_INFORMATION mbi;
+        if (VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) == 0) return 0;
+        if (mbi.State != MEM_FREE || mbi.RegionSize < SLAB_SIZE) return 0;
+        return reinterpret_cast<uintptr_t>(VirtualAlloc(reinterpret_cast<void*>(address), SLAB_SIZE,
+                                                        MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+    }
+
+    // Nearest free granule below the target, then above it; 0 if none is in range
+    static uintptr_t AllocateSlabNear(uintptr_t target) {
+#ifdef _WIN64
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        uintptr_t granularity = info.dwAllocationGranularity;
+        uintptr_t lowest = max(reinterpret_cast<uintptr_t>(info.lpMinimumApplicationAddress),
+                               target > static_cast<uintptr_t>(MAX_SLAB_DISTANCE) ? target - MAX_SLAB_DISTANCE : 0);
+        uintptr_t highest = min(reinterpret_cast<uintptr_t>(info.lpMaximumApplicationAddress),
+                                target + static_cast<uintptr_t>(MAX_SLAB_DISTANCE - SLAB_SIZE));
+
+        uintptr_t address = target - (target % granularity);
+        while (address >= lowest + granularity) {
+            address -= granularity;
+            if (!IsNear(address, target)) break;
+            if (uintptr_t slab = TryAllocateAt(address)) return slab;
+        }
+
+        address = target - (target % granularity);
+        while (address + granularity < highest) {
+            address += granularity;
+            if (!IsNear(address, target)) break;
+
+            MEMORY_BASIC_INFORMATION mbi;
+            if (VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) == 0) break;
+            if (mbi.State == MEM_FREE) {
+                if (uintptr_t slab = TryAllocateAt(address)) return slab;
+            } else {
+                // Skip the rest of an allocated region in one step
+                uintptr_t regionEnd = reinterpret_cast<uintptr_t>(mbi.BaseAddress) + mbi.RegionSize;
+                if (regionEnd > address + granularity) {
+                    address = regionEnd - (regionEnd % granularity);
+                }
+            }
+        }
+        return 0;
+#else
+        (void)target;
+        return reinterpret_cast<uintptr_t>(VirtualAlloc(nullptr, SLAB_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+#endif
+    }
+};
+
+static TrampolineSlabs g_trampolineSlabs;
+
+// ❄️ 스레드 일시 정지
+// Suspends every other thread of the process for the lifetime of the object. A suspended
+// thread may hold the heap lock, so nothing may allocate until the destructor has run;
+// thread handles are collected before the first SuspendThread.
+class ThreadFreezer {
+public:
+    ThreadFreezer() {
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot == INVALID_HANDLE_VALUE) return;
+
+        DWORD processId = GetCurrentProcessId();
+        DWORD currentThreadId = GetCurrentThreadId();
+        THREADENTRY32 entry;
+        entry.dwSize = sizeof(entry);
+        if (Thread32First(snapshot, &entry)) {
+            do {
+                if (entry.th32OwnerProcessID != processId || entry.th32ThreadID == currentThreadId) continue;
+                HANDLE thread = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT,
+                                           FALSE, entry.th32ThreadID);
+                if (thread) threads.push_back(thread);
+            } while (Thread32Next(snapshot, &entry));
+        }
+        CloseHandle(snapshot);
+
+        for (HANDLE& thread : threads) {
+            if (SuspendThread(thread) == static_cast<DWORD>(-1)) {
+                CloseHandle(thread);
+                thread = nullptr;
+            }
+        }
+    }
+
+    ~ThreadFreezer() {
+        for (HANDLE thread : threads) {
+            if (!thread) continue;
+            ResumeThread(thread);
+            CloseHandle(thread);
+        }
+    }
+
+    // Threads stopped in [from, from + size) continue at the same offset from to. Installing
+    // moves them from the overwritten bytes into the trampoline's copy; restoring moves them
+    // from the copy (and the jump back right after it) to the original bytes.
+    void RedirectThreads(uintptr_t from, size_t size, uintptr_t to) {
+        for (HANDLE thread : threads) {
+            if (!thread) continue;
+
+            CONTEXT context;
+            context.ContextFlags = CONTEXT_CONTROL;
+            if (!GetThreadContext(thread, &context)) continue;
+#ifdef _WIN64
+            DWORD64& ip = context.Rip;
+#else
+            DWORD& ip = context.Eip;
+#endif
+            if (ip >= from && ip < from + size) {
+                ip = to + (ip - from);
+                SetThreadContext(thread, &context);
+            }
+        }
+    }
+
+private:
+    std::vector<HANDLE> threads;
+};
+
 void DetoursLite::Initialize() {
     if (!initialized) {
         InitializeCriticalSection(&criticalSection);
@@ -24,22 +263,82 @@ void DetoursLite::Cleanup() {
 }
 
 bool DetoursLite::InstallHook(uintptr_t targetFunction, uintptr_t detourFunction, uintptr_t* originalFunction, HookType type) {
+    std::vector<uintptr_t> originals;
+    InstallHooks({ HookRequest{ targetFunction, detourFunction, type } }, originals);
+    
+    if (originals[0] == 0) {
+        return false;
+    }
+    if (originalFunction) {
+        *originalFunction = originals[0];
+    }
+    return true;
+}
+
+size_t DetoursLite::InstallHooks(const std::vector<HookRequest>& requests, std::vector<uintptr_t>& originals) {
     Initialize();
     EnterCriticalSection(&criticalSection);
     
-    // Check if already hooked
-    if (IsHooked(targetFunction)) {
-        LeaveCriticalSection(&criticalSection);
+    originals.assign(requests.size(), 0);
+    std::vector<Trampoline> prepared(requests.size());
+    std::vector<bool> ready(requests.size(), false);
+    std::unordered_set<uintptr_t> batchTargets;
+    
+    // Build every trampoline first; the hooked code is untouched until all are ready
+    for (size_t i = 0; i < requests.size(); i++) {
+        uintptr_t target = requests[i].targetFunction;
+        if (trampolines.count(target) || !batchTargets.insert(target).second) continue;
+        ready[i] = PrepareHook(requests[i], prepared[i]);
+    }
+    
+    // One suspension for the whole batch (no allocation inside this block)
+    if (std::find(ready.begin(), ready.end(), true) != ready.end()) {
+        ThreadFreezer freezer;
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (!ready[i]) continue;
+            const Trampoline& tramp = prepared[i];
+            ready[i] = WritePatch(tramp.originalFunction, tramp.patchBytes);
+            if (ready[i]) {
+                freezer.RedirectThreads(tramp.originalFunction, tramp.originalSize, tramp.trampolineAddress);
+            }
+        }
+    }
+    
+    size_t installed = 0;
+    for (size_t i = 0; i < requests.size(); i++) {
+        Trampoline& tramp = prepared[i];
+        if (ready[i]) {
+            originals[i] = tramp.trampolineAddress;
+            trampolines.emplace(tramp.originalFunction, std::move(tramp));
+            installed++;
+        } else if (tramp.trampolineAddress) {
+            g_trampolineSlabs.Free(tramp.trampolineAddress);
+        }
+    }
+    
+    LeaveCriticalSection(&criticalSection);
+    return installed;
+}
+
+// Copies the stolen instructions into a slab slot and encodes the patch; on failure the
+// slot is released again and trampoline.trampolineAddress stays 0
+bool DetoursLite::PrepareHook(const HookRequest& request, Trampoline& trampoline) {
+    uintptr_t target = request.targetFunction;
+    uintptr_t slot = g_trampolineSlabs.Allocate(target);
+    if (slot == 0) {
         return false;
     }
+    bool nearSlot = TrampolineSlabs::IsNear(slot - (slot % TrampolineSlabs::SLAB_SIZE), target);
     
-    // Auto-select hook type
+    // Auto-select hook type: rel32 whenever the slot (or the detour) is reachable
+    HookType type = request.type;
     if (type == HookType::AUTO) {
-        if (is64Bit) {
-            type = HookType::JMP_ABSOLUTE;
-        } else {
-            type = HookType::JMP_RELATIVE;
-        }
+        type = (nearSlot || IsRel32Reachable(target + 5, request.detourFunction)) ? HookType::JMP_RELATIVE : HookType::JMP_ABSOLUTE;
+    }
+    if ((type == HookType::JMP_RELATIVE && !nearSlot && !IsRel32Reachable(target + 5, request.detourFunction)) ||
+        (type == HookType::PUSH_RET && is64Bit)) {
+        g_trampolineSlabs.Free(slot);
+        return false;
     }
     
     size_t hookSize = CalculateHookSize(type);
@@ -47,102 +346,211 @@ bool DetoursLite::InstallHook(uintptr_t targetFunction, uintptr_t detourFunction
     // Calculate minimum bytes to copy
     size_t bytesToCopy = 0;
     while (bytesToCopy < hookSize) {
-        size_t instructionLength = GetInstructionLength(targetFunction + bytesToCopy);
-        if (instructionLength == 0) {
-            LeaveCriticalSection(&criticalSection);
+        size_t instructionLength = GetInstructionLength(target + bytesToCopy);
+        if (instructionLength == 0 || bytesToCopy + instructionLength > MAX_STOLEN_BYTES) {
+            g_trampolineSlabs.Free(slot);
             return false;
         }
         bytesToCopy += instructionLength;
     }
     
-    // Create trampoline
-    uintptr_t trampolineAddr = CreateTrampoline(targetFunction, bytesToCopy);
-    if (trampolineAddr == 0) {
-        LeaveCriticalSection(&criticalSection);
-        return false;
-    }
-    
     // Save original bytes
-    std::vector<uint8_t> originalBytes(bytesToCopy);
-    memcpy(originalBytes.data(), reinterpret_cast<void*>(targetFunction), bytesToCopy);
+    trampoline.originalBytes.resize(bytesToCopy);
+    memcpy(trampoline.originalBytes.data(), reinterpret_cast<void*>(target), bytesToCopy);
     
     // Build trampoline
-    BuildTrampoline(reinterpret_cast<uint8_t*>(trampolineAddr), originalBytes.data(), 
-                    bytesToCopy, targetFunction, trampolineAddr);
+    if (!BuildTrampoline(reinterpret_cast<uint8_t*>(slot), trampoline.originalBytes.data(), bytesToCopy, target, slot)) {
+        g_trampolineSlabs.Free(slot);
+        return false;
+    }
     
-    // Install hook
-    DWORD oldProtect;
-    if (!SetMemoryProtection(targetFunction, hookSize, PAGE_EXECUTE_READWRITE, &oldProtect)) {
-        VirtualFree(reinterpret_cast<void*>(trampolineAddr), 0, MEM_RELEASE);
-        LeaveCriticalSection(&criticalSection);
+    trampoline.originalFunction = target;
+    trampoline.detourFunction = request.detourFunction;
+    trampoline.trampolineAddress = slot;
+    trampoline.originalSize = bytesToCopy;
+    trampoline.type = type;
+    if (!EncodePatch(trampoline)) {
+        g_trampolineSlabs.Free(slot);
+        trampoline.trampolineAddress = 0;
         return false;
     }
     
-    bool success = false;
-    switch (type) {
+    trampoline.isActive = true;
+    FlushInstructionCache(GetCurrentProcess(), reinterpret_cast<void*>(slot), TRAMPOLINE_SLOT_SIZE);
+    return true;
+}
+
+// Patch: the jump (to the call counter stub when one is set), then NOPs over the rest of
+// the stolen instructions. A rel32 hook that cannot reach its destination goes through a
+// relay in the trampoline slot.
+bool DetoursLite::EncodePatch(Trampoline& trampoline) {
+    uintptr_t target = trampoline.originalFunction;
+    uintptr_t relay = trampoline.trampolineAddress + RELAY_OFFSET;
+    uintptr_t destination = trampoline.callCounter ? trampoline.counterStub : trampoline.detourFunction;
+    if (trampoline.type == HookType::JMP_RELATIVE && !IsRel32Reachable(target + 5, destination)) {
+        if (!is64Bit) return false;
+        EncodeJumpAbsolute(reinterpret_cast<uint8_t*>(relay), destination, 0);
+        destination = relay;
+    }
+    
+    trampoline.patchBytes.assign(trampoline.originalSize, 0x90);
+    size_t written = 0;
+    switch (trampoline.type) {
         case HookType::JMP_RELATIVE:
-            success = WriteJumpRelative(targetFunction, detourFunction);
+            written = EncodeJumpRelative(trampoline.patchBytes.data(), target, destination);
             break;
         case HookType::JMP_ABSOLUTE:
-            success = WriteJumpAbsolute(targetFunction, detourFunction);
+            written = EncodeJumpAbsolute(trampoline.patchBytes.data(), destination, relay);
             break;
         case HookType::PUSH_RET:
-            success = WritePushRet(targetFunction, detourFunction);
+            written = EncodePushRet(trampoline.patchBytes.data(), destination);
+            break;
+        default:
             break;
     }
+    return written != 0;
+}
+
+// 📊 호출 카운터 스텁
+// The stub bumps the counter and falls through to the detour; no register or flag that a
+// function entry must preserve is touched (x64 saves RAX around the increment).
+size_t DetoursLite::EncodeCounterStub(uint8_t* buffer, uintptr_t location, volatile uint64_t* counter, uintptr_t to) {
+    uintptr_t counterAddress = reinterpret_cast<uintptr_t>(counter);
+    size_t size = 0;
     
-    // Fill remaining bytes with NOPs
-    if (success && bytesToCopy > hookSize) {
-        memset(reinterpret_cast<void*>(targetFunction + hookSize), 0x90, bytesToCopy - hookSize);
+    if (is64Bit) {
+        buffer[size++] = 0x50;                          // push rax
+        buffer[size++] = 0x48;                          // mov rax, imm64
+        buffer[size++] = 0xB8;
+        memcpy(&buffer[size], &counterAddress, sizeof(uintptr_t));
+        size += 8;
+        const uint8_t increment[] = { 0xF0, 0x48, 0xFF, 0x00 }; // lock inc qword ptr [rax]
+        memcpy(&buffer[size], increment, sizeof(increment));
+        size += sizeof(increment);
+        buffer[size++] = 0x58;                          // pop rax
+    } else {
+        // lock add dword ptr [counter], 1 / lock adc dword ptr [counter + 4], 0
+        uint32_t low = static_cast<uint32_t>(counterAddress);
+        uint32_t high = low + 4;
+        const uint8_t add[] = { 0xF0, 0x83, 0x05 };
+        const uint8_t adc[] = { 0xF0, 0x83, 0x15 };
+        memcpy(&buffer[size], add, sizeof(add));
+        memcpy(&buffer[size + 3], &low, sizeof(uint32_t));
+        buffer[size + 7] = 0x01;
+        size += 8;
+        memcpy(&buffer[size], adc, sizeof(adc));
+        memcpy(&buffer[size + 3], &high, sizeof(uint32_t));
+        buffer[size + 7] = 0x00;
+        size += 8;
+    }
+    
+    size_t jump = EncodeJumpRelative(&buffer[size], location + size, to);
+    if (jump == 0) {
+        jump = EncodeJumpAbsolute(&buffer[size], to, 0);
+    }
+    return jump ? size + jump : 0;
+}
+
+bool DetoursLite::SetCallCounter(uintptr_t targetFunction, volatile uint64_t* counter) {
+    Initialize();
+    EnterCriticalSection(&criticalSection);
+    
+    auto it = trampolines.find(targetFunction);
+    if (it == trampolines.end()) {
+        LeaveCriticalSection(&criticalSection);
+        return false;
+    }
+    
+    Trampoline& tramp = it->second;
+    if (tramp.callCounter == counter) {
+        LeaveCriticalSection(&criticalSection);
+        return true;
     }
     
-    SetMemoryProtection(targetFunction, hookSize, oldProtect);
+    // A live stub is never rewritten: switch it off first
+    if (counter && tramp.callCounter) {
+        LeaveCriticalSection(&criticalSection);
+        return false;
+    }
     
-    if (success) {
-        // Store trampoline info
-        Trampoline tramp;
-        tramp.originalFunction = targetFunction;
-        tramp.trampolineAddress = trampolineAddr;
-        tramp.originalSize = bytesToCopy;
-        tramp.originalBytes = originalBytes;
-        tramp.isActive = true;
-        trampolines.push_back(tramp);
-        
-        if (originalFunction) {
-            *originalFunction = trampolineAddr;
+    if (counter) {
+        if (!tramp.counterStub) {
+            tramp.counterStub = g_trampolineSlabs.Allocate(targetFunction);
         }
-    } else {
-        VirtualFree(reinterpret_cast<void*>(trampolineAddr), 0, MEM_RELEASE);
+        if (!tramp.counterStub ||
+            !EncodeCounterStub(reinterpret_cast<uint8_t*>(tramp.counterStub), tramp.counterStub, counter, tramp.detourFunction)) {
+            LeaveCriticalSection(&criticalSection);
+            return false;
+        }
+        FlushInstructionCache(GetCurrentProcess(), reinterpret_cast<void*>(tramp.counterStub), TRAMPOLINE_SLOT_SIZE);
+    }
+    
+    volatile uint64_t* previous = tramp.callCounter;
+    tramp.callCounter = counter;
+    if (!EncodePatch(tramp)) {
+        tramp.callCounter = previous;
+        EncodePatch(tramp);
+        LeaveCriticalSection(&criticalSection);
+        return false;
+    }
+    
+    // The stub slot is kept after switching off (a thread may still be inside it) and
+    // released with the hook
+    bool success = true;
+    if (tramp.isActive) {
+        ThreadFreezer freezer;
+        success = WritePatch(targetFunction, tramp.patchBytes);
     }
     
     LeaveCriticalSection(&criticalSection);
     return success;
 }
 
+bool DetoursLite::WritePatch(uintptr_t address, const std::vector<uint8_t>& bytes) {
+    DWORD oldProtect;
+    if (!SetMemoryProtection(address, bytes.size(), PAGE_EXECUTE_READWRITE, &oldProtect)) {
+        return false;
+    }
+    
+    memcpy(reinterpret_cast<void*>(address), bytes.data(), bytes.size());
+    SetMemoryProtection(address, bytes.size(), oldProtect);
+    FlushInstructionCache(GetCurrentProcess(), reinterpret_cast<void*>(address), bytes.size());
+    CodeIndex::NotifyWrite(address, bytes.size());
+    return true;
+}
+
+// Writes the original bytes back with the other threads suspended; a thread stopped in the
+// trampoline's copy of them (or on its jump back) resumes in the original
+bool DetoursLite::RestoreOriginal(const Trampoline& trampoline) {
+    ThreadFreezer freezer;
+    if (!WritePatch(trampoline.originalFunction, trampoline.originalBytes)) {
+        return false;
+    }
+    freezer.RedirectThreads(trampoline.trampolineAddress, trampoline.originalSize + 1, trampoline.originalFunction);
+    return true;
+}
+
 bool DetoursLite::RemoveHook(uintptr_t targetFunction) {
     Initialize();
     EnterCriticalSection(&criticalSection);
     
-    auto it = std::find_if(trampolines.begin(), trampolines.end(),
-        [targetFunction](const Trampoline& t) { return t.originalFunction == targetFunction; });
-    
+    auto it = trampolines.find(targetFunction);
     if (it == trampolines.end()) {
         LeaveCriticalSection(&criticalSection);
         return false;
     }
     
     // Restore original bytes
-    DWORD oldProtect;
-    if (!SetMemoryProtection(targetFunction, it->originalSize, PAGE_EXECUTE_READWRITE, &oldProtect)) {
+    if (it->second.isActive && !RestoreOriginal(it->second)) {
         LeaveCriticalSection(&criticalSection);
         return false;
     }
     
-    memcpy(reinterpret_cast<void*>(targetFunction), it->originalBytes.data(), it->originalSize);
-    SetMemoryProtection(targetFunction, it->originalSize, oldProtect);
-    
-    // Free trampoline memory
-    VirtualFree(reinterpret_cast<void*>(it->trampolineAddress), 0, MEM_RELEASE);
+    // The slots go back to their slab once no thread can still be inside them
+    g_trampolineSlabs.Retire(it->second.trampolineAddress);
+    if (it->second.counterStub) {
+        g_trampolineSlabs.Retire(it->second.counterStub);
+    }
     
     // Remove from list
     trampolines.erase(it);
@@ -155,54 +563,55 @@ bool DetoursLite::EnableHook(uintptr_t targetFunction) {
     Initialize();
     EnterCriticalSection(&criticalSection);
     
-    auto it = std::find_if(trampolines.begin(), trampolines.end(),
-        [targetFunction](const Trampoline& t) { return t.originalFunction == targetFunction; });
-    
-    if (it == trampolines.end() || it->isActive) {
+    auto it = trampolines.find(targetFunction);
+    if (it == trampolines.end() || it->second.isActive) {
         LeaveCriticalSection(&criticalSection);
         return false;
     }
     
-    it->isActive = true;
-    // Re-install hook logic here
+    // Re-apply the saved jump
+    bool success;
+    {
+        ThreadFreezer freezer;
+        const Trampoline& tramp = it->second;
+        success = WritePatch(targetFunction, tramp.patchBytes);
+        if (success) {
+            freezer.RedirectThreads(targetFunction, tramp.originalSize, tramp.trampolineAddress);
+        }
+    }
+    if (success) {
+        it->second.isActive = true;
+    }
     
     LeaveCriticalSection(&criticalSection);
-    return true;
+    return success;
 }
 
 bool DetoursLite::DisableHook(uintptr_t targetFunction) {
     Initialize();
     EnterCriticalSection(&criticalSection);
     
-    auto it = std::find_if(trampolines.begin(), trampolines.end(),
-        [targetFunction](const Trampoline& t) { return t.originalFunction == targetFunction; });
-    
-    if (it == trampolines.end() || !it->isActive) {
+    auto it = trampolines.find(targetFunction);
+    if (it == trampolines.end() || !it->second.isActive) {
         LeaveCriticalSection(&criticalSection);
         return false;
     }
     
     // Restore original bytes temporarily
-    DWORD oldProtect;
-    if (!SetMemoryProtection(targetFunction, it->originalSize, PAGE_EXECUTE_READWRITE, &oldProtect)) {
-        LeaveCriticalSection(&criticalSection);
-        return false;
+    bool success = RestoreOriginal(it->second);
+    if (success) {
+        it->second.isActive = false;
     }
     
-    memcpy(reinterpret_cast<void*>(targetFunction), it->originalBytes.data(), it->originalSize);
-    SetMemoryProtection(targetFunction, it->originalSize, oldProtect);
-    
-    it->isActive = false;
-    
     LeaveCriticalSection(&criticalSection);
-    return true;
+    return success;
 }
 
 bool DetoursLite::IsHooked(uintptr_t address) {
+    Initialize();
     EnterCriticalSection(&criticalSection);
     
-    bool found = std::any_of(trampolines.begin(), trampolines.end(),
-        [address](const Trampoline& t) { return t.originalFunction == address; });
+    bool found = trampolines.count(address) != 0;
     
     LeaveCriticalSection(&criticalSection);
     return found;
@@ -211,11 +620,12 @@ bool DetoursLite::IsHooked(uintptr_t address) {
 std::vector<uintptr_t> DetoursLite::GetActiveHooks() {
     std::vector<uintptr_t> activeHooks;
     
+    Initialize();
     EnterCriticalSection(&criticalSection);
     
-    for (const auto& tramp : trampolines) {
-        if (tramp.isActive) {
-            activeHooks.push_back(tramp.originalFunction);
+    for (const auto& pair : trampolines) {
+        if (pair.second.isActive) {
+            activeHooks.push_back(pair.first);
         }
     }
     
@@ -224,7 +634,7 @@ std::vector<uintptr_t> DetoursLite::GetActiveHooks() {
 }
 
 size_t DetoursLite::GetInstructionLength(uintptr_t address) {
-    return LengthDisassembler::GetLength(reinterpret_cast<const uint8_t*>(address));
+    return X86Decoder::GetLength(reinterpret_cast<const uint8_t*>(address));
 }
 
 size_t DetoursLite::CalculateHookSize(HookType type) {
@@ -240,72 +650,51 @@ size_t DetoursLite::CalculateHookSize(HookType type) {
     }
 }
 
-bool DetoursLite::WriteJumpRelative(uintptr_t from, uintptr_t to) {
-    uint8_t jump[5];
-    jump[0] = 0xE9; // JMP rel32
-    
-    int32_t offset = CalculateRelativeOffset(from + 5, to);
-    memcpy(&jump[1], &offset, sizeof(int32_t));
+size_t DetoursLite::EncodeJumpRelative(uint8_t* buffer, uintptr_t location, uintptr_t to) {
+    if (!IsRel32Reachable(location + 5, to)) {
+        return 0;
+    }
     
-    memcpy(reinterpret_cast<void*>(from), jump, sizeof(jump));
-    return true;
+    buffer[0] = 0xE9; // JMP rel32
+    int32_t offset = CalculateRelativeOffset(location + 5, to);
+    memcpy(&buffer[1], &offset, sizeof(int32_t));
+    return 5;
 }
 
-bool DetoursLite::WriteJumpAbsolute(uintptr_t from, uintptr_t to) {
+size_t DetoursLite::EncodeJumpAbsolute(uint8_t* buffer, uintptr_t to, uintptr_t addressCell) {
     if (is64Bit) {
         // x64: FF 25 00 00 00 00 [8 bytes absolute address]
-        uint8_t jump[14];
-        jump[0] = 0xFF;
-        jump[1] = 0x25;
-        memset(&jump[2], 0, 4);
-        memcpy(&jump[6], &to, sizeof(uintptr_t));
-        
-        memcpy(reinterpret_cast<void*>(from), jump, sizeof(jump));
-    } else {
-        // x86: FF 25 [4 bytes absolute address]
-        uint8_t jump[6];
-        jump[0] = 0xFF;
-        jump[1] = 0x25;
-        
-        uintptr_t* addressPtr = reinterpret_cast<uintptr_t*>(&jump[2]);
-        *addressPtr = reinterpret_cast<uintptr_t>(&to);
-        
-        memcpy(reinterpret_cast<void*>(from), jump, sizeof(jump));
+        buffer[0] = 0xFF;
+        buffer[1] = 0x25;
+        memset(&buffer[2], 0, 4);
+        memcpy(&buffer[6], &to, sizeof(uintptr_t));
+        return 14;
     }
-    return true;
+    
+    // x86: FF 25 [4 bytes address of a cell holding the destination]
+    if (addressCell == 0) {
+        return 0;
+    }
+    memcpy(reinterpret_cast<void*>(addressCell), &to, sizeof(uintptr_t));
+    buffer[0] = 0xFF;
+    buffer[1] = 0x25;
+    memcpy(&buffer[2], &addressCell, sizeof(uint32_t));
+    return 6;
 }
 
-bool DetoursLite::WritePushRet(uintptr_t from, uintptr_t to) {
+size_t DetoursLite::EncodePushRet(uint8_t* buffer, uintptr_t to) {
     if (is64Bit) {
         // x64 doesn't support direct PUSH imm64, use MOV + PUSH
-        return false;
-    } else {
-        uint8_t jump[6];
-        jump[0] = 0x68; // PUSH imm32
-        memcpy(&jump[1], &to, sizeof(uint32_t));
-        jump[5] = 0xC3; // RET
-        
-        memcpy(reinterpret_cast<void*>(from), jump, sizeof(jump));
-        return true;
-    }
-}
-
-uintptr_t DetoursLite::CreateTrampoline(uintptr_t originalFunction, size_t hookSize) {
-    // Allocate memory for trampoline (original bytes + jump back)
-    size_t trampolineSize = hookSize + (is64Bit ? 14 : 5);
-    
-    void* trampolineMemory = VirtualAlloc(nullptr, trampolineSize, 
-                                         MEM_COMMIT | MEM_RESERVE, 
-                                         PAGE_EXECUTE_READWRITE);
-    
-    if (!trampolineMemory) {
         return 0;
     }
     
-    return reinterpret_cast<uintptr_t>(trampolineMemory);
+    buffer[0] = 0x68; // PUSH imm32
+    memcpy(&buffer[1], &to, sizeof(uint32_t));
+    buffer[5] = 0xC3; // RET
+    return 6;
 }
 
-void DetoursLite::BuildTrampoline(uint8_t* trampolineBuffer, const uint8_t* originalBytes, 
+bool DetoursLite::BuildTrampoline(uint8_t* trampolineBuffer, const uint8_t* originalBytes, 
                                   size_t originalSize, uintptr_t originalAddress, 
                                   uintptr_t trampolineAddress) {
     // Copy original bytes
@@ -313,31 +702,44 @@ void DetoursLite::BuildTrampoline(uint8_t* trampolineBuffer, const uint8_t* orig
     
     // Relocate instructions if necessary
     for (size_t i = 0; i < originalSize; ) {
-        size_t instructionLength = LengthDisassembler::GetLength(&trampolineBuffer[i]);
-        RelocateInstruction(&trampolineBuffer[i], originalAddress + i, trampolineAddress + i);
-        i += instructionLength;
+        X86Instruction instruction;
+        if (!X86Decoder::Decode(&originalBytes[i], originalSize - i, originalAddress + i, is64Bit, instruction) ||
+            !RelocateInstruction(&trampolineBuffer[i], instruction, trampolineAddress + i, originalAddress, originalSize)) {
+            return false;
+        }
+        i += instruction.length;
     }
     
-    // Add jump back to original function + hookSize
+    // Add jump back to original function + hookSize (absolute if the slot is far away)
     uintptr_t jumpBackAddress = originalAddress + originalSize;
-    WriteJumpRelative(trampolineAddress + originalSize, jumpBackAddress);
+    uintptr_t jumpLocation = trampolineAddress + originalSize;
+    return EncodeJumpRelative(&trampolineBuffer[originalSize], jumpLocation, jumpBackAddress) != 0 ||
+           EncodeJumpAbsolute(&trampolineBuffer[originalSize], jumpBackAddress, 0) != 0;
 }
 
-bool DetoursLite::RelocateInstruction(uint8_t* instruction, uintptr_t oldAddress, uintptr_t newAddress) {
-    // Check for relative jumps/calls
-    if (instruction[0] == 0xE8 || instruction[0] == 0xE9) { // CALL/JMP rel32
-        int32_t* offset = reinterpret_cast<int32_t*>(&instruction[1]);
-        uintptr_t targetAddress = oldAddress + 5 + *offset;
-        *offset = CalculateRelativeOffset(newAddress + 5, targetAddress);
-        return true;
+bool DetoursLite::RelocateInstruction(uint8_t* code, const X86Instruction& instruction, uintptr_t newAddress,
+                                      uintptr_t stolenStart, size_t stolenSize) {
+    uintptr_t next = newAddress + instruction.length;
+    
+    // Relative jumps/calls (rel8, rel32, jcc, loop, ...)
+    if (instruction.flags & X86_FLAG_RELATIVE) {
+        if (instruction.target >= stolenStart && instruction.target < stolenStart + stolenSize) {
+            return true; // Lands in the copied bytes: same offset inside the trampoline
+        }
+        if (instruction.immSize != 4 || !IsRel32Reachable(next, instruction.target)) {
+            return false;
+        }
+        int32_t offset = CalculateRelativeOffset(next, instruction.target);
+        memcpy(&code[instruction.immOffset], &offset, sizeof(offset));
     }
     
-    // Check for conditional jumps (0x0F 0x8X)
-    if (instruction[0] == 0x0F && (instruction[1] & 0xF0) == 0x80) {
-        int32_t* offset = reinterpret_cast<int32_t*>(&instruction[2]);
-        uintptr_t targetAddress = oldAddress + 6 + *offset;
-        *offset = CalculateRelativeOffset(newAddress + 6, targetAddress);
-        return true;
+    // RIP-relative memory operands (mov rax, [rip+x], lea, cmp, ...)
+    if (instruction.flags & X86_FLAG_RIP_RELATIVE) {
+        if (!IsRel32Reachable(next, instruction.target)) {
+            return false;
+        }
+        int32_t displacement = CalculateRelativeOffset(next, instruction.target);
+        memcpy(&code[instruction.dispOffset], &displacement, sizeof(displacement));
     }
     
     return true;
@@ -347,141 +749,15 @@ int32_t DetoursLite::CalculateRelativeOffset(uintptr_t from, uintptr_t to) {
     return static_cast<int32_t>(to - from);
 }
 
+bool DetoursLite::IsRel32Reachable(uintptr_t from, uintptr_t to) {
+    intptr_t distance = static_cast<intptr_t>(to - from);
+    return distance == static_cast<int32_t>(distance);
+}
+
 bool DetoursLite::SetMemoryProtection(uintptr_t address, size_t size, DWORD protection, DWORD* oldProtection) {
     DWORD temp;
     return VirtualProtect(reinterpret_cast<void*>(address), size, protection, 
                          oldProtection ? oldProtection : &temp) != 0;
 }
 
-// LengthDisassembler implementation
-size_t LengthDisassembler::GetLength(const uint8_t* data) {
-    size_t offset = 0;
-    bool hasRex = false;
-    
-    // Skip prefixes
-    while (IsPrefix(data[offset])) {
-        if (IsRexPrefix(data[offset])) {
-            hasRex = true;
-        }
-        offset++;
-    }
-    
-    // Get opcode size and total instruction length
-    size_t opcodeSize = GetOpcodeSize(&data[offset], hasRex);
-    return offset + opcodeSize;
-}
-
-bool LengthDisassembler::IsPrefix(uint8_t byte) {
-    // Segment override prefixes
-    if (byte == 0x26 || byte == 0x2E || byte == 0x36 || byte == 0x3E ||
-        byte == 0x64 || byte == 0x65) {
-        return true;
-    }
-    
-    // Operand-size override
-    if (byte == 0x66) return true;
-    
-    // Address-size override
-    if (byte == 0x67) return true;
-    
-    // LOCK, REP, REPNE
-    if (byte == 0xF0 || byte == 0xF2 || byte == 0xF3) return true;
-    
-    // REX prefixes (x64 only)
-    if ((byte & 0xF0) == 0x40) return true;
-    
-    return false;
-}
-
-bool LengthDisassembler::IsRexPrefix(uint8_t byte) {
-    return (byte & 0xF0) == 0x40;
-}
-
-size_t LengthDisassembler::GetOpcodeSize(const uint8_t* data, bool hasRex) {
-    uint8_t opcode = data[0];
-    size_t size = 1;
-    
-    // Two-byte opcodes
-    if (opcode == 0x0F) {
-        opcode = data[1];
-        size = 2;
-        
-        // Three-byte opcodes
-        if (opcode == 0x38 || opcode == 0x3A) {
-            size = 3;
-        }
-    }
-    
-    // Simple opcodes without ModRM
-    if ((opcode >= 0x50 && opcode <= 0x5F) || // PUSH/POP
-        (opcode >= 0x90 && opcode <= 0x97) || // XCHG/NOP
-        (opcode >= 0xA0 && opcode <= 0xA3)) { // MOV AL/AX/EAX
-        return size;
-    }
-    
-    // Immediate values
-    if (opcode == 0xE8 || opcode == 0xE9) { // CALL/JMP rel32
-        return size + 4;
-    }
-    
-    if (opcode == 0xEB) { // JMP rel8
-        return size + 1;
-    }
-    
-    // Instructions with ModRM byte
-    bool hasModRM = false;
-    if ((opcode & 0xFC) == 0x80 || // Group 1
-        (opcode & 0xFE) == 0x88 || // MOV
-        (opcode & 0xFC) == 0x8C || // MOV seg
-        (opcode & 0xFE) == 0xC6 || // MOV imm
-        (opcode & 0xFC) == 0xD0 || // Shift group
-        (opcode & 0xFE) == 0xF6 || // Group 3
-        (opcode & 0xFE) == 0xFE) { // INC/DEC group
-        hasModRM = true;
-    }
-    
-    if (hasModRM) {
-        uint8_t modRM = data[size];
-        size++;
-        size += GetModRMSize(modRM, hasRex);
-        
-        // Check for immediate values after ModRM
-        if ((opcode & 0xFC) == 0x80 || (opcode & 0xFE) == 0xC6) {
-            if ((opcode & 1) == 0) {
-                size += 1; // 8-bit immediate
-            } else {
-                size += 4; // 32-bit immediate
-            }
-        }
-    }
-    
-    return size;
-}
-
-size_t LengthDisassembler::GetModRMSize(uint8_t modRM, bool hasRex) {
-    uint8_t mod = (modRM >> 6) & 0x03;
-    uint8_t rm = modRM & 0x07;
-    size_t size = 0;
-    
-    if (mod == 0x00) {
-        if (rm == 0x05) {
-            size += 4; // disp32
-        } else if (rm == 0x04) {
-            size += 1; // SIB byte
-        }
-    } else if (mod == 0x01) {
-        size += 1; // disp8
-        if (rm == 0x04) {
-            size += 1; // SIB byte
-        }
-    } else if (mod == 0x02) {
-        size += 4; // disp32
-        if (rm == 0x04) {
-            size += 1; // SIB byte
-        }
-    }
-    
-    return size;
-}
-
 } // namespace InternalEngine
\ No newline at end of file
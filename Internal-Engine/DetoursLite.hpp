@@ -2,33 +2,54 @@
 #include <Windows.h>
 #include <cstdint>
 #include <vector>
+#include <unordered_map>
+#include "X86Decoder.hpp"
 
 namespace InternalEngine {
 
 // x86/x64 compatible Detours implementation
+// Trampolines come from shared 64 KB slabs placed within ±2 GB of the hooked code, so on
+// x64 the hook itself is a 5-byte rel32 jump (through a relay stub in the slab when the
+// detour is further away). Hooks are indexed by target address.
 class DetoursLite {
 public:
+    // Hook types
+    enum class HookType {
+        JMP_RELATIVE,    // E9 XX XX XX XX (5 bytes on x86, needs relay on x64)
+        JMP_ABSOLUTE,    // FF 25 XX XX XX XX (6 bytes on x86, 14 bytes on x64)
+        PUSH_RET,        // 68 XX XX XX XX C3 (6 bytes on x86)
+        AUTO             // Automatically choose best method
+    };
+
     // Trampoline structure for storing original bytes and jump back
     struct Trampoline {
         uintptr_t originalFunction;
+        uintptr_t detourFunction;
         uintptr_t trampolineAddress;
         size_t originalSize;
         std::vector<uint8_t> originalBytes;
+        std::vector<uint8_t> patchBytes;    // Jump (plus NOP padding) written over originalBytes
         bool isActive;
+        HookType type;                      // Resolved (never AUTO)
+        uintptr_t counterStub;              // Call counter stub slot, 0 if never enabled
+        volatile uint64_t* callCounter;     // Counter the patch currently routes through
     };
 
-    // Hook types
-    enum class HookType {
-        JMP_RELATIVE,    // E9 XX XX XX XX (5 bytes on x86, needs relay on x64)
-        JMP_ABSOLUTE,    // FF 25 XX XX XX XX (6 bytes on x86, 14 bytes on x64)
-        PUSH_RET,        // 68 XX XX XX XX C3 (6 bytes on x86)
-        AUTO             // Automatically choose best method
+    // One hook of a batch
+    struct HookRequest {
+        uintptr_t targetFunction;
+        uintptr_t detourFunction;
+        HookType type = HookType::AUTO;
     };
 
     // Install a hook
     static bool InstallHook(uintptr_t targetFunction, uintptr_t detourFunction, uintptr_t* originalFunction, HookType type = HookType::AUTO);
     
-    // Remove a hook
+    // Installs every request with the other threads suspended once for the whole batch.
+    // originals[i] is the trampoline of request i (0 if it failed); returns the number installed.
+    static size_t InstallHooks(const std::vector<HookRequest>& requests, std::vector<uintptr_t>& originals);
+    
+    // Remove a hook (its trampoline slots are reused only after a quarantine)
     static bool RemoveHook(uintptr_t targetFunction);
     
     // Enable/Disable hook temporarily
@@ -40,6 +61,10 @@ public:
     
     // Get all active hooks
     static std::vector<uintptr_t> GetActiveHooks();
+    
+    // Routes the hook through a stub that atomically increments *counter before entering
+    // the detour; nullptr switches it off. The counter must outlive the hook.
+    static bool SetCallCounter(uintptr_t targetFunction, volatile uint64_t* counter);
 
 private:
     // Disassembler helpers
@@ -48,24 +73,31 @@ private:
     static bool IsRelativeJump(uint8_t* instruction);
     static bool IsAbsoluteJump(uint8_t* instruction);
     
-    // Hook installation helpers
-    static bool WriteJumpRelative(uintptr_t from, uintptr_t to);
-    static bool WriteJumpAbsolute(uintptr_t from, uintptr_t to);
-    static bool WritePushRet(uintptr_t from, uintptr_t to);
+    // Jump encoders: write into buffer as if it were located at location; return the size (0 = impossible)
+    static size_t EncodeJumpRelative(uint8_t* buffer, uintptr_t location, uintptr_t to);
+    static size_t EncodeJumpAbsolute(uint8_t* buffer, uintptr_t to, uintptr_t addressCell);
+    static size_t EncodePushRet(uint8_t* buffer, uintptr_t to);
     
-    // Trampoline creation
-    static uintptr_t CreateTrampoline(uintptr_t originalFunction, size_t hookSize);
-    static void BuildTrampoline(uint8_t* trampolineBuffer, const uint8_t* originalBytes, size_t originalSize, uintptr_t originalAddress, uintptr_t trampolineAddress);
+    // Trampoline creation (no target code is modified until the patch is written)
+    static bool PrepareHook(const HookRequest& request, Trampoline& trampoline);
+    static bool BuildTrampoline(uint8_t* trampolineBuffer, const uint8_t* originalBytes, size_t originalSize, uintptr_t originalAddress, uintptr_t trampolineAddress);
+    static bool EncodePatch(Trampoline& trampoline);
+    static size_t EncodeCounterStub(uint8_t* buffer, uintptr_t location, volatile uint64_t* counter, uintptr_t to);
+    static bool WritePatch(uintptr_t address, const std::vector<uint8_t>& bytes);
+    static bool RestoreOriginal(const Trampoline& trampoline);
     
-    // Relocation helpers
-    static bool RelocateInstruction(uint8_t* instruction, uintptr_t oldAddress, uintptr_t newAddress);
+    // Relocation helpers: fix rel32 branches and RIP-relative operands of a copied instruction;
+    // branches into the stolen bytes keep their offset, rel8 branches out of them cannot be moved
+    static bool RelocateInstruction(uint8_t* code, const X86Instruction& instruction, uintptr_t newAddress,
+                                    uintptr_t stolenStart, size_t stolenSize);
     static int32_t CalculateRelativeOffset(uintptr_t from, uintptr_t to);
+    static bool IsRel32Reachable(uintptr_t from, uintptr_t to);
     
     // Memory protection
     static bool SetMemoryProtection(uintptr_t address, size_t size, DWORD protection, DWORD* oldProtection = nullptr);
     
-    // Hook storage
-    static std::vector<Trampoline> trampolines;
+    // Hook storage, keyed by target address
+    static std::unordered_map<uintptr_t, Trampoline> trampolines;
     static CRITICAL_SECTION criticalSection;
     static bool initialized;
     
@@ -81,23 +113,4 @@ private:
 #endif
 };
 
-// Simple length disassembler for x86/x64
-class LengthDisassembler {
-public:
-    static size_t GetLength(const uint8_t* data);
-    
-private:
-    // Instruction prefixes
-    static bool IsPrefix(uint8_t byte);
-    static bool IsRexPrefix(uint8_t byte);
-    
-    // ModRM byte parsing
-    static size_t GetModRMSize(uint8_t modRM, bool hasRex = false);
-    static bool HasSIB(uint8_t modRM);
-    static size_t GetSIBSize(uint8_t sib, uint8_t mod);
-    
-    // Opcode tables
-    static size_t GetOpcodeSize(const uint8_t* data, bool hasRex = false);
-};
-
 } // namespace InternalEngine 
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include "EngineMetrics.hpp"
+#include "BinaryProtocol.hpp"
+#include "WebSocketServer.hpp"
+#include <map>
+#include <memory>
+#include <cstring>
+
+namespace InternalEngine {
+
+// Counters written by different threads live in different cache lines
+struct alignas(64) ScanCounters {
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> results{ 0 };
+};
+
+struct alignas(64) QueueCounters {
+    std::atomic<int64_t> queued{ 0 };
+    std::atomic<int64_t> running{ 0 };
+};
+
+struct alignas(64) InboundCounters {
+    std::atomic<uint64_t> frames{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<int64_t> connections{ 0 };
+    std::atomic<uint64_t> accepted{ 0 };
+};
+
+struct alignas(64) OutboundCounters {
+    std::atomic<uint64_t> frames{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> stalls{ 0 };
+    std::atomic<uint64_t> stallMicros{ 0 };
+};
+
+static ScanCounters g_scan;
+static QueueCounters g_queue;
+static InboundCounters g_inbound;
+static OutboundCounters g_outbound;
+
+static uint64_t QueryTicks() {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return static_cast<uint64_t>(now.QuadPart);
+}
+
+static uint64_t QueryFrequency() {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return static_cast<uint64_t>(frequency.QuadPart);
+}
+
+static const uint64_t g_frequency = QueryFrequency();
+static const uint64_t g_startTicks = QueryTicks();
+static std::atomic<uint64_t> g_resetTicks{ g_startTicks };
+
+// Split so long intervals do not overflow the multiplication
+static uint64_t TicksToMicros(uint64_t ticks) {
+    return (ticks / g_frequency) * 1000000 + (ticks % g_frequency) * 1000000 / g_frequency;
+}
+
+// Registered commands; the map only grows, so handed-out pointers stay valid
+static std::mutex g_commandsMutex;
+static std::map<std::string, std::unique_ptr<CommandMetrics>> g_commands;
+
+CommandMetrics* EngineMetrics::ForCommand(const std::string& name) {
+    std::lock_guard<std::mutex> lock(g_commandsMutex);
+    std::unique_ptr<CommandMetrics>& metrics = g_commands[name];
+    if (!metrics) {
+        metrics = std::make_unique<CommandMetrics>();
+    }
+    return metrics.get();
+}
+
+uint64_t EngineMetrics::Now() {
+    return QueryTicks();
+}
+
+uint64_t EngineMetrics::MicrosSince(uint64_t start) {
+    return TicksToMicros(QueryTicks() - start);
+}
+
+void EngineMetrics::RecordCommand(CommandMetrics* metrics, uint64_t micros, bool failed) {
+    if (!metrics) return;
+    metrics->calls.fetch_add(1, std::memory_order_relaxed);
+    if (failed) metrics->errors.fetch_add(1, std::memory_order_relaxed);
+    metrics->totalMicros.fetch_add(micros, std::memory_order_relaxed);
+    metrics->buckets[CycleHistogram::BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+
+    // Lost updates only lower the max of a racing pair, so a CAS loop is not worth it
+    if (micros > metrics->maxMicros.load(std::memory_order_relaxed)) {
+        metrics->maxMicros.store(micros, std::memory_order_relaxed);
+    }
+}
+
+void EngineMetrics::AddBytesScanned(uint64_t bytes) {
+    if (bytes) g_scan.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void EngineMetrics::AddScanResults(uint64_t results) {
+    if (results) g_scan.results.fetch_add(results, std::memory_order_relaxed);
+}
+
+void EngineMetrics::FrameReceived(size_t wireBytes) {
+    g_inbound.frames.fetch_add(1, std::memory_order_relaxed);
+    g_inbound.bytes.fetch_add(wireBytes, std::memory_order_relaxed);
+}
+
+void EngineMetrics::FrameSent(size_t wireBytes, uint64_t micros) {
+    g_outbound.frames.fetch_add(1, std::memory_order_relaxed);
+    g_outbound.bytes.fetch_add(wireBytes, std::memory_order_relaxed);
+    if (micros >= SEND_STALL_MICROS) {
+        g_outbound.stalls.fetch_add(1, std::memory_order_relaxed);
+        g_outbound.stallMicros.fetch_add(micros, std::memory_order_relaxed);
+    }
+}
+
+void EngineMetrics::ConnectionOpened() {
+    g_inbound.connections.fetch_add(1, std::memory_order_relaxed);
+    g_inbound.accepted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EngineMetrics::ConnectionClosed() {
+    g_inbound.connections.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EngineMetrics::CommandQueued() {
+    g_queue.queued.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EngineMetrics::CommandDequeued() {
+    g_queue.queued.fetch_sub(1, std::memory_order_relaxed);
+    g_queue.running.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EngineMetrics::CommandFinished() {
+    g_queue.running.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EngineMetrics::CommandsDropped(size_t count) {
+    g_queue.queued.fetch_sub(static_cast<int64_t>(count), std::memory_order_relaxed);
+}
+
+static uint64_t ReadCounter(std::atomic<uint64_t>& counter, bool reset) {
+    return reset ? counter.exchange(0, std::memory_order_relaxed) : counter.load(std::memory_order_relaxed);
+}
+
+// Gauges are updated without ordering, so one can be read a moment below zero
+static uint64_t ReadGauge(const std::atomic<int64_t>& gauge) {
+    int64_t value = gauge.load(std::memory_order_relaxed);
+    return value > 0 ? static_cast<uint64_t>(value) : 0;
+}
+
+EngineMetricsSnapshot EngineMetrics::Snapshot(bool reset, bool includeIdle) {
+    EngineMetricsSnapshot snapshot;
+    uint64_t now = QueryTicks();
+    uint64_t since = reset ? g_resetTicks.exchange(now) : g_resetTicks.load();
+    snapshot.uptimeMs = TicksToMicros(now - g_startTicks) / 1000;
+    snapshot.intervalMs = TicksToMicros(now - since) / 1000;
+
+    snapshot.bytesScanned = ReadCounter(g_scan.bytes, reset);
+    snapshot.scanResults = ReadCounter(g_scan.results, reset);
+    double seconds = static_cast<double>(TicksToMicros(now - since)) / 1000000.0;
+    if (seconds > 0) {
+        snapshot.bytesScannedPerSec = static_cast<double>(snapshot.bytesScanned) / seconds;
+        snapshot.resultsPerSec = static_cast<double>(snapshot.scanResults) / seconds;
+    }
+
+    snapshot.queueDepth = ReadGauge(g_queue.queued);
+    snapshot.running = ReadGauge(g_queue.running);
+
+    snapshot.connections = ReadGauge(g_inbound.connections);
+    snapshot.connectionsAccepted = ReadCounter(g_inbound.accepted, reset);
+    snapshot.framesIn = ReadCounter(g_inbound.frames, reset);
+    snapshot.bytesIn = ReadCounter(g_inbound.bytes, reset);
+    snapshot.framesOut = ReadCounter(g_outbound.frames, reset);
+    snapshot.bytesOut = ReadCounter(g_outbound.bytes, reset);
+    snapshot.sendStalls = ReadCounter(g_outbound.stalls, reset);
+    snapshot.sendStallMicros = ReadCounter(g_outbound.stallMicros, reset);
+
+    std::lock_guard<std::mutex> lock(g_commandsMutex);
+    std::vector<uint64_t> histogram(CycleHistogram::BUCKET_COUNT);
+    for (auto& pair : g_commands) {
+        CommandMetrics& metrics = *pair.second;
+        if (!includeIdle && metrics.calls.load(std::memory_order_relaxed) == 0) continue;
+
+        CommandMetricsSnapshot command;
+        command.name = pair.first;
+        command.calls = ReadCounter(metrics.calls, reset);
+        command.errors = ReadCounter(metrics.errors, reset);
+        command.totalMicros = ReadCounter(metrics.totalMicros, reset);
+        command.maxMicros = ReadCounter(metrics.maxMicros, reset);
+
+        uint64_t sampled = 0;
+        for (uint32_t i = 0; i < CycleHistogram::BUCKET_COUNT; i++) {
+            histogram[i] = reset ? metrics.buckets[i].exchange(0, std::memory_order_relaxed)
+                                 : metrics.buckets[i].load(std::memory_order_relaxed);
+            sampled += histogram[i];
+        }
+        command.p50 = CycleHistogram::Percentile(histogram, sampled, 0.50);
+        command.p90 = CycleHistogram::Percentile(histogram, sampled, 0.90);
+        command.p99 = CycleHistogram::Percentile(histogram, sampled, 0.99);
+        command.p999 = CycleHistogram::Percentile(histogram, sampled, 0.999);
+
+        snapshot.commands += command.calls;
+        snapshot.commandErrors += command.errors;
+        snapshot.commandStats.push_back(std::move(command));
+    }
+    return snapshot;
+}
+
+MetricsPublisher::MetricsPublisher() {}
+
+MetricsPublisher::~MetricsPublisher() {
+    Stop();
+}
+
+uint32_t MetricsPublisher::Subscribe(uint32_t rateHz, WebSocketConnection* owner) {
+    if (!owner) return 0;
+    if (rateHz == 0) rateHz = DEFAULT_RATE_HZ;
+    if (rateHz > MAX_RATE_HZ) rateHz = MAX_RATE_HZ;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Subscription subscription;
+    subscription.owner = owner;
+    subscription.interval = std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(1000000 / rateHz));
+    subscription.nextPush = Clock::now();
+
+    uint32_t subscriptionId = nextSubscriptionId++;
+    if (nextSubscriptionId == 0) nextSubscriptionId = 1;
+    subscriptions[subscriptionId] = subscription;
+
+    if (!running) {
+        running = true;
+        publisher = std::thread(&MetricsPublisher::PublishLoop, this);
+    }
+    wakeup.notify_one();
+    return subscriptionId;
+}
+
+bool MetricsPublisher::Unsubscribe(uint32_t subscriptionId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscriptions.erase(subscriptionId) > 0;
+}
+
+void MetricsPublisher::UnsubscribeOwner(WebSocketConnection* owner) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = subscriptions.begin(); it != subscriptions.end();) {
+            if (it->second.owner == owner) {
+                it = subscriptions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // A round collected before the erase may still be sending to owner; wait it out so the
+    // connection is not freed under it
+    std::lock_guard<std::mutex> sending(sendMutex);
+}
+
+void MetricsPublisher::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+        subscriptions.clear();
+    }
+    wakeup.notify_one();
+    if (publisher.joinable()) {
+        publisher.join();
+    }
+}
+
+void MetricsPublisher::PublishLoop() {
+    std::vector<std::pair<uint32_t, WebSocketConnection*>> due;
+
+    while (true) {
+        std::unique_lock<std::mutex> sending(sendMutex, std::defer_lock);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!running) break;
+
+            if (subscriptions.empty()) {
+                wakeup.wait(lock);
+                continue;
+            }
+            Clock::time_point next = subscriptions.begin()->second.nextPush;
+            for (const auto& pair : subscriptions) {
+                if (pair.second.nextPush < next) next = pair.second.nextPush;
+            }
+            if (Clock::now() < next) {
+                wakeup.wait_until(lock, next);
+                continue;
+            }
+
+            Clock::time_point now = Clock::now();
+            for (auto& pair : subscriptions) {
+                if (pair.second.nextPush > now) continue;
+                due.emplace_back(pair.first, pair.second.owner);
+                pair.second.nextPush += pair.second.interval;
+                if (pair.second.nextPush < now) pair.second.nextPush = now + pair.second.interval;
+            }
+
+            // Taken before the lock is released, so UnsubscribeOwner cannot return while a
+            // frame collected above is still going to its owner
+            sending.lock();
+        }
+
+        // One snapshot for every subscription due this round; pushing never resets the counters
+        EngineMetricsSnapshot metrics = EngineMetrics::Snapshot();
+        for (const auto& target : due) {
+            target.second->SendBinary(EncodeFrame(target.first, metrics));
+        }
+        due.clear();
+    }
+}
+
+static void AppendUInt64(std::vector<uint8_t>& buffer, uint64_t value) {
+    uint8_t bytes[8];
+    memcpy(bytes, &value, sizeof(bytes));
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(bytes));
+}
+
+std::vector<uint8_t> MetricsPublisher::EncodeFrame(uint32_t subscriptionId, const EngineMetricsSnapshot& metrics) {
+    std::vector<uint8_t> payload;
+    payload.reserve(16 * 8 + 4 + metrics.commandStats.size() * 80);
+
+    const uint64_t fields[] = {
+        metrics.uptimeMs, metrics.intervalMs, metrics.bytesScanned, metrics.scanResults,
+        metrics.commands, metrics.commandErrors, metrics.queueDepth, metrics.running,
+        metrics.connections, metrics.connectionsAccepted, metrics.framesIn, metrics.framesOut,
+        metrics.bytesIn, metrics.bytesOut, metrics.sendStalls, metrics.sendStallMicros
+    };
+    for (uint64_t field : fields) {
+        AppendUInt64(payload, field);
+    }
+
+    uint32_t count = static_cast<uint32_t>(metrics.commandStats.size());
+    uint8_t countBytes[4];
+    memcpy(countBytes, &count, sizeof(countBytes));
+    payload.insert(payload.end(), countBytes, countBytes + sizeof(countBytes));
+
+    for (const auto& command : metrics.commandStats) {
+        AppendUInt64(payload, command.calls);
+        AppendUInt64(payload, command.errors);
+        AppendUInt64(payload, command.totalMicros);
+        AppendUInt64(payload, command.maxMicros);
+        AppendUInt64(payload, command.p50);
+        AppendUInt64(payload, command.p90);
+        AppendUInt64(payload, command.p99);
+
+        uint16_t nameLength = static_cast<uint16_t>(min(command.name.size(), static_cast<size_t>(0xFFFF)));
+        payload.push_back(static_cast<uint8_t>(nameLength & 0xFF));
+        payload.push_back(static_cast<uint8_t>(nameLength >> 8));
+        payload.insert(payload.end(), command.name.begin(), command.name.begin() + nameLength);
+    }
+
+    return BinaryProtocol::EncodeMessage(BinaryOpcode::ENGINE_METRICS, subscriptionId, 0, payload.data(), payload.size());
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,153 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include "HookProfiler.hpp"
+
+namespace InternalEngine {
+
+// Latency of one command in microseconds, bucketed like the hook profiles (CycleHistogram).
+// Updated by the command workers with relaxed atomics; never freed once registered.
+struct alignas(64) CommandMetrics {
+    std::atomic<uint64_t> calls{ 0 };
+    std::atomic<uint64_t> errors{ 0 };
+    std::atomic<uint64_t> totalMicros{ 0 };
+    std::atomic<uint64_t> maxMicros{ 0 };
+    std::atomic<uint32_t> buckets[CycleHistogram::BUCKET_COUNT] = {};
+};
+
+struct CommandMetricsSnapshot {
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t errors = 0;            // Handler threw or answered success:false / BINARY_FLAG_ERROR
+    uint64_t totalMicros = 0;
+    uint64_t maxMicros = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+};
+
+// Counters count from the last reset (intervalMs); gauges are the current state
+struct EngineMetricsSnapshot {
+    uint64_t uptimeMs = 0;
+    uint64_t intervalMs = 0;
+
+    // Scans (first, next, unknown-initial and pattern scans)
+    uint64_t bytesScanned = 0;
+    uint64_t scanResults = 0;
+    double bytesScannedPerSec = 0;
+    double resultsPerSec = 0;
+
+    // Command workers
+    uint64_t commands = 0;
+    uint64_t commandErrors = 0;
+    uint64_t queueDepth = 0;        // Gauge: frames waiting for a worker
+    uint64_t running = 0;           // Gauge: frames a worker is executing
+
+    // WebSocket
+    uint64_t connections = 0;       // Gauge
+    uint64_t connectionsAccepted = 0;
+    uint64_t framesIn = 0;
+    uint64_t framesOut = 0;
+    uint64_t bytesIn = 0;           // Wire bytes, frame headers included (compressed size)
+    uint64_t bytesOut = 0;
+    uint64_t sendStalls = 0;        // Sends that waited SEND_STALL_MICROS or more on the send buffer
+    uint64_t sendStallMicros = 0;
+
+    std::vector<CommandMetricsSnapshot> commandStats;   // Sorted by name
+};
+
+// 📊 엔진 메트릭
+// Always-on counters for the command path, the WebSocket server and the scan kernels. Every
+// update is a relaxed atomic add on a counter in its own cache line group, so recording costs
+// a few nanoseconds and never takes a lock; reading (Snapshot) merges them on demand.
+class EngineMetrics {
+public:
+    // A frame send that blocks this long was held up by a full socket send buffer
+    static const uint64_t SEND_STALL_MICROS = 1000;
+
+    // Registered once per name (the router does it in RegisterCommand); the pointer stays valid
+    static CommandMetrics* ForCommand(const std::string& name);
+
+    // QueryPerformanceCounter ticks and their conversion
+    static uint64_t Now();
+    static uint64_t MicrosSince(uint64_t start);
+
+    static void RecordCommand(CommandMetrics* metrics, uint64_t micros, bool failed);
+
+    static void AddBytesScanned(uint64_t bytes);
+    static void AddScanResults(uint64_t results);
+
+    static void FrameReceived(size_t wireBytes);
+    static void FrameSent(size_t wireBytes, uint64_t micros);
+    static void ConnectionOpened();
+    static void ConnectionClosed();
+
+    // Worker queue: queued -> dequeued (running) -> finished; dropped = discarded without running
+    static void CommandQueued();
+    static void CommandDequeued();
+    static void CommandFinished();
+    static void CommandsDropped(size_t count);
+
+    // Commands that were never called are left out unless includeIdle is set.
+    // reset zeroes the counters afterwards (updates racing with it may be lost); gauges stay.
+    static EngineMetricsSnapshot Snapshot(bool reset = false, bool includeIdle = false);
+};
+
+// 📡 메트릭 푸시
+// Pushes ENGINE_METRICS frames (requestId = subscription id) at the subscription's rate, with
+// the same threading model as HookStatsPublisher. Frames carry the raw counters and intervalMs,
+// so a client gets per-period rates by diffing consecutive frames.
+class MetricsPublisher {
+public:
+    static const uint32_t DEFAULT_RATE_HZ = 1;
+    static const uint32_t MAX_RATE_HZ = 20;
+
+    MetricsPublisher();
+    ~MetricsPublisher();
+
+    // Frames go to owner (required, 0 is returned without one)
+    uint32_t Subscribe(uint32_t rateHz, WebSocketConnection* owner);
+    bool Unsubscribe(uint32_t subscriptionId);
+    // Also waits for a send to owner already under way (called before owner is freed)
+    void UnsubscribeOwner(WebSocketConnection* owner);
+
+    void Stop();
+
+    // ENGINE_METRICS payload (little-endian): uptimeMs, intervalMs, bytesScanned, scanResults,
+    // commands, commandErrors, queueDepth, running, connections, connectionsAccepted, framesIn,
+    // framesOut, bytesIn, bytesOut, sendStalls, sendStallMicros (u64 each), count u32, then per
+    // command calls u64, errors u64, totalMicros u64, maxMicros u64, p50 u64, p90 u64, p99 u64,
+    // nameLength u16 and the name bytes
+    static std::vector<uint8_t> EncodeFrame(uint32_t subscriptionId, const EngineMetricsSnapshot& metrics);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Subscription {
+        WebSocketConnection* owner = nullptr;
+        Clock::duration interval;
+        Clock::time_point nextPush;
+    };
+
+    void PublishLoop();
+
+    std::mutex mutex;
+    std::mutex sendMutex;           // Held while a round's frames are sent
+    std::condition_variable wakeup;
+    std::unordered_map<uint32_t, Subscription> subscriptions;
+    uint32_t nextSubscriptionId = 1;
+
+    std::thread publisher;
+    bool running = false;
+};
+
+} // namespace InternalEngine
@@ -0,0 +1,334 @@
+#include "FreezeManager.hpp"
+#include "ChangeTracker.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace InternalEngine {
+
+// 🗺️ 쓰기 계획
+struct FreezeWrite {
+    uint8_t* target;
+    const uint8_t* value;
+    size_t size;
+};
+
+struct FreezeGroup {
+    uintptr_t protectBase;      // Page-aligned span covering every write of the group
+    size_t protectSize;
+    bool needsProtect;          // Not writable as committed (or spans two regions)
+    size_t firstWrite;
+    size_t writeCount;
+};
+
+// One region's part of a group's span, with the protection it had before the write
+struct ProtectedPart {
+    uintptr_t base;
+    size_t size;
+    DWORD oldProtect;
+};
+
+struct FreezePlan {
+    std::vector<uint8_t> values;        // Copies of the frozen bytes, owned by the thread
+    std::vector<FreezeWrite> writes;
+    std::vector<FreezeGroup> groups;
+    std::vector<uintptr_t> addresses;   // Sorted; writes[i] freezes addresses[i]
+    std::vector<uint8_t> changed;       // Per write, filled by the last tick
+    std::vector<ProtectedPart> parts;   // Scratch for the group being written
+};
+
+static bool IsFreezableRegion(const MEMORY_BASIC_INFORMATION& mbi) {
+    return mbi.State == MEM_COMMIT && mbi.Protect != 0 && (mbi.Protect & (PAGE_GUARD | PAGE_NOACCESS)) == 0;
+}
+
+static bool IsWritableProtection(DWORD protect) {
+    return (protect & (PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) != 0;
+}
+
+static void BuildFreezePlan(const std::map<uintptr_t, std::vector<uint8_t>>& entries, FreezePlan& plan) {
+    const uintptr_t pageMask = ~static_cast<uintptr_t>(FreezeManager::PAGE_SIZE - 1);
+
+    plan.values.clear();
+    plan.writes.clear();
+    plan.groups.clear();
+    plan.addresses.clear();
+
+    std::vector<size_t> valueOffsets;
+    MEMORY_BASIC_INFORMATION mbi = {};
+    uintptr_t regionBase = 0;
+    uintptr_t regionEnd = 0;
+    bool regionFreezable = false;
+    bool startGroup = true;
+
+    for (const auto& pair : entries) {
+        uintptr_t address = pair.first;
+        const std::vector<uint8_t>& value = pair.second;
+        uintptr_t end = address + value.size();
+        if (value.empty() || end < address) continue;
+
+        // One VirtualQuery per region; the entries are sorted, so the region is reused
+        if (address < regionBase || address >= regionEnd) {
+            startGroup = true;
+            if (!VirtualQuery(reinterpret_cast<LPCVOID>(address), &mbi, sizeof(mbi))) {
+                regionBase = regionEnd = 0;
+                continue;
+            }
+            regionBase = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
+            regionEnd = regionBase + mbi.RegionSize;
+            regionFreezable = IsFreezableRegion(mbi);
+        }
+        if (!regionFreezable) continue;
+
+        uintptr_t firstPage = address & pageMask;
+        uintptr_t pagesEnd = (end + FreezeManager::PAGE_SIZE - 1) & pageMask;
+        bool crossesRegion = end > regionEnd;
+
+        // A value that runs into the next region gets a group of its own, protected as a whole
+        if (startGroup || crossesRegion) {
+            FreezeGroup group;
+            group.protectBase = firstPage;
+            group.protectSize = pagesEnd - firstPage;
+            group.needsProtect = crossesRegion || !IsWritableProtection(mbi.Protect);
+            group.firstWrite = plan.writes.size();
+            group.writeCount = 0;
+            plan.groups.push_back(group);
+        } else {
+            FreezeGroup& group = plan.groups.back();
+            group.protectSize = (std::max)(group.protectSize, pagesEnd - group.protectBase);
+        }
+        startGroup = crossesRegion;
+
+        FreezeWrite write;
+        write.target = reinterpret_cast<uint8_t*>(address);
+        write.value = nullptr;
+        write.size = value.size();
+        plan.writes.push_back(write);
+        plan.groups.back().writeCount++;
+        plan.addresses.push_back(address);
+
+        valueOffsets.push_back(plan.values.size());
+        plan.values.insert(plan.values.end(), value.begin(), value.end());
+    }
+
+    // values no longer grows, so its pointers stay put
+    for (size_t i = 0; i < plan.writes.size(); i++) {
+        plan.writes[i].value = plan.values.data() + valueOffsets[i];
+    }
+    plan.changed.assign(plan.writes.size(), 0);
+}
+
+// SEH 전용 헬퍼 함수 (C++ 객체 없음)
+// Stores writes[first, count) whose memory differs from the frozen value and flags them in
+// changed; returns the index of the write that faulted, or count when every write succeeded
+static size_t SafeFreezeBatch(const FreezeWrite* writes, uint8_t* changed, size_t first, size_t count) {
+    volatile size_t index = first;
+    __try {
+        for (; index < count; index++) {
+            const FreezeWrite& write = writes[index];
+            changed[index] = memcmp(write.target, write.value, write.size) != 0;
+            if (changed[index]) {
+                memcpy(write.target, write.value, write.size);
+            }
+        }
+    }
+    __except(EXCEPTION_EXECUTE_HANDLER) {
+        return index;
+    }
+    return count;
+}
+
+static void RestoreProtection(const std::vector<ProtectedPart>& parts) {
+    for (const ProtectedPart& part : parts) {
+        DWORD ignored;
+        VirtualProtect(reinterpret_cast<void*>(part.base), part.size, part.oldProtect, &ignored);
+    }
+}
+
+// VirtualProtect only reports the first page's old protection, so a span that crosses regions
+// is made writable one region at a time and each part gets its own protection back.
+// Parts that are already writable are left alone.
+static bool MakeSpanWritable(uintptr_t base, size_t size, std::vector<ProtectedPart>& parts) {
+    parts.clear();
+    uintptr_t end = base + size;
+    for (uintptr_t cursor = base; cursor < end;) {
+        MEMORY_BASIC_INFORMATION mbi;
+        if (!VirtualQuery(reinterpret_cast<LPCVOID>(cursor), &mbi, sizeof(mbi))) {
+            RestoreProtection(parts);
+            return false;
+        }
+        uintptr_t partEnd = (std::min)(end, reinterpret_cast<uintptr_t>(mbi.BaseAddress) + mbi.RegionSize);
+
+        if (!IsWritableProtection(mbi.Protect)) {
+            ProtectedPart part = { cursor, partEnd - cursor, 0 };
+            if (!VirtualProtect(reinterpret_cast<void*>(part.base), part.size, PAGE_EXECUTE_READWRITE, &part.oldProtect)) {
+                RestoreProtection(parts);
+                return false;
+            }
+            parts.push_back(part);
+        }
+        cursor = partEnd;
+    }
+    return true;
+}
+
+static bool RunFreezePlan(FreezePlan& plan) {
+    bool clean = true;
+    for (const FreezeGroup& group : plan.groups) {
+        size_t first = group.firstWrite;
+        size_t count = group.firstWrite + group.writeCount;
+
+        if (group.needsProtect && !MakeSpanWritable(group.protectBase, group.protectSize, plan.parts)) {
+            clean = false;
+            continue;
+        }
+
+        // A faulting write is skipped; the rest of the group still runs
+        while (first < count) {
+            size_t faulted = SafeFreezeBatch(plan.writes.data(), plan.changed.data(), first, count);
+            if (faulted == count) break;
+            plan.changed[faulted] = 0;
+            first = faulted + 1;
+            clean = false;
+        }
+
+        if (group.needsProtect) {
+            RestoreProtection(plan.parts);
+
+            // Reported like every other engine write to protected memory
+            for (size_t i = group.firstWrite; i < count; i++) {
+                if (plan.changed[i]) {
+                    ChangeTracker::NotifyWrite(reinterpret_cast<uintptr_t>(plan.writes[i].target), plan.writes[i].size);
+                }
+            }
+        }
+    }
+    return clean;
+}
+
+// ❄️ FreezeManager
+FreezeManager::FreezeManager()
+    : interval(std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(1000000 / DEFAULT_RATE_HZ))) {}
+
+FreezeManager::~FreezeManager() {
+    Stop();
+}
+
+void FreezeManager::Set(uintptr_t address, std::vector<uint8_t> value) {
+    if (value.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[address] = std::move(value);
+    planDirty = true;
+
+    // The freezer starts with the first entry
+    if (!running) {
+        running = true;
+        freezer = std::thread(&FreezeManager::FreezeLoop, this);
+    }
+    wakeup.notify_one();
+}
+
+bool FreezeManager::Clear(uintptr_t address) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.erase(address) == 0) return false;
+    planDirty = true;
+    wakeup.notify_one();
+    return true;
+}
+
+size_t FreezeManager::ClearAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = entries.size();
+    entries.clear();
+    planDirty = true;
+    wakeup.notify_one();
+    return count;
+}
+
+void FreezeManager::SetRate(uint32_t rateHz) {
+    if (rateHz == 0) return;
+    if (rateHz > MAX_RATE_HZ) rateHz = MAX_RATE_HZ;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    interval = std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(1000000 / rateHz));
+    wakeup.notify_one();
+}
+
+uint32_t FreezeManager::GetRate() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(interval).count();
+    return micros > 0 ? static_cast<uint32_t>(1000000 / micros) : MAX_RATE_HZ;
+}
+
+std::vector<FreezeInfo> FreezeManager::List() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<FreezeInfo> list;
+    list.reserve(entries.size());
+    for (const auto& pair : entries) {
+        FreezeInfo info;
+        info.address = pair.first;
+        info.size = pair.second.size();
+        info.active = !planDirty && std::binary_search(activeAddresses.begin(), activeAddresses.end(), pair.first);
+        list.push_back(info);
+    }
+    return list;
+}
+
+void FreezeManager::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+        entries.clear();
+    }
+    wakeup.notify_one();
+    if (freezer.joinable()) {
+        freezer.join();
+    }
+}
+
+void FreezeManager::FreezeLoop() {
+    FreezePlan plan;
+    DWORD planTick = 0;
+    Clock::time_point nextTick = Clock::now();
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!running) break;
+
+            if (entries.empty()) {
+                BuildFreezePlan(entries, plan);
+                activeAddresses.clear();
+                planDirty = false;
+                wakeup.wait(lock);
+                nextTick = Clock::now();
+                continue;
+            }
+            if (Clock::now() < nextTick) {
+                wakeup.wait_until(lock, nextTick);
+                continue;
+            }
+
+            // Protections are only looked up here, not on every tick
+            if (planDirty || GetTickCount() - planTick >= REVALIDATE_MS) {
+                BuildFreezePlan(entries, plan);
+                activeAddresses = plan.addresses;
+                planDirty = false;
+                planTick = GetTickCount();
+            }
+
+            // Fixed-rate schedule; skip missed ticks instead of bursting to catch up
+            Clock::time_point now = Clock::now();
+            nextTick += interval;
+            if (nextTick < now) nextTick = now + interval;
+        }
+
+        // Written outside the lock - the plan holds its own copy of every value
+        if (!RunFreezePlan(plan)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            planDirty = true;
+        }
+    }
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,68 @@
+#pragma once
+#include <windows.h>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+namespace InternalEngine {
+
+// One frozen value as reported by freeze.list
+struct FreezeInfo {
+    uintptr_t address = 0;
+    size_t size = 0;
+    bool active = false;        // Covered by the write plan (committed, accessible memory)
+};
+
+// ❄️ 값 고정 (freezer)
+// Frozen values are rewritten by one engine thread at a fixed rate, with no client traffic.
+// The thread works from a write plan built from the sorted entries: each VirtualQuery region
+// becomes a group whose protection is looked up once, so writable pages are written with plain
+// memcpy under a single SEH frame and only read-only/code pages pay for a VirtualProtect pair -
+// once per group per tick, not once per value. A value is only stored when memory differs, so
+// an untouched value does not dirty its page. The plan is rebuilt whenever the entries change,
+// after a write faults, and every REVALIDATE_MS so freed or re-protected memory is picked up.
+class FreezeManager {
+public:
+    static const uint32_t DEFAULT_RATE_HZ = 60;
+    static const uint32_t MAX_RATE_HZ = 1000;
+    static const DWORD REVALIDATE_MS = 1000;
+    static const size_t PAGE_SIZE = 4096;
+
+    FreezeManager();
+    ~FreezeManager();
+
+    // Freezes address at value (replacing an earlier freeze of the same address)
+    void Set(uintptr_t address, std::vector<uint8_t> value);
+    bool Clear(uintptr_t address);
+    size_t ClearAll();
+
+    // 0 keeps the current rate
+    void SetRate(uint32_t rateHz);
+    uint32_t GetRate() const;
+
+    std::vector<FreezeInfo> List() const;
+
+    // Stops the freezer thread (called before the DLL unloads)
+    void Stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void FreezeLoop();
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeup;
+    std::map<uintptr_t, std::vector<uint8_t>> entries;
+    std::vector<uintptr_t> activeAddresses;     // Sorted, covered by the thread's current plan
+    Clock::duration interval;
+    bool planDirty = true;
+
+    std::thread freezer;
+    bool running = false;
+};
+
+} // namespace InternalEngine
@@ -1,6 +1,8 @@
 #include "HookManager.hpp"
 #include "MemoryEngine.hpp"
+#include "SignatureCache.hpp"
 #include <algorithm>
+#include <unordered_set>
 
 namespace InternalEngine {
 
@@ -74,6 +76,58 @@ bool HookManager::InstallHook(const std::string& name, void* targetFunction, voi
                       reinterpret_cast<uintptr_t>(detourFunction), type);
 }
 
+size_t HookManager::InstallHooksBatch(const std::vector<HookRequest>& requests, std::vector<bool>* results) {
+    EnterCriticalSection(&criticalSection);
+    
+    if (results) {
+        results->assign(requests.size(), false);
+    }
+    
+    // Same checks as InstallHook, also against names/targets earlier in the batch
+    std::vector<DetoursLite::HookRequest> detourRequests;
+    std::vector<size_t> requestIndex;
+    std::unordered_set<std::string> batchNames;
+    std::unordered_set<uintptr_t> batchTargets;
+    
+    for (size_t i = 0; i < requests.size(); i++) {
+        const HookRequest& request = requests[i];
+        if (hooks.find(request.name) != hooks.end() || addressToName.find(request.targetAddress) != addressToName.end()) {
+            continue;
+        }
+        if (!batchNames.insert(request.name).second || !batchTargets.insert(request.targetAddress).second) {
+            continue;
+        }
+        detourRequests.push_back({ request.targetAddress, request.detourAddress, request.type });
+        requestIndex.push_back(i);
+    }
+    
+    // Install the hooks
+    std::vector<uintptr_t> originals;
+    size_t installed = DetoursLite::InstallHooks(detourRequests, originals);
+    
+    for (size_t j = 0; j < detourRequests.size(); j++) {
+        if (originals[j] == 0) continue;
+        
+        const HookRequest& request = requests[requestIndex[j]];
+        auto hookInfo = std::make_unique<HookInfo>();
+        hookInfo->name = request.name;
+        hookInfo->targetAddress = request.targetAddress;
+        hookInfo->detourAddress = request.detourAddress;
+        hookInfo->originalAddress = originals[j];
+        hookInfo->type = request.type;
+        hookInfo->isActive = true;
+        
+        addressToName[request.targetAddress] = request.name;
+        hooks[request.name] = std::move(hookInfo);
+        if (results) {
+            (*results)[requestIndex[j]] = true;
+        }
+    }
+    
+    LeaveCriticalSection(&criticalSection);
+    return installed;
+}
+
 bool HookManager::RemoveHook(const std::string& name) {
     EnterCriticalSection(&criticalSection);
     
@@ -86,6 +140,11 @@ bool HookManager::RemoveHook(const std::string& name) {
     bool success = DetoursLite::RemoveHook(it->second->targetAddress);
     
     if (success) {
+        // The profile (and its counters) outlives the hook; only sampling stops
+        auto profile = profiles.find(name);
+        if (profile != profiles.end()) {
+            profile->second->SetEnabled(false);
+        }
         addressToName.erase(it->second->targetAddress);
         hooks.erase(it);
     }
@@ -221,6 +280,59 @@ std::vector<HookManager::HookInfo> HookManager::GetAllHooks() const {
     return allHooks;
 }
 
+HookProfile* HookManager::GetProfile(const std::string& name) {
+    EnterCriticalSection(&criticalSection);
+    
+    auto& profile = profiles[name];
+    if (!profile) {
+        profile = std::make_unique<HookProfile>(name);
+    }
+    HookProfile* result = profile.get();
+    
+    LeaveCriticalSection(&criticalSection);
+    return result;
+}
+
+bool HookManager::SetProfiling(const std::string& name, bool enabled) {
+    HookProfile* profile = GetProfile(name);
+    
+    EnterCriticalSection(&criticalSection);
+    
+    auto it = hooks.find(name);
+    if (it == hooks.end()) {
+        LeaveCriticalSection(&criticalSection);
+        return false;
+    }
+    
+    // Route the hook through the call counter stub (or back straight to the detour)
+    bool success = DetoursLite::SetCallCounter(it->second->targetAddress, enabled ? profile->GetCallCounter() : nullptr);
+    if (success) {
+        profile->SetEnabled(enabled);
+    }
+    
+    LeaveCriticalSection(&criticalSection);
+    return success;
+}
+
+std::vector<HookStatsSnapshot> HookManager::GetHookStats(const std::string& name, bool reset) {
+    EnterCriticalSection(&criticalSection);
+    
+    std::vector<HookStatsSnapshot> stats;
+    for (const auto& pair : hooks) {
+        if (!name.empty() && pair.first != name) continue;
+        
+        auto profile = profiles.find(pair.first);
+        if (profile == profiles.end()) continue;
+        
+        HookStatsSnapshot snapshot = profile->second->Snapshot(reset);
+        snapshot.targetAddress = pair.second->targetAddress;
+        stats.push_back(std::move(snapshot));
+    }
+    
+    LeaveCriticalSection(&criticalSection);
+    return stats;
+}
+
 uintptr_t HookManager::GetFunctionAddress(const std::string& moduleName, const std::string& functionName) {
     HMODULE hModule = GetModuleHandleA(moduleName.c_str());
     if (!hModule) {
@@ -252,13 +364,13 @@ uintptr_t HookManager::GetVTableFunction(uintptr_t objectPtr, size_t index) {
 bool HookManager::InstallHookByPattern(const std::string& name, const std::string& pattern, 
                                        const std::string& mask, uintptr_t detourAddress,
                                        DetoursLite::HookType type) {
-    // Find pattern
-    auto address = MemoryEngine::PatternScanFirst(pattern, mask);
-    if (!address.has_value()) {
+    // Find pattern (cached RVA of this module build if its bytes still match)
+    auto matches = SignatureCache::Resolve({ CodePattern{ pattern, mask } })[0];
+    if (matches.empty()) {
         return false;
     }
     
-    return InstallHook(name, address.value(), detourAddress, type);
+    return InstallHook(name, matches[0], detourAddress, type);
 }
 
 } // namespace InternalEngine
\ No newline at end of file
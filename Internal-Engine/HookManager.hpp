@@ -4,7 +4,9 @@
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <vector>
 #include "DetoursLite.hpp"
+#include "HookProfiler.hpp"
 
 namespace InternalEngine {
 
@@ -19,6 +21,13 @@ public:
         DetoursLite::HookType type;
     };
 
+    struct HookRequest {
+        std::string name;
+        uintptr_t targetAddress;
+        uintptr_t detourAddress;
+        DetoursLite::HookType type = DetoursLite::HookType::AUTO;
+    };
+
     HookManager();
     ~HookManager();
 
@@ -29,6 +38,10 @@ public:
     bool InstallHook(const std::string& name, void* targetFunction, void* detourFunction,
                      DetoursLite::HookType type = DetoursLite::HookType::AUTO);
     
+    // Batch installation: all targets are patched under a single thread suspension.
+    // Returns the number installed; results (optional) receives per-request success.
+    size_t InstallHooksBatch(const std::vector<HookRequest>& requests, std::vector<bool>* results = nullptr);
+    
     // Template version for function pointers
     template<typename T>
     bool InstallHook(const std::string& name, T targetFunction, T detourFunction, T* originalFunction = nullptr) {
@@ -61,6 +74,12 @@ public:
     static uintptr_t GetFunctionAddress(const std::string& moduleName, const std::string& functionName);
     static uintptr_t GetVTableFunction(uintptr_t objectPtr, size_t index);
     
+    // Profiling: the profile of a name exists from its first lookup until the manager is
+    // destroyed, so detours can cache it (see HOOK_PROFILE_SCOPE)
+    HookProfile* GetProfile(const std::string& name);
+    bool SetProfiling(const std::string& name, bool enabled);
+    std::vector<HookStatsSnapshot> GetHookStats(const std::string& name = "", bool reset = false);
+    
     // Pattern-based hooking
     bool InstallHookByPattern(const std::string& name, const std::string& pattern, 
                              const std::string& mask, uintptr_t detourAddress,
@@ -69,6 +88,7 @@ public:
 private:
     std::unordered_map<std::string, std::unique_ptr<HookInfo>> hooks;
     std::unordered_map<uintptr_t, std::string> addressToName;
+    std::unordered_map<std::string, std::unique_ptr<HookProfile>> profiles;
     CRITICAL_SECTION criticalSection;
     bool initialized;
 
@@ -88,4 +108,12 @@ extern HookManager* g_HookManager;
         reinterpret_cast<void*>(HookManager::GetVTableFunction(reinterpret_cast<uintptr_t>(object), index)), \
         reinterpret_cast<void*>(detour))
 
+// Times the rest of the enclosing detour for the hook's latency histogram (once profiling
+// is switched on with SetProfiling / hook.profile). It is the only source of the cycle
+// stats: a detour without it still gets calls counted, but timedCalls stays 0.
+#define HOOK_PROFILE_SCOPE(name) \
+    static InternalEngine::HookProfile* hookProfile_ = \
+        InternalEngine::g_HookManager ? InternalEngine::g_HookManager->GetProfile(name) : nullptr; \
+    InternalEngine::HookTimer hookTimer_(hookProfile_)
+
 } // namespace InternalEngine 
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "HookProfiler.hpp"
+#include "HookManager.hpp"
+#include "BinaryProtocol.hpp"
+#include "WebSocketServer.hpp"
+#include <cstring>
+
+namespace InternalEngine {
+
+uint64_t CycleHistogram::BucketLowerBound(uint32_t index) {
+    if (index < SUB_BUCKETS) return index;
+    uint32_t magnitude = (index >> SUB_BUCKET_BITS) + SUB_BUCKET_BITS - 1;
+    uint64_t sub = index & (SUB_BUCKETS - 1);
+    return (SUB_BUCKETS + sub) << (magnitude - SUB_BUCKET_BITS);
+}
+
+uint64_t CycleHistogram::BucketUpperBound(uint32_t index) {
+    if (index + 1 >= BUCKET_COUNT) return BucketLowerBound(BUCKET_COUNT - 1);
+    return BucketLowerBound(index + 1) - 1;
+}
+
+uint64_t CycleHistogram::Percentile(const std::vector<uint64_t>& buckets, uint64_t total, double fraction) {
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total));
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= rank) return BucketUpperBound(i);
+    }
+    return BucketUpperBound(static_cast<uint32_t>(buckets.size() - 1));
+}
+
+HookStatsSnapshot HookProfile::Snapshot(bool reset) {
+    HookStatsSnapshot snapshot;
+    snapshot.name = name;
+    snapshot.enabled = IsEnabled();
+    snapshot.calls = reset ? callCount.exchange(0, std::memory_order_relaxed) : callCount.load(std::memory_order_relaxed);
+    snapshot.histogram.assign(CycleHistogram::BUCKET_COUNT, 0);
+
+    for (HookThreadSlot& slot : slots) {
+        if (reset) {
+            snapshot.timedCalls += slot.calls.exchange(0, std::memory_order_relaxed);
+            snapshot.totalCycles += slot.cycles.exchange(0, std::memory_order_relaxed);
+            snapshot.maxCycles = max(snapshot.maxCycles, slot.maxCycles.exchange(0, std::memory_order_relaxed));
+        } else {
+            snapshot.timedCalls += slot.calls.load(std::memory_order_relaxed);
+            snapshot.totalCycles += slot.cycles.load(std::memory_order_relaxed);
+            snapshot.maxCycles = max(snapshot.maxCycles, slot.maxCycles.load(std::memory_order_relaxed));
+        }
+
+        for (uint32_t i = 0; i < CycleHistogram::BUCKET_COUNT; i++) {
+            snapshot.histogram[i] += reset ? slot.buckets[i].exchange(0, std::memory_order_relaxed)
+                                           : slot.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Percentiles over the bucket counts, not timedCalls: a sample can be between updates
+    uint64_t sampled = 0;
+    for (uint64_t count : snapshot.histogram) sampled += count;
+    snapshot.p50 = CycleHistogram::Percentile(snapshot.histogram, sampled, 0.50);
+    snapshot.p90 = CycleHistogram::Percentile(snapshot.histogram, sampled, 0.90);
+    snapshot.p99 = CycleHistogram::Percentile(snapshot.histogram, sampled, 0.99);
+    snapshot.p999 = CycleHistogram::Percentile(snapshot.histogram, sampled, 0.999);
+
+    while (!snapshot.histogram.empty() && snapshot.histogram.back() == 0) {
+        snapshot.histogram.pop_back();
+    }
+    return snapshot;
+}
+
+HookStatsPublisher::HookStatsPublisher() {}
+
+HookStatsPublisher::~HookStatsPublisher() {
+    Stop();
+}
+
+uint32_t HookStatsPublisher::Subscribe(uint32_t rateHz, WebSocketConnection* owner) {
+    if (!owner) return 0;
+    if (rateHz == 0) rateHz = DEFAULT_RATE_HZ;
+    if (rateHz > MAX_RATE_HZ) rateHz = MAX_RATE_HZ;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Subscription subscription;
+    subscription.owner = owner;
+    subscription.interval = std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(1000000 / rateHz));
+    subscription.nextPush = Clock::now();
+
+    uint32_t subscriptionId = nextSubscriptionId++;
+    if (nextSubscriptionId == 0) nextSubscriptionId = 1;
+    subscriptions[subscriptionId] = subscription;
+
+    if (!running) {
+        running = true;
+        publisher = std::thread(&HookStatsPublisher::PublishLoop, this);
+    }
+    wakeup.notify_one();
+    return subscriptionId;
+}
+
+bool HookStatsPublisher::Unsubscribe(uint32_t subscriptionId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscriptions.erase(subscriptionId) > 0;
+}
+
+void HookStatsPublisher::UnsubscribeOwner(WebSocketConnection* owner) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = subscriptions.begin(); it != subscriptions.end();) {
+            if (it->second.owner == owner) {
+                it = subscriptions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // A round collected before the erase may still be sending to owner; wait it out so the
+    // connection is not freed under it
+    std::lock_guard<std::mutex> sending(sendMutex);
+}
+
+void HookStatsPublisher::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+        subscriptions.clear();
+    }
+    wakeup.notify_one();
+    if (publisher.joinable()) {
+        publisher.join();
+    }
+}
+
+void HookStatsPublisher::PublishLoop() {
+    std::vector<std::pair<uint32_t, WebSocketConnection*>> due;
+
+    while (true) {
+        std::unique_lock<std::mutex> sending(sendMutex, std::defer_lock);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!running) break;
+
+            if (subscriptions.empty()) {
+                wakeup.wait(lock);
+                continue;
+            }
+            Clock::time_point next = subscriptions.begin()->second.nextPush;
+            for (const auto& pair : subscriptions) {
+                if (pair.second.nextPush < next) next = pair.second.nextPush;
+            }
+            if (Clock::now() < next) {
+                wakeup.wait_until(lock, next);
+                continue;
+            }
+
+            Clock::time_point now = Clock::now();
+            for (auto& pair : subscriptions) {
+                if (pair.second.nextPush > now) continue;
+                due.emplace_back(pair.first, pair.second.owner);
+                pair.second.nextPush += pair.second.interval;
+                if (pair.second.nextPush < now) pair.second.nextPush = now + pair.second.interval;
+            }
+
+            // Taken before the lock is released, so UnsubscribeOwner cannot return while a
+            // frame collected above is still going to its owner
+            sending.lock();
+        }
+
+        // One snapshot for every subscription due this round
+        std::vector<HookStatsSnapshot> stats;
+        if (g_HookManager) {
+            for (auto& snapshot : g_HookManager->GetHookStats()) {
+                if (snapshot.enabled) stats.push_back(std::move(snapshot));
+            }
+        }
+        for (const auto& target : due) {
+            target.second->SendBinary(EncodeFrame(target.first, stats));
+        }
+        due.clear();
+    }
+}
+
+static void AppendUInt64(std::vector<uint8_t>& buffer, uint64_t value) {
+    uint8_t bytes[8];
+    memcpy(bytes, &value, sizeof(bytes));
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(bytes));
+}
+
+std::vector<uint8_t> HookStatsPublisher::EncodeFrame(uint32_t subscriptionId, const std::vector<HookStatsSnapshot>& stats) {
+    std::vector<uint8_t> payload;
+    payload.reserve(4 + stats.size() * 96);
+
+    uint32_t count = static_cast<uint32_t>(stats.size());
+    uint8_t countBytes[4];
+    memcpy(countBytes, &count, sizeof(countBytes));
+    payload.insert(payload.end(), countBytes, countBytes + sizeof(countBytes));
+
+    for (const auto& hook : stats) {
+        AppendUInt64(payload, hook.targetAddress);
+        AppendUInt64(payload, hook.calls);
+        AppendUInt64(payload, hook.timedCalls);
+        AppendUInt64(payload, hook.totalCycles);
+        AppendUInt64(payload, hook.maxCycles);
+        AppendUInt64(payload, hook.p50);
+        AppendUInt64(payload, hook.p90);
+        AppendUInt64(payload, hook.p99);
+
+        uint16_t nameLength = static_cast<uint16_t>(min(hook.name.size(), static_cast<size_t>(0xFFFF)));
+        payload.push_back(static_cast<uint8_t>(nameLength & 0xFF));
+        payload.push_back(static_cast<uint8_t>(nameLength >> 8));
+        payload.insert(payload.end(), hook.name.begin(), hook.name.begin() + nameLength);
+    }
+
+    return BinaryProtocol::EncodeMessage(BinaryOpcode::HOOK_STATS, subscriptionId, 0, payload.data(), payload.size());
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,188 @@
+#pragma once
+#include <windows.h>
+#include <intrin.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+namespace InternalEngine {
+
+class WebSocketConnection;
+
+// 📈 로그-선형 사이클 히스토그램 (HDR 방식)
+// Values below SUB_BUCKETS get a bucket each; every higher power of two is split into
+// SUB_BUCKETS linear sub-buckets, so a bucket's bounds are within 12.5% of each other.
+class CycleHistogram {
+public:
+    static const uint32_t SUB_BUCKET_BITS = 3;
+    static const uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static const uint32_t MAX_MAGNITUDE = 40;   // ~1e12 cycles; anything larger lands in the last bucket
+    static const uint32_t BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    static uint32_t BucketIndex(uint64_t cycles) {
+        if (cycles < SUB_BUCKETS) return static_cast<uint32_t>(cycles);
+
+        unsigned long magnitude;
+        uint32_t high = static_cast<uint32_t>(cycles >> 32);
+        if (high) {
+            _BitScanReverse(&magnitude, high);
+            magnitude += 32;
+        } else {
+            _BitScanReverse(&magnitude, static_cast<uint32_t>(cycles));
+        }
+        if (magnitude > MAX_MAGNITUDE) return BUCKET_COUNT - 1;
+
+        uint32_t sub = static_cast<uint32_t>(cycles >> (magnitude - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return ((magnitude - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) + sub;
+    }
+
+    // Smallest value that maps to index
+    static uint64_t BucketLowerBound(uint32_t index);
+
+    // Largest value that maps to index (the last bucket reports its lower bound)
+    static uint64_t BucketUpperBound(uint32_t index);
+
+    // Upper bound of the bucket holding the given fraction of total samples
+    static uint64_t Percentile(const std::vector<uint64_t>& buckets, uint64_t total, double fraction);
+};
+
+// Counters of the threads sharing one slot; each slot has its own cache lines so threads
+// never contend for the same line unless more than THREAD_SLOTS threads call the hook
+struct alignas(64) HookThreadSlot {
+    std::atomic<uint64_t> calls{ 0 };
+    std::atomic<uint64_t> cycles{ 0 };
+    std::atomic<uint64_t> maxCycles{ 0 };
+    std::atomic<uint32_t> buckets[CycleHistogram::BUCKET_COUNT] = {};
+};
+
+struct HookStatsSnapshot {
+    std::string name;
+    uintptr_t targetAddress = 0;
+    bool enabled = false;
+    uint64_t calls = 0;             // Counted by the call counter stub in front of the detour
+    uint64_t timedCalls = 0;        // Recorded by HookTimer
+    uint64_t totalCycles = 0;
+    uint64_t maxCycles = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    std::vector<uint64_t> histogram; // Merged bucket counts, trailing empty buckets trimmed
+};
+
+// ⏱️ 훅별 프로파일
+// The call count comes from a stub DetoursLite generates between the patched jump and the
+// detour, so every hook gets it for free. Latency is measured with rdtsc by a HookTimer in
+// the detour (HOOK_PROFILE_SCOPE) and spread over per-thread slots that are merged only when
+// stats are read. Profiles live as long as the HookManager, so detours may cache the pointer.
+class HookProfile {
+public:
+    static const size_t THREAD_SLOTS = 16;
+
+    explicit HookProfile(const std::string& name) : name(name) {}
+
+    bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    void SetEnabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+
+    void Record(uint64_t cycles) {
+        HookThreadSlot& slot = slots[CurrentThreadSlot()];
+        slot.calls.fetch_add(1, std::memory_order_relaxed);
+        slot.cycles.fetch_add(cycles, std::memory_order_relaxed);
+        slot.buckets[CycleHistogram::BucketIndex(cycles)].fetch_add(1, std::memory_order_relaxed);
+        if (cycles > slot.maxCycles.load(std::memory_order_relaxed)) {
+            slot.maxCycles.store(cycles, std::memory_order_relaxed);
+        }
+    }
+
+    // Target of the generated `lock inc`
+    volatile uint64_t* GetCallCounter() { return reinterpret_cast<volatile uint64_t*>(&callCount); }
+
+    const std::string& GetName() const { return name; }
+
+    // Merges the thread slots; reset zeroes them afterwards (samples in flight may be lost)
+    HookStatsSnapshot Snapshot(bool reset = false);
+
+private:
+    static size_t CurrentThreadSlot() {
+        static std::atomic<size_t> nextSlot{ 0 };
+        thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % THREAD_SLOTS;
+        return slot;
+    }
+
+    std::string name;
+    std::atomic<bool> enabled{ false };
+    alignas(64) std::atomic<uint64_t> callCount{ 0 };
+    HookThreadSlot slots[THREAD_SLOTS];
+};
+
+// Times the enclosing scope of a detour; does nothing while profiling is off
+class HookTimer {
+public:
+    explicit HookTimer(HookProfile* profile)
+        : profile(profile && profile->IsEnabled() ? profile : nullptr), start(this->profile ? __rdtsc() : 0) {}
+
+    ~HookTimer() {
+        if (profile) profile->Record(__rdtsc() - start);
+    }
+
+    HookTimer(const HookTimer&) = delete;
+    HookTimer& operator=(const HookTimer&) = delete;
+
+private:
+    HookProfile* profile;
+    uint64_t start;
+};
+
+// 📡 훅 통계 푸시
+// Pushes HOOK_STATS frames (requestId = subscription id) with every profiled hook at the
+// subscription's rate. Same threading model as WatchManager: one thread, frames go to the
+// subscription's owner outside the lock, and its subscriptions are dropped on disconnect.
+class HookStatsPublisher {
+public:
+    static const uint32_t DEFAULT_RATE_HZ = 4;
+    static const uint32_t MAX_RATE_HZ = 60;
+
+    HookStatsPublisher();
+    ~HookStatsPublisher();
+
+    // Frames go to owner (required, 0 is returned without one)
+    uint32_t Subscribe(uint32_t rateHz, WebSocketConnection* owner);
+    bool Unsubscribe(uint32_t subscriptionId);
+    // Also waits for a send to owner already under way (called before owner is freed)
+    void UnsubscribeOwner(WebSocketConnection* owner);
+
+    void Stop();
+
+    // HOOK_STATS payload (little-endian): count u32, then per hook target u64, calls u64,
+    // timedCalls u64, totalCycles u64, maxCycles u64, p50 u64, p90 u64, p99 u64,
+    // nameLength u16 and the name bytes
+    static std::vector<uint8_t> EncodeFrame(uint32_t subscriptionId, const std::vector<HookStatsSnapshot>& stats);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Subscription {
+        WebSocketConnection* owner = nullptr;
+        Clock::duration interval;
+        Clock::time_point nextPush;
+    };
+
+    void PublishLoop();
+
+    std::mutex mutex;
+    std::mutex sendMutex;           // Held while a round's frames are sent
+    std::condition_variable wakeup;
+    std::unordered_map<uint32_t, Subscription> subscriptions;
+    uint32_t nextSubscriptionId = 1;
+
+    std::thread publisher;
+    bool running = false;
+};
+
+} // namespace InternalEngine
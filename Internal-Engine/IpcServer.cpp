@@ -2,6 +2,11 @@
 #include "CommandRouter.hpp"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #include <winsock.h>
 #pragma comment(lib, "ws2_32.lib")
@@ -67,6 +72,11 @@ void IpcServer::Stop() {
         LogIpcToConsole("Server thread finished");
     }
     
+    // Client threads notice running within one poll interval (after a running command returns)
+    while (activeClients > 0) {
+        Sleep(10);
+    }
+    
     CleanupWinsock();
 }
 
@@ -181,11 +191,15 @@ void IpcServer::ServerLoop() {
             
             SOCKET clientSocket = accept(serverSocket, (sockaddr*)&clientAddr, &clientAddrLen);
             if (clientSocket != INVALID_SOCKET) {
-                // 연결 로그는 POST 요청 시에만 출력하도록 HandleClient에서 처리
-                
-                // 클라이언트 처리를 별도 스레드에서 실행
-                std::thread clientThread(&IpcServer::HandleClient, this, clientSocket);
-                clientThread.detach();
+                if (activeClients >= MAX_CLIENTS) {
+                    LogIpcToConsole("Too many clients - connection refused");
+                    closesocket(clientSocket);
+                } else {
+                    // 클라이언트 처리를 별도 스레드에서 실행 (keep-alive: the thread lives as long as the connection)
+                    activeClients++;
+                    std::thread clientThread(&IpcServer::HandleClient, this, clientSocket);
+                    clientThread.detach();
+                }
             }
         } else if (selectResult == SOCKET_ERROR) {
             if (running) {
@@ -201,85 +215,395 @@ void IpcServer::ServerLoop() {
     LogIpcToConsole("=== HTTP Server Loop Ended ===");
 }
 
-void IpcServer::HandleClient(SOCKET clientSocket) {
-    char buffer[8192];
-    int bytesReceived = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
+// 📥 HTTP 수신 버퍼
+// One buffer per connection for every request on it: consumed bytes are dropped by moving the
+// unread tail to the front, so it only grows to the largest request the client sent
+class HttpInput {
+public:
+    const char* Data() const { return buffer.data() + start; }
+    size_t Size() const { return end - start; }
+    
+    // At least minimum writable bytes at WriteSpace(); Commit() makes them part of the input
+    char* WriteSpace(size_t minimum) {
+        if (buffer.size() - end < minimum && start > 0) {
+            memmove(buffer.data(), buffer.data() + start, end - start);
+            end -= start;
+            start = 0;
+        }
+        if (buffer.size() - end < minimum) {
+            buffer.resize(end + minimum);
+        }
+        return buffer.data() + end;
+    }
+    
+    void Commit(size_t length) { end += length; }
+    
+    void Consume(size_t length) {
+        start += length;
+        if (start == end) start = end = 0;
+    }
+    
+private:
+    std::vector<char> buffer;
+    size_t start = 0;
+    size_t end = 0;
+};
+
+struct IpcServer::HttpRequest {
+    std::string method;
+    std::string body;
+    bool http11 = false;
+    bool keepAlive = false;
+};
+
+enum class HttpParse { Incomplete, Ready, Invalid, TooLarge };
+
+static const size_t RECV_CHUNK_SIZE = 64 * 1024;
+static const long CLIENT_POLL_INTERVAL_MS = 100;
+
+static const char* FindCrlf(const char* begin, const char* end) {
+    for (const char* p = begin; p + 1 < end; p++) {
+        if (p[0] == '\r' && p[1] == '\n') return p;
+    }
+    return nullptr;
+}
+
+static bool HeaderIs(const char* name, size_t length, const char* expected) {
+    return length == strlen(expected) && _strnicmp(name, expected, length) == 0;
+}
+
+static bool ValueContains(const std::string& value, const char* token) {
+    std::string lower(value);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return lower.find(token) != std::string::npos;
+}
+
+// A chunked body that is still arriving: the chunks already walked are decoded once and
+// skipped when more input comes in, so a large body is not rescanned on every recv
+struct ChunkedProgress {
+    size_t offset = 0;      // Encoded bytes walked so far, from the start of the body
+    std::string body;       // Decoded bytes of those chunks
     
-    if (bytesReceived > 0) {
-        buffer[bytesReceived] = '\0';
-        std::string request(buffer);
+    void Reset() {
+        offset = 0;
+        body.clear();
+    }
+};
+
+// Walks a chunked body from where progress left off; consumed receives its encoded size
+static HttpParse ScanChunkedBody(const char* begin, const char* end, ChunkedProgress& progress, size_t& consumed) {
+    const char* p = begin + progress.offset;
+    while (true) {
+        const char* lineEnd = FindCrlf(p, end);
+        if (!lineEnd) return (end - p > 1024) ? HttpParse::Invalid : HttpParse::Incomplete;
         
-        // HTTP 메서드 확인
-        if (request.find("POST") == 0) {
-            // POST 요청 처리 - 실제 명령
-            LogIpcToConsole("📤 Processing command request (" + std::to_string(bytesReceived) + " bytes)");
-            
-            std::string body = ParseHttpBody(request);
-            if (!body.empty()) {
-                LogIpcToConsole("Request: " + body);
-                
-                // CommandRouter 사용
-                if (!g_CommandRouter) {
-                    g_CommandRouter = new CommandRouter();
-                }
-                
-                std::string jsonResponse = g_CommandRouter->ExecuteCommand(body);
-                std::string httpResponse = CreateHttpResponse(jsonResponse, "application/json");
-                
-                int bytesSent = send(clientSocket, httpResponse.c_str(), static_cast<int>(httpResponse.length()), 0);
-                if (bytesSent > 0) {
-                    LogIpcToConsole("📥 Response sent (" + std::to_string(bytesSent) + " bytes)");
-                } else {
-                    LogIpcToConsole("❌ Failed to send response");
-                }
-            } else {
-                LogIpcToConsole("❌ Empty request body in POST request");
-                std::string errorResponse = CreateHttpResponse("{\"success\":false,\"error\":\"Empty request body\"}", "application/json");
-                send(clientSocket, errorResponse.c_str(), static_cast<int>(errorResponse.length()), 0);
+        // Chunk extensions after ';' are ignored
+        char* sizeEnd = nullptr;
+        unsigned long long chunkSize = strtoull(p, &sizeEnd, 16);
+        if (sizeEnd == p || (sizeEnd != lineEnd && *sizeEnd != ';')) return HttpParse::Invalid;
+        p = lineEnd + 2;
+        
+        if (chunkSize == 0) {
+            // Trailer section: header lines up to an empty line
+            while (true) {
+                const char* trailerEnd = FindCrlf(p, end);
+                if (!trailerEnd) return HttpParse::Incomplete;
+                bool last = trailerEnd == p;
+                p = trailerEnd + 2;
+                if (last) break;
             }
-        } else if (request.find("GET") == 0) {
-            // GET 요청 - 상태 확인 (로그 없음, Keep-Alive 체크)
-            std::string statusResponse = CreateHttpResponse("{\"status\":\"running\",\"message\":\"Internal Engine IPC Server\"}", "application/json");
-            send(clientSocket, statusResponse.c_str(), static_cast<int>(statusResponse.length()), 0);
+            consumed = static_cast<size_t>(p - begin);
+            return HttpParse::Ready;
+        }
+        
+        if (chunkSize > IpcServer::MAX_BODY_SIZE - progress.body.size()) return HttpParse::TooLarge;
+        if (static_cast<size_t>(end - p) < chunkSize + 2) return HttpParse::Incomplete;
+        if (p[chunkSize] != '\r' || p[chunkSize + 1] != '\n') return HttpParse::Invalid;
+        progress.body.append(p, static_cast<size_t>(chunkSize));
+        p += chunkSize + 2;
+        progress.offset = static_cast<size_t>(p - begin);
+    }
+}
+
+// Parses the request at the front of the input; consumed is its size on the wire. chunked
+// carries a partly received chunked body between calls for the same request.
+static HttpParse ParseHttpRequest(const char* data, size_t size, IpcServer::HttpRequest& request, size_t& consumed,
+                                  ChunkedProgress& chunked) {
+    const char* end = data + size;
+    const char* headerEnd = nullptr;
+    for (const char* p = data; p + 3 < end; p++) {
+        if (p[0] == '\r' && p[1] == '\n' && p[2] == '\r' && p[3] == '\n') {
+            headerEnd = p;
+            break;
+        }
+    }
+    if (!headerEnd) {
+        return size > IpcServer::MAX_HEADER_SIZE ? HttpParse::TooLarge : HttpParse::Incomplete;
+    }
+    
+    // Request line: METHOD SP target SP HTTP/x.y
+    const char* lineEnd = FindCrlf(data, headerEnd + 2);
+    std::string requestLine(data, lineEnd);
+    size_t methodEnd = requestLine.find(' ');
+    size_t targetEnd = requestLine.rfind(' ');
+    if (methodEnd == std::string::npos || targetEnd == methodEnd) return HttpParse::Invalid;
+    std::string version = requestLine.substr(targetEnd + 1);
+    if (version.compare(0, 5, "HTTP/") != 0) return HttpParse::Invalid;
+    
+    request.method = requestLine.substr(0, methodEnd);
+    request.http11 = version != "HTTP/1.0";
+    request.keepAlive = request.http11;
+    request.body.clear();
+    
+    size_t contentLength = 0;
+    bool isChunked = false;
+    for (const char* line = lineEnd + 2; line < headerEnd + 2;) {
+        const char* next = FindCrlf(line, headerEnd + 2);
+        const char* colon = static_cast<const char*>(memchr(line, ':', next - line));
+        if (!colon) return HttpParse::Invalid;
+        
+        const char* valueStart = colon + 1;
+        while (valueStart < next && (*valueStart == ' ' || *valueStart == '\t')) valueStart++;
+        std::string value(valueStart, next);
+        size_t nameLength = static_cast<size_t>(colon - line);
+        
+        if (HeaderIs(line, nameLength, "Content-Length")) {
+            char* numberEnd = nullptr;
+            unsigned long long length = strtoull(value.c_str(), &numberEnd, 10);
+            if (numberEnd == value.c_str()) return HttpParse::Invalid;
+            if (length > IpcServer::MAX_BODY_SIZE) return HttpParse::TooLarge;
+            contentLength = static_cast<size_t>(length);
+        } else if (HeaderIs(line, nameLength, "Transfer-Encoding")) {
+            isChunked = ValueContains(value, "chunked");
+        } else if (HeaderIs(line, nameLength, "Connection")) {
+            if (ValueContains(value, "close")) request.keepAlive = false;
+            else if (ValueContains(value, "keep-alive")) request.keepAlive = true;
+        }
+        line = next + 2;
+    }
+    
+    const char* body = headerEnd + 4;
+    size_t headerSize = static_cast<size_t>(body - data);
+    if (isChunked) {
+        size_t encodedSize = 0;
+        HttpParse result = ScanChunkedBody(body, end, chunked, encodedSize);
+        if (result != HttpParse::Ready) return result;
+        request.body.swap(chunked.body);
+        chunked.Reset();
+        consumed = headerSize + encodedSize;
+        return HttpParse::Ready;
+    }
+    
+    if (static_cast<size_t>(end - body) < contentLength) return HttpParse::Incomplete;
+    request.body.assign(body, contentLength);
+    consumed = headerSize + contentLength;
+    return HttpParse::Ready;
+}
+
+static const char* StatusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        default: return "Internal Server Error";
+    }
+}
+
+static bool SendAll(SOCKET socket, const char* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        int chunk = static_cast<int>(min(size - total, static_cast<size_t>(INT_MAX)));
+        int sent = send(socket, data + total, chunk, 0);
+        if (sent == SOCKET_ERROR || sent == 0) {
+            return false;
+        }
+        total += static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+// 📤 HTTP 응답 작성
+// Responses are appended to one output buffer that is flushed after every response, or
+// whenever it reaches CHUNK_SIZE, so a large one streams out without being copied whole.
+// Pipelined requests are not held back: each answer leaves before the next request runs.
+class IpcServer::ResponseWriter {
+public:
+    // The output buffer is released after a response made it larger than this
+    static const size_t MAX_RETAINED_BUFFER = 1024 * 1024;
+    
+    explicit ResponseWriter(SOCKET socket) : socket(socket) {}
+    
+    bool Write(const HttpRequest& request, int status, const std::string& body, bool keepAlive) {
+        bool chunked = request.http11 && body.size() > CHUNKED_RESPONSE_THRESHOLD;
+        
+        char head[512];
+        int headLength = snprintf(head, sizeof(head),
+            "HTTP/1.1 %d %s\r\n"
+            "Content-Type: application/json\r\n"
+            "Access-Control-Allow-Origin: *\r\n"
+            "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+            "Access-Control-Allow-Headers: Content-Type\r\n",
+            status, StatusText(status));
+        Append(head, static_cast<size_t>(headLength));
+        
+        if (keepAlive) {
+            headLength = snprintf(head, sizeof(head), "Connection: keep-alive\r\nKeep-Alive: timeout=%lu\r\n",
+                                  static_cast<unsigned long>(KEEP_ALIVE_TIMEOUT_MS / 1000));
         } else {
-            // 지원하지 않는 메서드
-            LogIpcToConsole("❌ Unsupported HTTP method");
-            std::string errorResponse = CreateHttpResponse("{\"success\":false,\"error\":\"Method not allowed\"}", "application/json");
-            send(clientSocket, errorResponse.c_str(), static_cast<int>(errorResponse.length()), 0);
+            headLength = snprintf(head, sizeof(head), "Connection: close\r\n");
         }
-    } else if (bytesReceived == 0) {
-        // 클라이언트가 연결을 정상적으로 종료
-    } else {
-        // 에러 발생
-        LogIpcToConsole("❌ Error receiving data from client");
+        Append(head, static_cast<size_t>(headLength));
+        
+        if (chunked) {
+            Append("Transfer-Encoding: chunked\r\n\r\n", 30);
+            for (size_t offset = 0; offset < body.size(); offset += CHUNK_SIZE) {
+                size_t length = min(CHUNK_SIZE, body.size() - offset);
+                headLength = snprintf(head, sizeof(head), "%zx\r\n", length);
+                Append(head, static_cast<size_t>(headLength));
+                Append(body.data() + offset, length);
+                Append("\r\n", 2);
+            }
+            Append("0\r\n\r\n", 5);
+        } else if (status == 204) {
+            Append("\r\n", 2);
+        } else {
+            headLength = snprintf(head, sizeof(head), "Content-Length: %zu\r\n\r\n", body.size());
+            Append(head, static_cast<size_t>(headLength));
+            Append(body.data(), body.size());
+        }
+        return !failed;
+    }
+    
+    bool Flush() {
+        if (!failed && !output.empty()) {
+            failed = !SendAll(socket, output.data(), output.size());
+        }
+        output.clear();
+        if (output.capacity() > MAX_RETAINED_BUFFER) {
+            std::string().swap(output);
+        }
+        return !failed;
+    }
+    
+private:
+    void Append(const char* data, size_t size) {
+        while (size > 0 && !failed) {
+            size_t take = min(size, CHUNK_SIZE - min(output.size(), CHUNK_SIZE));
+            if (take == 0) {
+                Flush();
+                continue;
+            }
+            output.append(data, take);
+            data += take;
+            size -= take;
+        }
+    }
+    
+    SOCKET socket;
+    std::string output;
+    bool failed = false;
+};
+
+void IpcServer::HandleClient(SOCKET clientSocket) {
+    // Each response is flushed as soon as it is complete; Nagle would hold a small
+    // response back until the client's delayed ACK for the previous one
+    BOOL noDelay = TRUE;
+    setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    DWORD sendTimeout = SEND_TIMEOUT_MS;
+    setsockopt(clientSocket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&sendTimeout), sizeof(sendTimeout));
+    
+    HttpInput input;
+    HttpRequest request;
+    ChunkedProgress chunked;
+    ResponseWriter writer(clientSocket);
+    ULONGLONG lastActivity = GetTickCount64();
+    bool open = true;
+    
+    while (open && running) {
+        // Every complete request already buffered is answered before reading again (pipelining)
+        while (open) {
+            size_t consumed = 0;
+            HttpParse result = ParseHttpRequest(input.Data(), input.Size(), request, consumed, chunked);
+            if (result == HttpParse::Incomplete) break;
+            
+            if (result != HttpParse::Ready) {
+                // The stream cannot be re-synchronized after a malformed request
+                LogIpcToConsole(result == HttpParse::TooLarge ? "❌ Request too large" : "❌ Malformed HTTP request");
+                request.http11 = true;
+                int status = result == HttpParse::TooLarge ? 413 : 400;
+                writer.Write(request, status, result == HttpParse::TooLarge ? "{\"success\":false,\"error\":\"Request too large\"}"
+                                                                           : "{\"success\":false,\"error\":\"Bad request\"}", false);
+                open = false;
+                break;
+            }
+            
+            input.Consume(consumed);
+            open = HandleRequest(request, writer) && writer.Flush();
+        }
+        
+        if (!writer.Flush() || !open) break;
+        
+        // Wait for more input, noticing Stop() within one poll interval
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(clientSocket, &readfds);
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = CLIENT_POLL_INTERVAL_MS * 1000;
+        
+        int ready = select(0, &readfds, nullptr, nullptr, &timeout);
+        if (ready == SOCKET_ERROR) break;
+        if (ready == 0) {
+            if (GetTickCount64() - lastActivity >= KEEP_ALIVE_TIMEOUT_MS) break;
+            continue;
+        }
+        
+        int received = recv(clientSocket, input.WriteSpace(RECV_CHUNK_SIZE), static_cast<int>(RECV_CHUNK_SIZE), 0);
+        if (received <= 0) {
+            // 0: the client closed the connection (e.g. its keep-alive pool dropped it)
+            break;
+        }
+        input.Commit(static_cast<size_t>(received));
+        lastActivity = GetTickCount64();
     }
     
     // 연결 종료 (로그 없음)
     closesocket(clientSocket);
+    activeClients--;
 }
 
-std::string IpcServer::ParseHttpBody(const std::string& request) {
-    // HTTP 헤더와 바디 구분
-    size_t headerEnd = request.find("\r\n\r\n");
-    if (headerEnd != std::string::npos) {
-        return request.substr(headerEnd + 4);
+bool IpcServer::HandleRequest(const HttpRequest& request, ResponseWriter& writer) {
+    if (request.method == "POST") {
+        // POST 요청 처리 - 실제 명령 (no per-request logging: this is the bridge's hot path)
+        if (request.body.empty()) {
+            LogIpcToConsole("❌ Empty request body in POST request");
+            return writer.Write(request, 200, "{\"success\":false,\"error\":\"Empty request body\"}", request.keepAlive) && request.keepAlive;
+        }
+        
+        // CommandRouter 사용
+        if (!g_CommandRouter) {
+            g_CommandRouter = new CommandRouter();
+        }
+        
+        std::string jsonResponse = g_CommandRouter->ExecuteCommand(request.body);
+        return writer.Write(request, 200, jsonResponse, request.keepAlive) && request.keepAlive;
     }
-    return "";
-}
-
-std::string IpcServer::CreateHttpResponse(const std::string& body, const std::string& contentType) {
-    std::stringstream response;
-    response << "HTTP/1.1 200 OK\r\n";
-    response << "Content-Type: " << contentType << "\r\n";
-    response << "Content-Length: " << body.length() << "\r\n";
-    response << "Access-Control-Allow-Origin: *\r\n";
-    response << "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
-    response << "Access-Control-Allow-Headers: Content-Type\r\n";
-    response << "Connection: close\r\n";
-    response << "\r\n";
-    response << body;
-    
-    return response.str();
+    
+    if (request.method == "GET") {
+        // GET 요청 - 상태 확인 (로그 없음, Keep-Alive 체크)
+        return writer.Write(request, 200, "{\"status\":\"running\",\"message\":\"Internal Engine IPC Server\"}", request.keepAlive) && request.keepAlive;
+    }
+    
+    if (request.method == "OPTIONS") {
+        // CORS preflight
+        return writer.Write(request, 204, "", request.keepAlive) && request.keepAlive;
+    }
+    
+    // 지원하지 않는 메서드
+    LogIpcToConsole("❌ Unsupported HTTP method: " + request.method);
+    return writer.Write(request, 405, "{\"success\":false,\"error\":\"Method not allowed\"}", request.keepAlive) && request.keepAlive;
 }
 
 void IpcServer::ProcessMessages() {
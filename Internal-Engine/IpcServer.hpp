@@ -15,8 +15,28 @@ namespace InternalEngine {
 // Message handler function type
 using MessageHandler = std::function<std::string(const std::string& message)>;
 
+// HTTP/1.1 command endpoint for the Node bridge. Each client gets a thread that keeps its
+// connection open (keep-alive) and answers pipelined requests in order out of one receive
+// buffer reused for the whole connection; large responses are sent with chunked transfer
+// encoding straight from the response string.
 class IpcServer {
 public:
+    // Idle keep-alive connections are closed after this long (advertised in Keep-Alive)
+    static const DWORD KEEP_ALIVE_TIMEOUT_MS = 30000;
+    static const DWORD SEND_TIMEOUT_MS = 5000;
+    static const size_t MAX_CLIENTS = 32;
+    
+    static const size_t MAX_HEADER_SIZE = 16 * 1024;
+    static const size_t MAX_BODY_SIZE = 64 * 1024 * 1024;
+    
+    // Responses larger than this go out chunked (HTTP/1.1 clients), CHUNK_SIZE bytes per chunk
+    static const size_t CHUNKED_RESPONSE_THRESHOLD = 64 * 1024;
+    static const size_t CHUNK_SIZE = 64 * 1024;
+    
+    // Connection internals, defined in IpcServer.cpp
+    struct HttpRequest;
+    class ResponseWriter;
+    
     IpcServer(uint16_t port = 8767); // Changed from 8765 to avoid WebSocket conflict
     ~IpcServer();
 
@@ -36,6 +56,7 @@ private:
     std::unique_ptr<std::thread> serverThread;
     
     SOCKET serverSocket;
+    std::atomic<size_t> activeClients{ 0 };
     
     MessageHandler messageHandler;
     std::mutex queueMutex;
@@ -48,8 +69,9 @@ private:
     
     bool InitializeWinsock();
     void CleanupWinsock();
-    std::string ParseHttpBody(const std::string& request);
-    std::string CreateHttpResponse(const std::string& body, const std::string& contentType = "application/json");
+    
+    // Answers one parsed request; false when the connection must be closed afterwards
+    bool HandleRequest(const HttpRequest& request, ResponseWriter& writer);
 };
 
 // Global IPC server instance
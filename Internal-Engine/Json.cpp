@@ -0,0 +1,385 @@
+#include "Json.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+namespace InternalEngine {
+
+static void SkipWhitespace(std::string_view text, size_t& pos) {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+        pos++;
+    }
+}
+
+// text[pos] is the opening quote
+static bool ParseString(std::string_view text, size_t& pos, JsonValue& value) {
+    size_t start = ++pos;
+    bool escaped = false;
+    while (pos < text.size()) {
+        char c = text[pos];
+        if (c == '\\') {
+            escaped = true;
+            pos += 2;
+        } else if (c == '"') {
+            value.type = JsonType::String;
+            value.raw = text.substr(start, pos - start);
+            value.escaped = escaped;
+            pos++;
+            return true;
+        } else {
+            pos++;
+        }
+    }
+    return false;
+}
+
+// text[pos] is '{' or '['; nested containers are skipped by bracket depth, not validated
+static bool ParseContainer(std::string_view text, size_t& pos, JsonValue& value) {
+    size_t start = pos;
+    int depth = 0;
+    bool inString = false;
+    for (; pos < text.size(); pos++) {
+        char c = text[pos];
+        if (inString) {
+            if (c == '\\') pos++;
+            else if (c == '"') inString = false;
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if ((c == '}' || c == ']') && --depth == 0) {
+            pos++;
+            value.type = (text[start] == '{') ? JsonType::Object : JsonType::Array;
+            value.raw = text.substr(start, pos - start);
+            value.escaped = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Numbers, true/false/null - and, like the old extractor, bare tokens such as 0x1234
+static bool ParseBareToken(std::string_view text, size_t& pos, JsonValue& value) {
+    size_t start = pos;
+    while (pos < text.size()) {
+        char c = text[pos];
+        if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\n' || c == '\r') break;
+        pos++;
+    }
+    if (pos == start) return false;
+
+    value.raw = text.substr(start, pos - start);
+    value.escaped = false;
+    if (value.raw == "true" || value.raw == "false") value.type = JsonType::Bool;
+    else if (value.raw == "null") value.type = JsonType::Null;
+    else value.type = JsonType::Number;
+    return true;
+}
+
+bool ParseJsonValue(std::string_view text, size_t& pos, JsonValue& value) {
+    SkipWhitespace(text, pos);
+    if (pos >= text.size()) return false;
+
+    switch (text[pos]) {
+        case '"': return ParseString(text, pos, value);
+        case '{':
+        case '[': return ParseContainer(text, pos, value);
+        default:  return ParseBareToken(text, pos, value);
+    }
+}
+
+// Walks the members of the object in text; visit returns false to stop early
+template<typename Visitor>
+static bool VisitMembers(std::string_view text, Visitor&& visit) {
+    size_t pos = 0;
+    SkipWhitespace(text, pos);
+    if (pos >= text.size() || text[pos] != '{') return false;
+    pos++;
+
+    while (true) {
+        SkipWhitespace(text, pos);
+        if (pos >= text.size()) return false;
+        if (text[pos] == '}') return true;
+
+        JsonValue key;
+        if (text[pos] != '"' || !ParseString(text, pos, key)) return false;
+
+        SkipWhitespace(text, pos);
+        if (pos >= text.size() || text[pos] != ':') return false;
+        pos++;
+
+        JsonValue value;
+        if (!ParseJsonValue(text, pos, value)) return false;
+        if (!visit(key.raw, value)) return true;
+
+        SkipWhitespace(text, pos);
+        if (pos >= text.size()) return false;
+        if (text[pos] == ',') {
+            pos++;
+        } else if (text[pos] == '}') {
+            return true;
+        } else {
+            return false;
+        }
+    }
+}
+
+bool JsonObject::Parse(std::string_view text) {
+    source = text;
+    members.clear();
+    return VisitMembers(text, [this](std::string_view key, const JsonValue& value) {
+        members.emplace_back(key, value);
+        return true;
+    });
+}
+
+JsonValue JsonObject::Get(std::string_view key) const {
+    for (const auto& member : members) {
+        if (member.first == key) return member.second;
+    }
+    return JsonValue();
+}
+
+JsonValue FindJsonMember(std::string_view object, std::string_view key) {
+    JsonValue found;
+    VisitMembers(object, [&](std::string_view name, const JsonValue& value) {
+        if (name != key) return true;
+        found = value;
+        return false;
+    });
+    return found;
+}
+
+JsonArrayReader::JsonArrayReader(const JsonValue& array) {
+    if (array.type == JsonType::Array) {
+        text = array.raw;
+        pos = 1;
+    } else {
+        done = true;
+    }
+}
+
+bool JsonArrayReader::Next(JsonValue& element) {
+    if (done) return false;
+
+    SkipWhitespace(text, pos);
+    if (pos >= text.size() || text[pos] == ']' || !ParseJsonValue(text, pos, element)) {
+        done = true;
+        return false;
+    }
+
+    SkipWhitespace(text, pos);
+    if (pos < text.size() && text[pos] == ',') {
+        pos++;
+    } else {
+        done = true; // ']' (or garbage) - this element is still returned
+    }
+    return true;
+}
+
+static void AppendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+static bool ParseHex4(std::string_view raw, size_t pos, uint32_t& value) {
+    if (pos + 4 > raw.size()) return false;
+    auto result = std::from_chars(raw.data() + pos, raw.data() + pos + 4, value, 16);
+    return result.ec == std::errc() && result.ptr == raw.data() + pos + 4;
+}
+
+std::string UnescapeJsonString(std::string_view raw) {
+    std::string out;
+    out.reserve(raw.size());
+
+    for (size_t i = 0; i < raw.size(); i++) {
+        char c = raw[i];
+        if (c != '\\' || i + 1 >= raw.size()) {
+            out += c;
+            continue;
+        }
+
+        char escape = raw[++i];
+        switch (escape) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t codepoint;
+                if (!ParseHex4(raw, i + 1, codepoint)) {
+                    out += "\\u";
+                    break;
+                }
+                i += 4;
+
+                // Surrogate pair
+                uint32_t low;
+                if (codepoint >= 0xD800 && codepoint < 0xDC00 && i + 2 < raw.size() &&
+                    raw[i + 1] == '\\' && raw[i + 2] == 'u' && ParseHex4(raw, i + 3, low) &&
+                    low >= 0xDC00 && low < 0xE000) {
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                AppendUtf8(out, codepoint);
+                break;
+            }
+            default: out += escape; break; // \" \\ \/
+        }
+    }
+    return out;
+}
+
+std::string JsonValue::ToString() const {
+    if (type == JsonType::Invalid) return std::string();
+    if (type == JsonType::String && escaped) return UnescapeJsonString(raw);
+    return std::string(raw);
+}
+
+void AppendJsonEscaped(std::string& out, std::string_view text) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    size_t plainStart = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        // Copy runs of plain characters in one go
+        out.append(text.data() + plainStart, i - plainStart);
+        plainStart = i + 1;
+
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += hexDigits[c >> 4];
+                out += hexDigits[c & 0xF];
+                break;
+        }
+    }
+    out.append(text.data() + plainStart, text.size() - plainStart);
+}
+
+// ✍️ JsonWriter
+void JsonWriter::Separate() {
+    if (needComma) out += ',';
+    needComma = true;
+}
+
+JsonWriter& JsonWriter::BeginObject() {
+    Separate();
+    out += '{';
+    needComma = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndObject() {
+    out += '}';
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray() {
+    Separate();
+    out += '[';
+    needComma = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndArray() {
+    out += ']';
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key) {
+    Separate();
+    out += '"';
+    out.append(key.data(), key.size());
+    out += "\":";
+    needComma = false; // The value follows directly
+    return *this;
+}
+
+JsonWriter& JsonWriter::String(std::string_view value) {
+    Separate();
+    out += '"';
+    AppendJsonEscaped(out, value);
+    out += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::Int(int64_t value) {
+    Separate();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr - buffer);
+    return *this;
+}
+
+JsonWriter& JsonWriter::UInt(uint64_t value) {
+    Separate();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr - buffer);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Double(double value) {
+    if (!std::isfinite(value)) return Null(); // JSON has no NaN/Infinity
+    Separate();
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%.17g", value);
+    if (length > 0) out.append(buffer, static_cast<size_t>(length));
+    return *this;
+}
+
+JsonWriter& JsonWriter::Bool(bool value) {
+    Separate();
+    out += value ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::Null() {
+    Separate();
+    out += "null";
+    return *this;
+}
+
+JsonWriter& JsonWriter::Hex(uint64_t value) {
+    Separate();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, 16);
+    out += "\"0x";
+    out.append(buffer, result.ptr - buffer);
+    out += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::Raw(std::string_view json) {
+    Separate();
+    out.append(json.data(), json.size());
+    return *this;
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,109 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace InternalEngine {
+
+enum class JsonType : uint8_t {
+    Invalid,
+    String,
+    Number,
+    Bool,
+    Null,
+    Object,
+    Array
+};
+
+// A value as a slice of the source text; nothing is copied until ToString()
+struct JsonValue {
+    JsonType type = JsonType::Invalid;
+    std::string_view raw;       // String: between the quotes, escapes intact. Object/Array: brackets included.
+    bool escaped = false;       // String contains backslash escapes
+
+    explicit operator bool() const { return type != JsonType::Invalid; }
+
+    // Unescaped contents for strings, raw text for everything else, "" when invalid
+    std::string ToString() const;
+};
+
+// 🧾 JSON 토크나이저
+// One pass over an object records every top-level member as (key, value) slices of the
+// source, so a handler's lookups are a short linear search instead of a scan of the whole
+// request per key. The member vector keeps its capacity across Parse calls; a reader that
+// lives for a whole thread tokenizes requests without allocating.
+class JsonObject {
+public:
+    using Member = std::pair<std::string_view, JsonValue>;
+
+    // Returns false if text is not a well-formed object (members parsed so far remain)
+    bool Parse(std::string_view text);
+
+    // Member value, or an Invalid value when the key is missing. Keys compare raw.
+    JsonValue Get(std::string_view key) const;
+
+    const std::vector<Member>& Members() const { return members; }
+    std::string_view Source() const { return source; }
+
+private:
+    std::string_view source;
+    std::vector<Member> members;
+};
+
+// Elements of an array value, in order
+class JsonArrayReader {
+public:
+    explicit JsonArrayReader(const JsonValue& array);
+
+    // Next element; returns false at the end or on malformed input
+    bool Next(JsonValue& element);
+
+private:
+    std::string_view text;
+    size_t pos = 0;
+    bool done = false;
+};
+
+// Parses the value starting at text[pos] (after whitespace) and moves pos past it
+bool ParseJsonValue(std::string_view text, size_t& pos, JsonValue& value);
+
+// Single member of an object without tokenizing the rest (stops at the key)
+JsonValue FindJsonMember(std::string_view object, std::string_view key);
+
+std::string UnescapeJsonString(std::string_view raw);
+void AppendJsonEscaped(std::string& out, std::string_view text);
+
+// ✍️ JSON 직렬화
+// Appends straight into a caller-owned buffer, so the caller decides how large to reserve
+// and whether to reuse it. Commas are inserted automatically; numbers never go through
+// iostreams, so there is no formatting state to leak between fields.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& buffer) : out(buffer) {}
+
+    JsonWriter& BeginObject();
+    JsonWriter& EndObject();
+    JsonWriter& BeginArray();
+    JsonWriter& EndArray();
+
+    JsonWriter& Key(std::string_view key);          // key must not need escaping
+
+    JsonWriter& String(std::string_view value);     // Escaped
+    JsonWriter& Int(int64_t value);
+    JsonWriter& UInt(uint64_t value);
+    JsonWriter& Double(double value);
+    JsonWriter& Bool(bool value);
+    JsonWriter& Null();
+    JsonWriter& Hex(uint64_t value);                // "0x1a2b" (as a string)
+    JsonWriter& Raw(std::string_view json);         // Already serialized JSON value
+
+private:
+    void Separate();
+
+    std::string& out;
+    bool needComma = false;
+};
+
+} // namespace InternalEngine
@@ -1,10 +1,21 @@
 #include "MemoryEngine.hpp"
+#include "WorkStealingPool.hpp"
+#include "SimdScan.hpp"
+#include "ScanResultStore.hpp"
+#include "ScanFilter.hpp"
+#include "RegionMap.hpp"
+#include "RegionReader.hpp"
+#include "EngineMetrics.hpp"
 #include <Psapi.h>
 #include <TlHelp32.h>
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
 #include <cstring>
+#include <iterator>
+#include <mutex>
+#include <numeric>
 
 namespace InternalEngine {
 
@@ -12,46 +23,37 @@ MemoryEngine::MemoryEngine() {}
 MemoryEngine::~MemoryEngine() {}
 
 // 🛡️ 안전한 메모리 접근 확인
-bool MemoryEngine::IsAddressValid(uintptr_t address, size_t size) {
+// Checks go through the RegionMap cache. A positive cached answer is trusted (the access
+// itself is SEH-guarded); a negative one is confirmed with a live query before refusing.
+static bool CheckAddressRange(uintptr_t address, size_t size, bool needRead, bool needWrite) {
     if (address == 0) return false;
     
-    MEMORY_BASIC_INFORMATION mbi;
-    if (VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) == 0) {
-        return false;
-    }
-    
-    // 커밋된 메모리인지 확인
-    if (mbi.State != MEM_COMMIT) {
-        return false;
-    }
-    
     // 주소 범위가 유효한지 확인
-    uintptr_t endAddress = address + size - 1;
-    uintptr_t regionEnd = reinterpret_cast<uintptr_t>(mbi.BaseAddress) + mbi.RegionSize - 1;
+    uintptr_t lastAddress = address + (size ? size - 1 : 0);
     
-    return endAddress <= regionEnd;
+    RegionSpan span;
+    bool verify = false;
+    while (RegionMap::Find(address, span, verify)) {
+        bool covered = lastAddress >= address && lastAddress < span.end;
+        if (covered && (!needRead || span.readable) && (!needWrite || span.writable)) {
+            return true;
+        }
+        if (span.live) break;
+        verify = true;
+    }
+    return false;
+}
+
+bool MemoryEngine::IsAddressValid(uintptr_t address, size_t size) {
+    return CheckAddressRange(address, size, false, false);
 }
 
 bool MemoryEngine::IsAddressReadable(uintptr_t address, size_t size) {
-    if (!IsAddressValid(address, size)) return false;
-    
-    MEMORY_BASIC_INFORMATION mbi;
-    VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi));
-    
-    // 읽기 가능한 보호 속성 확인
-    return (mbi.Protect & (PAGE_READONLY | PAGE_READWRITE | PAGE_EXECUTE_READ | 
-                          PAGE_EXECUTE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_WRITECOPY)) != 0;
+    return CheckAddressRange(address, size, true, false);
 }
 
 bool MemoryEngine::IsAddressWritable(uintptr_t address, size_t size) {
-    if (!IsAddressValid(address, size)) return false;
-    
-    MEMORY_BASIC_INFORMATION mbi;
-    VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi));
-    
-    // 쓰기 가능한 보호 속성 확인
-    return (mbi.Protect & (PAGE_READWRITE | PAGE_EXECUTE_READWRITE | 
-                          PAGE_WRITECOPY | PAGE_EXECUTE_WRITECOPY)) != 0;
+    return CheckAddressRange(address, size, false, true);
 }
 
 // SEH 전용 헬퍼 함수 (C++ 객체 없음)
@@ -103,47 +105,271 @@ bool MemoryEngine::SafeWriteBytes(uintptr_t address, const std::vector<uint8_t>&
     if (bytes.empty() || !IsAddressValid(address, bytes.size())) {
         return false;
     }
+
+    if (!SafeWriteMemory(address, bytes.data(), bytes.size())) {
+        return false;
+    }
     
-    return SafeWriteMemory(address, bytes.data(), bytes.size());
+    // Tracked pages written here count as dirty for every tracker
+    ChangeTracker::NotifyWrite(address, bytes.size());
+    CodeIndex::NotifyWrite(address, bytes.size());
+    return true;
+}
+
+// 📚 일괄 읽기
+struct BulkCopyOp {
+    const uint8_t* source;
+    uint8_t* destination;
+    size_t size;
+    size_t entryIndex;
+};
+
+// SEH 전용 헬퍼 함수 (C++ 객체 없음)
+// Copies ops[first, count) under one SEH frame; returns the index of the op that faulted,
+// or count when every copy succeeded
+static size_t SafeCopyBatch(BulkCopyOp* ops, size_t first, size_t count) {
+    volatile size_t index = first;
+    __try {
+        for (; index < count; index++) {
+            memcpy(ops[index].destination, ops[index].source, ops[index].size);
+        }
+    }
+    __except(EXCEPTION_EXECUTE_HANDLER) {
+        return index;
+    }
+    return count;
+}
+
+static bool IsSpanBulkReadable(const RegionSpan& span) {
+    return span.readable && (span.protection & (PAGE_GUARD | PAGE_NOACCESS)) == 0;
+}
+
+void MemoryEngine::ReadBulk(const std::vector<BulkReadEntry>& entries, std::vector<uint8_t>& out, std::vector<uint8_t>& readable) {
+    std::vector<size_t> offsets(entries.size());
+    size_t total = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        offsets[i] = total;
+        total += entries[i].size;
+    }
+    out.assign(total, 0);
+    readable.assign(entries.size(), 0);
+
+    // Visit entries in address order so neighbouring values share pages and regions
+    std::vector<size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), static_cast<size_t>(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return entries[a].address < entries[b].address;
+    });
+
+    // One region lookup per region: it answers every entry until one starts past it
+    std::vector<BulkCopyOp> ops;
+    ops.reserve(entries.size());
+    RegionSpan span;
+    bool regionReadable = false;
+
+    for (size_t index : order) {
+        const BulkReadEntry& entry = entries[index];
+        uintptr_t end = entry.address + entry.size;
+        if (entry.address == 0 || entry.size == 0 || end < entry.address) continue;
+
+        // Values straddling a region boundary need every region they touch to be readable
+        bool ok = true;
+        for (uintptr_t cursor = entry.address; cursor < end; cursor = span.end) {
+            if (cursor < span.start || cursor >= span.end) {
+                if (!RegionMap::Find(cursor, span)) {
+                    span = RegionSpan();
+                    ok = false;
+                    break;
+                }
+                regionReadable = IsSpanBulkReadable(span);
+                
+                // Confirm a cached refusal before zero-filling the entry
+                if (!regionReadable && !span.live && RegionMap::Find(cursor, span, true)) {
+                    regionReadable = IsSpanBulkReadable(span);
+                }
+            }
+            if (!regionReadable) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) continue;
+
+        BulkCopyOp op;
+        op.source = reinterpret_cast<const uint8_t*>(entry.address);
+        op.destination = out.data() + offsets[index];
+        op.size = entry.size;
+        op.entryIndex = index;
+        ops.push_back(op);
+    }
+
+    // A page can still disappear between the region check and the copy; skip that entry and resume
+    size_t next = 0;
+    while (next < ops.size()) {
+        size_t failed = SafeCopyBatch(ops.data(), next, ops.size());
+        if (failed == ops.size()) break;
+
+        memset(ops[failed].destination, 0, ops[failed].size);
+        ops[failed].destination = nullptr;
+        next = failed + 1;
+    }
+
+    for (const auto& op : ops) {
+        if (op.destination) readable[op.entryIndex] = 1;
+    }
+}
+
+// ⚡ 병렬 스캔 청크
+// Scannable regions are split into fixed-size chunks so large heaps spread across workers;
+// a chunk is also the most a worker ever copies at once (see RegionReader)
+static const size_t SCAN_CHUNK_SIZE = 1024 * 1024; // 1 MB
+
+struct ScanChunk {
+    uintptr_t start;     // First candidate address
+    uintptr_t end;       // One past the last candidate address
+    uintptr_t limit;     // End of the scan range for this region (reads may overlap up to here)
+};
+
+static std::vector<ScanChunk> BuildScanChunks(const std::vector<MemoryRegion>& regions, const ScanOptions& options, size_t alignment) {
+    std::vector<ScanChunk> chunks;
+
+    // Keep chunk boundaries on the alignment lattice of the region start
+    size_t chunkSize = SCAN_CHUNK_SIZE - (SCAN_CHUNK_SIZE % alignment);
+    if (chunkSize == 0) chunkSize = alignment;
+
+    for (const auto& region : regions) {
+        if (!MemoryEngine::IsRegionScannable(region, options)) continue;
+
+        uintptr_t start = max(region.baseAddress, options.startAddress);
+        uintptr_t end = (options.endAddress == 0) ? (region.baseAddress + region.size) : min(region.baseAddress + region.size, options.endAddress);
+        if (start >= end) continue;
+
+        for (uintptr_t chunkStart = start; chunkStart < end; chunkStart += chunkSize) {
+            ScanChunk chunk;
+            chunk.start = chunkStart;
+            chunk.end = (end - chunkStart > chunkSize) ? chunkStart + chunkSize : end;
+            chunk.limit = end;
+            chunks.push_back(chunk);
+        }
+    }
+
+    return chunks;
+}
+
+// Reports finished chunks to ScanOptions::onResults / onProgress in address order.
+// Workers finish in any order; whoever completes the next pending chunk also emits every
+// consecutive finished chunk behind it. Callbacks run under the lock, so a slow consumer
+// (e.g. a full socket send buffer) holds the workers back instead of piling up results.
+class ChunkReporter {
+public:
+    ChunkReporter(const ScanOptions& options, size_t chunkCount)
+        : options(options), finished(chunkCount, false) {}
+
+    bool IsActive() const { return options.onResults || options.onProgress; }
+
+    template<typename EmitChunk>
+    void ChunkDone(size_t index, size_t resultCount, EmitChunk&& emitChunk) {
+        if (!IsActive()) return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished[index] = true;
+        chunksDone++;
+        resultsFound += resultCount;
+
+        while (nextToEmit < finished.size() && finished[nextToEmit]) {
+            emitChunk(nextToEmit++);
+        }
+        if (options.onProgress) {
+            options.onProgress(chunksDone, finished.size(), resultsFound);
+        }
+    }
+
+private:
+    const ScanOptions& options;
+    std::mutex mutex;
+    std::vector<bool> finished;
+    size_t nextToEmit = 0;
+    size_t chunksDone = 0;
+    size_t resultsFound = 0;
+};
+
+static bool IsCancelled(const ScanOptions& options) {
+    return options.cancel && options.cancel->load(std::memory_order_relaxed);
+}
+
+static void EmitChunkResults(const ScanOptions& options, const std::vector<ScanResult>& results) {
+    if (options.onResults && !results.empty()) options.onResults(results);
+}
+
+static void EmitChunkResults(const ScanOptions&, const std::vector<uintptr_t>&) {}
+
+// Runs scanChunk for every chunk on the work-stealing pool and concatenates the
+// per-chunk results. Chunks are built in address order, so the merged output is sorted.
+// A cancelled scan still reports every chunk (as empty) so progress reaches the total.
+template<typename T, typename ChunkScanner>
+static std::vector<T> ScanChunksParallel(const std::vector<ScanChunk>& chunks, const ScanOptions& options, ChunkScanner&& scanChunk) {
+    std::vector<std::vector<T>> chunkResults(chunks.size());
+    ChunkReporter reporter(options, chunks.size());
+
+    WorkStealingPool::Run(chunks.size(), options.threadCount, [&](size_t index, size_t) {
+        if (!IsCancelled(options)) scanChunk(chunks[index], chunkResults[index]);
+        reporter.ChunkDone(index, chunkResults[index].size(), [&](size_t ready) {
+            EmitChunkResults(options, chunkResults[ready]);
+        });
+    });
+
+    size_t total = 0;
+    for (const auto& partial : chunkResults) {
+        total += partial.size();
+    }
+
+    EngineMetrics::AddScanResults(total);
+
+    std::vector<T> results;
+    results.reserve(total);
+    for (auto& partial : chunkResults) {
+        std::move(partial.begin(), partial.end(), std::back_inserter(results));
+    }
+    return results;
+}
+
+// Runs kernel over the readable bytes of a chunk plus (overlap) trailing bytes, so matches
+// straddling the chunk end are found. The candidate bytes actually read are added to the
+// scanned-bytes metric once per chunk.
+template<typename Kernel>
+static void VisitScanChunk(const ScanChunk& chunk, size_t overlap, size_t alignment, Kernel&& kernel) {
+    uintptr_t readEnd = (chunk.limit - chunk.end > overlap) ? chunk.end + overlap : chunk.limit;
+    size_t scanned = 0;
+    RegionReader::Visit(chunk.start, chunk.end - chunk.start, readEnd - chunk.start, alignment,
+                        [&](const uint8_t* data, size_t dataSize, size_t candidates, size_t runOffset) {
+                            scanned += min(candidates, dataSize);
+                            kernel(data, dataSize, candidates, runOffset);
+                        });
+    EngineMetrics::AddBytesScanned(scanned);
 }
 
 // 🔍 고급 메모리 스캔
 std::vector<ScanResult> MemoryEngine::ScanForValue(const std::vector<uint8_t>& value, const ScanOptions& options) {
-    std::vector<ScanResult> results;
-    if (value.empty()) return results;
+    if (value.empty()) return {};
     
-    auto regions = GetMemoryRegions();
+    size_t alignment = max(options.alignment, static_cast<size_t>(1));
+    auto chunks = BuildScanChunks(*RegionMap::GetRegions(), options, alignment);
     
-    for (const auto& region : regions) {
-        if (!IsRegionScannable(region, options)) continue;
-        
-        uintptr_t start = max(region.baseAddress, options.startAddress);
-        uintptr_t end = options.endAddress == 0 ? region.baseAddress + region.size : 
-                       min(region.baseAddress + region.size, options.endAddress);
-        
-        if (start >= end) continue;
-        
-        auto regionData = SafeReadBytes(start, end - start);
-        if (regionData.empty()) continue;
-        
-        for (size_t i = 0; i <= regionData.size() - value.size(); i += options.alignment) {
-            if (CompareBytes(regionData.data() + i, value, value.size())) {
-                uintptr_t foundAddress = start + i;
-                
-                // if (options.customFilter && !options.customFilter(foundAddress)) {
-                //     continue;
-                // }
-                
+    return ScanChunksParallel<ScanResult>(chunks, options, [&](const ScanChunk& chunk, std::vector<ScanResult>& out) {
+        std::vector<size_t> offsets;
+        VisitScanChunk(chunk, value.size() - 1, alignment, [&](const uint8_t* data, size_t dataSize, size_t candidates, size_t runOffset) {
+            offsets.clear();
+            SimdScan::FindValue(data, dataSize, candidates, value.data(), value.size(), alignment, offsets);
+            
+            for (size_t offset : offsets) {
                 ScanResult result;
-                result.address = foundAddress;
+                result.address = chunk.start + runOffset + offset;
                 result.value = value;
                 result.type = "bytes";
-                results.push_back(result);
+                out.push_back(result);
             }
-        }
-    }
-    
-    return results;
+        });
+    });
 }
 
 std::vector<ScanResult> MemoryEngine::ScanForInt32(int32_t value, const ScanOptions& options) {
@@ -180,8 +406,7 @@ std::vector<ScanResult> MemoryEngine::ScanForDouble(double value, const ScanOpti
 }
 
 std::vector<ScanResult> MemoryEngine::ScanForString(const std::string& value, bool caseSensitive, const ScanOptions& options) {
-    std::vector<ScanResult> results;
-    if (value.empty()) return results;
+    if (value.empty()) return {};
     
     std::vector<uint8_t> searchBytes(value.begin(), value.end());
     std::string lowerValue = value;
@@ -189,84 +414,148 @@ std::vector<ScanResult> MemoryEngine::ScanForString(const std::string& value, bo
         std::transform(lowerValue.begin(), lowerValue.end(), lowerValue.begin(), ::tolower);
     }
     
-    auto regions = GetMemoryRegions();
+    size_t alignment = max(options.alignment, static_cast<size_t>(1));
+    auto chunks = BuildScanChunks(*RegionMap::GetRegions(), options, alignment);
     
-    for (const auto& region : regions) {
-        if (!IsRegionScannable(region, options)) continue;
-        
-        uintptr_t start = max(region.baseAddress, options.startAddress);
-        uintptr_t end = options.endAddress == 0 ? region.baseAddress + region.size : 
-                       min(region.baseAddress + region.size, options.endAddress);
-        
-        auto regionData = SafeReadBytes(start, end - start);
-        if (regionData.empty()) continue;
-        
-        for (size_t i = 0; i <= regionData.size() - value.size(); i += options.alignment) {
-            bool match = false;
-            
-            if (caseSensitive) {
-                match = memcmp(regionData.data() + i, searchBytes.data(), value.size()) == 0;
-            } else {
-                std::string regionStr(reinterpret_cast<char*>(regionData.data() + i), value.size());
-                std::transform(regionStr.begin(), regionStr.end(), regionStr.begin(), ::tolower);
-                match = regionStr == lowerValue;
-            }
-            
-            if (match) {
-                uintptr_t foundAddress = start + i;
+    return ScanChunksParallel<ScanResult>(chunks, options, [&](const ScanChunk& chunk, std::vector<ScanResult>& out) {
+        VisitScanChunk(chunk, value.size() - 1, alignment, [&](const uint8_t* data, size_t dataSize, size_t candidates, size_t runOffset) {
+            for (size_t i = 0; i < candidates && i + value.size() <= dataSize; i += alignment) {
+                bool match = false;
                 
-                // if (options.customFilter && !options.customFilter(foundAddress)) {
-                //     continue;
-                // }
+                if (caseSensitive) {
+                    match = memcmp(data + i, searchBytes.data(), value.size()) == 0;
+                } else {
+                    std::string regionStr(reinterpret_cast<const char*>(data + i), value.size());
+                    std::transform(regionStr.begin(), regionStr.end(), regionStr.begin(), ::tolower);
+                    match = regionStr == lowerValue;
+                }
                 
-                ScanResult result;
-                result.address = foundAddress;
-                result.value = std::vector<uint8_t>(regionData.begin() + i, regionData.begin() + i + value.size());
-                result.type = "string";
-                results.push_back(result);
+                if (match) {
+                    ScanResult result;
+                    result.address = chunk.start + runOffset + i;
+                    result.value = std::vector<uint8_t>(data + i, data + i + value.size());
+                    result.type = "string";
+                    out.push_back(result);
+                }
+            }
+        });
+    });
+}
+
+// 🎯 패턴 스캔 (개선된 버전)
+std::vector<uintptr_t> MemoryEngine::PatternScanAll(const std::string& pattern, const std::string& mask, uintptr_t start, uintptr_t end, const ScanOptions* control) {
+    return PatternScanBatch({ CodePattern{ pattern, mask } }, start, end, control)[0];
+}
+
+std::optional<uintptr_t> MemoryEngine::PatternScanFirst(const std::string& pattern, const std::string& mask, uintptr_t start, uintptr_t end) {
+    auto results = PatternScanAll(pattern, mask, start, end);
+    return results.empty() ? std::nullopt : std::make_optional(results[0]);
+}
+
+struct PatternMatch {
+    size_t pattern;
+    uintptr_t address;
+};
+
+static void EmitChunkResults(const ScanOptions&, const std::vector<PatternMatch>&) {}
+
+// Regions with the spans (sorted, disjoint) already answered elsewhere cut out
+static std::vector<MemoryRegion> SubtractSpans(const std::vector<MemoryRegion>& regions, const std::vector<std::pair<uintptr_t, uintptr_t>>& spans) {
+    if (spans.empty()) return regions;
+    
+    std::vector<MemoryRegion> remaining;
+    for (const auto& region : regions) {
+        uintptr_t cursor = region.baseAddress;
+        uintptr_t regionEnd = region.baseAddress + region.size;
+        
+        auto span = std::upper_bound(spans.begin(), spans.end(), cursor,
+                                     [](uintptr_t address, const std::pair<uintptr_t, uintptr_t>& s) { return address < s.second; });
+        for (; span != spans.end() && span->first < regionEnd; ++span) {
+            if (span->first > cursor) {
+                MemoryRegion piece = region;
+                piece.baseAddress = cursor;
+                piece.size = span->first - cursor;
+                remaining.push_back(piece);
             }
+            cursor = max(cursor, span->second);
+        }
+        if (cursor < regionEnd) {
+            MemoryRegion piece = region;
+            piece.baseAddress = cursor;
+            piece.size = regionEnd - cursor;
+            remaining.push_back(piece);
         }
     }
-    
-    return results;
+    return remaining;
 }
 
-// 🎯 패턴 스캔 (개선된 버전)
-std::vector<uintptr_t> MemoryEngine::PatternScanAll(const std::string& pattern, const std::string& mask, uintptr_t start, uintptr_t end) {
-    std::vector<uintptr_t> results;
+std::vector<std::vector<uintptr_t>> MemoryEngine::PatternScanBatch(const std::vector<CodePattern>& patterns, uintptr_t start, uintptr_t end, const ScanOptions* control) {
+    std::vector<std::vector<uintptr_t>> results(patterns.size());
+    
+    std::vector<CodePattern> valid;
+    std::vector<size_t> validIndex;
+    size_t maxLength = 0;
+    for (size_t i = 0; i < patterns.size(); i++) {
+        if (patterns[i].mask.empty() || patterns[i].pattern.length() < patterns[i].mask.length()) continue;
+        valid.push_back(patterns[i]);
+        validIndex.push_back(i);
+        maxLength = max(maxLength, patterns[i].mask.length());
+    }
+    if (valid.empty()) return results;
     
     if (start == 0) start = GetModuleBase();
     if (end == 0) end = start + GetModuleSize();
     
-    auto regions = GetMemoryRegions();
+    // Executable module code: posting lookups in the module's index
+    std::vector<std::vector<uintptr_t>> indexed;
+    std::vector<std::pair<uintptr_t, uintptr_t>> covered;
+    CodeIndex::FindPatterns(valid, start, end, indexed, covered);
     
-    for (const auto& region : regions) {
-        if (!region.readable) continue;
-        
-        uintptr_t regionStart = max(region.baseAddress, start);
-        uintptr_t regionEnd = min(region.baseAddress + region.size, end);
-        
-        if (regionStart >= regionEnd) continue;
-        
-        auto data = SafeReadBytes(regionStart, regionEnd - regionStart);
-        if (data.empty()) continue;
-        
-        for (size_t i = 0; i <= data.size() - pattern.length(); i++) {
-            if (ComparePattern(data.data() + i, pattern, mask)) {
-                results.push_back(regionStart + i);
-            }
-        }
+    // Signature scans look at every readable page in the range regardless of protection
+    ScanOptions options;
+    options.startAddress = start;
+    options.endAddress = end;
+    options.filterWritable = TriState::Any;
+    options.filterExecutable = TriState::Any;
+    options.filterCopyOnWrite = TriState::Any;
+    if (control) {
+        options.threadCount = control->threadCount;
+        options.onProgress = control->onProgress;
+        options.cancel = control->cancel;
     }
     
+    // Everything else: each chunk is read once and searched for every pattern
+    auto chunks = BuildScanChunks(SubtractSpans(*RegionMap::GetRegions(), covered), options, 1);
+    auto scanned = ScanChunksParallel<PatternMatch>(chunks, options, [&](const ScanChunk& chunk, std::vector<PatternMatch>& out) {
+        std::vector<size_t> offsets;
+        VisitScanChunk(chunk, maxLength - 1, 1, [&](const uint8_t* data, size_t dataSize, size_t candidates, size_t runOffset) {
+            for (size_t p = 0; p < valid.size(); p++) {
+                const CodePattern& pattern = valid[p];
+                if (dataSize < pattern.mask.length()) continue;
+                
+                offsets.clear();
+                SimdScan::FindPattern(data, dataSize, candidates, reinterpret_cast<const uint8_t*>(pattern.pattern.data()),
+                                      pattern.mask.data(), pattern.mask.length(), offsets);
+                for (size_t offset : offsets) {
+                    out.push_back({ p, chunk.start + runOffset + offset });
+                }
+            }
+        });
+    });
+    
+    for (size_t p = 0; p < valid.size(); p++) {
+        results[validIndex[p]] = std::move(indexed[p]);
+    }
+    for (const auto& match : scanned) {
+        results[validIndex[match.pattern]].push_back(match.address);
+    }
+    for (auto& list : results) {
+        std::sort(list.begin(), list.end());
+    }
     return results;
 }
 
-std::optional<uintptr_t> MemoryEngine::PatternScanFirst(const std::string& pattern, const std::string& mask, uintptr_t start, uintptr_t end) {
-    auto results = PatternScanAll(pattern, mask, start, end);
-    return results.empty() ? std::nullopt : std::make_optional(results[0]);
-}
-
-std::vector<uintptr_t> MemoryEngine::AOBScanAll(const std::string& pattern, uintptr_t start, uintptr_t end) {
+CodePattern MemoryEngine::AOBToPattern(const std::string& pattern) {
     std::vector<uint8_t> patternBytes = PatternToBytes(pattern);
     std::string mask;
     
@@ -276,8 +565,21 @@ std::vector<uintptr_t> MemoryEngine::AOBScanAll(const std::string& pattern, uint
         mask += (byte == "?" || byte == "??") ? '?' : 'x';
     }
     
-    std::string patternStr(patternBytes.begin(), patternBytes.end());
-    return PatternScanAll(patternStr, mask, start, end);
+    return CodePattern{ std::string(patternBytes.begin(), patternBytes.end()), mask };
+}
+
+std::vector<uintptr_t> MemoryEngine::AOBScanAll(const std::string& pattern, uintptr_t start, uintptr_t end, const ScanOptions* control) {
+    CodePattern converted = AOBToPattern(pattern);
+    return PatternScanAll(converted.pattern, converted.mask, start, end, control);
+}
+
+std::vector<std::vector<uintptr_t>> MemoryEngine::AOBScanBatch(const std::vector<std::string>& patterns, uintptr_t start, uintptr_t end, const ScanOptions* control) {
+    std::vector<CodePattern> converted;
+    converted.reserve(patterns.size());
+    for (const auto& pattern : patterns) {
+        converted.push_back(AOBToPattern(pattern));
+    }
+    return PatternScanBatch(converted, start, end, control);
 }
 
 std::optional<uintptr_t> MemoryEngine::AOBScanFirst(const std::string& pattern, uintptr_t start, uintptr_t end) {
@@ -287,46 +589,7 @@ std::optional<uintptr_t> MemoryEngine::AOBScanFirst(const std::string& pattern,
 
 // 🗺️ 메모리 영역 관리
 std::vector<MemoryRegion> MemoryEngine::GetMemoryRegions() {
-    std::vector<MemoryRegion> regions;
-    
-    MEMORY_BASIC_INFORMATION mbi;
-    uintptr_t address = 0;
-    
-    while (VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) == sizeof(mbi)) {
-        if (mbi.State == MEM_COMMIT) {
-            MemoryRegion region;
-            region.baseAddress = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
-            region.size = mbi.RegionSize;
-            region.protection = mbi.Protect;
-            region.state = mbi.State;
-            region.type = mbi.Type;
-            
-            // 권한 플래그 설정
-            region.readable = (mbi.Protect & (PAGE_READONLY | PAGE_READWRITE | PAGE_EXECUTE_READ | 
-                                            PAGE_EXECUTE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_WRITECOPY)) != 0;
-            region.writable = (mbi.Protect & (PAGE_READWRITE | PAGE_EXECUTE_READWRITE | 
-                                            PAGE_WRITECOPY | PAGE_EXECUTE_WRITECOPY)) != 0;
-            region.executable = (mbi.Protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | 
-                                              PAGE_EXECUTE_WRITECOPY)) != 0;
-            
-            // 모듈 이름 찾기
-            HMODULE hModule;
-            if (GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
-                                 reinterpret_cast<LPCTSTR>(address), &hModule)) {
-                char moduleName[MAX_PATH];
-                if (GetModuleFileNameA(hModule, moduleName, MAX_PATH)) {
-                    region.moduleName = moduleName;
-                }
-            }
-            
-            regions.push_back(region);
-        }
-        
-        address = reinterpret_cast<uintptr_t>(mbi.BaseAddress) + mbi.RegionSize;
-        if (address == 0) break; // 오버플로우 방지
-    }
-    
-    return regions;
+    return *RegionMap::GetRegions();
 }
 
 std::optional<MemoryRegion> MemoryEngine::GetMemoryRegion(uintptr_t address) {
@@ -353,20 +616,20 @@ std::optional<MemoryRegion> MemoryEngine::GetMemoryRegion(uintptr_t address) {
 }
 
 std::vector<MemoryRegion> MemoryEngine::GetExecutableRegions() {
-    auto regions = GetMemoryRegions();
+    auto regions = RegionMap::GetRegions();
     std::vector<MemoryRegion> executableRegions;
     
-    std::copy_if(regions.begin(), regions.end(), std::back_inserter(executableRegions),
+    std::copy_if(regions->begin(), regions->end(), std::back_inserter(executableRegions),
                 [](const MemoryRegion& region) { return region.executable; });
     
     return executableRegions;
 }
 
 std::vector<MemoryRegion> MemoryEngine::GetWritableRegions() {
-    auto regions = GetMemoryRegions();
+    auto regions = RegionMap::GetRegions();
     std::vector<MemoryRegion> writableRegions;
     
-    std::copy_if(regions.begin(), regions.end(), std::back_inserter(writableRegions),
+    std::copy_if(regions->begin(), regions->end(), std::back_inserter(writableRegions),
                 [](const MemoryRegion& region) { return region.writable; });
     
     return writableRegions;
@@ -375,15 +638,21 @@ std::vector<MemoryRegion> MemoryEngine::GetWritableRegions() {
 // 🔧 메모리 보호 및 할당
 bool MemoryEngine::ChangeProtection(uintptr_t address, size_t size, DWORD newProtect, DWORD* oldProtect) {
     DWORD temp;
-    return VirtualProtect(reinterpret_cast<void*>(address), size, newProtect, oldProtect ? oldProtect : &temp);
+    bool changed = VirtualProtect(reinterpret_cast<void*>(address), size, newProtect, oldProtect ? oldProtect : &temp) != FALSE;
+    if (changed) RegionMap::Invalidate(address, size);
+    return changed;
 }
 
 uintptr_t MemoryEngine::AllocateMemory(size_t size, DWORD protection) {
-    return reinterpret_cast<uintptr_t>(VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, protection));
+    uintptr_t address = reinterpret_cast<uintptr_t>(VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, protection));
+    if (address) RegionMap::Invalidate(address, size);
+    return address;
 }
 
 bool MemoryEngine::FreeMemory(uintptr_t address) {
-    return VirtualFree(reinterpret_cast<void*>(address), 0, MEM_RELEASE);
+    bool freed = VirtualFree(reinterpret_cast<void*>(address), 0, MEM_RELEASE) != FALSE;
+    if (freed) RegionMap::Invalidate(address, 1);
+    return freed;
 }
 
 // 📦 모듈 관리
@@ -485,10 +754,14 @@ std::string MemoryEngine::BytesToPattern(const std::vector<uint8_t>& bytes) {
 std::string MemoryEngine::ValueToString(const std::vector<uint8_t>& bytes, const std::string& type) {
     if (bytes.empty()) return "";
     
-    if (type == "int32" && bytes.size() >= 4) {
+    if ((type == "int32" || type == "int") && bytes.size() >= 4) {
         int32_t value;
         memcpy(&value, bytes.data(), sizeof(int32_t));
         return std::to_string(value);
+    } else if (type == "int64" && bytes.size() >= 8) {
+        int64_t value;
+        memcpy(&value, bytes.data(), sizeof(int64_t));
+        return std::to_string(value);
     } else if (type == "float" && bytes.size() >= 4) {
         float value;
         memcpy(&value, bytes.data(), sizeof(float));
@@ -507,10 +780,14 @@ std::string MemoryEngine::ValueToString(const std::vector<uint8_t>& bytes, const
 std::vector<uint8_t> MemoryEngine::StringToValue(const std::string& value, const std::string& type) {
     std::vector<uint8_t> bytes;
     
-    if (type == "int32") {
+    if (type == "int32" || type == "int") {
         int32_t intValue = std::stoi(value);
         bytes.resize(sizeof(int32_t));
         memcpy(bytes.data(), &intValue, sizeof(int32_t));
+    } else if (type == "int64") {
+        int64_t intValue = std::stoll(value);
+        bytes.resize(sizeof(int64_t));
+        memcpy(bytes.data(), &intValue, sizeof(int64_t));
     } else if (type == "float") {
         float floatValue = std::stof(value);
         bytes.resize(sizeof(float));
@@ -608,7 +885,8 @@ DWORD MemoryEngine::GetProtectionFlags(uintptr_t address) {
 
 // Scan filter function
 bool MemoryEngine::IsRegionScannable(const MemoryRegion& region, const ScanOptions& options) {
-    if (!region.readable) return false;
+    // Reading a guard page would consume the guard (e.g. a thread's stack growth trigger)
+    if (!region.readable || (region.protection & (PAGE_GUARD | PAGE_NOACCESS))) return false;
 
     auto checkState = [](TriState state, bool condition) {
         if (state == TriState::Yes && !condition) return false;
@@ -633,34 +911,30 @@ bool MemoryEngine::IsRegionScannable(const MemoryRegion& region, const ScanOptio
 
 // First Scan Implementation
 std::vector<ScanResult> MemoryEngine::FirstScan(const std::string& value, const std::string& type, const ScanOptions& options) {
-    std::vector<ScanResult> results;
     std::vector<uint8_t> valueBytes = StringToValue(value, type);
-    if (valueBytes.empty()) return results;
+    if (valueBytes.empty()) return {};
 
-    auto regions = GetMemoryRegions();
-    
-    for (const auto& region : regions) {
-        if (!IsRegionScannable(region, options)) continue;
-        
-        uintptr_t start = max(region.baseAddress, options.startAddress);
-        uintptr_t end = (options.endAddress == 0) ? (region.baseAddress + region.size) : min(region.baseAddress + region.size, options.endAddress);
-        
-        if (start >= end) continue;
+    size_t alignment = max(options.alignment, static_cast<size_t>(1));
+    auto chunks = BuildScanChunks(*RegionMap::GetRegions(), options, alignment);
 
-        auto regionData = SafeReadBytes(start, end - start);
-        if (regionData.empty()) continue;
-        
-        for (size_t i = 0; i <= regionData.size() - valueBytes.size(); i += options.alignment) {
-            if (memcmp(regionData.data() + i, valueBytes.data(), valueBytes.size()) == 0) {
+    return ScanChunksParallel<ScanResult>(chunks, options, [&](const ScanChunk& chunk, std::vector<ScanResult>& out) {
+        std::vector<size_t> offsets;
+        VisitScanChunk(chunk, valueBytes.size() - 1, alignment, [&](const uint8_t* data, size_t dataSize, size_t candidates, size_t runOffset) {
+            offsets.clear();
+            SimdScan::FindValue(data, dataSize, candidates, valueBytes.data(), valueBytes.size(), alignment, offsets);
+
+            for (size_t offset : offsets) {
+                uintptr_t address = chunk.start + runOffset + offset;
+                if (options.filter && !options.filter->Matches(address, data + offset, nullptr)) continue;
+                
                 ScanResult result;
-                result.address = start + i;
+                result.address = address;
                 result.value = valueBytes;
                 result.type = type;
-                results.push_back(result);
+                out.push_back(result);
             }
-        }
-    }
-    return results;
+        });
+    });
 }
 
 // 레거시 함수들 (하위 호환성)
@@ -684,77 +958,166 @@ bool MemoryEngine::Nop(uintptr_t address, size_t size) {
     return NopInstruction(address, size);
 }
 
-// Type-aware value comparison helper
-template<typename T>
-bool CompareNumericValues(const T& current, const T& previous, const std::string& scanType) {
-    if (scanType == "increased") return current > previous;
-    if (scanType == "decreased") return current < previous;
-    // Potentially other comparisons like "increased by", "decreased by" could be added here
-    return false;
-}
-
 // Main Next Scan Implementation
-std::vector<ScanResult> MemoryEngine::NextScan(const std::string& scanType, const std::string& value, const ScanOptions& options) {
-    std::vector<ScanResult> newResults;
+std::vector<ScanResult> MemoryEngine::NextScan(const NextScanQuery& query, const ScanOptions& options) {
     if (!options.previousResults || options.previousResults->empty()) {
-        return newResults;
+        return {};
     }
 
-    for (const auto& prevResult : *options.previousResults) {
-        auto currentValueBytes = SafeReadBytes(prevResult.address, prevResult.value.size());
-        if (currentValueBytes.empty() || currentValueBytes.size() != prevResult.value.size()) {
-            continue; // Skip addresses that can no longer be read
-        }
+    // Legacy vector API: filter through the columnar store and convert back
+    ScanResultStore store = ScanResultStore::FromResults(*options.previousResults);
+    NextScan(query, store, nullptr, nullptr, &options);
+    return store.ToResults();
+}
 
-        bool match = false;
+bool MemoryEngine::NextScan(const NextScanQuery& query, ScanResultStore& store, const std::vector<uintptr_t>* cleanPages,
+                            ScanUndoRecord* undo, const ScanOptions* control) {
+    // Compiled before any candidate is touched, so a bad expression leaves the store as it was
+    ScanFilter filter;
+    if (!query.filter.empty()) {
+        filter = ScanFilter::Compile(query.filter, ScanResultStore::ParseValueKind(store.GetType()));
+    }
+    size_t candidates = store.Count();
+    if (!store.Filter(ParseScanCriteria(query, store.GetType()), cleanPages, filter.IsEmpty() ? nullptr : &filter, undo, control)) {
+        return false;
+    }
+    EngineMetrics::AddBytesScanned(static_cast<uint64_t>(candidates) * store.GetValueSize());
+    EngineMetrics::AddScanResults(store.Count());
+    return true;
+}
 
-        if (scanType == "exact") {
-            std::vector<uint8_t> valueToCompare = StringToValue(value, prevResult.type);
-            if (!valueToCompare.empty() && memcmp(currentValueBytes.data(), valueToCompare.data(), currentValueBytes.size()) == 0) {
-                match = true;
-            }
-        } else if (scanType == "unchanged") {
-            if (memcmp(currentValueBytes.data(), prevResult.value.data(), currentValueBytes.size()) == 0) {
-                match = true;
-            }
-        } else if (scanType == "changed") {
-            if (memcmp(currentValueBytes.data(), prevResult.value.data(), currentValueBytes.size()) != 0) {
-                match = true;
-            }
-        } else { // Handle numeric comparisons
-            if (prevResult.type == "int32") {
-                int32_t currentVal, prevVal;
-                memcpy(&currentVal, currentValueBytes.data(), sizeof(int32_t));
-                memcpy(&prevVal, prevResult.value.data(), sizeof(int32_t));
-                match = CompareNumericValues(currentVal, prevVal, scanType);
-            } else if (prevResult.type == "int64") {
-                int64_t currentVal, prevVal;
-                memcpy(&currentVal, currentValueBytes.data(), sizeof(int64_t));
-                memcpy(&prevVal, prevResult.value.data(), sizeof(int64_t));
-                match = CompareNumericValues(currentVal, prevVal, scanType);
-            } else if (prevResult.type == "float") {
-                float currentVal, prevVal;
-                memcpy(&currentVal, currentValueBytes.data(), sizeof(float));
-                memcpy(&prevVal, prevResult.value.data(), sizeof(float));
-                match = CompareNumericValues(currentVal, prevVal, scanType);
-            } else if (prevResult.type == "double") {
-                double currentVal, prevVal;
-                memcpy(&currentVal, currentValueBytes.data(), sizeof(double));
-                memcpy(&prevVal, prevResult.value.data(), sizeof(double));
-                match = CompareNumericValues(currentVal, prevVal, scanType);
+// Strings are parsed once here; the filter itself only sees encoded operands
+ScanCriteria MemoryEngine::ParseScanCriteria(const NextScanQuery& query, const std::string& type) {
+    ScanCriteria criteria;
+    criteria.compare = ScanResultStore::ParseScanCompare(query.scanType);
+
+    bool usesValue = criteria.compare == ScanCompare::Exact || criteria.compare == ScanCompare::IncreasedBy ||
+                     criteria.compare == ScanCompare::DecreasedBy || criteria.compare == ScanCompare::Between;
+    if (usesValue && !query.value.empty()) {
+        criteria.target = StringToValue(query.value, type);
+    }
+    if (criteria.compare == ScanCompare::Between && !query.value2.empty()) {
+        criteria.target2 = StringToValue(query.value2, type);
+    }
+
+    if (!query.epsilon.empty()) {
+        criteria.epsilon = std::fabs(std::stod(query.epsilon));
+    } else if (query.scanType == "rounded") {
+        // "12.3" matches [12.25, 12.35]; "12" matches [11.5, 12.5]
+        size_t point = query.value.find('.');
+        size_t decimals = 0;
+        if (point != std::string::npos) {
+            while (point + 1 + decimals < query.value.size() && isdigit(static_cast<unsigned char>(query.value[point + 1 + decimals]))) {
+                decimals++;
             }
         }
+        criteria.epsilon = 0.5 * std::pow(10.0, -static_cast<double>(decimals));
+    }
+    return criteria;
+}
+
+// Columnar first scan: each chunk records 32-bit hit offsets, appended in address order
+void MemoryEngine::FirstScan(const std::string& value, const std::string& type, const ScanOptions& options, ScanResultStore& store) {
+    FirstScan(StringToValue(value, type), type, options, store);
+}
+
+// Raw value bytes (binary protocol requests carry the value already encoded)
+void MemoryEngine::FirstScan(const std::vector<uint8_t>& valueBytes, const std::string& type, const ScanOptions& options,
+                             ScanResultStore& store) {
+    size_t alignment = max(options.alignment, static_cast<size_t>(1));
+    store.Reset(type, valueBytes.size(), alignment);
+    if (valueBytes.empty()) return;
 
-        if (match) {
-            ScanResult newResult;
-            newResult.address = prevResult.address;
-            newResult.value = currentValueBytes;
-            newResult.previousValue = prevResult.value;
-            newResult.type = prevResult.type;
-            newResults.push_back(newResult);
+    auto chunks = BuildScanChunks(*RegionMap::GetRegions(), options, alignment);
+    std::vector<std::vector<uint32_t>> chunkHits(chunks.size());
+    ChunkReporter reporter(options, chunks.size());
+
+    // Streaming consumers get ScanResult batches built from the hit offsets
+    auto emitChunk = [&](size_t ready) {
+        if (!options.onResults || chunkHits[ready].empty()) return;
+        std::vector<ScanResult> batch(chunkHits[ready].size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            batch[i].address = chunks[ready].start + chunkHits[ready][i];
+            batch[i].value = valueBytes;
+            batch[i].type = type;
+        }
+        options.onResults(batch);
+    };
+
+    WorkStealingPool::Run(chunks.size(), options.threadCount, [&](size_t index, size_t) {
+        const ScanChunk& chunk = chunks[index];
+        std::vector<uint32_t>& hits = chunkHits[index];
+        if (!IsCancelled(options)) {
+            std::vector<size_t> offsets;
+            VisitScanChunk(chunk, valueBytes.size() - 1, alignment, [&](const uint8_t* data, size_t dataSize, size_t candidates, size_t runOffset) {
+                offsets.clear();
+                SimdScan::FindValue(data, dataSize, candidates, valueBytes.data(), valueBytes.size(), alignment, offsets);
+                for (size_t offset : offsets) {
+                    if (options.filter && !options.filter->Matches(chunk.start + runOffset + offset, data + offset, nullptr)) continue;
+                    hits.push_back(static_cast<uint32_t>(runOffset + offset));
+                }
+            });
+        }
+        reporter.ChunkDone(index, hits.size(), emitChunk);
+    });
+
+    size_t hitCount = 0;
+    for (const auto& hits : chunkHits) hitCount += hits.size();
+    EngineMetrics::AddScanResults(hitCount);
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        for (uint32_t offset : chunkHits[i]) {
+            store.Append(chunks[i].start + offset, valueBytes.data());
+        }
+        std::vector<uint32_t>().swap(chunkHits[i]);
+    }
+}
+
+// Unknown initial value: every aligned slot is a candidate; chunks are compressed as they are
+// read so the raw address space is never held in memory at once
+void MemoryEngine::UnknownInitialScan(const std::string& type, const ScanOptions& options, ScanResultStore& store) {
+    size_t valueSize = GetValueSize(type);
+    size_t alignment = max(options.alignment, static_cast<size_t>(1));
+    store.Reset(type, valueSize, alignment);
+    if (valueSize == 0) return;
+
+    auto chunks = BuildScanChunks(*RegionMap::GetRegions(), options, alignment);
+    ChunkReporter reporter(options, chunks.size());
+
+    // One snapshot per readable run of a chunk (a chunk with faulting pages has several)
+    using SnapshotRun = std::pair<size_t, RegionSnapshot>;
+    std::vector<std::vector<SnapshotRun>> snapshots(chunks.size());
+
+    // Progress only - every slot is a candidate, so there is nothing useful to stream
+    WorkStealingPool::Run(chunks.size(), options.threadCount, [&](size_t index, size_t) {
+        const ScanChunk& chunk = chunks[index];
+        std::vector<SnapshotRun>& runs = snapshots[index];
+        size_t slots = 0;
+        if (!IsCancelled(options)) {
+            VisitScanChunk(chunk, valueSize - 1, alignment, [&](const uint8_t* data, size_t dataSize, size_t candidates, size_t runOffset) {
+                size_t span = min(candidates, dataSize);
+                runs.emplace_back(runOffset, RegionSnapshot());
+                runs.back().second.Capture(data, span, dataSize, valueSize - 1);
+                slots += (span + alignment - 1) / alignment;
+            });
+        }
+        reporter.ChunkDone(index, slots, [](size_t) {});
+        EngineMetrics::AddScanResults(slots);
+    });
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        for (auto& run : snapshots[i]) {
+            if (run.second.GetSpan() == 0) continue;
+            store.AddSnapshotRegion(chunks[i].start + run.first, std::move(run.second));
         }
     }
-    return newResults;
+}
+
+size_t MemoryEngine::GetValueSize(const std::string& type) {
+    if (type == "int32" || type == "int" || type == "float") return 4;
+    if (type == "int64" || type == "double") return 8;
+    if (type == "byte") return 1;
+    return 0;
 }
 
 // Enhanced reading functions for disassembler
@@ -826,74 +1189,23 @@ std::optional<std::vector<uint8_t>> MemoryEngine::ReadValueAtAddress(uintptr_t a
 
 int MemoryEngine::CompareValues(const std::vector<uint8_t>& value1, const std::vector<uint8_t>& value2, const std::string& type) {
     if (value1.empty() || value2.empty()) return 0;
-    
-    try {
-        if (type == "int32" || type == "int") {
-            if (value1.size() < sizeof(int32_t) || value2.size() < sizeof(int32_t)) return 0;
-            
-            int32_t val1, val2;
-            memcpy(&val1, value1.data(), sizeof(int32_t));
-            memcpy(&val2, value2.data(), sizeof(int32_t));
-            
-            if (val1 > val2) return 1;
-            if (val1 < val2) return -1;
-            return 0;
-        }
-        else if (type == "int64") {
-            if (value1.size() < sizeof(int64_t) || value2.size() < sizeof(int64_t)) return 0;
-            
-            int64_t val1, val2;
-            memcpy(&val1, value1.data(), sizeof(int64_t));
-            memcpy(&val2, value2.data(), sizeof(int64_t));
-            
-            if (val1 > val2) return 1;
-            if (val1 < val2) return -1;
-            return 0;
-        }
-        else if (type == "float") {
-            if (value1.size() < sizeof(float) || value2.size() < sizeof(float)) return 0;
-            
-            float val1, val2;
-            memcpy(&val1, value1.data(), sizeof(float));
-            memcpy(&val2, value2.data(), sizeof(float));
-            
-            if (val1 > val2) return 1;
-            if (val1 < val2) return -1;
-            return 0;
-        }
-        else if (type == "double") {
-            if (value1.size() < sizeof(double) || value2.size() < sizeof(double)) return 0;
-            
-            double val1, val2;
-            memcpy(&val1, value1.data(), sizeof(double));
-            memcpy(&val2, value2.data(), sizeof(double));
-            
-            if (val1 > val2) return 1;
-            if (val1 < val2) return -1;
-            return 0;
-        }
-        else if (type == "byte") {
-            uint8_t val1 = value1[0];
-            uint8_t val2 = value2[0];
-            
-            if (val1 > val2) return 1;
-            if (val1 < val2) return -1;
-            return 0;
-        }
-        else {
-            // For strings and bytes, do lexicographical comparison
-            if (value1.size() != value2.size()) {
-                return (value1.size() > value2.size()) ? 1 : -1;
-            }
-            
-            int result = memcmp(value1.data(), value2.data(), value1.size());
-            if (result > 0) return 1;
-            if (result < 0) return -1;
-            return 0;
-        }
-    } catch (...) {
-        return 0;
+
+    ScanValueKind kind = ScanResultStore::ParseValueKind(type);
+    if (kind != ScanValueKind::Bytes) {
+        size_t size = GetValueSize(type);
+        if (value1.size() < size || value2.size() < size) return 0;
+        return ScanResultStore::CompareTyped(kind, value1.data(), value2.data());
     }
+
+    // For strings and bytes, do lexicographical comparison
+    if (value1.size() != value2.size()) {
+        return (value1.size() > value2.size()) ? 1 : -1;
+    }
+
+    int result = memcmp(value1.data(), value2.data(), value1.size());
+    if (result > 0) return 1;
+    if (result < 0) return -1;
+    return 0;
 }
 
 } // namespace InternalEngine 
\ No newline at end of file
@@ -5,9 +5,17 @@
 #include <optional>
 #include <memory>
 #include <functional>
+#include <atomic>
+#include "ChangeTracker.hpp"
+#include "CodeIndex.hpp"
 
 namespace InternalEngine {
 
+class ScanResultStore;
+class ScanUndoRecord;
+struct ScanCriteria;
+class ScanFilter;
+
 // 메모리 영역 정보 구조체
 struct MemoryRegion {
     uintptr_t baseAddress;
@@ -36,6 +44,21 @@ struct ScanResult {
     std::vector<uint8_t> previousValue; // For next scans
 };
 
+// Next scan as sent by a client; values are parsed against the candidates' type
+struct NextScanQuery {
+    std::string scanType;       // exact, rounded, changed, unchanged, increased, decreased, increasedby, decreasedby, between
+    std::string value;          // exact/rounded value, increasedby/decreasedby amount, between lower bound
+    std::string value2;         // between upper bound (inclusive)
+    std::string epsilon;        // Optional float/double tolerance; "rounded" defaults it to half the value's last decimal
+    std::string filter;         // Optional ScanFilter expression, compiled for the store's value type
+};
+
+// 일괄 읽기 항목
+struct BulkReadEntry {
+    uintptr_t address;
+    size_t size;
+};
+
 // 메모리 스캔 옵션
 struct ScanOptions {
     uintptr_t startAddress = 0;
@@ -50,7 +73,23 @@ struct ScanOptions {
     // Advanced options
     bool isFirstScan = true;
     bool caseSensitive = true;
-    std::string luaFilter;
+
+    // Compiled "filter" predicate (see ScanFilter); first scan hits it rejects are dropped
+    const ScanFilter* filter = nullptr;
+
+    // Parallel scanning (0 = one worker per hardware thread, 1 = single-threaded)
+    size_t threadCount = 0;
+
+    // Incremental delivery while the scan runs. Both callbacks are serialized and see
+    // chunks in address order; onResults is only called by scans that produce ScanResult.
+    std::function<void(const std::vector<ScanResult>& batch)> onResults;
+    std::function<void(size_t chunksDone, size_t chunksTotal, size_t resultsFound)> onProgress;
+
+    // Checked before each chunk; once set, remaining chunks are skipped (results are partial)
+    const std::atomic<bool>* cancel = nullptr;
+
+    // Scan sessions: track writes to candidate pages so next scans skip clean ones
+    bool trackChanges = false;
 
     // For next scans
     const std::vector<ScanResult>* previousResults = nullptr;
@@ -68,6 +107,10 @@ public:
     static std::vector<uint8_t> SafeReadBytes(uintptr_t address, size_t size);
     static bool SafeWriteBytes(uintptr_t address, const std::vector<uint8_t>& bytes);
     
+    // 📚 일괄 읽기: entries are packed back to back in entry order into out;
+    // readable[i] is 1 when entry i was copied (unreadable entries stay zero-filled)
+    static void ReadBulk(const std::vector<BulkReadEntry>& entries, std::vector<uint8_t>& out, std::vector<uint8_t>& readable);
+    
     // 📖 기본 메모리 읽기/쓰기 (템플릿)
     template<typename T>
     static std::optional<T> SafeRead(uintptr_t address) {
@@ -99,6 +142,7 @@ public:
             
             memcpy(reinterpret_cast<void*>(address), &value, sizeof(T));
             VirtualProtect(reinterpret_cast<void*>(address), sizeof(T), oldProtect, &oldProtect);
+            ChangeTracker::NotifyWrite(address, sizeof(T));
             return true;
         }
         __except(EXCEPTION_EXECUTE_HANDLER) {
@@ -129,11 +173,18 @@ public:
     static std::vector<ScanResult> ScanForString(const std::string& value, bool caseSensitive = true, const ScanOptions& options = {});
     
     // 🎯 패턴 스캔 (개선된 버전)
-    static std::vector<uintptr_t> PatternScanAll(const std::string& pattern, const std::string& mask, uintptr_t start = 0, uintptr_t end = 0);
+    // control (optional) supplies threadCount, onProgress and cancel for the scan
+    static std::vector<uintptr_t> PatternScanAll(const std::string& pattern, const std::string& mask, uintptr_t start = 0, uintptr_t end = 0, const ScanOptions* control = nullptr);
     static std::optional<uintptr_t> PatternScanFirst(const std::string& pattern, const std::string& mask, uintptr_t start = 0, uintptr_t end = 0);
-    static std::vector<uintptr_t> AOBScanAll(const std::string& pattern, uintptr_t start = 0, uintptr_t end = 0);
+    static std::vector<uintptr_t> AOBScanAll(const std::string& pattern, uintptr_t start = 0, uintptr_t end = 0, const ScanOptions* control = nullptr);
     static std::optional<uintptr_t> AOBScanFirst(const std::string& pattern, uintptr_t start = 0, uintptr_t end = 0);
     
+    // Every signature in one pass: executable module code is answered by CodeIndex, the rest
+    // of the range is read once for all patterns. results[i] holds the matches of patterns[i].
+    static std::vector<std::vector<uintptr_t>> PatternScanBatch(const std::vector<CodePattern>& patterns, uintptr_t start = 0, uintptr_t end = 0, const ScanOptions* control = nullptr);
+    static std::vector<std::vector<uintptr_t>> AOBScanBatch(const std::vector<std::string>& patterns, uintptr_t start = 0, uintptr_t end = 0, const ScanOptions* control = nullptr);
+    static CodePattern AOBToPattern(const std::string& pattern);
+    
     // 레거시 패턴 스캔 (public으로 이동)
     static std::optional<uintptr_t> PatternScan(const std::string& pattern, const std::string& mask, uintptr_t start = 0, uintptr_t end = 0);
     static std::optional<uintptr_t> AOBScan(const std::string& pattern, uintptr_t start = 0, uintptr_t end = 0);
@@ -179,8 +230,19 @@ public:
 
     // Core scanning functions
     static std::vector<ScanResult> FirstScan(const std::string& value, const std::string& type, const ScanOptions& options);
-    static std::vector<ScanResult> NextScan(const std::string& scanType, const std::string& value, const ScanOptions& options);
+    static std::vector<ScanResult> NextScan(const NextScanQuery& query, const ScanOptions& options);
     static bool IsRegionScannable(const MemoryRegion& region, const ScanOptions& options);
+
+    // Columnar variants used by scan sessions (results never materialize as ScanResult)
+    static void FirstScan(const std::string& value, const std::string& type, const ScanOptions& options, ScanResultStore& store);
+    static void FirstScan(const std::vector<uint8_t>& valueBytes, const std::string& type, const ScanOptions& options,
+                          ScanResultStore& store);
+    static void UnknownInitialScan(const std::string& type, const ScanOptions& options, ScanResultStore& store);
+    // Returns false if control's cancel flag stopped it; the store is then left as it was
+    static bool NextScan(const NextScanQuery& query, ScanResultStore& store, const std::vector<uintptr_t>* cleanPages = nullptr,
+                         ScanUndoRecord* undo = nullptr, const ScanOptions* control = nullptr);
+    static ScanCriteria ParseScanCriteria(const NextScanQuery& query, const std::string& type);
+    static size_t GetValueSize(const std::string& type);
     
     // Enhanced reading functions for disassembler
     static std::optional<std::vector<uint8_t>> ReadValueAtAddress(uintptr_t address, const std::string& type);
@@ -0,0 +1,172 @@
+#include "ModuleMap.hpp"
+#include <Psapi.h>
+#include <Shlwapi.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace InternalEngine {
+
+// 📡 로더 알림 (LdrRegisterDllNotification)
+struct LoaderNotificationData {
+    ULONG flags;
+    const void* fullDllName;
+    const void* baseDllName;
+    PVOID dllBase;
+    ULONG sizeOfImage;
+};
+
+typedef VOID (CALLBACK* LoaderNotificationFunction)(ULONG reason, const LoaderNotificationData* data, PVOID context);
+typedef LONG (NTAPI* LdrRegisterDllNotificationFunction)(ULONG flags, LoaderNotificationFunction callback, PVOID context, PVOID* cookie);
+typedef LONG (NTAPI* LdrUnregisterDllNotificationFunction)(PVOID cookie);
+
+static std::mutex g_buildMutex;                 // Rebuilds and the name table
+static ModuleMap::Snapshot g_snapshot;          // Only accessed through std::atomic_load/atomic_store
+static DWORD g_snapshotTick = 0;
+static PVOID g_notificationCookie = nullptr;
+static bool g_notificationTried = false;
+static std::atomic<bool> g_notificationActive{false};
+
+// Interned names (grow only, so ids stay valid)
+static std::vector<std::string> g_names;
+static std::unordered_map<std::string, uint32_t> g_nameIds;
+
+// Bumped by the loader callback, which must not take our locks
+static std::atomic<uint32_t> g_loaderGeneration{1};
+
+static VOID CALLBACK OnLoaderNotification(ULONG, const LoaderNotificationData*, PVOID) {
+    g_loaderGeneration.fetch_add(1);
+}
+
+// Caller holds g_buildMutex
+static void RegisterLoaderNotification() {
+    if (g_notificationTried) return;
+    g_notificationTried = true;
+
+    HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+    if (!ntdll) return;
+    auto registerNotification = reinterpret_cast<LdrRegisterDllNotificationFunction>(
+        GetProcAddress(ntdll, "LdrRegisterDllNotification"));
+    if (registerNotification && registerNotification(0, OnLoaderNotification, nullptr, &g_notificationCookie) == 0) {
+        g_notificationActive.store(true);
+    } else {
+        g_notificationCookie = nullptr;
+    }
+}
+
+// Caller holds g_buildMutex
+static uint32_t InternName(const std::string& name) {
+    auto it = g_nameIds.find(name);
+    if (it != g_nameIds.end()) return it->second;
+
+    uint32_t nameId = static_cast<uint32_t>(g_names.size());
+    g_names.push_back(name);
+    g_nameIds.emplace(name, nameId);
+    return nameId;
+}
+
+// Caller holds g_buildMutex
+static std::shared_ptr<ModuleSnapshot> BuildSnapshot() {
+    auto snapshot = std::make_shared<ModuleSnapshot>();
+
+    // Taken first: a load during the walk leaves the snapshot one generation behind
+    snapshot->generation = g_loaderGeneration.load();
+
+    std::vector<HMODULE> handles(256);
+    DWORD needed = 0;
+    HANDLE process = GetCurrentProcess();
+    bool listed = false;
+    while (true) {
+        DWORD capacity = static_cast<DWORD>(handles.size() * sizeof(HMODULE));
+        if (!EnumProcessModules(process, handles.data(), capacity, &needed)) break;
+        if (needed <= capacity) {
+            listed = true;
+            break;
+        }
+        handles.resize(needed / sizeof(HMODULE) + 16);
+    }
+    if (listed) {
+        handles.resize(needed / sizeof(HMODULE));
+        snapshot->modules.reserve(handles.size());
+    } else {
+        handles.clear();
+    }
+
+    for (HMODULE handle : handles) {
+        MODULEINFO info;
+        char path[MAX_PATH];
+        if (!GetModuleInformation(process, handle, &info, sizeof(info))) continue;
+        if (!GetModuleFileNameExA(process, handle, path, MAX_PATH)) continue;
+
+        ModuleRange range;
+        range.base = reinterpret_cast<uintptr_t>(info.lpBaseOfDll);
+        range.end = range.base + info.SizeOfImage;
+        range.nameId = InternName(PathFindFileNameA(path));
+        snapshot->modules.push_back(range);
+    }
+
+    std::sort(snapshot->modules.begin(), snapshot->modules.end(),
+              [](const ModuleRange& a, const ModuleRange& b) { return a.base < b.base; });
+    snapshot->names = g_names;
+    return snapshot;
+}
+
+static bool IsCurrent(const ModuleSnapshot& snapshot) {
+    if (snapshot.generation != g_loaderGeneration.load()) return false;
+    return g_notificationActive.load() || GetTickCount() - g_snapshotTick < ModuleMap::FALLBACK_REFRESH_MS;
+}
+
+const ModuleRange* ModuleSnapshot::Find(uintptr_t address) const {
+    auto it = std::upper_bound(modules.begin(), modules.end(), address,
+        [](uintptr_t value, const ModuleRange& module) { return value < module.base; });
+    if (it == modules.begin()) return nullptr;
+    --it;
+    return address < it->end ? &*it : nullptr;
+}
+
+const ModuleRange* ModuleSnapshot::FindByName(const std::string& name) const {
+    for (const auto& module : modules) {
+        if (_stricmp(names[module.nameId].c_str(), name.c_str()) == 0) return &module;
+    }
+    return nullptr;
+}
+
+ModuleMap::Snapshot ModuleMap::GetSnapshot() {
+    Snapshot current = std::atomic_load(&g_snapshot);
+    if (current && IsCurrent(*current)) return current;
+
+    std::lock_guard<std::mutex> lock(g_buildMutex);
+    current = std::atomic_load(&g_snapshot);
+    if (current && IsCurrent(*current)) return current;     // A racing caller rebuilt it
+
+    RegisterLoaderNotification();
+    Snapshot next = BuildSnapshot();
+    g_snapshotTick = GetTickCount();
+    std::atomic_store(&g_snapshot, next);
+    return next;
+}
+
+void ModuleMap::Refresh() {
+    std::lock_guard<std::mutex> lock(g_buildMutex);
+    RegisterLoaderNotification();
+    Snapshot next = BuildSnapshot();
+    g_snapshotTick = GetTickCount();
+    std::atomic_store(&g_snapshot, next);
+}
+
+void ModuleMap::Shutdown() {
+    std::lock_guard<std::mutex> lock(g_buildMutex);
+    if (g_notificationCookie) {
+        HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+        auto unregisterNotification = ntdll ? reinterpret_cast<LdrUnregisterDllNotificationFunction>(
+            GetProcAddress(ntdll, "LdrUnregisterDllNotification")) : nullptr;
+        if (unregisterNotification) unregisterNotification(g_notificationCookie);
+        g_notificationCookie = nullptr;
+    }
+    g_notificationTried = false;
+    g_notificationActive.store(false);
+    std::atomic_store(&g_snapshot, Snapshot());
+}
+
+} // namespace InternalEngine
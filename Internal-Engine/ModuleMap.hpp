@@ -0,0 +1,54 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace InternalEngine {
+
+// Loaded module image [base, end); nameId indexes ModuleSnapshot::names
+struct ModuleRange {
+    uintptr_t base = 0;
+    uintptr_t end = 0;
+    uint32_t nameId = 0;
+};
+
+// Immutable list of the loaded modules, sorted by base address
+struct ModuleSnapshot {
+    std::vector<ModuleRange> modules;
+    // Interned file names. Ids never change for the life of the process, so an id taken
+    // from one snapshot is valid in every later one.
+    std::vector<std::string> names;
+    uint32_t generation = 0;
+
+    // Module containing address, or nullptr (binary search)
+    const ModuleRange* Find(uintptr_t address) const;
+    // First module with this file name (case-insensitive), or nullptr
+    const ModuleRange* FindByName(const std::string& name) const;
+    const std::string& NameOf(const ModuleRange& module) const { return names[module.nameId]; }
+};
+
+// 🧱 모듈 맵
+// Address -> module lookups without a walk per lookup. Readers take the current snapshot with
+// an atomic load and search it lock-free; it is rebuilt on the next access after the loader
+// reports a module load or unload (LdrRegisterDllNotification). The callback runs under the
+// loader lock, so it only bumps a generation counter. Without the notification the snapshot
+// is rebuilt once it is older than FALLBACK_REFRESH_MS.
+class ModuleMap {
+public:
+    using Snapshot = std::shared_ptr<const ModuleSnapshot>;
+
+    static const DWORD FALLBACK_REFRESH_MS = 5000;
+
+    static Snapshot GetSnapshot();
+
+    // Rebuilds the snapshot now
+    static void Refresh();
+
+    // Unregisters the loader notification and drops the snapshot
+    static void Shutdown();
+};
+
+} // namespace InternalEngine
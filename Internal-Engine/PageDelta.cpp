@@ -0,0 +1,48 @@
+#include "PageDelta.hpp"
+#include <algorithm>
+
+namespace InternalEngine {
+
+uint32_t PageDeltaCache::Encode(const void* owner, uintptr_t address, const std::vector<uint8_t>& current, uint32_t baseId,
+                                std::vector<uint8_t>& out, bool& isDelta) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Page>& owned = pages[owner];
+
+    auto entry = std::find_if(owned.begin(), owned.end(), [&](const Page& page) {
+        return page.address == address && page.bytes.size() == current.size();
+    });
+
+    isDelta = entry != owned.end() && baseId != 0 && entry->id == baseId;
+    out.resize(current.size());
+    if (isDelta) {
+        for (size_t i = 0; i < current.size(); i++) {
+            out[i] = static_cast<uint8_t>(current[i] ^ entry->bytes[i]);
+        }
+    } else {
+        std::copy(current.begin(), current.end(), out.begin());
+    }
+
+    if (entry == owned.end()) {
+        if (owned.size() >= MAX_PAGES_PER_OWNER) {
+            entry = std::min_element(owned.begin(), owned.end(),
+                                     [](const Page& a, const Page& b) { return a.lastUse < b.lastUse; });
+        } else {
+            owned.push_back(Page());
+            entry = owned.end() - 1;
+        }
+        entry->address = address;
+    }
+
+    entry->id = nextId++;
+    if (nextId == 0) nextId = 1;
+    entry->lastUse = ++useCounter;
+    entry->bytes = current;
+    return entry->id;
+}
+
+void PageDeltaCache::DropOwner(const void* owner) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pages.erase(owner);
+}
+
+} // namespace InternalEngine
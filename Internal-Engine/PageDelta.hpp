@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace InternalEngine {
+
+// 🔁 메모리 뷰어 페이지 델타
+// Repeated reads of the same range (memory viewer refreshes) can be answered with the XOR
+// of the new bytes against the copy the client received last time. An unchanged page is
+// then all zeros, which permessage-deflate shrinks to a few bytes. Every page sent is
+// remembered per owner (connection) under a new id; the client echoes the id of the page it
+// holds as baseId, and anything that does not match - another range, an evicted or unknown
+// id - is answered with the full bytes.
+class PageDeltaCache {
+public:
+    // Least recently used pages beyond this are forgotten (their next read is sent in full)
+    static const size_t MAX_PAGES_PER_OWNER = 32;
+
+    // Writes the bytes to send into out and returns the id the page is now known by.
+    // isDelta tells whether out is current XOR the baseId page or current itself.
+    uint32_t Encode(const void* owner, uintptr_t address, const std::vector<uint8_t>& current, uint32_t baseId,
+                    std::vector<uint8_t>& out, bool& isDelta);
+
+    // Forgets every page of owner (connection closed)
+    void DropOwner(const void* owner);
+
+private:
+    struct Page {
+        uintptr_t address;
+        uint32_t id;
+        uint64_t lastUse;
+        std::vector<uint8_t> bytes;
+    };
+
+    std::mutex mutex;
+    std::map<const void*, std::vector<Page>> pages;
+    uint32_t nextId = 1;
+    uint64_t useCounter = 0;
+};
+
+} // namespace InternalEngine
@@ -0,0 +1,433 @@
+#include "PointerScanner.hpp"
+#include "MemoryEngine.hpp"
+#include "RegionMap.hpp"
+#include "RegionReader.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+namespace InternalEngine {
+
+// Sources are read in chunks of up to this size (one task each), through a per-thread copy
+static const size_t POINTER_CHUNK_SIZE = 1024 * 1024; // 1 MB
+
+// Frontier nodes expanded per search task
+static const size_t NODES_PER_TASK = 1024;
+
+// Saved map layout: header, roots (base, size, name), then raw entries
+static const uint32_t POINTER_MAP_MAGIC = 0x4D504549; // "IEPM"
+static const uint32_t POINTER_MAP_VERSION = 1;
+
+namespace {
+
+struct AddressRange {
+    uintptr_t start;
+    uintptr_t end;
+};
+
+struct SourceChunk {
+    uintptr_t start;
+    size_t size;
+};
+
+struct SearchNode {
+    uintptr_t address;
+    uintptr_t offset;   // address - value of the pointer that led here
+    size_t parent;      // Index in the previous level
+};
+
+bool EntryLess(const PointerMap::Entry& a, const PointerMap::Entry& b) {
+    return a.value < b.value || (a.value == b.value && a.source < b.source);
+}
+
+bool IsBulkReadable(const MemoryRegion& region) {
+    return region.readable && (region.protection & (PAGE_GUARD | PAGE_NOACCESS)) == 0;
+}
+
+// Readable regions merged into disjoint sorted ranges (valid pointer targets)
+std::vector<AddressRange> BuildTargetRanges(const std::vector<MemoryRegion>& regions) {
+    std::vector<AddressRange> ranges;
+    for (const auto& region : regions) {
+        if (!IsBulkReadable(region)) continue;
+        uintptr_t end = region.baseAddress + region.size;
+        if (!ranges.empty() && ranges.back().end == region.baseAddress) {
+            ranges.back().end = end;
+        } else {
+            ranges.push_back({ region.baseAddress, end });
+        }
+    }
+    return ranges;
+}
+
+// Merges sorted runs pairwise (in parallel) until one is left
+void MergeRuns(std::vector<std::vector<PointerMap::Entry>>& runs, size_t threadCount) {
+    runs.erase(std::remove_if(runs.begin(), runs.end(),
+        [](const std::vector<PointerMap::Entry>& run) { return run.empty(); }), runs.end());
+
+    while (runs.size() > 1) {
+        std::vector<std::vector<PointerMap::Entry>> merged((runs.size() + 1) / 2);
+        WorkStealingPool::Run(merged.size(), threadCount, [&](size_t index, size_t) {
+            auto& a = runs[index * 2];
+            if (index * 2 + 1 >= runs.size()) {
+                merged[index] = std::move(a);
+                return;
+            }
+            auto& b = runs[index * 2 + 1];
+            merged[index].resize(a.size() + b.size());
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), merged[index].begin(), EntryLess);
+            std::vector<PointerMap::Entry>().swap(a);
+            std::vector<PointerMap::Entry>().swap(b);
+        });
+        runs.swap(merged);
+    }
+}
+
+bool IsOnPath(const std::vector<std::vector<SearchNode>>& levels, size_t level, size_t index, uintptr_t address) {
+    while (true) {
+        const SearchNode& node = levels[level][index];
+        if (node.address == address) return true;
+        if (level == 0) return false;
+        index = node.parent;
+        level--;
+    }
+}
+
+PointerChain MakeChain(const std::vector<std::vector<SearchNode>>& levels, size_t parentLevel, const SearchNode& child,
+                       uint32_t rootIndex, const PointerRoot& root) {
+    PointerChain chain;
+    chain.rootIndex = rootIndex;
+    chain.moduleOffset = child.address - root.base;
+    chain.offsets.reserve(parentLevel + 1);
+    chain.offsets.push_back(child.offset);
+
+    // Walk back towards the target; level 0 is the target itself
+    size_t index = child.parent;
+    for (size_t level = parentLevel; level > 0; level--) {
+        const SearchNode& node = levels[level][index];
+        chain.offsets.push_back(node.offset);
+        index = node.parent;
+    }
+    return chain;
+}
+
+std::string ChainKey(const PointerScanResult& result, const PointerChain& chain) {
+    std::string key = result.roots[chain.rootIndex].name;
+    key.push_back('\0');
+    key.append(reinterpret_cast<const char*>(&chain.moduleOffset), sizeof(chain.moduleOffset));
+    key.append(reinterpret_cast<const char*>(chain.offsets.data()), chain.offsets.size() * sizeof(uintptr_t));
+    return key;
+}
+
+} // namespace
+
+// 🧭 포인터 맵 생성
+std::shared_ptr<PointerMap> PointerMap::Build(std::vector<PointerRoot> roots, size_t threadCount, const std::atomic<bool>* cancel) {
+    auto map = std::make_shared<PointerMap>();
+    std::sort(roots.begin(), roots.end(), [](const PointerRoot& a, const PointerRoot& b) { return a.base < b.base; });
+    map->roots = std::move(roots);
+
+    auto regions = RegionMap::GetRegions();
+    std::vector<AddressRange> targets = BuildTargetRanges(*regions);
+    if (targets.empty()) return map;
+    uintptr_t lowestTarget = targets.front().start;
+    uintptr_t highestTarget = targets.back().end;
+
+    // Pointers worth following live in writable memory (heaps, stacks, module .data)
+    std::vector<SourceChunk> chunks;
+    for (const auto& region : *regions) {
+        if (!IsBulkReadable(region) || !region.writable) continue;
+        for (size_t offset = 0; offset < region.size; offset += POINTER_CHUNK_SIZE) {
+            size_t size = region.size - offset;
+            if (size > POINTER_CHUNK_SIZE) size = POINTER_CHUNK_SIZE;
+            chunks.push_back({ region.baseAddress + offset, size });
+        }
+    }
+
+    threadCount = WorkStealingPool::ResolveThreadCount(threadCount);
+    std::vector<std::vector<Entry>> runs(chunks.size());
+
+    WorkStealingPool::Run(chunks.size(), threadCount, [&](size_t chunkIndex, size_t) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return;
+        const SourceChunk& chunk = chunks[chunkIndex];
+        std::vector<Entry>& run = runs[chunkIndex];
+        size_t lastRange = 0;
+        RegionReader::Visit(chunk.start, chunk.size, chunk.size, sizeof(uintptr_t),
+                            [&](const uint8_t* data, size_t dataSize, size_t, size_t runOffset) {
+            for (size_t offset = 0; offset + sizeof(uintptr_t) <= dataSize; offset += sizeof(uintptr_t)) {
+                uintptr_t value;
+                memcpy(&value, data + offset, sizeof(value));
+                if (value < lowestTarget || value >= highestTarget) continue;
+
+                // Neighbouring pointers usually hit the same range; check it before searching
+                if (value < targets[lastRange].start || value >= targets[lastRange].end) {
+                    auto it = std::upper_bound(targets.begin(), targets.end(), value,
+                        [](uintptr_t v, const AddressRange& range) { return v < range.start; });
+                    if (it == targets.begin()) continue;
+                    --it;
+                    if (value >= it->end) continue;
+                    lastRange = it - targets.begin();
+                }
+
+                run.push_back({ value, chunk.start + runOffset + offset });
+            }
+        });
+        std::sort(run.begin(), run.end(), EntryLess);
+    });
+
+    MergeRuns(runs, threadCount);
+    if (!runs.empty()) map->entries = std::move(runs.front());
+    return map;
+}
+
+size_t PointerMap::MemoryUsage() const {
+    size_t usage = entries.capacity() * sizeof(Entry);
+    for (const auto& root : roots) {
+        usage += sizeof(PointerRoot) + root.name.capacity();
+    }
+    return usage;
+}
+
+std::pair<const PointerMap::Entry*, const PointerMap::Entry*> PointerMap::Range(uintptr_t low, uintptr_t high) const {
+    auto first = std::lower_bound(entries.begin(), entries.end(), low,
+        [](const Entry& entry, uintptr_t value) { return entry.value < value; });
+    auto last = std::upper_bound(first, entries.end(), high,
+        [](uintptr_t value, const Entry& entry) { return value < entry.value; });
+    const Entry* base = entries.data();
+    return { base + (first - entries.begin()), base + (last - entries.begin()) };
+}
+
+int PointerMap::FindRoot(uintptr_t address) const {
+    auto it = std::upper_bound(roots.begin(), roots.end(), address,
+        [](uintptr_t value, const PointerRoot& root) { return value < root.base; });
+    if (it == roots.begin()) return -1;
+    --it;
+    if (address >= it->end) return -1;
+    return static_cast<int>(it - roots.begin());
+}
+
+// 💾 포인터 맵 저장/불러오기
+bool PointerMap::Save(const std::string& path, std::string& error) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot open file for writing";
+        return false;
+    }
+
+    uint32_t header[4] = { POINTER_MAP_MAGIC, POINTER_MAP_VERSION, static_cast<uint32_t>(sizeof(uintptr_t)),
+                           static_cast<uint32_t>(roots.size()) };
+    uint64_t entryCount = entries.size();
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&entryCount), sizeof(entryCount));
+
+    for (const auto& root : roots) {
+        uint64_t base = root.base;
+        uint64_t size = root.end - root.base;
+        uint32_t nameLength = static_cast<uint32_t>(root.name.size());
+        file.write(reinterpret_cast<const char*>(&base), sizeof(base));
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+        file.write(root.name.data(), nameLength);
+    }
+
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+    if (!file) {
+        error = "Write failed";
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<PointerMap> PointerMap::Load(const std::string& path, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "Cannot open file";
+        return nullptr;
+    }
+
+    uint32_t header[4] = {};
+    uint64_t entryCount = 0;
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&entryCount), sizeof(entryCount));
+    if (!file || header[0] != POINTER_MAP_MAGIC || header[1] != POINTER_MAP_VERSION) {
+        error = "Not a pointer map file";
+        return nullptr;
+    }
+    if (header[2] != sizeof(uintptr_t)) {
+        error = "Pointer map was saved by a build with a different pointer size";
+        return nullptr;
+    }
+
+    auto map = std::make_shared<PointerMap>();
+    map->roots.resize(header[3]);
+    for (auto& root : map->roots) {
+        uint64_t base = 0;
+        uint64_t size = 0;
+        uint32_t nameLength = 0;
+        file.read(reinterpret_cast<char*>(&base), sizeof(base));
+        file.read(reinterpret_cast<char*>(&size), sizeof(size));
+        file.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+        if (!file || nameLength > MAX_PATH) {
+            error = "Corrupt pointer map roots";
+            return nullptr;
+        }
+        root.base = static_cast<uintptr_t>(base);
+        root.end = static_cast<uintptr_t>(base + size);
+        root.name.resize(nameLength);
+        file.read(&root.name[0], nameLength);
+    }
+
+    // Check the size up front instead of trusting entryCount with an allocation
+    std::streamoff entriesStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff available = file.tellg() - entriesStart;
+    if (!file || available < 0 || static_cast<uint64_t>(available) / sizeof(Entry) < entryCount) {
+        error = "Truncated pointer map file";
+        return nullptr;
+    }
+    file.seekg(entriesStart);
+
+    map->entries.resize(static_cast<size_t>(entryCount));
+    file.read(reinterpret_cast<char*>(map->entries.data()), map->entries.size() * sizeof(Entry));
+    if (!file) {
+        error = "Truncated pointer map file";
+        return nullptr;
+    }
+    return map;
+}
+
+// 🔗 다단계 포인터 스캔
+std::shared_ptr<PointerScanResult> PointerScanner::Scan(const PointerMap& map, const PointerScanOptions& options) {
+    auto result = std::make_shared<PointerScanResult>();
+    result->target = options.target;
+    result->roots = map.GetRoots();
+
+    size_t threadCount = WorkStealingPool::ResolveThreadCount(options.threadCount);
+    std::atomic<size_t> found(0);
+
+    std::vector<std::vector<SearchNode>> levels;
+    levels.push_back({ SearchNode{ options.target, 0, 0 } });
+
+    auto isCancelled = [&options]() { return options.cancel && options.cancel->load(std::memory_order_relaxed); };
+
+    for (size_t depth = 1; depth <= options.maxDepth && !levels.back().empty(); depth++) {
+        const size_t parentLevel = depth - 1;
+        const std::vector<SearchNode>& frontier = levels[parentLevel];
+        const bool expand = depth < options.maxDepth;
+
+        size_t taskCount = (frontier.size() + NODES_PER_TASK - 1) / NODES_PER_TASK;
+        std::vector<std::vector<SearchNode>> nextParts(taskCount);
+        std::vector<std::vector<PointerChain>> chainParts(taskCount);
+
+        WorkStealingPool::Run(taskCount, threadCount, [&](size_t task, size_t) {
+            if (isCancelled()) return;
+            size_t first = task * NODES_PER_TASK;
+            size_t last = min(first + NODES_PER_TASK, frontier.size());
+
+            for (size_t i = first; i < last; i++) {
+                uintptr_t address = frontier[i].address;
+                uintptr_t low = address > options.maxOffset ? address - options.maxOffset : 0;
+                auto range = map.Range(low, address);
+
+                for (const PointerMap::Entry* entry = range.first; entry != range.second; ++entry) {
+                    // A pointer already on this path would only loop back
+                    if (IsOnPath(levels, parentLevel, i, entry->source)) continue;
+
+                    SearchNode child{ entry->source, address - entry->value, i };
+                    int root = map.FindRoot(entry->source);
+                    if (root >= 0 && found.fetch_add(1) < options.maxResults) {
+                        chainParts[task].push_back(MakeChain(levels, parentLevel, child, static_cast<uint32_t>(root),
+                                                             result->roots[root]));
+                    }
+                    if (expand) nextParts[task].push_back(child);
+                }
+            }
+        });
+
+        // Merge in task order so results are deterministic
+        for (auto& part : chainParts) {
+            for (auto& chain : part) {
+                result->chains.push_back(std::move(chain));
+            }
+        }
+        if (options.onProgress) {
+            options.onProgress(depth, options.maxDepth, result->chains.size());
+        }
+        if (isCancelled()) {
+            result->cancelled = true;
+            break;
+        }
+        if (found.load() >= options.maxResults) {
+            // Deeper levels could still have produced chains
+            result->truncated = found.load() > options.maxResults || expand;
+            break;
+        }
+        if (!expand) break;
+
+        std::vector<SearchNode> next;
+        for (auto& part : nextParts) {
+            size_t room = options.maxFrontier - min(next.size(), options.maxFrontier);
+            if (part.size() > room) {
+                result->truncated = true;
+                part.resize(room);
+            }
+            next.insert(next.end(), part.begin(), part.end());
+        }
+        levels.push_back(std::move(next));
+    }
+
+    return result;
+}
+
+void PointerScanner::Intersect(PointerScanResult& current, const PointerScanResult& previous) {
+    std::unordered_set<std::string> keys;
+    keys.reserve(previous.chains.size());
+    for (const auto& chain : previous.chains) {
+        keys.insert(ChainKey(previous, chain));
+    }
+
+    current.chains.erase(std::remove_if(current.chains.begin(), current.chains.end(),
+        [&](const PointerChain& chain) { return keys.count(ChainKey(current, chain)) == 0; }),
+        current.chains.end());
+}
+
+// 🗂️ 서버측 포인터 맵/결과 저장소
+uint32_t PointerScanManager::AddMap(std::shared_ptr<PointerMap> map) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t mapId = nextId++;
+    maps[mapId] = std::move(map);
+    return mapId;
+}
+
+std::shared_ptr<PointerMap> PointerScanManager::GetMap(uint32_t mapId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = maps.find(mapId);
+    return it != maps.end() ? it->second : nullptr;
+}
+
+bool PointerScanManager::CloseMap(uint32_t mapId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return maps.erase(mapId) > 0;
+}
+
+uint32_t PointerScanManager::AddResult(std::shared_ptr<PointerScanResult> result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t resultId = nextId++;
+    results[resultId] = std::move(result);
+    return resultId;
+}
+
+std::shared_ptr<PointerScanResult> PointerScanManager::GetResult(uint32_t resultId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = results.find(resultId);
+    return it != results.end() ? it->second : nullptr;
+}
+
+bool PointerScanManager::CloseResult(uint32_t resultId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return results.erase(resultId) > 0;
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,115 @@
+#pragma once
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <cstdint>
+
+namespace InternalEngine {
+
+// Module image range; chains must start at a static address inside one of these
+struct PointerRoot {
+    uintptr_t base;
+    uintptr_t end;
+    std::string name;
+};
+
+// FollowPointerChain(roots[rootIndex].base + moduleOffset, offsets) lands on the target
+struct PointerChain {
+    uint32_t rootIndex;
+    uintptr_t moduleOffset;
+    std::vector<uintptr_t> offsets;
+};
+
+// 🧭 포인터 맵
+// Every aligned pointer-sized value in readable, writable memory that points into a
+// committed readable region, sorted by value so "who points near X" is a binary search.
+// The module list it was built with travels with it, so a saved map can be scanned again
+// after the process is gone.
+class PointerMap {
+public:
+    struct Entry {
+        uintptr_t value;
+        uintptr_t source;
+    };
+
+    // One pass over memory (chunks are scanned in parallel, then merged).
+    // Once cancel is set the remaining chunks are skipped and the map is incomplete.
+    static std::shared_ptr<PointerMap> Build(std::vector<PointerRoot> roots, size_t threadCount = 0,
+                                             const std::atomic<bool>* cancel = nullptr);
+
+    bool Save(const std::string& path, std::string& error) const;
+    static std::shared_ptr<PointerMap> Load(const std::string& path, std::string& error);
+
+    size_t Count() const { return entries.size(); }
+    size_t MemoryUsage() const;
+    const std::vector<PointerRoot>& GetRoots() const { return roots; }
+
+    // Entries whose value lies in [low, high]
+    std::pair<const Entry*, const Entry*> Range(uintptr_t low, uintptr_t high) const;
+
+    // Index of the root containing address, or -1
+    int FindRoot(uintptr_t address) const;
+
+private:
+    std::vector<Entry> entries;
+    std::vector<PointerRoot> roots;     // Sorted by base
+};
+
+struct PointerScanOptions {
+    uintptr_t target = 0;
+    size_t maxDepth = 5;
+    size_t maxOffset = 0x1000;
+    size_t maxResults = 100000;
+    size_t maxFrontier = 1 << 20;       // Nodes kept per search level
+    size_t threadCount = 0;
+
+    // Called after each search level; cancel is checked between frontier tasks
+    std::function<void(size_t depth, size_t maxDepth, size_t chainsFound)> onProgress;
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+struct PointerScanResult {
+    uintptr_t target = 0;
+    std::vector<PointerRoot> roots;     // Copied from the map; chains index into it
+    std::vector<PointerChain> chains;
+    bool truncated = false;             // maxResults or maxFrontier cut the search short
+    bool cancelled = false;             // options.cancel stopped the search
+};
+
+// 🔗 다단계 포인터 스캐너
+// Breadth-first search backwards from the target: level k holds every address that reaches
+// the target through k dereferences with offsets in [0, maxOffset]. Each level is expanded
+// in parallel; a node inside a module root is reported as a chain and still expanded.
+class PointerScanner {
+public:
+    static std::shared_ptr<PointerScanResult> Scan(const PointerMap& map, const PointerScanOptions& options);
+
+    // Chains of current that also appear in previous (same module name, offset and offsets)
+    static void Intersect(PointerScanResult& current, const PointerScanResult& previous);
+};
+
+// Server-side storage so clients only pass ids between calls
+class PointerScanManager {
+public:
+    uint32_t AddMap(std::shared_ptr<PointerMap> map);
+    std::shared_ptr<PointerMap> GetMap(uint32_t mapId);
+    bool CloseMap(uint32_t mapId);
+
+    uint32_t AddResult(std::shared_ptr<PointerScanResult> result);
+    std::shared_ptr<PointerScanResult> GetResult(uint32_t resultId);
+    bool CloseResult(uint32_t resultId);
+
+private:
+    std::mutex mutex;
+    std::unordered_map<uint32_t, std::shared_ptr<PointerMap>> maps;
+    std::unordered_map<uint32_t, std::shared_ptr<PointerScanResult>> results;
+    uint32_t nextId = 1;
+};
+
+} // namespace InternalEngine
@@ -0,0 +1,224 @@
+#include "RegionMap.hpp"
+#include <mutex>
+#include <algorithm>
+#include <utility>
+
+namespace InternalEngine {
+
+static std::mutex g_regionMutex;
+static RegionMap::Snapshot g_regions;
+static DWORD g_lastRegionRefresh = 0;
+static bool g_regionRefreshing = false;
+
+static MemoryRegion MakeRegion(const MEMORY_BASIC_INFORMATION& mbi) {
+    MemoryRegion region;
+    region.baseAddress = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
+    region.size = mbi.RegionSize;
+    region.protection = mbi.Protect;
+    region.state = mbi.State;
+    region.type = mbi.Type;
+
+    // 권한 플래그 설정
+    region.readable = (mbi.Protect & (PAGE_READONLY | PAGE_READWRITE | PAGE_EXECUTE_READ |
+                                    PAGE_EXECUTE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_WRITECOPY)) != 0;
+    region.writable = (mbi.Protect & (PAGE_READWRITE | PAGE_EXECUTE_READWRITE |
+                                    PAGE_WRITECOPY | PAGE_EXECUTE_WRITECOPY)) != 0;
+    region.executable = (mbi.Protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE |
+                                      PAGE_EXECUTE_WRITECOPY)) != 0;
+    return region;
+}
+
+// 모듈 이름 찾기 (only image memory can belong to a module)
+static void ResolveModuleName(MemoryRegion& region) {
+    if (region.type != MEM_IMAGE) return;
+
+    HMODULE hModule;
+    if (GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                         reinterpret_cast<LPCTSTR>(region.baseAddress), &hModule)) {
+        char moduleName[MAX_PATH];
+        if (GetModuleFileNameA(hModule, moduleName, MAX_PATH)) {
+            region.moduleName = moduleName;
+        }
+    }
+}
+
+static const MemoryRegion* FindCached(const std::vector<MemoryRegion>& regions, uintptr_t address) {
+    auto it = std::upper_bound(regions.begin(), regions.end(), address,
+        [](uintptr_t value, const MemoryRegion& region) { return value < region.baseAddress; });
+    if (it == regions.begin()) return nullptr;
+    --it;
+    if (address - it->baseAddress >= it->size) return nullptr;
+    return &*it;
+}
+
+static void FillSpan(const MemoryRegion& region, RegionSpan& span, bool live) {
+    span.start = region.baseAddress;
+    span.end = region.baseAddress + region.size;
+    span.protection = region.protection;
+    span.readable = region.readable;
+    span.writable = region.writable;
+    span.live = live;
+}
+
+// Returns the current map, rebuilding it first when it has gone stale. While one thread
+// rebuilds, the others keep using the previous map.
+static RegionMap::Snapshot CurrentRegions() {
+    {
+        std::lock_guard<std::mutex> lock(g_regionMutex);
+        bool stale = !g_regions || GetTickCount() - g_lastRegionRefresh >= RegionMap::REFRESH_INTERVAL_MS;
+        if (!stale || (g_regionRefreshing && g_regions)) {
+            return g_regions;
+        }
+        g_regionRefreshing = true;
+    }
+
+    RegionMap::Refresh();
+
+    std::lock_guard<std::mutex> lock(g_regionMutex);
+    return g_regions;
+}
+
+// Replaces the cached view of [start, end) with region (nullptr when nothing is committed
+// there). Entries that only partly overlap keep the part outside the range.
+static void SpliceRegion(uintptr_t start, uintptr_t end, const MemoryRegion* region) {
+    std::lock_guard<std::mutex> lock(g_regionMutex);
+    if (!g_regions) return; // The first rebuild picks it up
+
+    const auto& current = *g_regions;
+    size_t lo = std::partition_point(current.begin(), current.end(), [start](const MemoryRegion& entry) {
+        return entry.baseAddress + entry.size <= start;
+    }) - current.begin();
+    size_t hi = std::partition_point(current.begin() + lo, current.end(), [end](const MemoryRegion& entry) {
+        return entry.baseAddress < end;
+    }) - current.begin();
+
+    // Nothing to change - the common case for lookups of unmapped or already cached addresses
+    if (!region && lo == hi) return;
+    if (region && hi - lo == 1) {
+        const MemoryRegion& entry = current[lo];
+        if (entry.baseAddress <= start && entry.baseAddress + entry.size >= end &&
+            entry.protection == region->protection && entry.state == region->state && entry.type == region->type) {
+            return;
+        }
+    }
+
+    auto updated = std::make_shared<std::vector<MemoryRegion>>();
+    updated->reserve(current.size() + 2);
+    updated->insert(updated->end(), current.begin(), current.begin() + lo);
+
+    if (lo < hi && current[lo].baseAddress < start) {
+        MemoryRegion head = current[lo];
+        head.size = start - head.baseAddress;
+        updated->push_back(std::move(head));
+    }
+    if (region) {
+        updated->push_back(*region);
+    }
+    if (lo < hi) {
+        const MemoryRegion& last = current[hi - 1];
+        uintptr_t lastEnd = last.baseAddress + last.size;
+        if (lastEnd > end) {
+            MemoryRegion tail = last;
+            tail.baseAddress = end;
+            tail.size = lastEnd - end;
+            updated->push_back(std::move(tail));
+        }
+    }
+
+    updated->insert(updated->end(), current.begin() + hi, current.end());
+    g_regions = updated;
+}
+
+// One live VirtualQuery, spliced into the map; returns false when the query itself fails
+static bool QueryAndSplice(uintptr_t address, MemoryRegion& region, uintptr_t& regionEnd) {
+    MEMORY_BASIC_INFORMATION mbi;
+    if (VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) == 0) {
+        return false;
+    }
+
+    region = MakeRegion(mbi);
+    regionEnd = region.baseAddress + region.size;
+    if (region.state == MEM_COMMIT) {
+        ResolveModuleName(region);
+        SpliceRegion(region.baseAddress, regionEnd, &region);
+    } else {
+        SpliceRegion(region.baseAddress, regionEnd, nullptr);
+    }
+    return true;
+}
+
+RegionMap::Snapshot RegionMap::GetRegions() {
+    return CurrentRegions();
+}
+
+bool RegionMap::Find(uintptr_t address, RegionSpan& span, bool verify) {
+    if (!verify) {
+        Snapshot regions = CurrentRegions();
+        if (const MemoryRegion* region = FindCached(*regions, address)) {
+            FillSpan(*region, span, false);
+            return true;
+        }
+    }
+
+    // Cache miss (or confirmation): ask the OS and keep the answer
+    MemoryRegion region;
+    uintptr_t regionEnd;
+    if (!QueryAndSplice(address, region, regionEnd) || region.state != MEM_COMMIT) {
+        return false;
+    }
+    FillSpan(region, span, true);
+    return true;
+}
+
+void RegionMap::Invalidate(uintptr_t address, size_t size) {
+    uintptr_t end = address + (size ? size : 1);
+    if (end < address) end = UINTPTR_MAX;
+
+    uintptr_t cursor = address;
+    while (cursor < end) {
+        MemoryRegion region;
+        uintptr_t regionEnd;
+        if (!QueryAndSplice(cursor, region, regionEnd) || regionEnd <= cursor) break;
+        cursor = regionEnd;
+    }
+}
+
+void RegionMap::Refresh() {
+    Snapshot previous;
+    {
+        std::lock_guard<std::mutex> lock(g_regionMutex);
+        previous = g_regions;
+    }
+
+    auto regions = std::make_shared<std::vector<MemoryRegion>>();
+    if (previous) regions->reserve(previous->size());
+
+    MEMORY_BASIC_INFORMATION mbi;
+    uintptr_t address = 0;
+
+    while (VirtualQuery(reinterpret_cast<void*>(address), &mbi, sizeof(mbi)) == sizeof(mbi)) {
+        if (mbi.State == MEM_COMMIT) {
+            MemoryRegion region = MakeRegion(mbi);
+
+            // Module lookups dominate a full walk; an image region at the same base keeps its name
+            const MemoryRegion* known = previous ? FindCached(*previous, region.baseAddress) : nullptr;
+            if (region.type == MEM_IMAGE && known && known->type == MEM_IMAGE && known->baseAddress == region.baseAddress) {
+                region.moduleName = known->moduleName;
+            } else {
+                ResolveModuleName(region);
+            }
+
+            regions->push_back(std::move(region));
+        }
+
+        address = reinterpret_cast<uintptr_t>(mbi.BaseAddress) + mbi.RegionSize;
+        if (address == 0) break; // 오버플로우 방지
+    }
+
+    std::lock_guard<std::mutex> lock(g_regionMutex);
+    g_regions = regions;
+    g_lastRegionRefresh = GetTickCount();
+    g_regionRefreshing = false;
+}
+
+} // namespace InternalEngine
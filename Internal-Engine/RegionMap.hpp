@@ -0,0 +1,47 @@
+#pragma once
+#include <windows.h>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "MemoryEngine.hpp"
+
+namespace InternalEngine {
+
+// Attributes of the region containing a looked-up address
+struct RegionSpan {
+    uintptr_t start = 0;
+    uintptr_t end = 0;          // One past the last byte
+    DWORD protection = 0;
+    bool readable = false;
+    bool writable = false;
+    bool live = false;          // Came from VirtualQuery just now rather than the cache
+};
+
+// 🗺️ 메모리 영역 캐시
+// Committed regions are kept as a sorted vector behind a shared_ptr, so scanners and the
+// safety checks share one VirtualQuery walk instead of doing their own. The map is rebuilt
+// when it is older than REFRESH_INTERVAL_MS; between rebuilds a lookup that misses (or a
+// caller confirming a negative answer) runs one VirtualQuery and splices the result in.
+// Cached positives can be stale by up to one interval, which is safe because every read
+// and write behind these checks is SEH-guarded.
+class RegionMap {
+public:
+    using Snapshot = std::shared_ptr<const std::vector<MemoryRegion>>;
+
+    static const DWORD REFRESH_INTERVAL_MS = 1000;
+
+    // Committed regions sorted by base address
+    static Snapshot GetRegions();
+
+    // Committed region containing address; returns false when it is not committed.
+    // verify = true skips the cache (the live answer is still spliced in).
+    static bool Find(uintptr_t address, RegionSpan& span, bool verify = false);
+
+    // Re-queries [address, address + size) after an allocation, free or protection change
+    static void Invalidate(uintptr_t address, size_t size);
+
+    // Full rebuild (module names are carried over for image regions that did not move)
+    static void Refresh();
+};
+
+} // namespace InternalEngine
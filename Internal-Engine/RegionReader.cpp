@@ -0,0 +1,86 @@
+#include "RegionReader.hpp"
+#include <windows.h>
+#include <cstring>
+#include <vector>
+
+namespace InternalEngine {
+
+// Grows to the largest chunk (plus overlap) this thread has read and is reused after that
+static thread_local std::vector<uint8_t> t_buffer;
+
+int RegionReader::FilterReadFault(EXCEPTION_POINTERS* exception) {
+    const EXCEPTION_RECORD* record = exception->ExceptionRecord;
+    switch (record->ExceptionCode) {
+    case EXCEPTION_ACCESS_VIOLATION:
+    case EXCEPTION_IN_PAGE_ERROR:
+        return EXCEPTION_EXECUTE_HANDLER;
+    case EXCEPTION_GUARD_PAGE:
+        // Re-arm the one-shot guard the read just consumed
+        if (record->NumberParameters >= 2) {
+            void* page = reinterpret_cast<void*>(record->ExceptionInformation[1] & ~static_cast<ULONG_PTR>(PAGE_SIZE - 1));
+            MEMORY_BASIC_INFORMATION mbi;
+            DWORD oldProtect;
+            if (VirtualQuery(page, &mbi, sizeof(mbi)) == sizeof(mbi) && mbi.State == MEM_COMMIT && !(mbi.Protect & PAGE_GUARD)) {
+                VirtualProtect(page, PAGE_SIZE, mbi.Protect | PAGE_GUARD, &oldProtect);
+            }
+        }
+        return EXCEPTION_EXECUTE_HANDLER;
+    default:
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+}
+
+// SEH 전용 헬퍼 함수 (C++ 객체 없음)
+static bool CopyGuarded(void* dest, const void* src, size_t size) {
+    __try {
+        memcpy(dest, src, size);
+        return true;
+    }
+    __except(FilterReadFault(GetExceptionInformation())) {
+        return false;
+    }
+}
+
+void RegionReader::VisitCopied(RunCallback callback, void* context, uintptr_t start, size_t candidateCount,
+                               size_t readSize, size_t alignment) {
+    if (t_buffer.size() < readSize) t_buffer.resize(readSize);
+    uint8_t* buffer = t_buffer.data();
+
+    if (CopyGuarded(buffer, reinterpret_cast<const void*>(start), readSize)) {
+        callback(context, buffer, readSize, candidateCount, 0);
+        return;
+    }
+
+    // Page by page; each run of readable pages is scanned on its own
+    auto flushRun = [&](size_t runStart, size_t runEnd) {
+        // First candidate of the run on the chunk's alignment lattice
+        size_t first = (runStart + alignment - 1) / alignment * alignment;
+        if (first >= runEnd || first >= candidateCount) return;
+        callback(context, buffer + first, runEnd - first, candidateCount - first, first);
+    };
+
+    size_t runStart = 0;
+    size_t offset = 0;
+    while (offset < readSize) {
+        uintptr_t address = start + offset;
+        size_t pageRemaining = PAGE_SIZE - (address & (PAGE_SIZE - 1));
+        size_t length = min(pageRemaining, readSize - offset);
+
+        if (!CopyGuarded(buffer + offset, reinterpret_cast<const void*>(address), length)) {
+            if (offset > runStart) flushRun(runStart, offset);
+            runStart = offset + length;
+        }
+        offset += length;
+    }
+    if (readSize > runStart) flushRun(runStart, readSize);
+}
+
+size_t RegionReader::GetThreadBufferSize() {
+    return t_buffer.capacity();
+}
+
+void RegionReader::ReleaseThreadBuffer() {
+    std::vector<uint8_t>().swap(t_buffer);
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+struct _EXCEPTION_POINTERS;
+
+namespace InternalEngine {
+
+// 📖 영역 스트리밍 읽기
+// Hands a scan kernel the readable bytes of one chunk without allocating per chunk: the
+// chunk is copied into a per-thread buffer that is reused for every chunk the thread reads.
+// Only the copy runs under the access-violation guard (kernels allocate, and a fault would
+// skip their destructors). A fault on the bulk copy falls back to page-by-page copies, so
+// only the pages that fault are skipped and the kernel sees each readable run separately.
+// A guard page hit also counts as unreadable; the system clears PAGE_GUARD when it raises
+// the fault, so the filter sets it again and the target's trap (another thread's stack
+// growth, a guard-page watch) still fires on the target's own next access.
+//
+// Kernels get (data, dataSize, candidateCount, runOffset): candidates start at
+// data[0 .. candidateCount), data[] is readable for dataSize bytes and data[0] is
+// chunk start + runOffset. runOffset keeps the chunk's alignment lattice.
+class RegionReader {
+public:
+    static const size_t PAGE_SIZE = 4096;
+
+    template<typename Kernel>
+    static void Visit(uintptr_t start, size_t candidateCount, size_t readSize, size_t alignment, Kernel&& kernel) {
+        if (candidateCount == 0 || readSize == 0) return;
+        void* context = const_cast<void*>(static_cast<const void*>(&kernel));
+        VisitCopied(&Invoke<Kernel>, context, start, candidateCount, readSize, alignment);
+    }
+
+    // Bytes held by the calling thread's buffer
+    static size_t GetThreadBufferSize();
+
+    // Frees the calling thread's buffer
+    static void ReleaseThreadBuffer();
+
+    // __except filter for guarded reads of target memory (see above); other exceptions pass
+    static int FilterReadFault(_EXCEPTION_POINTERS* exception);
+
+private:
+    using RunCallback = void (*)(void* context, const uint8_t* data, size_t dataSize, size_t candidateCount, size_t runOffset);
+
+    template<typename Kernel>
+    static void Invoke(void* context, const uint8_t* data, size_t dataSize, size_t candidateCount, size_t runOffset) {
+        (*static_cast<typename std::remove_reference<Kernel>::type*>(context))(data, dataSize, candidateCount, runOffset);
+    }
+
+    static void VisitCopied(RunCallback callback, void* context, uintptr_t start, size_t candidateCount,
+                            size_t readSize, size_t alignment);
+};
+
+} // namespace InternalEngine
@@ -0,0 +1,186 @@
+#include "RegionSnapshot.hpp"
+#include "Deflate.hpp"
+#include <cstring>
+
+namespace InternalEngine {
+
+// RLE token layout: control < 128 -> (control + 1) literal bytes follow,
+// control >= 128 -> the next byte repeats (control - 128 + MIN_RUN) times
+static const size_t MIN_RUN = 3;
+static const size_t MAX_RUN = 127 + MIN_RUN;
+static const size_t MAX_LITERAL = 128;
+
+// An RLE page this small is kept without trying DEFLATE (it decodes several times faster)
+static const size_t RLE_GOOD_ENOUGH_DIVISOR = 8;
+
+// Empty stored block tail left off by Deflate::Compress; stored with the page so it inflates as is
+static const uint8_t DEFLATE_TAIL[] = { 0x00, 0x00, 0xFF, 0xFF };
+
+// Reused by every page this thread compresses
+static thread_local std::vector<uint8_t> t_deflateBuffer;
+
+RegionSnapshot::RegionSnapshot() {}
+
+void RegionSnapshot::Reset(size_t newSpan, size_t newDataSize, size_t newOverlap) {
+    span = newSpan;
+    dataSize = newDataSize < newSpan ? newSpan : newDataSize;
+    overlap = newOverlap;
+    pages.clear();
+    pages.resize((span + PAGE_SIZE - 1) / PAGE_SIZE);
+}
+
+void RegionSnapshot::Capture(const uint8_t* data, size_t newSpan, size_t newDataSize, size_t newOverlap) {
+    Reset(newSpan, newDataSize, newOverlap);
+    for (size_t i = 0; i < pages.size(); i++) {
+        StorePage(i, data + i * PAGE_SIZE);
+    }
+}
+
+size_t RegionSnapshot::PageLength(size_t pageIndex) const {
+    size_t start = pageIndex * PAGE_SIZE;
+    size_t end = start + PAGE_SIZE + overlap;
+    if (end > dataSize) end = dataSize;
+    return end - start;
+}
+
+void RegionSnapshot::StorePage(size_t pageIndex, const uint8_t* data) {
+    Page& page = pages[pageIndex];
+    size_t length = PageLength(pageIndex);
+
+    bool allZero = true;
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != 0) {
+            allZero = false;
+            break;
+        }
+    }
+
+    page.bytes.clear();
+    if (allZero) {
+        page.encoding = PageEncoding::Zero;
+        page.bytes.shrink_to_fit();
+        return;
+    }
+
+    bool rle = EncodeRle(data, length, page.bytes);
+    if (rle && page.bytes.size() <= length / RLE_GOOD_ENOUGH_DIVISOR) {
+        page.encoding = PageEncoding::Rle;
+        page.bytes.shrink_to_fit();
+        return;
+    }
+
+    std::vector<uint8_t>& deflated = t_deflateBuffer;
+    deflated.clear();
+    Deflate::Compress(data, length, deflated);
+    deflated.insert(deflated.end(), DEFLATE_TAIL, DEFLATE_TAIL + sizeof(DEFLATE_TAIL));
+
+    if (deflated.size() < (rle ? page.bytes.size() : length)) {
+        page.encoding = PageEncoding::Deflate;
+        page.bytes.assign(deflated.begin(), deflated.end());
+        page.bytes.shrink_to_fit();     // The failed RLE attempt may have grown it to a full page
+    } else if (rle) {
+        page.encoding = PageEncoding::Rle;
+        page.bytes.shrink_to_fit();
+    } else {
+        page.encoding = PageEncoding::Raw;
+        page.bytes.assign(data, data + length);
+    }
+}
+
+void RegionSnapshot::ReleasePage(size_t pageIndex) {
+    Page& page = pages[pageIndex];
+    page.encoding = PageEncoding::Released;
+    std::vector<uint8_t>().swap(page.bytes);
+}
+
+bool RegionSnapshot::LoadPage(size_t pageIndex, std::vector<uint8_t>& out) const {
+    const Page& page = pages[pageIndex];
+    size_t length = PageLength(pageIndex);
+
+    switch (page.encoding) {
+        case PageEncoding::Zero:
+            out.assign(length, 0);
+            return true;
+        case PageEncoding::Rle:
+            out.resize(length);
+            return DecodeRle(page.bytes, out.data(), length);
+        case PageEncoding::Deflate:
+            return Deflate::Inflate(page.bytes.data(), page.bytes.size(), out, length) && out.size() == length;
+        case PageEncoding::Raw:
+            out.assign(page.bytes.begin(), page.bytes.end());
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t RegionSnapshot::MemoryUsage() const {
+    size_t usage = pages.capacity() * sizeof(Page);
+    for (const auto& page : pages) {
+        usage += page.bytes.capacity();
+    }
+    return usage;
+}
+
+bool RegionSnapshot::EncodeRle(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    out.reserve(size / 4);
+
+    size_t i = 0;
+    size_t literalStart = 0;
+
+    auto flushLiterals = [&](size_t end) {
+        while (literalStart < end) {
+            size_t count = end - literalStart;
+            if (count > MAX_LITERAL) count = MAX_LITERAL;
+            out.push_back(static_cast<uint8_t>(count - 1));
+            out.insert(out.end(), data + literalStart, data + literalStart + count);
+            literalStart += count;
+        }
+    };
+
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < MAX_RUN && data[i + run] == data[i]) run++;
+
+        if (run >= MIN_RUN) {
+            flushLiterals(i);
+            out.push_back(static_cast<uint8_t>(128 + run - MIN_RUN));
+            out.push_back(data[i]);
+            i += run;
+            literalStart = i;
+        } else {
+            i += run;
+        }
+
+        // Not worth it - caller stores the page raw
+        if (out.size() >= size) return false;
+    }
+    flushLiterals(size);
+
+    return out.size() < size;
+}
+
+bool RegionSnapshot::DecodeRle(const std::vector<uint8_t>& in, uint8_t* out, size_t size) {
+    size_t pos = 0;
+    size_t written = 0;
+
+    while (pos < in.size() && written < size) {
+        uint8_t control = in[pos++];
+        if (control < 128) {
+            size_t count = static_cast<size_t>(control) + 1;
+            if (pos + count > in.size() || written + count > size) return false;
+            memcpy(out + written, in.data() + pos, count);
+            pos += count;
+            written += count;
+        } else {
+            size_t count = static_cast<size_t>(control) - 128 + MIN_RUN;
+            if (pos >= in.size() || written + count > size) return false;
+            memset(out + written, in[pos++], count);
+            written += count;
+        }
+    }
+
+    return written == size;
+}
+
+} // namespace InternalEngine
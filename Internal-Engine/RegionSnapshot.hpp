@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace InternalEngine {
+
+// 📸 압축된 영역 스냅샷
+// A copy of one scan chunk split into 64 KB pages. Each page is stored as all-zero
+// (no bytes), run-length encoded, DEFLATE compressed or raw, whichever is smallest. RLE
+// alone covers fill patterns; ordinary heap data (pointers, small integers, vtables) only
+// shrinks under LZ77 + Huffman, so it is tried whenever RLE does not get a page below
+// 1/8 of its size. Pages carry `overlap`
+// extra bytes from the next page so values starting near a page end can be compared
+// without touching a second page.
+class RegionSnapshot {
+public:
+    static const size_t PAGE_SIZE = 64 * 1024;
+
+    RegionSnapshot();
+
+    // span: bytes of candidate start offsets, dataSize: bytes actually captured (>= span)
+    void Reset(size_t span, size_t dataSize, size_t overlap);
+
+    // Compresses every page of a contiguous dataSize-byte buffer
+    void Capture(const uint8_t* data, size_t span, size_t dataSize, size_t overlap);
+
+    size_t GetSpan() const { return span; }
+    size_t GetDataSize() const { return dataSize; }
+    size_t PageCount() const { return pages.size(); }
+    size_t PageLength(size_t pageIndex) const;
+
+    void StorePage(size_t pageIndex, const uint8_t* data);
+    void ReleasePage(size_t pageIndex);
+
+    // Decompresses a page into out (resized to PageLength); false if the page was released
+    bool LoadPage(size_t pageIndex, std::vector<uint8_t>& out) const;
+
+    size_t MemoryUsage() const;
+
+private:
+    enum class PageEncoding : uint8_t {
+        Released,
+        Zero,
+        Rle,
+        Deflate,
+        Raw
+    };
+
+    struct Page {
+        PageEncoding encoding = PageEncoding::Released;
+        std::vector<uint8_t> bytes;
+    };
+
+    static bool EncodeRle(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+    static bool DecodeRle(const std::vector<uint8_t>& in, uint8_t* out, size_t size);
+
+    std::vector<Page> pages;
+    size_t span = 0;
+    size_t dataSize = 0;
+    size_t overlap = 0;
+};
+
+} // namespace InternalEngine
@@ -0,0 +1,505 @@
+#include "ScanFilter.hpp"
+#include <windows.h>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace InternalEngine {
+
+// Reads below this are null-pointer arithmetic, rejected without taking a fault
+static const uintptr_t MIN_READ_ADDRESS = 0x10000;
+
+// SEH 전용 헬퍼 함수 (C++ 객체 없음)
+static bool SafeLoad(uintptr_t address, void* out, size_t size) {
+    if (address < MIN_READ_ADDRESS) return false;
+    __try {
+        memcpy(out, reinterpret_cast<const void*>(address), size);
+        return true;
+    }
+    __except(EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+// 🛠️ 컴파일러 (recursive descent straight to bytecode; each level returns its result type)
+enum class FilterType {
+    Int,
+    Float
+};
+
+class ScanFilter::Compiler {
+public:
+    Compiler(const std::string& source, ScanValueKind kind, std::vector<Instruction>& code)
+        : source(source), kind(kind), code(code) {}
+
+    void Run() {
+        FilterType type = ParseOr();
+        SkipSpaces();
+        if (position < source.size()) {
+            Fail(std::string("unexpected '") + source[position] + "'");
+        }
+        Emit(type == FilterType::Float ? Op::FloatTruth : Op::Truth, 0);
+    }
+
+private:
+    const std::string& source;
+    ScanValueKind kind;
+    std::vector<Instruction>& code;
+    size_t position = 0;
+    size_t depth = 0;
+    size_t nesting = 0;
+
+    [[noreturn]] void Fail(const std::string& message) const {
+        throw std::invalid_argument("filter: " + message + " at position " + std::to_string(position));
+    }
+
+    void SkipSpaces() {
+        while (position < source.size() && isspace(static_cast<unsigned char>(source[position]))) position++;
+    }
+
+    // Matches token unless the next character is one of notBefore ("&" must not take "&&")
+    bool Accept(const char* token, const char* notBefore = "") {
+        SkipSpaces();
+        size_t length = strlen(token);
+        if (source.compare(position, length, token) != 0) return false;
+        if (position + length < source.size() && source[position + length] != 0 &&
+            strchr(notBefore, source[position + length])) {
+            return false;
+        }
+        position += length;
+        return true;
+    }
+
+    void Expect(const char* token) {
+        if (!Accept(token)) Fail(std::string("expected '") + token + "'");
+    }
+
+    size_t Emit(Op op, int stackEffect) {
+        Instruction instruction;
+        instruction.op = op;
+        instruction.integer = 0;
+        code.push_back(instruction);
+
+        depth = static_cast<size_t>(static_cast<ptrdiff_t>(depth) + stackEffect);
+        if (depth > MAX_STACK) Fail("expression nests too deeply");
+        return code.size() - 1;
+    }
+
+    void EmitTruth(FilterType type) {
+        Emit(type == FilterType::Float ? Op::FloatTruth : Op::Truth, 0);
+    }
+
+    // Integer operands are promoted to double when the other side is a float
+    FilterType EmitBinary(FilterType left, FilterType right, Op intOp, Op floatOp, bool comparison) {
+        FilterType type = FilterType::Int;
+        if (left == FilterType::Int && right == FilterType::Int) {
+            Emit(intOp, -1);
+        } else {
+            if (left == FilterType::Int) Emit(Op::ToFloatBelow, 0);
+            if (right == FilterType::Int) Emit(Op::ToFloat, 0);
+            Emit(floatOp, -1);
+            type = FilterType::Float;
+        }
+        return comparison ? FilterType::Int : type;
+    }
+
+    FilterType EmitIntegerOnly(FilterType left, FilterType right, Op op, const char* name) {
+        if (left != FilterType::Int || right != FilterType::Int) {
+            Fail(std::string("'") + name + "' needs integer operands");
+        }
+        Emit(op, -1);
+        return FilterType::Int;
+    }
+
+    FilterType ParseOr() {
+        FilterType type = ParseAnd();
+        while (Accept("||")) {
+            if (type == FilterType::Float) Emit(Op::FloatTruth, 0);
+            size_t jump = Emit(Op::JumpIfTrue, -1);
+            EmitTruth(ParseAnd());
+            code[jump].target = code.size();
+            type = FilterType::Int;
+        }
+        return type;
+    }
+
+    FilterType ParseAnd() {
+        FilterType type = ParseBitOr();
+        while (Accept("&&")) {
+            if (type == FilterType::Float) Emit(Op::FloatTruth, 0);
+            size_t jump = Emit(Op::JumpIfFalse, -1);
+            EmitTruth(ParseBitOr());
+            code[jump].target = code.size();
+            type = FilterType::Int;
+        }
+        return type;
+    }
+
+    FilterType ParseBitOr() {
+        FilterType type = ParseBitXor();
+        while (Accept("|", "|")) {
+            type = EmitIntegerOnly(type, ParseBitXor(), Op::OrI, "|");
+        }
+        return type;
+    }
+
+    FilterType ParseBitXor() {
+        FilterType type = ParseBitAnd();
+        while (Accept("^")) {
+            type = EmitIntegerOnly(type, ParseBitAnd(), Op::XorI, "^");
+        }
+        return type;
+    }
+
+    FilterType ParseBitAnd() {
+        FilterType type = ParseEquality();
+        while (Accept("&", "&")) {
+            type = EmitIntegerOnly(type, ParseEquality(), Op::AndI, "&");
+        }
+        return type;
+    }
+
+    FilterType ParseEquality() {
+        FilterType type = ParseRelational();
+        while (true) {
+            if (Accept("==")) {
+                type = EmitBinary(type, ParseRelational(), Op::EqI, Op::EqF, true);
+            } else if (Accept("!=")) {
+                type = EmitBinary(type, ParseRelational(), Op::NeI, Op::NeF, true);
+            } else {
+                return type;
+            }
+        }
+    }
+
+    FilterType ParseRelational() {
+        FilterType type = ParseShift();
+        while (true) {
+            if (Accept("<=")) {
+                type = EmitBinary(type, ParseShift(), Op::LeI, Op::LeF, true);
+            } else if (Accept(">=")) {
+                type = EmitBinary(type, ParseShift(), Op::GeI, Op::GeF, true);
+            } else if (Accept("<", "<=")) {
+                type = EmitBinary(type, ParseShift(), Op::LtI, Op::LtF, true);
+            } else if (Accept(">", ">=")) {
+                type = EmitBinary(type, ParseShift(), Op::GtI, Op::GtF, true);
+            } else {
+                return type;
+            }
+        }
+    }
+
+    FilterType ParseShift() {
+        FilterType type = ParseAdditive();
+        while (true) {
+            if (Accept("<<")) {
+                type = EmitIntegerOnly(type, ParseAdditive(), Op::ShlI, "<<");
+            } else if (Accept(">>")) {
+                type = EmitIntegerOnly(type, ParseAdditive(), Op::ShrI, ">>");
+            } else {
+                return type;
+            }
+        }
+    }
+
+    FilterType ParseAdditive() {
+        FilterType type = ParseMultiplicative();
+        while (true) {
+            if (Accept("+")) {
+                type = EmitBinary(type, ParseMultiplicative(), Op::AddI, Op::AddF, false);
+            } else if (Accept("-")) {
+                type = EmitBinary(type, ParseMultiplicative(), Op::SubI, Op::SubF, false);
+            } else {
+                return type;
+            }
+        }
+    }
+
+    FilterType ParseMultiplicative() {
+        FilterType type = ParseUnary();
+        while (true) {
+            if (Accept("*")) {
+                type = EmitBinary(type, ParseUnary(), Op::MulI, Op::MulF, false);
+            } else if (Accept("/")) {
+                type = EmitBinary(type, ParseUnary(), Op::DivI, Op::DivF, false);
+            } else if (Accept("%")) {
+                type = EmitIntegerOnly(type, ParseUnary(), Op::ModI, "%");
+            } else {
+                return type;
+            }
+        }
+    }
+
+    // Every nested operand ('(', '[', call arguments, unary operators) comes through here, so
+    // this bounds the parser's recursion on the command worker's stack
+    FilterType ParseUnary() {
+        if (++nesting > MAX_NESTING) Fail("expression nests too deeply");
+        FilterType type = ParseUnaryOperand();
+        nesting--;
+        return type;
+    }
+
+    FilterType ParseUnaryOperand() {
+        if (Accept("-")) {
+            FilterType type = ParseUnary();
+            Emit(type == FilterType::Float ? Op::NegF : Op::NegI, 0);
+            return type;
+        }
+        if (Accept("+")) {
+            return ParseUnary();
+        }
+        if (Accept("!", "=")) {
+            FilterType type = ParseUnary();
+            if (type == FilterType::Float) Emit(Op::FloatTruth, 0);
+            Emit(Op::LogicalNot, 0);
+            return FilterType::Int;
+        }
+        if (Accept("~")) {
+            if (ParseUnary() != FilterType::Int) Fail("'~' needs an integer operand");
+            Emit(Op::NotI, 0);
+            return FilterType::Int;
+        }
+        return ParsePrimary();
+    }
+
+    // [address] with the address already parsed; pops it and pushes the loaded value
+    FilterType ParseRead(Op op) {
+        if (ParseOr() != FilterType::Int) Fail("memory addresses must be integers");
+        Expect("]");
+        Emit(op, 0);
+        return (op == Op::ReadFloat || op == Op::ReadDouble) ? FilterType::Float : FilterType::Int;
+    }
+
+    FilterType ParseNumber() {
+        size_t start = position;
+        const char* begin = source.c_str() + start;
+        char* end = nullptr;
+
+        Instruction instruction;
+        FilterType type = FilterType::Int;
+        if (begin[0] == '0' && (begin[1] == 'x' || begin[1] == 'X')) {
+            instruction.op = Op::PushInt;
+            instruction.integer = static_cast<int64_t>(strtoull(begin, &end, 16));
+        } else {
+            // A '.' or an exponent makes it a float
+            size_t scan = start;
+            bool isFloat = false;
+            while (scan < source.size()) {
+                char c = source[scan];
+                if (c == '.' || c == 'e' || c == 'E') {
+                    isFloat = true;
+                } else if (!isdigit(static_cast<unsigned char>(c)) &&
+                           !((c == '+' || c == '-') && scan > start && (source[scan - 1] == 'e' || source[scan - 1] == 'E'))) {
+                    break;
+                }
+                scan++;
+            }
+            if (isFloat) {
+                instruction.op = Op::PushFloat;
+                instruction.real = strtod(begin, &end);
+                type = FilterType::Float;
+            } else {
+                instruction.op = Op::PushInt;
+                instruction.integer = static_cast<int64_t>(strtoull(begin, &end, 10));
+            }
+        }
+        if (end == begin) Fail("malformed number");
+        position = start + static_cast<size_t>(end - begin);
+
+        Emit(instruction.op, 1);
+        code.back() = instruction;
+        return type;
+    }
+
+    FilterType ParsePrimary() {
+        SkipSpaces();
+        if (position >= source.size()) Fail("unexpected end of expression");
+
+        if (Accept("(")) {
+            FilterType type = ParseOr();
+            Expect(")");
+            return type;
+        }
+        if (Accept("[")) {
+            return ParseRead(Op::ReadInt32);
+        }
+
+        char first = source[position];
+        if (isdigit(static_cast<unsigned char>(first)) || first == '.') {
+            return ParseNumber();
+        }
+        if (!isalpha(static_cast<unsigned char>(first)) && first != '_') {
+            Fail(std::string("unexpected '") + first + "'");
+        }
+
+        size_t start = position;
+        while (position < source.size() && (isalnum(static_cast<unsigned char>(source[position])) || source[position] == '_')) {
+            position++;
+        }
+        std::string name = source.substr(start, position - start);
+
+        if (name == "value" || name == "previous") {
+            if (kind == ScanValueKind::Bytes) {
+                position = start;
+                Fail("'" + name + "' needs a numeric valueType");
+            }
+            Emit(name == "value" ? Op::LoadValue : Op::LoadPrevious, 1);
+            return (kind == ScanValueKind::Float || kind == ScanValueKind::Double) ? FilterType::Float : FilterType::Int;
+        }
+        if (name == "addr" || name == "address") {
+            Emit(Op::LoadAddress, 1);
+            return FilterType::Int;
+        }
+
+        Op read;
+        if (name == "byte") read = Op::ReadByte;
+        else if (name == "int16") read = Op::ReadInt16;
+        else if (name == "int32" || name == "int") read = Op::ReadInt32;
+        else if (name == "int64" || name == "ptr") read = Op::ReadInt64;
+        else if (name == "float") read = Op::ReadFloat;
+        else if (name == "double") read = Op::ReadDouble;
+        else {
+            position = start;
+            Fail("unknown name '" + name + "'");
+        }
+        Expect("[");
+        return ParseRead(read);
+    }
+};
+
+ScanFilter ScanFilter::Compile(const std::string& expression, ScanValueKind kind) {
+    if (expression.size() > MAX_EXPRESSION_LENGTH) {
+        throw std::invalid_argument("filter: expression longer than " + std::to_string(MAX_EXPRESSION_LENGTH) + " characters");
+    }
+
+    ScanFilter filter;
+    filter.kind = kind;
+    Compiler(expression, kind, filter.code).Run();
+    return filter;
+}
+
+// ⚡ 평가
+union FilterSlot {
+    int64_t integer;
+    double real;
+};
+
+static FilterSlot LoadValueOfKind(ScanValueKind kind, const uint8_t* bytes) {
+    FilterSlot slot;
+    slot.integer = 0;
+    switch (kind) {
+        case ScanValueKind::Byte: slot.integer = bytes[0]; break;
+        case ScanValueKind::Int32: { int32_t v; memcpy(&v, bytes, sizeof(v)); slot.integer = v; break; }
+        case ScanValueKind::Int64: memcpy(&slot.integer, bytes, sizeof(int64_t)); break;
+        case ScanValueKind::Float: { float v; memcpy(&v, bytes, sizeof(v)); slot.real = v; break; }
+        case ScanValueKind::Double: memcpy(&slot.real, bytes, sizeof(double)); break;
+        case ScanValueKind::Bytes: break;
+    }
+    return slot;
+}
+
+template<typename T>
+static bool ReadInto(FilterSlot& slot) {
+    T loaded;
+    if (!SafeLoad(static_cast<uintptr_t>(slot.integer), &loaded, sizeof(T))) return false;
+    if constexpr (std::is_floating_point<T>::value) {
+        slot.real = loaded;
+    } else {
+        slot.integer = static_cast<int64_t>(loaded);
+    }
+    return true;
+}
+
+bool ScanFilter::Matches(uintptr_t address, const uint8_t* value, const uint8_t* previous) const {
+    if (code.empty()) return true;
+    if (!previous) previous = value;
+
+    FilterSlot stack[MAX_STACK];
+    size_t top = 0;     // stack[top - 1] is the top
+
+    const size_t count = code.size();
+    for (size_t pc = 0; pc < count; pc++) {
+        const Instruction& instruction = code[pc];
+        FilterSlot* slot = top > 0 ? &stack[top - 1] : nullptr;
+        FilterSlot* below = top > 1 ? &stack[top - 2] : nullptr;
+
+        switch (instruction.op) {
+            case Op::PushInt: stack[top++].integer = instruction.integer; break;
+            case Op::PushFloat: stack[top++].real = instruction.real; break;
+            case Op::LoadValue: stack[top++] = LoadValueOfKind(kind, value); break;
+            case Op::LoadPrevious: stack[top++] = LoadValueOfKind(kind, previous); break;
+            case Op::LoadAddress: stack[top++].integer = static_cast<int64_t>(address); break;
+
+            case Op::ReadByte: if (!ReadInto<uint8_t>(*slot)) return false; break;
+            case Op::ReadInt16: if (!ReadInto<int16_t>(*slot)) return false; break;
+            case Op::ReadInt32: if (!ReadInto<int32_t>(*slot)) return false; break;
+            case Op::ReadInt64: if (!ReadInto<int64_t>(*slot)) return false; break;
+            case Op::ReadFloat: if (!ReadInto<float>(*slot)) return false; break;
+            case Op::ReadDouble: if (!ReadInto<double>(*slot)) return false; break;
+
+            case Op::ToFloat: slot->real = static_cast<double>(slot->integer); break;
+            case Op::ToFloatBelow: below->real = static_cast<double>(below->integer); break;
+            case Op::FloatTruth: slot->integer = slot->real != 0.0; break;
+            case Op::Truth: slot->integer = slot->integer != 0; break;
+
+            // Wrapping arithmetic is done unsigned so overflow is defined
+            case Op::AddI: below->integer = static_cast<int64_t>(static_cast<uint64_t>(below->integer) + static_cast<uint64_t>(slot->integer)); top--; break;
+            case Op::SubI: below->integer = static_cast<int64_t>(static_cast<uint64_t>(below->integer) - static_cast<uint64_t>(slot->integer)); top--; break;
+            case Op::MulI: below->integer = static_cast<int64_t>(static_cast<uint64_t>(below->integer) * static_cast<uint64_t>(slot->integer)); top--; break;
+            case Op::DivI:
+            case Op::ModI:
+                if (slot->integer == 0 || (slot->integer == -1 && below->integer == INT64_MIN)) return false;
+                below->integer = instruction.op == Op::DivI ? below->integer / slot->integer : below->integer % slot->integer;
+                top--;
+                break;
+            case Op::AndI: below->integer &= slot->integer; top--; break;
+            case Op::OrI: below->integer |= slot->integer; top--; break;
+            case Op::XorI: below->integer ^= slot->integer; top--; break;
+            case Op::ShlI: below->integer = static_cast<int64_t>(static_cast<uint64_t>(below->integer) << (slot->integer & 63)); top--; break;
+            case Op::ShrI: below->integer >>= (slot->integer & 63); top--; break;
+            case Op::NegI: slot->integer = static_cast<int64_t>(0 - static_cast<uint64_t>(slot->integer)); break;
+            case Op::NotI: slot->integer = ~slot->integer; break;
+            case Op::LogicalNot: slot->integer = slot->integer == 0; break;
+
+            case Op::EqI: below->integer = below->integer == slot->integer; top--; break;
+            case Op::NeI: below->integer = below->integer != slot->integer; top--; break;
+            case Op::LtI: below->integer = below->integer < slot->integer; top--; break;
+            case Op::LeI: below->integer = below->integer <= slot->integer; top--; break;
+            case Op::GtI: below->integer = below->integer > slot->integer; top--; break;
+            case Op::GeI: below->integer = below->integer >= slot->integer; top--; break;
+
+            case Op::AddF: below->real += slot->real; top--; break;
+            case Op::SubF: below->real -= slot->real; top--; break;
+            case Op::MulF: below->real *= slot->real; top--; break;
+            case Op::DivF: below->real /= slot->real; top--; break;
+            case Op::NegF: slot->real = -slot->real; break;
+
+            case Op::EqF: below->integer = below->real == slot->real; top--; break;
+            case Op::NeF: below->integer = below->real != slot->real; top--; break;
+            case Op::LtF: below->integer = below->real < slot->real; top--; break;
+            case Op::LeF: below->integer = below->real <= slot->real; top--; break;
+            case Op::GtF: below->integer = below->real > slot->real; top--; break;
+            case Op::GeF: below->integer = below->real >= slot->real; top--; break;
+
+            case Op::JumpIfFalse:
+                if (slot->integer == 0) {
+                    pc = instruction.target - 1;
+                } else {
+                    top--;
+                }
+                break;
+            case Op::JumpIfTrue:
+                if (slot->integer != 0) {
+                    slot->integer = 1;
+                    pc = instruction.target - 1;
+                } else {
+                    top--;
+                }
+                break;
+        }
+    }
+    return top > 0 && stack[top - 1].integer != 0;
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "ScanResultStore.hpp"
+
+namespace InternalEngine {
+
+// 🧮 스캔 필터 식
+// A user predicate such as "value > 100 && value % 4 == 0 && [addr+8] == 1", compiled once per
+// scan into stack bytecode and evaluated for every hit inside the scan kernels, so rejected
+// candidates never leave the DLL.
+//  - Operands: integer/float literals (0x hex too), value, previous (the stored value in next
+//    scans, value itself in first scans), addr (the candidate address).
+//  - Memory: [expr] reads an int32; byte[...], int16[...], int32[...], int64[...], float[...],
+//    double[...] and ptr[...] read that type. A read that faults rejects the candidate.
+//  - Operators (C precedence): || && | ^ & == != < <= > >= << >> + - * / % and unary - ! ~.
+//    && and || short-circuit, so "addr != 0 && [addr] == 1" only reads when it has to.
+// Integers are 64-bit; an operation with a float operand is done in double. Bitwise, shift
+// and % need integers. Integer division by zero rejects the candidate.
+class ScanFilter {
+public:
+    static const size_t MAX_STACK = 32;
+    static const size_t MAX_NESTING = 64;   // Parenthesized, bracketed or unary operands inside each other
+    static const size_t MAX_EXPRESSION_LENGTH = 1024;
+
+    ScanFilter() = default;
+
+    // Throws std::invalid_argument with the position of the first error.
+    // kind is the scan's value type; "value" is rejected for raw bytes.
+    static ScanFilter Compile(const std::string& expression, ScanValueKind kind);
+
+    bool IsEmpty() const { return code.empty(); }
+
+    // value points at the candidate's current bytes, previous at its stored bytes (or nullptr).
+    // Safe to call from several threads at once.
+    bool Matches(uintptr_t address, const uint8_t* value, const uint8_t* previous) const;
+
+private:
+    enum class Op : uint8_t {
+        PushInt, PushFloat, LoadValue, LoadPrevious, LoadAddress,
+        ReadByte, ReadInt16, ReadInt32, ReadInt64, ReadFloat, ReadDouble,
+        ToFloat, ToFloatBelow, FloatTruth, Truth,
+        AddI, SubI, MulI, DivI, ModI, AndI, OrI, XorI, ShlI, ShrI, NegI, NotI, LogicalNot,
+        EqI, NeI, LtI, LeI, GtI, GeI,
+        AddF, SubF, MulF, DivF, NegF, EqF, NeF, LtF, LeF, GtF, GeF,
+        JumpIfFalse,    // Top == 0: jump, keeping it; otherwise pop
+        JumpIfTrue      // Top != 0: jump with 1 on top; otherwise pop
+    };
+
+    struct Instruction {
+        Op op;
+        union {
+            int64_t integer;
+            double real;
+            size_t target;
+        };
+    };
+
+    class Compiler;
+
+    std::vector<Instruction> code;
+    ScanValueKind kind = ScanValueKind::Bytes;
+};
+
+} // namespace InternalEngine
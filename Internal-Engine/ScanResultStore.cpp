@@ -0,0 +1,896 @@
+#include "ScanResultStore.hpp"
+#include "MemoryEngine.hpp"
+#include "ScanFilter.hpp"
+#include "WorkStealingPool.hpp"
+#include "ChangeTracker.hpp"
+#include <intrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+namespace InternalEngine {
+
+// Candidates are re-read in blocks of up to this size instead of one VirtualQuery per address
+static const size_t FILTER_BLOCK_SIZE = 64 * 1024;
+
+static bool IsCancelled(const ScanOptions* control) {
+    return control && control->cancel && control->cancel->load(std::memory_order_relaxed);
+}
+
+static void ReportProgress(const ScanOptions* control, size_t done, size_t total, size_t found) {
+    if (control && control->onProgress) control->onProgress(done, total, found);
+}
+
+namespace {
+
+template<typename T>
+inline T Load(const uint8_t* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+template<typename T>
+int CompareAs(const uint8_t* a, const uint8_t* b) {
+    T x = Load<T>(a);
+    T y = Load<T>(b);
+    return static_cast<int>(x > y) - static_cast<int>(x < y);
+}
+
+// Same-width unsigned type: changed/unchanged compare bit patterns, like memcmp did
+template<typename T> struct BitsOf { using type = typename std::make_unsigned<T>::type; };
+template<> struct BitsOf<float> { using type = uint32_t; };
+template<> struct BitsOf<double> { using type = uint64_t; };
+
+// One (value type, comparison) pair. Every branch but the loop is resolved at compile time
+// and the body only uses non-short-circuit operators, so the loop has no data dependent
+// branches and the compiler is free to vectorize it.
+template<typename T, ScanCompare C>
+void TypedKernel(const uint8_t* current, const uint8_t* previous, size_t count, size_t stride,
+                 const ScanKernelOperands& operands, uint8_t* flags) {
+    using Bits = typename BitsOf<T>::type;
+    const T target = operands.target ? Load<T>(operands.target) : T();
+    const T target2 = operands.target2 ? Load<T>(operands.target2) : T();
+    const T epsilon = static_cast<T>(operands.epsilon);
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* c = current + i * stride;
+        const uint8_t* p = previous + i * stride;
+        bool match;
+        if constexpr (C == ScanCompare::Changed) {
+            match = Load<Bits>(c) != Load<Bits>(p);
+        } else if constexpr (C == ScanCompare::Unchanged) {
+            match = Load<Bits>(c) == Load<Bits>(p);
+        } else if constexpr (C == ScanCompare::Exact) {
+            T value = Load<T>(c);
+            if constexpr (std::is_floating_point<T>::value) {
+                match = (value == target) | (std::fabs(value - target) <= epsilon);
+            } else {
+                match = value == target;
+            }
+        } else if constexpr (C == ScanCompare::Increased) {
+            match = Load<T>(c) > Load<T>(p);
+        } else if constexpr (C == ScanCompare::Decreased) {
+            match = Load<T>(c) < Load<T>(p);
+        } else if constexpr (C == ScanCompare::IncreasedBy || C == ScanCompare::DecreasedBy) {
+            T value = Load<T>(c);
+            T old = Load<T>(p);
+            if constexpr (std::is_floating_point<T>::value) {
+                T delta = (C == ScanCompare::IncreasedBy) ? value - old : old - value;
+                match = std::fabs(delta - target) <= epsilon;
+            } else {
+                // Wrapping difference (no signed overflow), so INT_MIN -> INT_MAX is "increased by -1"
+                Bits delta = (C == ScanCompare::IncreasedBy) ? static_cast<Bits>(static_cast<Bits>(value) - static_cast<Bits>(old))
+                                                             : static_cast<Bits>(static_cast<Bits>(old) - static_cast<Bits>(value));
+                match = delta == static_cast<Bits>(target);
+            }
+        } else if constexpr (C == ScanCompare::Between) {
+            T value = Load<T>(c);
+            match = (value >= target) & (value <= target2);
+        } else {
+            match = true;
+        }
+        flags[i] = static_cast<uint8_t>(match);
+    }
+}
+
+// Raw bytes: only equality comparisons are defined, ordered ones never match
+template<ScanCompare C>
+void BytesKernel(const uint8_t* current, const uint8_t* previous, size_t count, size_t stride,
+                 const ScanKernelOperands& operands, uint8_t* flags) {
+    const size_t size = operands.valueSize;
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* c = current + i * stride;
+        bool match;
+        if constexpr (C == ScanCompare::Exact) {
+            match = memcmp(c, operands.target, size) == 0;
+        } else if constexpr (C == ScanCompare::Changed) {
+            match = memcmp(c, previous + i * stride, size) != 0;
+        } else if constexpr (C == ScanCompare::Unchanged) {
+            match = memcmp(c, previous + i * stride, size) == 0;
+        } else if constexpr (C == ScanCompare::Any) {
+            match = true;
+        } else {
+            match = false;
+        }
+        flags[i] = static_cast<uint8_t>(match);
+    }
+}
+
+void NoMatchKernel(const uint8_t*, const uint8_t*, size_t count, size_t, const ScanKernelOperands&, uint8_t* flags) {
+    memset(flags, 0, count);
+}
+
+template<template<ScanCompare> class Table>
+ScanKernel SelectCompare(ScanCompare compare) {
+    switch (compare) {
+        case ScanCompare::Exact: return Table<ScanCompare::Exact>::kernel;
+        case ScanCompare::Changed: return Table<ScanCompare::Changed>::kernel;
+        case ScanCompare::Unchanged: return Table<ScanCompare::Unchanged>::kernel;
+        case ScanCompare::Increased: return Table<ScanCompare::Increased>::kernel;
+        case ScanCompare::Decreased: return Table<ScanCompare::Decreased>::kernel;
+        case ScanCompare::IncreasedBy: return Table<ScanCompare::IncreasedBy>::kernel;
+        case ScanCompare::DecreasedBy: return Table<ScanCompare::DecreasedBy>::kernel;
+        case ScanCompare::Between: return Table<ScanCompare::Between>::kernel;
+        default: return Table<ScanCompare::Any>::kernel;
+    }
+}
+
+template<typename T>
+struct TypedTable {
+    template<ScanCompare C>
+    struct For { static constexpr ScanKernel kernel = &TypedKernel<T, C>; };
+};
+
+template<ScanCompare C>
+struct BytesTable { static constexpr ScanKernel kernel = &BytesKernel<C>; };
+
+// Picks the kernel once per filter pass
+ScanKernel SelectKernel(ScanValueKind kind, ScanCompare compare) {
+    switch (kind) {
+        case ScanValueKind::Byte: return SelectCompare<TypedTable<uint8_t>::For>(compare);
+        case ScanValueKind::Int32: return SelectCompare<TypedTable<int32_t>::For>(compare);
+        case ScanValueKind::Int64: return SelectCompare<TypedTable<int64_t>::For>(compare);
+        case ScanValueKind::Float: return SelectCompare<TypedTable<float>::For>(compare);
+        case ScanValueKind::Double: return SelectCompare<TypedTable<double>::For>(compare);
+        default: return SelectCompare<BytesTable>(compare);
+    }
+}
+
+inline unsigned long LowestBit64(uint64_t word) {
+    unsigned long index = 0;
+    uint32_t low = static_cast<uint32_t>(word);
+    if (low) {
+        _BitScanForward(&index, low);
+        return index;
+    }
+    _BitScanForward(&index, static_cast<uint32_t>(word >> 32));
+    return index + 32;
+}
+
+inline size_t CountBits64(uint64_t word) {
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<size_t>((word * 0x0101010101010101ULL) >> 56);
+}
+
+// Word of bits[wordIndex] restricted to bit positions [first, last)
+inline uint64_t MaskedWord(const std::vector<uint64_t>& bits, size_t wordIndex, size_t first, size_t last) {
+    uint64_t word = bits[wordIndex];
+    if (wordIndex == first / 64) word &= ~0ULL << (first % 64);
+    if ((wordIndex + 1) * 64 > last) word &= (1ULL << (last % 64)) - 1;
+    return word;
+}
+
+inline size_t CountSetBits(const std::vector<uint64_t>& bits, size_t first, size_t last) {
+    size_t count = 0;
+    for (size_t w = first / 64; w * 64 < last; w++) {
+        count += CountBits64(MaskedWord(bits, w, first, last));
+    }
+    return count;
+}
+
+template<typename Fn>
+void ForEachSetBit(const std::vector<uint64_t>& bits, size_t first, size_t last, Fn&& fn) {
+    for (size_t w = first / 64; w * 64 < last; w++) {
+        uint64_t word = MaskedWord(bits, w, first, last);
+        while (word) {
+            unsigned long bit = LowestBit64(word);
+            word &= word - 1;
+            fn(w * 64 + bit);
+        }
+    }
+}
+
+inline void ClearBit(std::vector<uint64_t>& bits, size_t index) {
+    bits[index / 64] &= ~(1ULL << (index % 64));
+}
+
+} // namespace
+
+ScanResultStore::ScanResultStore() {}
+
+void ScanResultStore::Reset(const std::string& newType, size_t newValueSize, size_t newAlignment) {
+    Clear();
+    type = newType;
+    valueSize = newValueSize;
+    alignment = max(newAlignment, static_cast<size_t>(1));
+    kind = ParseValueKind(newType);
+}
+
+void ScanResultStore::Clear() {
+    mode = ScanStoreMode::List;
+    std::vector<Segment>().swap(segments);
+    std::vector<uint32_t>().swap(offsets);
+    std::vector<uint8_t>().swap(values);
+    std::vector<uint8_t>().swap(previousValues);
+    std::vector<SnapshotRegion>().swap(regions);
+}
+
+ScanCompare ScanResultStore::ParseScanCompare(const std::string& scanType) {
+    if (scanType == "exact") return ScanCompare::Exact;
+    if (scanType == "changed") return ScanCompare::Changed;
+    if (scanType == "unchanged") return ScanCompare::Unchanged;
+    if (scanType == "increased") return ScanCompare::Increased;
+    if (scanType == "decreased") return ScanCompare::Decreased;
+    if (scanType == "increasedby") return ScanCompare::IncreasedBy;
+    if (scanType == "decreasedby") return ScanCompare::DecreasedBy;
+    if (scanType == "between") return ScanCompare::Between;
+    if (scanType == "rounded") return ScanCompare::Exact;  // Tolerance comes from the value's decimals
+    return ScanCompare::Any;
+}
+
+ScanValueKind ScanResultStore::ParseValueKind(const std::string& valueType) {
+    if (valueType == "byte") return ScanValueKind::Byte;
+    if (valueType == "int32" || valueType == "int") return ScanValueKind::Int32;
+    if (valueType == "int64") return ScanValueKind::Int64;
+    if (valueType == "float") return ScanValueKind::Float;
+    if (valueType == "double") return ScanValueKind::Double;
+    return ScanValueKind::Bytes;
+}
+
+// Raw bytes have no ordering - increased/decreased never match, same as CompareValues
+int ScanResultStore::CompareTyped(ScanValueKind kind, const uint8_t* a, const uint8_t* b) {
+    switch (kind) {
+        case ScanValueKind::Byte: return CompareAs<uint8_t>(a, b);
+        case ScanValueKind::Int32: return CompareAs<int32_t>(a, b);
+        case ScanValueKind::Int64: return CompareAs<int64_t>(a, b);
+        case ScanValueKind::Float: return CompareAs<float>(a, b);
+        case ScanValueKind::Double: return CompareAs<double>(a, b);
+        default: return 0;
+    }
+}
+
+size_t ScanResultStore::Count() const {
+    if (mode == ScanStoreMode::List) return offsets.size();
+
+    size_t total = 0;
+    for (const auto& region : regions) {
+        total += region.candidateCount;
+    }
+    return total;
+}
+
+size_t ScanResultStore::MemoryUsage() const {
+    size_t usage = segments.capacity() * sizeof(Segment) +
+                   offsets.capacity() * sizeof(uint32_t) +
+                   values.capacity() + previousValues.capacity();
+    for (const auto& region : regions) {
+        usage += region.snapshot.MemoryUsage() + region.candidates.capacity() * sizeof(uint64_t);
+    }
+    return usage;
+}
+
+uintptr_t ScanResultStore::AddressAt(size_t index) const {
+    // First segment whose firstIndex is greater than index, then step back one
+    auto it = std::upper_bound(segments.begin(), segments.end(), index,
+        [](size_t value, const Segment& segment) { return value < segment.firstIndex; });
+    return (it - 1)->base + offsets[index];
+}
+
+size_t ScanResultStore::SlotCount(const RegionSnapshot& snapshot) const {
+    if (snapshot.GetSpan() == 0 || snapshot.GetDataSize() < valueSize) return 0;
+    size_t lastValueStart = snapshot.GetDataSize() - valueSize;
+    size_t maxOffset = min(snapshot.GetSpan() - 1, lastValueStart);
+    return maxOffset / alignment + 1;
+}
+
+void ScanResultStore::PageSlotRange(const SnapshotRegion& region, size_t pageIndex, size_t& first, size_t& last) const {
+    size_t pageStart = pageIndex * RegionSnapshot::PAGE_SIZE;
+    size_t pageEnd = pageStart + RegionSnapshot::PAGE_SIZE;
+    first = (pageStart + alignment - 1) / alignment;
+    last = min((pageEnd + alignment - 1) / alignment, region.slotCount);
+}
+
+void ScanResultStore::Append(uintptr_t address, const uint8_t* value) {
+    if (segments.empty() || address - segments.back().base > UINT32_MAX) {
+        Segment segment;
+        segment.base = address;
+        segment.firstIndex = offsets.size();
+        segments.push_back(segment);
+    }
+
+    offsets.push_back(static_cast<uint32_t>(address - segments.back().base));
+    values.insert(values.end(), value, value + valueSize);
+}
+
+void ScanResultStore::AddSnapshotRegion(uintptr_t baseAddress, RegionSnapshot&& snapshot) {
+    mode = ScanStoreMode::Snapshot;
+
+    size_t slotCount = SlotCount(snapshot);
+    if (slotCount == 0) return;
+
+    SnapshotRegion region;
+    region.baseAddress = baseAddress;
+    region.snapshot = std::move(snapshot);
+    region.slotCount = slotCount;
+    region.candidateCount = slotCount;
+
+    // Every slot starts as a candidate; clear the padding bits of the last word
+    region.candidates.assign((slotCount + 63) / 64, ~0ULL);
+    size_t tailBits = slotCount % 64;
+    if (tailBits != 0) {
+        region.candidates.back() = (1ULL << tailBits) - 1;
+    }
+
+    regions.push_back(std::move(region));
+}
+
+bool ScanResultStore::Filter(const ScanCriteria& criteria, const std::vector<uintptr_t>* cleanPages, const ScanFilter* filter,
+                             ScanUndoRecord* undo, const ScanOptions* control) {
+    if (undo) *undo = ScanUndoRecord();
+    if (valueSize == 0) return true;
+
+    // Rolling back a cancelled Filter needs a record even when the caller keeps none
+    ScanUndoRecord rollback;
+    if (!undo && control && control->cancel) undo = &rollback;
+
+    // Operands narrower than the stored width cannot be compared
+    ScanKernelOperands operands;
+    operands.target = (criteria.target.size() >= valueSize) ? criteria.target.data() : nullptr;
+    operands.target2 = (criteria.target2.size() >= valueSize) ? criteria.target2.data() : nullptr;
+    operands.epsilon = criteria.epsilon;
+    operands.valueSize = valueSize;
+
+    bool needsTarget = criteria.compare == ScanCompare::Exact || criteria.compare == ScanCompare::IncreasedBy ||
+                       criteria.compare == ScanCompare::DecreasedBy || criteria.compare == ScanCompare::Between;
+    bool missing = (needsTarget && !operands.target) || (criteria.compare == ScanCompare::Between && !operands.target2);
+    ScanKernel kernel = missing ? &NoMatchKernel : SelectKernel(kind, criteria.compare);
+
+    if (cleanPages && cleanPages->empty()) cleanPages = nullptr;
+
+    if (undo) {
+        undo->filtered = true;
+        undo->mode = mode;
+    }
+    bool finished = (mode == ScanStoreMode::List) ? FilterList(kernel, operands, cleanPages, filter, undo, control)
+                                                  : FilterSnapshot(kernel, operands, cleanPages, filter, undo, control);
+    if (!finished) {
+        Restore(std::move(*undo));
+        *undo = ScanUndoRecord();
+    }
+    return finished;
+}
+
+void ScanResultStore::Restore(ScanUndoRecord&& record) {
+    if (!record.filtered) return;
+
+    if (record.mode == ScanStoreMode::Snapshot) {
+        Clear();
+        mode = ScanStoreMode::Snapshot;
+        regions = std::move(record.regions);
+        return;
+    }
+
+    // Kept and removed candidates are both sorted: merging them by address gives the old order.
+    // A kept candidate's value before the Filter is its previous value now.
+    const ScanResultStore& removed = record.removed;
+    size_t keptCount = offsets.size();
+    size_t removedCount = removed.offsets.size();
+
+    ScanResultStore restored;
+    restored.Reset(type, valueSize, alignment);
+    restored.offsets.reserve(keptCount + removedCount);
+    restored.values.reserve((keptCount + removedCount) * valueSize);
+    if (record.hadPrevious) restored.previousValues.reserve((keptCount + removedCount) * valueSize);
+
+    size_t k = 0;
+    size_t d = 0;
+    while (k < keptCount || d < removedCount) {
+        bool takeKept = d >= removedCount || (k < keptCount && AddressAt(k) < removed.AddressAt(d));
+        if (takeKept) {
+            restored.Append(AddressAt(k), previousValues.data() + k * valueSize);
+            if (record.hadPrevious) {
+                const uint8_t* previous = record.keptPrevious.data() + k * valueSize;
+                restored.previousValues.insert(restored.previousValues.end(), previous, previous + valueSize);
+            }
+            k++;
+        } else {
+            restored.Append(removed.AddressAt(d), removed.values.data() + d * valueSize);
+            if (record.hadPrevious) {
+                const uint8_t* previous = removed.previousValues.data() + d * valueSize;
+                restored.previousValues.insert(restored.previousValues.end(), previous, previous + valueSize);
+            }
+            d++;
+        }
+    }
+
+    *this = std::move(restored);
+}
+
+size_t ScanUndoRecord::MemoryUsage() const {
+    size_t usage = removed.MemoryUsage() + keptPrevious.capacity();
+    for (const auto& region : regions) {
+        usage += region.snapshot.MemoryUsage() + region.candidates.capacity() * sizeof(uint64_t);
+    }
+    return usage;
+}
+
+void ScanResultStore::CollectPages(size_t pageSize, std::vector<uintptr_t>& pages) const {
+    pages.clear();
+    auto addRange = [&](uintptr_t start, size_t size) {
+        uintptr_t last = (start + size - 1) & ~(pageSize - 1);
+        for (uintptr_t page = start & ~(pageSize - 1); page <= last; page += pageSize) {
+            if (pages.empty() || page > pages.back()) pages.push_back(page);
+        }
+    };
+
+    if (mode == ScanStoreMode::List) {
+        for (size_t i = 0; i < offsets.size(); i++) {
+            addRange(AddressAt(i), valueSize);
+        }
+        return;
+    }
+
+    // Snapshot mode: every snapshot page that still has candidates (plus its overlap)
+    for (const auto& region : regions) {
+        if (region.candidateCount == 0) continue;
+        for (size_t p = 0; p < region.snapshot.PageCount(); p++) {
+            size_t first, last;
+            PageSlotRange(region, p, first, last);
+            if (first >= last || CountSetBits(region.candidates, first, last) == 0) continue;
+            addRange(region.baseAddress + p * RegionSnapshot::PAGE_SIZE, region.snapshot.PageLength(p));
+        }
+    }
+}
+
+bool ScanResultStore::FilterList(ScanKernel kernel, const ScanKernelOperands& operands, const std::vector<uintptr_t>* cleanPages,
+                                 const ScanFilter* filter, ScanUndoRecord* undo, const ScanOptions* control) {
+    const size_t count = offsets.size();
+    if (count == 0) return true;
+
+    bool hadPrevious = !previousValues.empty();
+    if (undo) {
+        undo->removed.Reset(type, valueSize, alignment);
+        undo->hadPrevious = hadPrevious;
+    }
+
+    std::vector<Segment> oldSegments;
+    oldSegments.swap(segments);
+    previousValues.resize(values.size());
+
+    size_t segmentIndex = 0;
+    auto addressOf = [&](size_t index) {
+        while (segmentIndex + 1 < oldSegments.size() && oldSegments[segmentIndex + 1].firstIndex <= index) {
+            segmentIndex++;
+        }
+        return oldSegments[segmentIndex].base + offsets[index];
+    };
+
+    size_t kept = 0;
+    size_t index = 0;
+    auto retain = [&](uintptr_t address, const uint8_t* previous, const uint8_t* current) {
+        // Compact in place (kept <= index + i, so nothing unread is overwritten)
+        if (segments.empty() || address - segments.back().base > UINT32_MAX) {
+            Segment segment;
+            segment.base = address;
+            segment.firstIndex = kept;
+            segments.push_back(segment);
+        }
+        offsets[kept] = static_cast<uint32_t>(address - segments.back().base);
+        memmove(previousValues.data() + kept * valueSize, previous, valueSize);
+        memmove(values.data() + kept * valueSize, current, valueSize);
+        kept++;
+    };
+
+    bool cancelled = false;
+    std::vector<uint8_t> block;
+    std::vector<uintptr_t> blockAddresses;
+    std::vector<uint8_t> currentColumn;     // Current values of the block, same stride as values
+    std::vector<uint8_t> readable;
+    std::vector<uint8_t> flags;
+
+    while (index < count) {
+        if (IsCancelled(control)) {
+            cancelled = true;
+            break;
+        }
+
+        // Group neighbouring candidates into one read
+        uintptr_t blockStart = addressOf(index);
+        size_t blockEndIndex = index;
+        blockAddresses.clear();
+        while (blockEndIndex < count) {
+            uintptr_t address = (blockEndIndex == index) ? blockStart : addressOf(blockEndIndex);
+            if (address + valueSize - blockStart > FILTER_BLOCK_SIZE && blockEndIndex > index) break;
+            blockAddresses.push_back(address);
+            blockEndIndex++;
+        }
+
+        size_t blockSize = blockAddresses.back() + valueSize - blockStart;
+        size_t blockCount = blockAddresses.size();
+
+        // Blocks lying entirely on clean pages are not read at all
+        bool blockClean = cleanPages && ChangeTracker::IsRangeClean(*cleanPages, blockStart, blockSize);
+        block = blockClean ? std::vector<uint8_t>() : MemoryEngine::SafeReadBytes(blockStart, blockSize);
+
+        // Gather the current values into a column next to the stored (previous) one
+        currentColumn.resize(blockCount * valueSize);
+        readable.assign(blockCount, 1);
+        const uint8_t* previousColumn = values.data() + index * valueSize;
+        for (size_t i = 0; i < blockCount; i++) {
+            uintptr_t address = blockAddresses[i];
+            uint8_t* current = currentColumn.data() + i * valueSize;
+
+            if (cleanPages && (blockClean || ChangeTracker::IsRangeClean(*cleanPages, address, valueSize))) {
+                // Unwritten since the last read: the stored value is the current one
+                memcpy(current, previousColumn + i * valueSize, valueSize);
+            } else if (!block.empty()) {
+                memcpy(current, block.data() + (address - blockStart), valueSize);
+            } else {
+                // Block straddles an unreadable page - fall back to one read per candidate
+                std::vector<uint8_t> single = MemoryEngine::SafeReadBytes(address, valueSize);
+                if (single.empty()) {
+                    readable[i] = 0;
+                    memset(current, 0, valueSize);
+                    continue;
+                }
+                memcpy(current, single.data(), valueSize);
+            }
+        }
+
+        flags.resize(blockCount);
+        kernel(currentColumn.data(), previousColumn, blockCount, valueSize, operands, flags.data());
+
+        for (size_t i = 0; i < blockCount; i++) {
+            uintptr_t address = blockAddresses[i];
+            const uint8_t* oldPrevious = previousValues.data() + (index + i) * valueSize;
+            bool keep = (flags[i] & readable[i]) &&
+                        (!filter || filter->Matches(address, currentColumn.data() + i * valueSize, previousColumn + i * valueSize));
+            if (!keep) {
+                if (undo) {
+                    undo->removed.Append(address, previousColumn + i * valueSize);
+                    if (hadPrevious) undo->removed.previousValues.insert(undo->removed.previousValues.end(), oldPrevious, oldPrevious + valueSize);
+                }
+                continue;
+            }
+            if (undo && hadPrevious) {
+                undo->keptPrevious.insert(undo->keptPrevious.end(), oldPrevious, oldPrevious + valueSize);
+            }
+            retain(address, previousColumn + i * valueSize, currentColumn.data() + i * valueSize);
+        }
+
+        index = blockEndIndex;
+        ReportProgress(control, index, count, kept);
+    }
+
+    // Candidates not reached count as kept and unchanged, so Restore can rebuild the old store exactly
+    if (cancelled) {
+        for (; index < count; index++) {
+            const uint8_t* stored = values.data() + index * valueSize;
+            if (undo && hadPrevious) {
+                const uint8_t* oldPrevious = previousValues.data() + index * valueSize;
+                undo->keptPrevious.insert(undo->keptPrevious.end(), oldPrevious, oldPrevious + valueSize);
+            }
+            retain(addressOf(index), stored, stored);
+        }
+    }
+
+    offsets.resize(kept);
+    values.resize(kept * valueSize);
+    previousValues.resize(kept * valueSize);
+
+    // Records are charged against the session's undo budget by capacity
+    if (undo) {
+        undo->removed.offsets.shrink_to_fit();
+        undo->removed.values.shrink_to_fit();
+        undo->removed.previousValues.shrink_to_fit();
+        undo->keptPrevious.shrink_to_fit();
+    }
+
+    // Give memory back after large reductions
+    if (kept < offsets.capacity() / 2) {
+        offsets.shrink_to_fit();
+        values.shrink_to_fit();
+        previousValues.shrink_to_fit();
+    }
+    return !cancelled;
+}
+
+bool ScanResultStore::FilterSnapshot(ScanKernel kernel, const ScanKernelOperands& operands, const std::vector<uintptr_t>* cleanPages,
+                                     const ScanFilter* filter, ScanUndoRecord* undo, const ScanOptions* control) {
+    std::vector<RegionSnapshot> previous(regions.size());
+    std::vector<uint8_t> finished(regions.size(), 0);
+    std::atomic<bool> cancelled(false);
+
+    // Progress counts regions; the callback is serialized like the first scan's
+    std::mutex progressMutex;
+    size_t regionsDone = 0;
+    size_t found = 0;
+
+    // The candidate bits are cleared in place; undo gets the old ones and, below, the old snapshots
+    if (undo) {
+        undo->regions.resize(regions.size());
+        for (size_t r = 0; r < regions.size(); r++) {
+            undo->regions[r].baseAddress = regions[r].baseAddress;
+            undo->regions[r].candidates = regions[r].candidates;
+            undo->regions[r].slotCount = regions[r].slotCount;
+            undo->regions[r].candidateCount = regions[r].candidateCount;
+        }
+    }
+
+    // Regions are independent - diff them in parallel, one page at a time
+    WorkStealingPool::Run(regions.size(), 0, [&](size_t r, size_t) {
+        SnapshotRegion& region = regions[r];
+        if (cancelled.load(std::memory_order_relaxed)) return;
+        if (region.candidateCount == 0) {
+            finished[r] = 1;
+            return;
+        }
+
+        RegionSnapshot next;
+        next.Reset(region.snapshot.GetSpan(), region.snapshot.GetDataSize(), valueSize - 1);
+
+        std::vector<uint8_t> old;
+        std::vector<uint8_t> flags;
+        size_t remaining = 0;
+
+        for (size_t p = 0; p < region.snapshot.PageCount(); p++) {
+            // A region left half done keeps its old snapshot; its cleared bits come back from undo
+            if (IsCancelled(control)) {
+                cancelled = true;
+                return;
+            }
+
+            size_t first, last;
+            PageSlotRange(region, p, first, last);
+            if (first >= last) continue;
+            size_t candidates = CountSetBits(region.candidates, first, last);
+            if (candidates == 0) continue;
+
+            size_t pageStart = p * RegionSnapshot::PAGE_SIZE;
+            std::vector<uint8_t> live;
+            if (region.snapshot.LoadPage(p, old)) {
+                bool clean = cleanPages && ChangeTracker::IsRangeClean(*cleanPages, region.baseAddress + pageStart, old.size());
+                live = clean ? old : MemoryEngine::SafeReadBytes(region.baseAddress + pageStart, old.size());
+            }
+
+            size_t keptInPage = 0;
+            if (live.empty()) {
+                ForEachSetBit(region.candidates, first, last, [&](size_t slot) { ClearBit(region.candidates, slot); });
+            } else if (candidates * 8 >= last - first) {
+                // Dense page: one kernel pass over every slot, then keep the flagged candidates
+                size_t local = first * alignment - pageStart;
+                flags.resize(last - first);
+                kernel(live.data() + local, old.data() + local, last - first, alignment, operands, flags.data());
+                ForEachSetBit(region.candidates, first, last, [&](size_t slot) {
+                    size_t slotOffset = slot * alignment - pageStart;
+                    if (flags[slot - first] && (!filter || filter->Matches(region.baseAddress + slot * alignment,
+                                                                            live.data() + slotOffset, old.data() + slotOffset))) {
+                        keptInPage++;
+                    } else {
+                        ClearBit(region.candidates, slot);
+                    }
+                });
+            } else {
+                // Sparse page: only the remaining candidates are compared
+                ForEachSetBit(region.candidates, first, last, [&](size_t slot) {
+                    size_t local = slot * alignment - pageStart;
+                    uint8_t match = 0;
+                    kernel(live.data() + local, old.data() + local, 1, alignment, operands, &match);
+                    if (match && (!filter || filter->Matches(region.baseAddress + slot * alignment,
+                                                             live.data() + local, old.data() + local))) {
+                        keptInPage++;
+                    } else {
+                        ClearBit(region.candidates, slot);
+                    }
+                });
+            }
+
+            // Pages without candidates stay released in the new snapshot
+            if (keptInPage > 0) {
+                next.StorePage(p, live.data());
+            }
+            remaining += keptInPage;
+        }
+
+        region.candidateCount = remaining;
+        previous[r] = std::move(region.snapshot);
+        region.snapshot = std::move(next);
+        finished[r] = 1;
+
+        std::lock_guard<std::mutex> lock(progressMutex);
+        regionsDone++;
+        found += remaining;
+        ReportProgress(control, regionsDone, regions.size(), found);
+    });
+
+    // Handed back untouched: Filter restores the store from undo, which needs every old snapshot
+    if (cancelled) {
+        for (size_t r = 0; r < regions.size(); r++) {
+            undo->regions[r].snapshot = finished[r] ? std::move(previous[r]) : std::move(regions[r].snapshot);
+        }
+        return false;
+    }
+
+    size_t total = 0;
+    size_t snapshotBytes = 0;
+    for (auto& region : regions) {
+        if (region.candidateCount == 0) {
+            region.snapshot = RegionSnapshot();
+            std::vector<uint64_t>().swap(region.candidates);
+        }
+        total += region.candidateCount;
+        snapshotBytes += region.snapshot.MemoryUsage() + region.candidates.capacity() * sizeof(uint64_t);
+    }
+
+    // Switch to explicit addresses once they are cheaper than the snapshot
+    size_t listBytes = total * (sizeof(uint32_t) + 2 * valueSize);
+    if (listBytes < snapshotBytes || total == 0) {
+        ConvertSnapshotToList(previous);
+    }
+
+    // Regions without candidates were skipped and kept their (empty) snapshot
+    if (undo) {
+        for (size_t r = 0; r < previous.size(); r++) {
+            undo->regions[r].snapshot = std::move(previous[r]);
+        }
+    }
+    return true;
+}
+
+void ScanResultStore::ConvertSnapshotToList(const std::vector<RegionSnapshot>& previous) {
+    std::vector<SnapshotRegion> snapshot;
+    snapshot.swap(regions);
+    mode = ScanStoreMode::List;
+
+    size_t total = 0;
+    for (const auto& region : snapshot) {
+        total += region.candidateCount;
+    }
+    offsets.reserve(total);
+    values.reserve(total * valueSize);
+    previousValues.reserve(total * valueSize);
+
+    bool hasPrevious = true;
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> old;
+
+    for (size_t r = 0; r < snapshot.size(); r++) {
+        const SnapshotRegion& region = snapshot[r];
+        if (region.candidateCount == 0) continue;
+
+        for (size_t p = 0; p < region.snapshot.PageCount(); p++) {
+            size_t first, last;
+            PageSlotRange(region, p, first, last);
+            if (first >= last || !region.snapshot.LoadPage(p, current)) continue;
+
+            bool pageHasPrevious = r < previous.size() && previous[r].PageCount() > p && previous[r].LoadPage(p, old);
+            hasPrevious = hasPrevious && pageHasPrevious;
+
+            size_t pageStart = p * RegionSnapshot::PAGE_SIZE;
+            ForEachSetBit(region.candidates, first, last, [&](size_t slot) {
+                size_t local = slot * alignment - pageStart;
+                Append(region.baseAddress + slot * alignment, current.data() + local);
+                if (pageHasPrevious) {
+                    previousValues.insert(previousValues.end(), old.data() + local, old.data() + local + valueSize);
+                }
+            });
+        }
+    }
+
+    // Keep the columns aligned even if some pages had no previous copy
+    if (!hasPrevious || previousValues.size() != values.size()) {
+        std::vector<uint8_t>().swap(previousValues);
+    }
+}
+
+std::vector<ScanResult> ScanResultStore::GetPage(size_t offset, size_t limit) const {
+    std::vector<ScanResult> page;
+    size_t total = Count();
+    if (offset >= total || limit == 0) return page;
+
+    size_t count = min(limit, total - offset);
+    page.reserve(count);
+
+    if (mode == ScanStoreMode::List) {
+        for (size_t i = offset; i < offset + count; i++) {
+            ScanResult result;
+            result.address = AddressAt(i);
+            result.type = type;
+            result.value.assign(values.begin() + i * valueSize, values.begin() + (i + 1) * valueSize);
+            if (!previousValues.empty()) {
+                result.previousValue.assign(previousValues.begin() + i * valueSize, previousValues.begin() + (i + 1) * valueSize);
+            }
+            page.push_back(result);
+        }
+        return page;
+    }
+
+    // Snapshot mode: skip whole regions and pages by their candidate count, then walk the bits
+    size_t skip = offset;
+    std::vector<uint8_t> pageData;
+
+    for (const auto& region : regions) {
+        if (page.size() >= count) break;
+        if (skip >= region.candidateCount) {
+            skip -= region.candidateCount;
+            continue;
+        }
+
+        for (size_t p = 0; p < region.snapshot.PageCount() && page.size() < count; p++) {
+            size_t first, last;
+            PageSlotRange(region, p, first, last);
+            if (first >= last) continue;
+
+            size_t inPage = CountSetBits(region.candidates, first, last);
+            if (skip >= inPage) {
+                skip -= inPage;
+                continue;
+            }
+            if (!region.snapshot.LoadPage(p, pageData)) continue;
+
+            size_t pageStart = p * RegionSnapshot::PAGE_SIZE;
+            ForEachSetBit(region.candidates, first, last, [&](size_t slot) {
+                if (page.size() >= count) return;
+                if (skip > 0) {
+                    skip--;
+                    return;
+                }
+
+                size_t local = slot * alignment - pageStart;
+                ScanResult result;
+                result.address = region.baseAddress + slot * alignment;
+                result.type = type;
+                result.value.assign(pageData.begin() + local, pageData.begin() + local + valueSize);
+                page.push_back(result);
+            });
+        }
+    }
+    return page;
+}
+
+std::vector<ScanResult> ScanResultStore::ToResults() const {
+    return GetPage(0, Count());
+}
+
+ScanResultStore ScanResultStore::FromResults(const std::vector<ScanResult>& results) {
+    ScanResultStore store;
+    if (results.empty()) return store;
+
+    store.Reset(results.front().type, results.front().value.size());
+    if (store.valueSize == 0) return store;
+
+    // Client supplied lists are not guaranteed to be sorted
+    std::vector<size_t> order(results.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return results[a].address < results[b].address; });
+
+    bool hasLast = false;
+    uintptr_t lastAddress = 0;
+    for (size_t i : order) {
+        const auto& result = results[i];
+        if (result.value.size() != store.valueSize) continue;
+        if (hasLast && result.address == lastAddress) continue;
+
+        store.Append(result.address, result.value.data());
+        lastAddress = result.address;
+        hasLast = true;
+    }
+    return store;
+}
+
+} // namespace InternalEngine
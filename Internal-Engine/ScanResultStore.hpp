@@ -0,0 +1,182 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "RegionSnapshot.hpp"
+
+namespace InternalEngine {
+
+struct ScanResult;
+class ScanFilter;
+struct ScanOptions;
+class ScanUndoRecord;
+
+// Next scan comparisons (current value against previous value or target)
+enum class ScanCompare {
+    Exact,
+    Changed,
+    Unchanged,
+    Increased,
+    Decreased,
+    IncreasedBy,    // current - previous == target
+    DecreasedBy,    // previous - current == target
+    Between,        // target <= current <= target2
+    Any             // Unknown scan type - keep every readable candidate
+};
+
+// Value interpretation for ordered comparisons
+enum class ScanValueKind {
+    Byte,
+    Int32,
+    Int64,
+    Float,
+    Double,
+    Bytes
+};
+
+// Operands of a next scan, already encoded like the stored values
+struct ScanCriteria {
+    ScanCompare compare = ScanCompare::Any;
+    std::vector<uint8_t> target;    // Exact: value, IncreasedBy/DecreasedBy: amount, Between: lower bound
+    std::vector<uint8_t> target2;   // Between: upper bound (inclusive)
+    double epsilon = 0.0;           // Float/double only: tolerance of Exact, IncreasedBy and DecreasedBy
+};
+
+struct ScanKernelOperands {
+    const uint8_t* target = nullptr;
+    const uint8_t* target2 = nullptr;
+    double epsilon = 0.0;
+    size_t valueSize = 0;
+};
+
+// Compares count values at current + i * stride against previous + i * stride and the
+// operands; flags[i] = 1 if value i matches
+using ScanKernel = void (*)(const uint8_t* current, const uint8_t* previous, size_t count, size_t stride,
+                            const ScanKernelOperands& operands, uint8_t* flags);
+
+enum class ScanStoreMode {
+    List,       // Explicit candidate addresses with value columns
+    Snapshot    // Full copy of each region plus one candidate bit per alignment slot
+};
+
+// 📦 컬럼형 스캔 결과 저장소
+// List mode keeps addresses sorted as 32-bit offsets from a per-segment base, and values
+// in flat fixed-stride columns (about 4 + 2 * valueSize bytes per hit instead of a
+// ScanResult with three heap allocations).
+// Snapshot mode is used for "unknown initial value" scans: each chunk is kept as a compressed
+// RegionSnapshot and diffed page by page against live memory. It converts itself to list
+// mode once the surviving candidates are cheaper to store explicitly.
+class ScanResultStore {
+public:
+    ScanResultStore();
+
+    void Reset(const std::string& type, size_t valueSize, size_t alignment = 1);
+    void Clear();
+
+    const std::string& GetType() const { return type; }
+    size_t GetValueSize() const { return valueSize; }
+    ScanStoreMode GetMode() const { return mode; }
+    size_t Count() const;
+    size_t MemoryUsage() const;
+
+    // List mode building (addresses must be strictly increasing)
+    void Append(uintptr_t address, const uint8_t* value);
+
+    // Snapshot mode building (regions must be added in address order). Candidate slots
+    // cover the snapshot's span; its data may extend past span so the last slots hold a
+    // full value.
+    void AddSnapshotRegion(uintptr_t baseAddress, RegionSnapshot&& snapshot);
+
+    // Next scan: re-reads every candidate and drops the ones that fail the comparison.
+    // The kernel for (value kind, comparison) is picked once; it then runs over whole
+    // columns of current/previous values. A comparison missing its operands matches
+    // nothing. Candidates entirely on cleanPages (sorted 4 KB page bases known not to have
+    // been written, see ChangeTracker) are compared against their stored value without
+    // being read. Candidates that pass the comparison must also pass filter, if given.
+    // The store is filtered in place; undo (optional) receives what Restore needs to go back.
+    // control (optional) supplies the cancel flag and onProgress (candidates or regions done);
+    // a cancelled Filter puts the store back as it was, leaves undo empty and returns false.
+    bool Filter(const ScanCriteria& criteria, const std::vector<uintptr_t>* cleanPages = nullptr,
+                const ScanFilter* filter = nullptr, ScanUndoRecord* undo = nullptr, const ScanOptions* control = nullptr);
+
+    // Puts the store back as it was before the Filter that filled record
+    void Restore(ScanUndoRecord&& record);
+
+    // Sorted, unique pageSize-aligned pages touched by candidate values
+    void CollectPages(size_t pageSize, std::vector<uintptr_t>& pages) const;
+
+    static ScanCompare ParseScanCompare(const std::string& scanType);
+    static ScanValueKind ParseValueKind(const std::string& type);
+
+    // Ordered comparison of two values of kind (-1, 0, 1); raw bytes compare equal
+    static int CompareTyped(ScanValueKind kind, const uint8_t* a, const uint8_t* b);
+
+    // Legacy conversion (ScanResult vectors are only built for the requested page)
+    std::vector<ScanResult> GetPage(size_t offset, size_t limit) const;
+    std::vector<ScanResult> ToResults() const;
+    static ScanResultStore FromResults(const std::vector<ScanResult>& results);
+
+private:
+    friend class ScanUndoRecord;
+
+    // Addresses [firstIndex, next segment's firstIndex) are base + offsets[i]
+    struct Segment {
+        uintptr_t base;
+        size_t firstIndex;
+    };
+
+    struct SnapshotRegion {
+        uintptr_t baseAddress;
+        RegionSnapshot snapshot;
+        std::vector<uint64_t> candidates;   // Bit k = slot at baseAddress + k * alignment
+        size_t slotCount;
+        size_t candidateCount;
+    };
+
+    uintptr_t AddressAt(size_t index) const;
+    size_t SlotCount(const RegionSnapshot& snapshot) const;
+    void PageSlotRange(const SnapshotRegion& region, size_t pageIndex, size_t& first, size_t& last) const;
+
+    bool FilterList(ScanKernel kernel, const ScanKernelOperands& operands, const std::vector<uintptr_t>* cleanPages,
+                    const ScanFilter* filter, ScanUndoRecord* undo, const ScanOptions* control);
+    bool FilterSnapshot(ScanKernel kernel, const ScanKernelOperands& operands, const std::vector<uintptr_t>* cleanPages,
+                        const ScanFilter* filter, ScanUndoRecord* undo, const ScanOptions* control);
+    void ConvertSnapshotToList(const std::vector<RegionSnapshot>& previous);
+
+    std::string type;
+    size_t valueSize = 0;
+    size_t alignment = 1;
+    ScanValueKind kind = ScanValueKind::Bytes;
+    ScanStoreMode mode = ScanStoreMode::List;
+
+    // List mode columns
+    std::vector<Segment> segments;
+    std::vector<uint32_t> offsets;
+    std::vector<uint8_t> values;
+    std::vector<uint8_t> previousValues;    // Empty until the first Filter
+
+    // Snapshot mode
+    std::vector<SnapshotRegion> regions;
+};
+
+// What one Filter dropped or overwrote - a diff, not a copy of the store. List mode keeps the
+// removed candidates and the overwritten previous values of the kept ones; the kept values
+// before the Filter are the store's previous values after it. Snapshot mode keeps the
+// replaced snapshots, which are the only copy of the values they held.
+class ScanUndoRecord {
+public:
+    size_t MemoryUsage() const;
+
+private:
+    friend class ScanResultStore;
+
+    ScanStoreMode mode = ScanStoreMode::List;
+    ScanResultStore removed;                    // List mode: values and previous values of the dropped candidates
+    std::vector<uint8_t> keptPrevious;          // List mode: previous values of the kept candidates
+    bool filtered = false;
+    bool hadPrevious = false;
+    std::vector<ScanResultStore::SnapshotRegion> regions;   // Snapshot mode: the store's regions before the Filter
+};
+
+} // namespace InternalEngine
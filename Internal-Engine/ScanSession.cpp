@@ -0,0 +1,194 @@
+#include "ScanSession.hpp"
+
+namespace InternalEngine {
+
+ScanSession::~ScanSession() {
+    if (trackerId) {
+        ChangeTracker::Untrack(trackerId);
+    }
+}
+
+ScanSessionManager::ScanSessionManager() {}
+
+ScanSessionManager::~ScanSessionManager() {
+    CloseAll();
+}
+
+std::shared_ptr<ScanSession> ScanSessionManager::Find(uint32_t sessionId) {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    auto it = sessions.find(sessionId);
+    if (it == sessions.end()) return nullptr;
+    it->second->lastUsed = GetTickCount64();
+    return it->second;
+}
+
+void ScanSessionManager::ExpireUnowned(size_t keep) {
+    ULONGLONG now = GetTickCount64();
+    size_t unowned = 0;
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        const ScanSession& session = *it->second;
+        if (!session.owner && now - session.lastUsed >= UNOWNED_IDLE_MS) {
+            it = sessions.erase(it);
+            continue;
+        }
+        if (!session.owner) unowned++;
+        ++it;
+    }
+
+    while (unowned > keep) {
+        auto oldest = sessions.end();
+        for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+            if (it->second->owner) continue;
+            if (oldest == sessions.end() || it->second->lastUsed < oldest->second->lastUsed) oldest = it;
+        }
+        sessions.erase(oldest);
+        unowned--;
+    }
+}
+
+uint32_t ScanSessionManager::Create(const std::string& scanType, const std::string& value, const std::string& valueType, const ScanOptions& options,
+                                    size_t& resultCount, WebSocketConnection* owner) {
+    auto session = std::make_shared<ScanSession>();
+    session->owner = owner;
+    session->valueType = valueType;
+    session->options = options;
+    session->options.isFirstScan = true;
+    session->options.previousResults = nullptr;
+
+    // Scan before publishing the session so no one can observe it half-initialized
+    if (scanType == "unknown") {
+        MemoryEngine::UnknownInitialScan(valueType, session->options, session->results);
+    } else {
+        MemoryEngine::FirstScan(value, valueType, session->options, session->results);
+    }
+    resultCount = session->results.Count();
+
+    // Streaming callbacks, the cancel flag and the filter belong to the request that created the session
+    session->options.onResults = nullptr;
+    session->options.onProgress = nullptr;
+    session->options.cancel = nullptr;
+    session->options.filter = nullptr;
+    if (options.cancel && options.cancel->load()) {
+        return 0; // Cancelled: the partial candidate list is discarded
+    }
+
+    // Tracking starts after the first scan; its values are re-read once by the first Next
+    if (options.trackChanges) {
+        std::vector<uintptr_t> pages;
+        session->results.CollectPages(ChangeTracker::PAGE_SIZE, pages);
+        session->trackerId = ChangeTracker::Track(pages);
+    }
+
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    ExpireUnowned(owner ? MAX_UNOWNED_SESSIONS : MAX_UNOWNED_SESSIONS - 1);
+    session->id = nextSessionId++;
+    if (nextSessionId == 0) nextSessionId = 1;
+    session->lastUsed = GetTickCount64();
+    sessions[session->id] = session;
+    return session->id;
+}
+
+bool ScanSessionManager::Next(uint32_t sessionId, const NextScanQuery& query, size_t& resultCount, size_t* cleanPages,
+                              const ScanOptions* control, bool* cancelled) {
+    if (cancelled) *cancelled = false;
+    auto session = Find(sessionId);
+    if (!session) return false;
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+
+    // Pages not written since the previous Next keep their stored values
+    std::vector<uintptr_t> clean;
+    if (session->trackerId) {
+        ChangeTracker::CollectClean(session->trackerId, clean);
+        // Taken by a cancelled Next: these pages are clean since then, not since the values were read
+        if (session->cleanPagesLost) clean.clear();
+    }
+    if (cleanPages) *cleanPages = clean.size();
+
+    // Filtered in place; the record holds only what the filter removed or overwrote
+    ScanUndoRecord record;
+    if (!MemoryEngine::NextScan(query, session->results, session->trackerId ? &clean : nullptr, &record, control)) {
+        session->cleanPagesLost = session->trackerId != 0;
+        if (cancelled) *cancelled = true;
+        resultCount = session->results.Count();
+        return true;
+    }
+    session->cleanPagesLost = false;
+
+    // Stop tracking pages that no longer hold candidates
+    if (session->trackerId) {
+        std::vector<uintptr_t> pages;
+        session->results.CollectPages(ChangeTracker::PAGE_SIZE, pages);
+        ChangeTracker::Retain(session->trackerId, pages);
+    }
+
+    // A record over the whole budget is not kept at all: undo stops at this scan
+    size_t recordBytes = record.MemoryUsage();
+    if (recordBytes > MAX_UNDO_BYTES) {
+        session->undo.clear();
+        session->undoBytes = 0;
+    } else {
+        session->undo.push_back(std::move(record));
+        session->undoBytes += recordBytes;
+        while (session->undo.size() > MAX_UNDO_DEPTH || session->undoBytes > MAX_UNDO_BYTES) {
+            session->undoBytes -= session->undo.front().MemoryUsage();
+            session->undo.pop_front();
+        }
+    }
+
+    resultCount = session->results.Count();
+    return true;
+}
+
+bool ScanSessionManager::Undo(uint32_t sessionId, size_t& resultCount) {
+    auto session = Find(sessionId);
+    if (!session) return false;
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (session->undo.empty()) return false;
+
+    session->undoBytes -= session->undo.back().MemoryUsage();
+    session->results.Restore(std::move(session->undo.back()));
+    session->undo.pop_back();
+    resultCount = session->results.Count();
+
+    // The restored values predate the last Collect; pages dropped since stay untracked
+    if (session->trackerId) {
+        ChangeTracker::Invalidate(session->trackerId);
+    }
+    return true;
+}
+
+bool ScanSessionManager::Close(uint32_t sessionId) {
+    // A scan still running on this session holds its own reference until it finishes
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    return sessions.erase(sessionId) > 0;
+}
+
+void ScanSessionManager::CloseOwner(WebSocketConnection* owner) {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        if (it->second->owner == owner) {
+            it = sessions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ScanSessionManager::CloseAll() {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    sessions.clear();
+}
+
+bool ScanSessionManager::GetResults(uint32_t sessionId, size_t offset, size_t limit, std::vector<ScanResult>& page, size_t& totalCount) {
+    auto session = Find(sessionId);
+    if (!session) return false;
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+    totalCount = session->results.Count();
+    page = session->results.GetPage(offset, limit);
+    return true;
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,91 @@
+#pragma once
+#include "MemoryEngine.hpp"
+#include "ScanResultStore.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+namespace InternalEngine {
+
+class WebSocketConnection;
+
+// 🗂️ 서버측 스캔 세션
+// Candidate sets stay inside the DLL between scans; clients only send a session id
+// and fetch result pages on demand. With options.trackChanges the candidate pages are
+// handed to ChangeTracker and next scans only re-check candidates on pages that changed.
+// A session belongs to the WebSocket connection that created it and is closed with it;
+// sessions created without one (IPC) expire when idle and are capped in number.
+struct ScanSession {
+    uint32_t id = 0;
+    WebSocketConnection* owner = nullptr;
+    ULONGLONG lastUsed = 0;     // GetTickCount64 of the last lookup, guarded by sessionsMutex
+    std::string valueType;
+    ScanOptions options;
+    uint32_t trackerId = 0;     // ChangeTracker id, 0 when not tracking
+    bool cleanPagesLost = false;    // A cancelled Next used up the tracker's clean pages
+
+    ~ScanSession();
+
+    // Current candidate set, filtered in place by every Next
+    ScanResultStore results;
+
+    // One record per Next that can be undone, oldest first (see ScanUndoRecord)
+    std::deque<ScanUndoRecord> undo;
+    size_t undoBytes = 0;
+
+    std::mutex mutex;
+};
+
+class ScanSessionManager {
+public:
+    // Undo is limited by steps and by the memory the records hold; the oldest go first
+    static const size_t MAX_UNDO_DEPTH = 8;
+    static const size_t MAX_UNDO_BYTES = 256 * 1024 * 1024;
+
+    // Sessions without an owner connection
+    static const size_t MAX_UNOWNED_SESSIONS = 8;
+    static const ULONGLONG UNOWNED_IDLE_MS = 10 * 60 * 1000;
+
+    ScanSessionManager();
+    ~ScanSessionManager();
+
+    // Runs the first scan and returns the new session id (0 when options.cancel stopped it)
+    // scanType "unknown" takes a snapshot instead of matching value. Without an owner the
+    // least recently used unowned session is closed once MAX_UNOWNED_SESSIONS are open.
+    uint32_t Create(const std::string& scanType, const std::string& value, const std::string& valueType, const ScanOptions& options,
+                    size_t& resultCount, WebSocketConnection* owner = nullptr);
+
+    // Filters the current candidate set; returns false if the session does not exist.
+    // cleanPages (optional) receives the number of tracked pages that were skipped.
+    // control (optional) supplies cancel/onProgress; a cancelled Next leaves the candidates
+    // as they were, pushes no undo step and sets *cancelled.
+    bool Next(uint32_t sessionId, const NextScanQuery& query, size_t& resultCount, size_t* cleanPages = nullptr,
+              const ScanOptions* control = nullptr, bool* cancelled = nullptr);
+
+    // Restores the previous candidate set; returns false if there is nothing to undo
+    bool Undo(uint32_t sessionId, size_t& resultCount);
+
+    bool Close(uint32_t sessionId);
+    void CloseOwner(WebSocketConnection* owner);
+    void CloseAll();
+
+    // Copies [offset, offset + limit) of the current candidate set
+    bool GetResults(uint32_t sessionId, size_t offset, size_t limit, std::vector<ScanResult>& page, size_t& totalCount);
+
+private:
+    std::shared_ptr<ScanSession> Find(uint32_t sessionId);
+
+    // Caller holds sessionsMutex. Closes idle unowned sessions, then the least recently used
+    // ones until at most keep are left.
+    void ExpireUnowned(size_t keep);
+
+    std::mutex sessionsMutex;
+    std::unordered_map<uint32_t, std::shared_ptr<ScanSession>> sessions;
+    uint32_t nextSessionId = 1;
+};
+
+} // namespace InternalEngine
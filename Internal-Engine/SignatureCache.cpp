@@ -0,0 +1,495 @@
+#include "SignatureCache.hpp"
+#include "MemoryEngine.hpp"
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+namespace InternalEngine {
+
+static const uint32_t MAX_STRING_LENGTH = 4096;
+static const uint32_t MAX_LIST_LENGTH = 1 << 20;
+
+struct SignatureEntry {
+    uint64_t moduleKey = 0;
+    std::string moduleName;
+    uint32_t rangeStart = 0;        // Searched range, RVAs
+    uint32_t rangeEnd = 0;
+    std::string pattern;            // Wildcard bytes zeroed
+    std::string mask;
+    std::vector<uint32_t> rvas;     // Every match, ascending
+};
+
+struct ChainEntry {
+    uint64_t moduleKey = 0;
+    CachedPointerChain chain;
+};
+
+static std::mutex g_cacheMutex;
+static std::unordered_map<std::string, SignatureEntry> g_signatures;
+static std::unordered_map<std::string, ChainEntry> g_chains;
+static std::string g_path;
+static bool g_loaded = false;
+static bool g_dirty = false;
+static ULONGLONG g_dirtySince = 0;      // When the oldest unwritten change was made
+static size_t g_hits = 0;
+static size_t g_misses = 0;
+
+// SEH 전용 헬퍼 함수 (C++ 객체 없음)
+static bool SafeMatch(const uint8_t* address, const uint8_t* pattern, const char* mask, size_t length) {
+    __try {
+        for (size_t i = 0; i < length; i++) {
+            if (mask[i] == 'x' && address[i] != pattern[i]) return false;
+        }
+        return true;
+    }
+    __except(EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+static bool ReadImageHeaders(uintptr_t base, uint32_t* timeDateStamp, uint32_t* checkSum, uint32_t* sizeOfImage) {
+    __try {
+        const IMAGE_DOS_HEADER* dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+        if (dos->e_magic != IMAGE_DOS_SIGNATURE) return false;
+        const IMAGE_NT_HEADERS* nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dos->e_lfanew);
+        if (nt->Signature != IMAGE_NT_SIGNATURE) return false;
+
+        *timeDateStamp = nt->FileHeader.TimeDateStamp;
+        *checkSum = nt->OptionalHeader.CheckSum;
+        *sizeOfImage = nt->OptionalHeader.SizeOfImage;
+        return true;
+    }
+    __except(EXCEPTION_EXECUTE_HANDLER) {
+        return false;
+    }
+}
+
+static void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+}
+
+static std::string FileNameOf(const char* path) {
+    std::string name(path);
+    size_t slash = name.find_last_of("\\/");
+    if (slash != std::string::npos) name.erase(0, slash + 1);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    return name;
+}
+
+bool SignatureCache::GetModuleIdentity(uintptr_t address, ModuleIdentity& identity, uintptr_t& base) {
+    HMODULE module = nullptr;
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                            reinterpret_cast<LPCSTR>(address), &module) || !module) {
+        return false;
+    }
+
+    base = reinterpret_cast<uintptr_t>(module);
+    if (!ReadImageHeaders(base, &identity.timeDateStamp, &identity.checkSum, &identity.sizeOfImage)) {
+        return false;
+    }
+
+    char path[MAX_PATH];
+    DWORD length = GetModuleFileNameA(module, path, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH) return false;
+    identity.name = FileNameOf(path);
+
+    identity.key = 0xCBF29CE484222325ull;
+    HashBytes(identity.key, identity.name.data(), identity.name.size());
+    HashBytes(identity.key, &identity.timeDateStamp, sizeof(identity.timeDateStamp));
+    HashBytes(identity.key, &identity.checkSum, sizeof(identity.checkSum));
+    HashBytes(identity.key, &identity.sizeOfImage, sizeof(identity.sizeOfImage));
+    return true;
+}
+
+static void MarkDirty() {
+    if (!g_dirty) {
+        g_dirty = true;
+        g_dirtySince = GetTickCount64();
+    }
+}
+
+static std::string DefaultCachePath() {
+    HMODULE self = nullptr;
+    char path[MAX_PATH];
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                           reinterpret_cast<LPCSTR>(&DefaultCachePath), &self)) {
+        DWORD length = GetModuleFileNameA(self, path, MAX_PATH);
+        if (length > 0 && length < MAX_PATH) {
+            std::string directory(path, length);
+            size_t slash = directory.find_last_of("\\/");
+            if (slash != std::string::npos) {
+                return directory.substr(0, slash + 1) + "InternalEngine.sigcache";
+            }
+        }
+    }
+    return "InternalEngine.sigcache";
+}
+
+static std::string MakeSignatureKey(uint64_t moduleKey, uint32_t rangeStart, uint32_t rangeEnd,
+                                    const std::string& pattern, const std::string& mask) {
+    std::string key;
+    key.reserve(16 + pattern.size() + mask.size());
+    key.append(reinterpret_cast<const char*>(&moduleKey), sizeof(moduleKey));
+    key.append(reinterpret_cast<const char*>(&rangeStart), sizeof(rangeStart));
+    key.append(reinterpret_cast<const char*>(&rangeEnd), sizeof(rangeEnd));
+    key.append(pattern);
+    key.append(mask);
+    return key;
+}
+
+// Pattern bytes under '?' never take part in a match; zero them so they do not split keys
+static CodePattern Normalize(const CodePattern& pattern) {
+    CodePattern normalized;
+    normalized.mask = pattern.mask;
+    normalized.pattern = pattern.pattern.substr(0, pattern.mask.size());
+    for (size_t i = 0; i < normalized.mask.size(); i++) {
+        if (normalized.mask[i] != 'x') normalized.pattern[i] = 0;
+    }
+    return normalized;
+}
+
+// 💾 파일 형식
+// header: magic, version, signature count, chain count (uint32 each)
+// signature: moduleKey u64, name, rangeStart u32, rangeEnd u32, pattern, mask, rva count u32, rvas u32[]
+// chain: moduleKey u64, name, module name, moduleOffset u64, offset count u32, offsets u64[]
+// strings: length u32 + bytes
+static void WriteUInt32(std::ofstream& file, uint32_t value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteUInt64(std::ofstream& file, uint64_t value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteString(std::ofstream& file, const std::string& value) {
+    WriteUInt32(file, static_cast<uint32_t>(value.size()));
+    file.write(value.data(), value.size());
+}
+
+static bool ReadUInt32(std::ifstream& file, uint32_t& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static bool ReadUInt64(std::ifstream& file, uint64_t& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static bool ReadString(std::ifstream& file, std::string& value) {
+    uint32_t length = 0;
+    if (!ReadUInt32(file, length) || length > MAX_STRING_LENGTH) return false;
+    value.resize(length);
+    return length == 0 || static_cast<bool>(file.read(&value[0], length));
+}
+
+// Caller holds g_cacheMutex. A missing or unreadable file leaves the cache empty.
+static void EnsureLoaded() {
+    if (g_loaded) return;
+    g_loaded = true;
+    if (g_path.empty()) g_path = DefaultCachePath();
+
+    std::ifstream file(g_path, std::ios::binary);
+    if (!file) return;
+
+    uint32_t magic = 0, version = 0, signatureCount = 0, chainCount = 0;
+    if (!ReadUInt32(file, magic) || !ReadUInt32(file, version) || magic != SignatureCache::FILE_MAGIC ||
+        version != SignatureCache::FILE_VERSION || !ReadUInt32(file, signatureCount) || !ReadUInt32(file, chainCount)) {
+        return;
+    }
+
+    std::unordered_map<std::string, SignatureEntry> signatures;
+    for (uint32_t i = 0; i < signatureCount; i++) {
+        SignatureEntry entry;
+        uint32_t rvaCount = 0;
+        if (!ReadUInt64(file, entry.moduleKey) || !ReadString(file, entry.moduleName) ||
+            !ReadUInt32(file, entry.rangeStart) || !ReadUInt32(file, entry.rangeEnd) ||
+            !ReadString(file, entry.pattern) || !ReadString(file, entry.mask) ||
+            entry.pattern.size() != entry.mask.size() || !ReadUInt32(file, rvaCount) || rvaCount > MAX_LIST_LENGTH) {
+            return;
+        }
+        entry.rvas.resize(rvaCount);
+        if (rvaCount && !file.read(reinterpret_cast<char*>(entry.rvas.data()), rvaCount * sizeof(uint32_t))) return;
+
+        std::string key = MakeSignatureKey(entry.moduleKey, entry.rangeStart, entry.rangeEnd, entry.pattern, entry.mask);
+        signatures[key] = std::move(entry);
+    }
+
+    std::unordered_map<std::string, ChainEntry> chains;
+    for (uint32_t i = 0; i < chainCount; i++) {
+        ChainEntry entry;
+        std::string name;
+        uint64_t moduleOffset = 0;
+        uint32_t offsetCount = 0;
+        if (!ReadUInt64(file, entry.moduleKey) || !ReadString(file, name) || !ReadString(file, entry.chain.module) ||
+            !ReadUInt64(file, moduleOffset) || !ReadUInt32(file, offsetCount) || offsetCount > MAX_LIST_LENGTH) {
+            return;
+        }
+        entry.chain.moduleOffset = static_cast<uintptr_t>(moduleOffset);
+        for (uint32_t j = 0; j < offsetCount; j++) {
+            uint64_t offset = 0;
+            if (!ReadUInt64(file, offset)) return;
+            entry.chain.offsets.push_back(static_cast<uintptr_t>(offset));
+        }
+        chains[name] = std::move(entry);
+    }
+
+    // Only a file that parsed completely replaces the (empty) cache
+    g_signatures = std::move(signatures);
+    g_chains = std::move(chains);
+}
+
+std::vector<std::vector<uintptr_t>> SignatureCache::Resolve(const std::vector<CodePattern>& patterns, uintptr_t start,
+                                                            uintptr_t end, const ScanOptions* control) {
+    if (start == 0) start = MemoryEngine::GetModuleBase();
+    if (end == 0) end = start + MemoryEngine::GetModuleSize();
+
+    ModuleIdentity identity;
+    uintptr_t base = 0;
+    if (start >= end || !GetModuleIdentity(start, identity, base) || end > base + identity.sizeOfImage) {
+        return MemoryEngine::PatternScanBatch(patterns, start, end, control);
+    }
+    uint32_t rangeStart = static_cast<uint32_t>(start - base);
+    uint32_t rangeEnd = static_cast<uint32_t>(end - base);
+
+    std::vector<std::vector<uintptr_t>> results(patterns.size());
+    std::vector<CodePattern> missing;
+    std::vector<size_t> missingIndex;
+    std::vector<std::string> missingKeys;
+
+    {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        EnsureLoaded();
+
+        for (size_t i = 0; i < patterns.size(); i++) {
+            if (patterns[i].mask.empty() || patterns[i].pattern.size() < patterns[i].mask.size()) continue;
+
+            CodePattern normalized = Normalize(patterns[i]);
+            std::string key = MakeSignatureKey(identity.key, rangeStart, rangeEnd, normalized.pattern, normalized.mask);
+
+            auto it = g_signatures.find(key);
+            bool valid = it != g_signatures.end();
+            if (valid) {
+                for (uint32_t rva : it->second.rvas) {
+                    if (!SafeMatch(reinterpret_cast<const uint8_t*>(base + rva), reinterpret_cast<const uint8_t*>(normalized.pattern.data()),
+                                   normalized.mask.data(), normalized.mask.size())) {
+                        valid = false;
+                        break;
+                    }
+                }
+            }
+
+            if (valid) {
+                for (uint32_t rva : it->second.rvas) {
+                    results[i].push_back(base + rva);
+                }
+                g_hits++;
+            } else {
+                missing.push_back(std::move(normalized));
+                missingIndex.push_back(i);
+                missingKeys.push_back(std::move(key));
+                g_misses++;
+            }
+        }
+    }
+
+    if (missing.empty()) return results;
+
+    auto scanned = MemoryEngine::PatternScanBatch(missing, start, end, control);
+    bool cancelled = control && control->cancel && control->cancel->load();
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    for (size_t j = 0; j < missing.size(); j++) {
+        results[missingIndex[j]] = scanned[j];
+        if (cancelled) continue;
+
+        if (scanned[j].empty()) {
+            if (g_signatures.erase(missingKeys[j])) MarkDirty();
+            continue;
+        }
+
+        SignatureEntry entry;
+        entry.moduleKey = identity.key;
+        entry.moduleName = identity.name;
+        entry.rangeStart = rangeStart;
+        entry.rangeEnd = rangeEnd;
+        entry.pattern = missing[j].pattern;
+        entry.mask = missing[j].mask;
+        for (uintptr_t address : scanned[j]) {
+            entry.rvas.push_back(static_cast<uint32_t>(address - base));
+        }
+        g_signatures[missingKeys[j]] = std::move(entry);
+        MarkDirty();
+    }
+    return results;
+}
+
+bool SignatureCache::StoreChain(const std::string& name, const std::string& moduleName, uintptr_t moduleOffset,
+                                const std::vector<uintptr_t>& offsets, std::string& error) {
+    uintptr_t moduleBase = MemoryEngine::GetModuleBase(moduleName);
+    ModuleIdentity identity;
+    uintptr_t base = 0;
+    if (moduleBase == 0 || !GetModuleIdentity(moduleBase, identity, base)) {
+        error = "Module not loaded";
+        return false;
+    }
+    if (name.empty() || name.size() > MAX_STRING_LENGTH) {
+        error = "Invalid chain name";
+        return false;
+    }
+
+    ChainEntry entry;
+    entry.moduleKey = identity.key;
+    entry.chain.module = identity.name;
+    entry.chain.moduleOffset = moduleOffset;
+    entry.chain.offsets = offsets;
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    EnsureLoaded();
+    g_chains[name] = std::move(entry);
+    MarkDirty();
+    return true;
+}
+
+bool SignatureCache::FindChain(const std::string& name, CachedPointerChain& chain) {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    EnsureLoaded();
+
+    auto it = g_chains.find(name);
+    if (it == g_chains.end()) return false;
+
+    uintptr_t moduleBase = MemoryEngine::GetModuleBase(it->second.chain.module);
+    ModuleIdentity identity;
+    uintptr_t base = 0;
+    if (moduleBase == 0 || !GetModuleIdentity(moduleBase, identity, base) || identity.key != it->second.moduleKey) {
+        return false;
+    }
+    chain = it->second.chain;
+    return true;
+}
+
+bool SignatureCache::RemoveChain(const std::string& name) {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    EnsureLoaded();
+    if (!g_chains.erase(name)) return false;
+    MarkDirty();
+    return true;
+}
+
+bool SignatureCache::Flush(std::string& error) {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    if (!g_loaded || !g_dirty) return true;
+
+    // Written next to the target and swapped in, so a crash never leaves half a file
+    std::string temporary = g_path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            error = "Cannot open file for writing";
+            return false;
+        }
+
+        WriteUInt32(file, FILE_MAGIC);
+        WriteUInt32(file, FILE_VERSION);
+        WriteUInt32(file, static_cast<uint32_t>(g_signatures.size()));
+        WriteUInt32(file, static_cast<uint32_t>(g_chains.size()));
+
+        for (const auto& pair : g_signatures) {
+            const SignatureEntry& entry = pair.second;
+            WriteUInt64(file, entry.moduleKey);
+            WriteString(file, entry.moduleName);
+            WriteUInt32(file, entry.rangeStart);
+            WriteUInt32(file, entry.rangeEnd);
+            WriteString(file, entry.pattern);
+            WriteString(file, entry.mask);
+            WriteUInt32(file, static_cast<uint32_t>(entry.rvas.size()));
+            file.write(reinterpret_cast<const char*>(entry.rvas.data()), entry.rvas.size() * sizeof(uint32_t));
+        }
+
+        for (const auto& pair : g_chains) {
+            const ChainEntry& entry = pair.second;
+            WriteUInt64(file, entry.moduleKey);
+            WriteString(file, pair.first);
+            WriteString(file, entry.chain.module);
+            WriteUInt64(file, entry.chain.moduleOffset);
+            WriteUInt32(file, static_cast<uint32_t>(entry.chain.offsets.size()));
+            for (uintptr_t offset : entry.chain.offsets) {
+                WriteUInt64(file, offset);
+            }
+        }
+
+        if (!file.flush()) {
+            error = "Write failed";
+            return false;
+        }
+    }
+
+    if (!MoveFileExA(temporary.c_str(), g_path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileA(temporary.c_str());
+        error = "Cannot replace cache file";
+        return false;
+    }
+    g_dirty = false;
+    return true;
+}
+
+bool SignatureCache::FlushIfDue(std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        if (!g_loaded || !g_dirty || GetTickCount64() - g_dirtySince < FLUSH_DELAY_MS) return true;
+    }
+    return Flush(error);
+}
+
+// A client only picks the name: the file is always created next to this DLL
+bool SignatureCache::SetFileName(const std::string& fileName, std::string& error) {
+    if (fileName.empty() || fileName == "." || fileName == ".." || fileName.find_first_of("\\/:") != std::string::npos) {
+        error = "Cache file must be a file name without a directory";
+        return false;
+    }
+    std::string path = DefaultCachePath();
+    size_t slash = path.find_last_of("\\/");
+    path = (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + fileName;
+
+    std::string flushError;
+    Flush(flushError);
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_path = path;
+    g_loaded = false;
+    g_dirty = false;
+    g_signatures.clear();
+    g_chains.clear();
+    return true;
+}
+
+std::string SignatureCache::GetPath() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    if (g_path.empty()) g_path = DefaultCachePath();
+    return g_path;
+}
+
+void SignatureCache::Clear() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    EnsureLoaded();
+    if (!g_signatures.empty() || !g_chains.empty()) MarkDirty();
+    g_signatures.clear();
+    g_chains.clear();
+}
+
+SignatureCacheStats SignatureCache::GetStats() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    EnsureLoaded();
+    SignatureCacheStats stats;
+    stats.signatures = g_signatures.size();
+    stats.chains = g_chains.size();
+    stats.hits = g_hits;
+    stats.misses = g_misses;
+    stats.dirty = g_dirty;
+    return stats;
+}
+
+} // namespace InternalEngine
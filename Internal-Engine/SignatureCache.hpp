@@ -0,0 +1,87 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "CodeIndex.hpp"
+
+namespace InternalEngine {
+
+struct ScanOptions;
+
+// Build of a module image: a rebuilt or patched binary gets a different key
+struct ModuleIdentity {
+    std::string name;               // File name, lower case
+    uint32_t timeDateStamp = 0;     // IMAGE_FILE_HEADER
+    uint32_t checkSum = 0;          // IMAGE_OPTIONAL_HEADER
+    uint32_t sizeOfImage = 0;
+    uint64_t key = 0;               // FNV-1a over the fields above
+};
+
+struct SignatureCacheStats {
+    size_t signatures = 0;          // Cached entries (every module, loaded or not)
+    size_t chains = 0;
+    size_t hits = 0;                // Since load: resolved from the cache
+    size_t misses = 0;              // Not cached, or the cached bytes no longer matched
+    bool dirty = false;             // Changes not yet written
+};
+
+// Named pointer chain relative to a module: FollowPointerChain(module base + moduleOffset, offsets)
+struct CachedPointerChain {
+    std::string module;
+    uintptr_t moduleOffset = 0;
+    std::vector<uintptr_t> offsets;
+};
+
+// 💾 시그니처 캐시
+// Signature results as RVAs, keyed by the module's build (PE timestamp, checksum, image
+// size) plus the pattern and the searched RVA range, and persisted across injections. A hit
+// is confirmed by comparing the pattern at every cached RVA; nothing is scanned unless a
+// compare fails or the entry is missing, and all of those are resolved in one batch scan.
+// Results that found nothing are not cached (there is nothing to compare against).
+// Ranges that do not lie inside one module image bypass the cache.
+//
+// Pointer chains are stored by name under the same module key, so a chain saved for one
+// build is never followed on another.
+//
+// The file (default: InternalEngine.sigcache, always next to this DLL) is loaded on first
+// use. Changes stay in memory until FlushIfDue finds them FLUSH_DELAY_MS old, so a burst
+// of lookups costs one write, or until an explicit Flush (shutdown, cache.clear).
+class SignatureCache {
+public:
+    static const uint32_t FILE_MAGIC = 0x43474953;     // "SIGC"
+    static const uint32_t FILE_VERSION = 1;
+    static const ULONGLONG FLUSH_DELAY_MS = 5000;
+
+    // Same contract as MemoryEngine::PatternScanBatch
+    static std::vector<std::vector<uintptr_t>> Resolve(const std::vector<CodePattern>& patterns, uintptr_t start = 0,
+                                                       uintptr_t end = 0, const ScanOptions* control = nullptr);
+
+    static bool StoreChain(const std::string& name, const std::string& moduleName, uintptr_t moduleOffset,
+                           const std::vector<uintptr_t>& offsets, std::string& error);
+    // Chain saved for the loaded build of its module
+    static bool FindChain(const std::string& name, CachedPointerChain& chain);
+    static bool RemoveChain(const std::string& name);
+
+    // Writes the cache if it changed since the last load or flush
+    static bool Flush(std::string& error);
+
+    // Called periodically; flushes once the oldest unwritten change is FLUSH_DELAY_MS old
+    static bool FlushIfDue(std::string& error);
+
+    // Switches to another file in the DLL's directory; fileName may not contain a path
+    // (the current cache is flushed first, the new one loaded lazily)
+    static bool SetFileName(const std::string& fileName, std::string& error);
+    static std::string GetPath();
+
+    // Drops every entry (the file is rewritten by the next Flush)
+    static void Clear();
+
+    static SignatureCacheStats GetStats();
+
+    // Identity of the loaded module containing address; false if it is not in an image
+    static bool GetModuleIdentity(uintptr_t address, ModuleIdentity& identity, uintptr_t& base);
+};
+
+} // namespace InternalEngine
@@ -0,0 +1,318 @@
+#include "SimdScan.hpp"
+#include <intrin.h>
+#include <immintrin.h>
+#include <cstring>
+
+namespace InternalEngine {
+
+namespace {
+
+// 🧠 CPU 기능 감지
+SimdLevel DetectSimdLevel() {
+    int info[4] = { 0 };
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool hasSse2 = (info[3] & (1 << 26)) != 0;
+    bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+    bool hasAvx2 = false;
+    if (maxLeaf >= 7 && hasOsxsave && hasAvx) {
+        // The OS must save YMM state across context switches (XCR0 bits 1 and 2)
+        unsigned long long xcr0 = _xgetbv(0);
+        if ((xcr0 & 0x6) == 0x6) {
+            __cpuidex(info, 7, 0);
+            hasAvx2 = (info[1] & (1 << 5)) != 0;
+        }
+    }
+
+    if (hasAvx2) return SimdLevel::AVX2;
+    if (hasSse2) return SimdLevel::SSE2;
+    return SimdLevel::Scalar;
+}
+
+inline unsigned long LowestBit(uint32_t bits) {
+    unsigned long index = 0;
+    _BitScanForward(&index, bits);
+    return index;
+}
+
+inline bool MatchesAt(const uint8_t* data, const uint8_t* pattern, const char* mask, size_t length) {
+    if (!mask) return memcmp(data, pattern, length) == 0;
+    for (size_t i = 0; i < length; i++) {
+        if (mask[i] == 'x' && data[i] != pattern[i]) return false;
+    }
+    return true;
+}
+
+// Plain loop used for the scalar level and for the tail the vector loops cannot cover
+void FindScalar(const uint8_t* data, size_t dataSize, size_t candidateCount, size_t startOffset,
+                const uint8_t* pattern, const char* mask, size_t length, size_t alignment,
+                std::vector<size_t>& offsets) {
+    size_t offset = startOffset + (alignment - startOffset % alignment) % alignment;
+    for (; offset < candidateCount && offset + length <= dataSize; offset += alignment) {
+        if (MatchesAt(data + offset, pattern, mask, length)) {
+            offsets.push_back(offset);
+        }
+    }
+}
+
+struct Sse2Ops {
+    static const size_t Width = 16;
+    typedef __m128i Vec;
+
+    static Vec Load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static Vec Broadcast8(uint8_t value) { return _mm_set1_epi8(static_cast<char>(value)); }
+    static Vec Broadcast32(uint32_t value) { return _mm_set1_epi32(static_cast<int>(value)); }
+    static Vec Broadcast64(uint64_t value) {
+        return _mm_set_epi32(static_cast<int>(value >> 32), static_cast<int>(value),
+                             static_cast<int>(value >> 32), static_cast<int>(value));
+    }
+
+    // One bit per byte / 32-bit lane / 64-bit lane
+    static uint32_t MatchBytes(Vec a, Vec b) { return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))); }
+    static uint32_t MatchLanes32(Vec a, Vec b) {
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))));
+    }
+    static uint32_t MatchLanes64(Vec a, Vec b) {
+        // SSE2 has no 64-bit compare: a 64-bit lane matches when both 32-bit halves do
+        uint32_t halves = MatchLanes32(a, b);
+        return ((halves & 0x3) == 0x3 ? 0x1u : 0u) | ((halves & 0xC) == 0xC ? 0x2u : 0u);
+    }
+    static void Finish() {}
+};
+
+struct Avx2Ops {
+    static const size_t Width = 32;
+    typedef __m256i Vec;
+
+    static Vec Load(const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static Vec Broadcast8(uint8_t value) { return _mm256_set1_epi8(static_cast<char>(value)); }
+    static Vec Broadcast32(uint32_t value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+    static Vec Broadcast64(uint64_t value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+
+    static uint32_t MatchBytes(Vec a, Vec b) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))); }
+    static uint32_t MatchLanes32(Vec a, Vec b) {
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+    }
+    static uint32_t MatchLanes64(Vec a, Vec b) {
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))));
+    }
+    // Avoid AVX-SSE transition stalls in the surrounding (non-VEX) code
+    static void Finish() { _mm256_zeroupper(); }
+};
+
+// Whole-lane compare for 4/8-byte values when every candidate sits on a lane boundary
+template<typename Ops, size_t LaneSize>
+void FindLanes(const uint8_t* data, size_t dataSize, size_t candidateCount,
+               const uint8_t* value, size_t alignment, std::vector<size_t>& offsets) {
+    typename Ops::Vec needle;
+    if (LaneSize == 4) {
+        uint32_t v;
+        memcpy(&v, value, sizeof(v));
+        needle = Ops::Broadcast32(v);
+    } else {
+        uint64_t v;
+        memcpy(&v, value, sizeof(v));
+        needle = Ops::Broadcast64(v);
+    }
+
+    size_t i = 0;
+    for (; i < candidateCount && i + Ops::Width <= dataSize; i += Ops::Width) {
+        typename Ops::Vec block = Ops::Load(data + i);
+        uint32_t bits = (LaneSize == 4) ? Ops::MatchLanes32(block, needle) : Ops::MatchLanes64(block, needle);
+
+        while (bits) {
+            size_t offset = i + LowestBit(bits) * LaneSize;
+            bits &= bits - 1;
+            if (offset >= candidateCount) break;
+            if (offset % alignment != 0) continue;
+            offsets.push_back(offset);
+        }
+    }
+    Ops::Finish();
+
+    FindScalar(data, dataSize, candidateCount, i, value, nullptr, LaneSize, alignment, offsets);
+}
+
+// Two-anchor filter: compare the first and last significant byte at Width positions at once,
+// then verify the full pattern only where both anchors hit
+template<typename Ops>
+void FindAnchored(const uint8_t* data, size_t dataSize, size_t candidateCount,
+                  const uint8_t* pattern, const char* mask, size_t length, size_t alignment,
+                  std::vector<size_t>& offsets) {
+    size_t firstIndex = 0;
+    size_t lastIndex = length - 1;
+    if (mask) {
+        while (firstIndex < length && mask[firstIndex] != 'x') firstIndex++;
+        while (lastIndex > firstIndex && mask[lastIndex] != 'x') lastIndex--;
+
+        // Only wildcards - every candidate matches
+        if (firstIndex == length) {
+            FindScalar(data, dataSize, candidateCount, 0, pattern, mask, length, alignment, offsets);
+            return;
+        }
+    }
+
+    const typename Ops::Vec firstByte = Ops::Broadcast8(pattern[firstIndex]);
+    const typename Ops::Vec lastByte = Ops::Broadcast8(pattern[lastIndex]);
+
+    size_t i = 0;
+    for (; i < candidateCount && i + lastIndex + Ops::Width <= dataSize; i += Ops::Width) {
+        uint32_t bits = Ops::MatchBytes(Ops::Load(data + i + firstIndex), firstByte) &
+                        Ops::MatchBytes(Ops::Load(data + i + lastIndex), lastByte);
+
+        while (bits) {
+            size_t offset = i + LowestBit(bits);
+            bits &= bits - 1;
+            if (offset >= candidateCount || offset + length > dataSize) break;
+            if (offset % alignment != 0) continue;
+            if (MatchesAt(data + offset, pattern, mask, length)) {
+                offsets.push_back(offset);
+            }
+        }
+    }
+    Ops::Finish();
+
+    FindScalar(data, dataSize, candidateCount, i, pattern, mask, length, alignment, offsets);
+}
+
+template<typename Ops>
+void FindValueWith(const uint8_t* data, size_t dataSize, size_t candidateCount,
+                   const uint8_t* value, size_t valueSize, size_t alignment, std::vector<size_t>& offsets) {
+    if (valueSize == 4 && alignment % 4 == 0) {
+        FindLanes<Ops, 4>(data, dataSize, candidateCount, value, alignment, offsets);
+    } else if (valueSize == 8 && alignment % 8 == 0) {
+        FindLanes<Ops, 8>(data, dataSize, candidateCount, value, alignment, offsets);
+    } else {
+        FindAnchored<Ops>(data, dataSize, candidateCount, value, nullptr, valueSize, alignment, offsets);
+    }
+}
+
+// Records bytes [offset, offset + length) as changed, merging with the previous range when the
+// gap between them is at most mergeGap
+inline void AddChangedRun(std::vector<ByteRange>& ranges, size_t offset, size_t length, size_t mergeGap) {
+    if (!ranges.empty()) {
+        ByteRange& last = ranges.back();
+        if (offset <= last.offset + last.length + mergeGap) {
+            last.length = offset + length - last.offset;
+            return;
+        }
+    }
+    ranges.push_back(ByteRange{ offset, length });
+}
+
+void FindChangedScalar(const uint8_t* current, const uint8_t* previous, size_t start, size_t size,
+                       size_t baseOffset, size_t mergeGap, std::vector<ByteRange>& ranges) {
+    size_t offset = start;
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t a, b;
+        memcpy(&a, current + offset, sizeof(a));
+        memcpy(&b, previous + offset, sizeof(b));
+        if (a == b) continue;
+        for (size_t i = 0; i < 8; i++) {
+            if (current[offset + i] != previous[offset + i]) AddChangedRun(ranges, baseOffset + offset + i, 1, mergeGap);
+        }
+    }
+    for (; offset < size; offset++) {
+        if (current[offset] != previous[offset]) AddChangedRun(ranges, baseOffset + offset, 1, mergeGap);
+    }
+}
+
+// One vector compare per Width bytes; an all-equal block (static memory) costs a compare and a
+// branch, and a differing block is walked run by run instead of byte by byte
+template<typename Ops>
+void FindChangedWith(const uint8_t* current, const uint8_t* previous, size_t size,
+                     size_t baseOffset, size_t mergeGap, std::vector<ByteRange>& ranges) {
+    const uint32_t fullMask = Ops::Width == 32 ? 0xFFFFFFFFu : ((1u << Ops::Width) - 1);
+
+    size_t offset = 0;
+    for (; offset + Ops::Width <= size; offset += Ops::Width) {
+        uint32_t differ = ~Ops::MatchBytes(Ops::Load(current + offset), Ops::Load(previous + offset)) & fullMask;
+        while (differ) {
+            unsigned long first = LowestBit(differ);
+            uint32_t rest = ~(differ >> first);
+            size_t length = rest ? LowestBit(rest) : 32 - first;
+            AddChangedRun(ranges, baseOffset + offset + first, length, mergeGap);
+
+            size_t end = first + length;
+            differ = end >= 32 ? 0 : differ & ~((1u << end) - 1);
+        }
+    }
+    Ops::Finish();
+
+    FindChangedScalar(current, previous, offset, size, baseOffset, mergeGap, ranges);
+}
+
+} // namespace
+
+SimdLevel SimdScan::GetLevel() {
+    static const SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+const char* SimdScan::GetLevelName() {
+    switch (GetLevel()) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+void SimdScan::FindValue(const uint8_t* data, size_t dataSize, size_t candidateCount,
+                         const uint8_t* value, size_t valueSize, size_t alignment,
+                         std::vector<size_t>& offsets) {
+    if (!data || !value || valueSize == 0 || valueSize > dataSize) return;
+    if (alignment == 0) alignment = 1;
+
+    switch (GetLevel()) {
+        case SimdLevel::AVX2:
+            FindValueWith<Avx2Ops>(data, dataSize, candidateCount, value, valueSize, alignment, offsets);
+            break;
+        case SimdLevel::SSE2:
+            FindValueWith<Sse2Ops>(data, dataSize, candidateCount, value, valueSize, alignment, offsets);
+            break;
+        default:
+            FindScalar(data, dataSize, candidateCount, 0, value, nullptr, valueSize, alignment, offsets);
+            break;
+    }
+}
+
+void SimdScan::FindPattern(const uint8_t* data, size_t dataSize, size_t candidateCount,
+                           const uint8_t* pattern, const char* mask, size_t length,
+                           std::vector<size_t>& offsets) {
+    if (!data || !pattern || !mask || length == 0 || length > dataSize) return;
+
+    switch (GetLevel()) {
+        case SimdLevel::AVX2:
+            FindAnchored<Avx2Ops>(data, dataSize, candidateCount, pattern, mask, length, 1, offsets);
+            break;
+        case SimdLevel::SSE2:
+            FindAnchored<Sse2Ops>(data, dataSize, candidateCount, pattern, mask, length, 1, offsets);
+            break;
+        default:
+            FindScalar(data, dataSize, candidateCount, 0, pattern, mask, length, 1, offsets);
+            break;
+    }
+}
+
+void SimdScan::FindChangedRanges(const uint8_t* current, const uint8_t* previous, size_t size,
+                                 size_t baseOffset, size_t mergeGap, std::vector<ByteRange>& ranges) {
+    if (!current || !previous || size == 0) return;
+
+    switch (GetLevel()) {
+        case SimdLevel::AVX2:
+            FindChangedWith<Avx2Ops>(current, previous, size, baseOffset, mergeGap, ranges);
+            break;
+        case SimdLevel::SSE2:
+            FindChangedWith<Sse2Ops>(current, previous, size, baseOffset, mergeGap, ranges);
+            break;
+        default:
+            FindChangedScalar(current, previous, 0, size, baseOffset, mergeGap, ranges);
+            break;
+    }
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace InternalEngine {
+
+// Instruction set used by the scan kernels (picked once at runtime via CPUID)
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// A run of bytes, relative to the start of the compared buffers
+struct ByteRange {
+    size_t offset;
+    size_t length;
+};
+
+// ⚡ SIMD 스캔 커널
+// Compares 16/32 bytes per instruction and walks the resulting match bitmask.
+// All kernels report offsets relative to data[0] that are multiples of alignment
+// and lie in [0, candidateCount); data must stay readable for dataSize bytes.
+class SimdScan {
+public:
+    static SimdLevel GetLevel();
+    static const char* GetLevelName();
+
+    // Exact byte match (4/8-byte values on a matching alignment use lane compares)
+    static void FindValue(const uint8_t* data, size_t dataSize, size_t candidateCount,
+                          const uint8_t* value, size_t valueSize, size_t alignment,
+                          std::vector<size_t>& offsets);
+
+    // Masked match, mask[i] == 'x' means pattern[i] must match ('?' = wildcard)
+    static void FindPattern(const uint8_t* data, size_t dataSize, size_t candidateCount,
+                            const uint8_t* pattern, const char* mask, size_t length,
+                            std::vector<size_t>& offsets);
+
+    // Appends the runs where current differs from previous (both size bytes), in order, with
+    // offsets shifted by baseOffset so several spans can share one range list.
+    // Runs separated by at most mergeGap equal bytes are reported as one range, and a range
+    // starting within mergeGap of the last one already in ranges extends it.
+    static void FindChangedRanges(const uint8_t* current, const uint8_t* previous, size_t size,
+                                  size_t baseOffset, size_t mergeGap, std::vector<ByteRange>& ranges);
+};
+
+} // namespace InternalEngine
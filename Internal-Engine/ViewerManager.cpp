@@ -0,0 +1,230 @@
+#include "ViewerManager.hpp"
+#include "BinaryProtocol.hpp"
+#include "WebSocketServer.hpp"
+#include <cstring>
+
+namespace InternalEngine {
+
+ViewerManager::ViewerManager() {}
+
+ViewerManager::~ViewerManager() {
+    Stop();
+}
+
+// Adjacent unreadable pages are reported as one range
+static void CollectUnreadable(const std::vector<BulkReadEntry>& pages, const std::vector<uint8_t>& readable,
+                              std::vector<ByteRange>& unreadable) {
+    size_t offset = 0;
+    for (size_t i = 0; i < pages.size(); i++) {
+        if (!readable[i]) {
+            if (!unreadable.empty() && unreadable.back().offset + unreadable.back().length == offset) {
+                unreadable.back().length += pages[i].size;
+            } else {
+                unreadable.push_back(ByteRange{ offset, pages[i].size });
+            }
+        }
+        offset += pages[i].size;
+    }
+}
+
+uint32_t ViewerManager::Subscribe(uintptr_t address, size_t length, uint32_t rateHz, WebSocketConnection* owner,
+                                  std::vector<uint8_t>& initial, std::vector<ByteRange>& unreadable) {
+    if (!owner) return 0;
+    if (rateHz == 0) rateHz = DEFAULT_RATE_HZ;
+    if (rateHz > MAX_RATE_HZ) rateHz = MAX_RATE_HZ;
+
+    Subscription subscription;
+    subscription.owner = owner;
+    subscription.interval = std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(1000000 / rateHz));
+
+    // The first page runs up to the next page boundary, so later pages line up with real ones
+    for (uintptr_t cursor = address; cursor < address + length;) {
+        uintptr_t pageEnd = (cursor & ~static_cast<uintptr_t>(PAGE_SIZE - 1)) + PAGE_SIZE;
+        BulkReadEntry page;
+        page.address = cursor;
+        page.size = static_cast<size_t>(min(pageEnd, address + length) - cursor);
+        subscription.pages.push_back(page);
+        cursor += page.size;
+    }
+
+    // First sample: handed to the caller, and the base of the first diff
+    MemoryEngine::ReadBulk(subscription.pages, subscription.last, subscription.lastReadable);
+    initial = subscription.last;
+    unreadable.clear();
+    CollectUnreadable(subscription.pages, subscription.lastReadable, unreadable);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    subscription.nextSample = Clock::now() + subscription.interval;
+    uint32_t subscriptionId = nextSubscriptionId++;
+    if (nextSubscriptionId == 0) nextSubscriptionId = 1;
+    subscriptions[subscriptionId] = std::move(subscription);
+
+    // The sampler starts with the first subscription
+    if (!running) {
+        running = true;
+        sampler = std::thread(&ViewerManager::SampleLoop, this);
+    }
+    wakeup.notify_one();
+    return subscriptionId;
+}
+
+bool ViewerManager::Unsubscribe(uint32_t subscriptionId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscriptions.erase(subscriptionId) > 0;
+}
+
+void ViewerManager::UnsubscribeOwner(WebSocketConnection* owner) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = subscriptions.begin(); it != subscriptions.end();) {
+            if (it->second.owner == owner) {
+                it = subscriptions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // A round collected before the erase may still be sending to owner; wait it out so the
+    // connection is not freed under it
+    std::lock_guard<std::mutex> sending(sendMutex);
+}
+
+void ViewerManager::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+        subscriptions.clear();
+    }
+    wakeup.notify_one();
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+}
+
+void ViewerManager::SampleLoop() {
+    std::vector<std::pair<WebSocketConnection*, std::vector<uint8_t>>> frames;
+
+    while (true) {
+        std::unique_lock<std::mutex> sending(sendMutex, std::defer_lock);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!running) break;
+
+            // Sleep until the earliest subscription is due (or something changes)
+            if (subscriptions.empty()) {
+                wakeup.wait(lock);
+                continue;
+            }
+            Clock::time_point due = subscriptions.begin()->second.nextSample;
+            for (const auto& pair : subscriptions) {
+                if (pair.second.nextSample < due) due = pair.second.nextSample;
+            }
+            if (Clock::now() < due) {
+                wakeup.wait_until(lock, due);
+                continue;
+            }
+
+            Clock::time_point now = Clock::now();
+            for (auto& pair : subscriptions) {
+                Subscription& subscription = pair.second;
+                if (subscription.nextSample > now) continue;
+
+                auto frame = Sample(pair.first, subscription);
+                if (!frame.empty()) frames.emplace_back(subscription.owner, std::move(frame));
+
+                // Fixed-rate schedule; skip missed samples instead of bursting to catch up
+                subscription.nextSample += subscription.interval;
+                if (subscription.nextSample < now) subscription.nextSample = now + subscription.interval;
+            }
+
+            // Taken before the lock is released, so UnsubscribeOwner cannot return while a
+            // frame collected above is still going to its owner
+            sending.lock();
+        }
+
+        // Send outside the lock - a slow client must not block subscribe/unsubscribe
+        for (const auto& frame : frames) {
+            frame.first->SendBinary(frame.second);
+        }
+        frames.clear();
+    }
+}
+
+std::vector<uint8_t> ViewerManager::Sample(uint32_t subscriptionId, Subscription& subscription) {
+    // Both buffers keep their capacity, so a steady window samples without allocating
+    MemoryEngine::ReadBulk(subscription.pages, subscription.current, subscription.currentReadable);
+
+    changed.clear();
+    lost.clear();
+
+    // Consecutive pages readable in both samples are compared as one span, so changes on
+    // either side of a page boundary still merge
+    const uint8_t* current = subscription.current.data();
+    const uint8_t* last = subscription.last.data();
+    size_t spanStart = 0;
+    size_t offset = 0;
+    for (size_t i = 0; i <= subscription.pages.size(); i++) {
+        bool bothReadable = i < subscription.pages.size() && subscription.currentReadable[i] && subscription.lastReadable[i];
+        if (!bothReadable && offset > spanStart) {
+            SimdScan::FindChangedRanges(current + spanStart, last + spanStart, offset - spanStart, spanStart, MERGE_GAP, changed);
+        }
+        if (i == subscription.pages.size()) break;
+
+        size_t size = subscription.pages[i].size;
+        if (!bothReadable) {
+            if (subscription.currentReadable[i]) {
+                // Became readable: the whole page is new
+                if (!changed.empty() && changed.back().offset + changed.back().length + MERGE_GAP >= offset) {
+                    changed.back().length = offset + size - changed.back().offset;
+                } else {
+                    changed.push_back(ByteRange{ offset, size });
+                }
+            } else if (subscription.lastReadable[i]) {
+                lost.push_back(ByteRange{ offset, size });
+            }
+            spanStart = offset + size;
+        }
+        offset += size;
+    }
+
+    subscription.last.swap(subscription.current);
+    subscription.lastReadable.swap(subscription.currentReadable);
+
+    if (changed.empty() && lost.empty()) return {};
+    return EncodeFrame(subscriptionId, ++subscription.sequence, subscription.last.data(), changed, lost);
+}
+
+static void AppendUInt32(std::vector<uint8_t>& buffer, uint32_t value) {
+    uint8_t bytes[4];
+    memcpy(bytes, &value, sizeof(bytes));
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(bytes));
+}
+
+std::vector<uint8_t> ViewerManager::EncodeFrame(uint32_t subscriptionId, uint32_t sequence, const uint8_t* data,
+                                                const std::vector<ByteRange>& changed,
+                                                const std::vector<ByteRange>& unreadable) {
+    size_t dataSize = 0;
+    for (const auto& range : changed) dataSize += range.length;
+
+    std::vector<uint8_t> payload;
+    payload.reserve(8 + (changed.size() + unreadable.size()) * 8 + dataSize);
+    AppendUInt32(payload, sequence);
+    AppendUInt32(payload, static_cast<uint32_t>(changed.size() + unreadable.size()));
+
+    for (const auto& range : changed) {
+        AppendUInt32(payload, static_cast<uint32_t>(range.offset));
+        AppendUInt32(payload, static_cast<uint32_t>(range.length));
+        payload.insert(payload.end(), data + range.offset, data + range.offset + range.length);
+    }
+    for (const auto& range : unreadable) {
+        AppendUInt32(payload, static_cast<uint32_t>(range.offset));
+        AppendUInt32(payload, static_cast<uint32_t>(range.length) | RANGE_UNREADABLE);
+    }
+
+    return BinaryProtocol::EncodeMessage(BinaryOpcode::VIEWER_UPDATE, subscriptionId, 0, payload.data(), payload.size());
+}
+
+} // namespace InternalEngine
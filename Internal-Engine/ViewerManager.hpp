@@ -0,0 +1,92 @@
+#pragma once
+#include <windows.h>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include "MemoryEngine.hpp"
+#include "SimdScan.hpp"
+
+namespace InternalEngine {
+
+class WebSocketConnection;
+
+// 🔭 메모리 뷰어 구독
+// A memory viewer's window (address, length) is sampled at the subscription's rate and only
+// the byte ranges that changed since the previous sample are pushed. Subscribe takes the first
+// sample itself and hands it back to the caller, so every VIEWER_UPDATE frame is a diff: frames
+// carry a sequence number starting at 1, and a client that sees a gap resubscribes. Static
+// memory costs one bulk read and a SIMD compare per tick and sends nothing.
+// Same threading model as WatchManager: one thread, frames go to the owner outside the lock.
+class ViewerManager {
+public:
+    static const uint32_t DEFAULT_RATE_HZ = 30;
+    static const uint32_t MAX_RATE_HZ = 120;
+    static const size_t MAX_LENGTH = 64 * 1024;
+    static const size_t PAGE_SIZE = 4096;
+
+    // Changes this close together go out as one range (a range header costs 8 bytes)
+    static const size_t MERGE_GAP = 8;
+
+    // Set in a range's length: those bytes became unreadable and no data follows
+    static const uint32_t RANGE_UNREADABLE = 0x80000000u;
+
+    ViewerManager();
+    ~ViewerManager();
+
+    // initial receives the window's bytes (zero where unreadable), unreadable the ranges that
+    // could not be read. Frames go to owner, and its subscriptions are dropped on disconnect;
+    // without an owner nothing is subscribed and 0 is returned.
+    uint32_t Subscribe(uintptr_t address, size_t length, uint32_t rateHz, WebSocketConnection* owner,
+                       std::vector<uint8_t>& initial, std::vector<ByteRange>& unreadable);
+    bool Unsubscribe(uint32_t subscriptionId);
+    // Also waits for a send to owner already under way (called before owner is freed)
+    void UnsubscribeOwner(WebSocketConnection* owner);
+
+    // Stops the sampling thread (called before the WebSocket server goes away)
+    void Stop();
+
+    // VIEWER_UPDATE payload (little-endian): sequence u32, count u32, then per range offset u32,
+    // length u32 (RANGE_UNREADABLE flag in the top bit) and, for readable ranges, the bytes
+    static std::vector<uint8_t> EncodeFrame(uint32_t subscriptionId, uint32_t sequence, const uint8_t* data,
+                                            const std::vector<ByteRange>& changed,
+                                            const std::vector<ByteRange>& unreadable);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Subscription {
+        WebSocketConnection* owner = nullptr;
+        Clock::duration interval;
+        Clock::time_point nextSample;
+        uint32_t sequence = 0;
+
+        // One read per page, so a page that faults does not hide the rest of the window
+        std::vector<BulkReadEntry> pages;
+        std::vector<uint8_t> last;
+        std::vector<uint8_t> lastReadable;
+        std::vector<uint8_t> current;
+        std::vector<uint8_t> currentReadable;
+    };
+
+    void SampleLoop();
+    std::vector<uint8_t> Sample(uint32_t subscriptionId, Subscription& subscription);
+
+    std::mutex mutex;
+    std::mutex sendMutex;           // Held while a round's frames are sent
+    std::condition_variable wakeup;
+    std::unordered_map<uint32_t, Subscription> subscriptions;
+    uint32_t nextSubscriptionId = 1;
+
+    std::thread sampler;
+    bool running = false;
+
+    // Scratch lists, sampler thread only
+    std::vector<ByteRange> changed;
+    std::vector<ByteRange> lost;
+};
+
+} // namespace InternalEngine
@@ -0,0 +1,176 @@
+#include "WatchManager.hpp"
+#include "WebSocketServer.hpp"
+#include <cstring>
+
+namespace InternalEngine {
+
+WatchManager::WatchManager() {}
+
+WatchManager::~WatchManager() {
+    Stop();
+}
+
+uint32_t WatchManager::Subscribe(std::vector<WatchEntry> entries, uint32_t rateHz, WebSocketConnection* owner) {
+    if (!owner) return 0;
+    if (rateHz == 0) rateHz = DEFAULT_RATE_HZ;
+    if (rateHz > MAX_RATE_HZ) rateHz = MAX_RATE_HZ;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Subscription subscription;
+    subscription.id = nextWatchId++;
+    if (nextWatchId == 0) nextWatchId = 1;
+    subscription.owner = owner;
+    subscription.entries = std::move(entries);
+    subscription.interval = std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(1000000 / rateHz));
+    subscription.nextSample = Clock::now();
+    subscription.reads.resize(subscription.entries.size());
+
+    uint32_t watchId = subscription.id;
+    subscriptions[watchId] = std::move(subscription);
+
+    // The sampler starts with the first subscription
+    if (!running) {
+        running = true;
+        sampler = std::thread(&WatchManager::SampleLoop, this);
+    }
+    wakeup.notify_one();
+    return watchId;
+}
+
+bool WatchManager::Unsubscribe(uint32_t watchId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscriptions.erase(watchId) > 0;
+}
+
+void WatchManager::UnsubscribeOwner(WebSocketConnection* owner) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = subscriptions.begin(); it != subscriptions.end();) {
+            if (it->second.owner == owner) {
+                it = subscriptions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // A round collected before the erase may still be sending to owner; wait it out so the
+    // connection is not freed under it
+    std::lock_guard<std::mutex> sending(sendMutex);
+}
+
+size_t WatchManager::GetSubscriptionCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscriptions.size();
+}
+
+void WatchManager::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+        subscriptions.clear();
+    }
+    wakeup.notify_one();
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+}
+
+void WatchManager::SampleLoop() {
+    std::vector<std::pair<WebSocketConnection*, std::vector<uint8_t>>> frames;
+
+    while (true) {
+        std::unique_lock<std::mutex> sending(sendMutex, std::defer_lock);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!running) break;
+
+            // Sleep until the earliest subscription is due (or something changes)
+            if (subscriptions.empty()) {
+                wakeup.wait(lock);
+                continue;
+            }
+            Clock::time_point due = subscriptions.begin()->second.nextSample;
+            for (const auto& pair : subscriptions) {
+                if (pair.second.nextSample < due) due = pair.second.nextSample;
+            }
+            if (Clock::now() < due) {
+                wakeup.wait_until(lock, due);
+                continue;
+            }
+
+            Clock::time_point now = Clock::now();
+            for (auto& pair : subscriptions) {
+                Subscription& subscription = pair.second;
+                if (subscription.nextSample > now) continue;
+
+                auto frame = Sample(subscription);
+                if (!frame.empty()) frames.emplace_back(subscription.owner, std::move(frame));
+
+                // Fixed-rate schedule; skip missed samples instead of bursting to catch up
+                subscription.nextSample += subscription.interval;
+                if (subscription.nextSample < now) subscription.nextSample = now + subscription.interval;
+            }
+
+            // Taken before the lock is released, so UnsubscribeOwner cannot return while a
+            // frame collected above is still going to its owner
+            sending.lock();
+        }
+
+        // Send outside the lock - a slow client must not block subscribe/unsubscribe
+        for (const auto& frame : frames) {
+            frame.first->SendBinary(frame.second);
+        }
+        frames.clear();
+    }
+}
+
+std::vector<uint8_t> WatchManager::Sample(Subscription& subscription) {
+    const auto& entries = subscription.entries;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        BulkReadEntry& read = subscription.reads[i];
+        read.size = entries[i].size;
+        if (entries[i].offsets.empty()) {
+            read.address = entries[i].address;
+        } else {
+            read.address = MemoryEngine::FollowPointerChain(entries[i].address, entries[i].offsets).value_or(0);
+        }
+    }
+
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> readable;
+    MemoryEngine::ReadBulk(subscription.reads, data, readable);
+
+    std::vector<MemoryReadRequest> changed;
+    std::vector<std::vector<uint8_t>> values;
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        size_t size = entries[i].size;
+        bool isChanged = !subscription.primed || readable[i] != subscription.lastReadable[i] ||
+                         (readable[i] && memcmp(data.data() + offset, subscription.lastData.data() + offset, size) != 0);
+
+        if (isChanged && (readable[i] || subscription.primed)) {
+            MemoryReadRequest update;
+            update.address = i;
+            update.size = static_cast<uint32_t>(size);
+            update.type = entries[i].type;
+            changed.push_back(update);
+
+            values.emplace_back();
+            if (readable[i]) values.back().assign(data.begin() + offset, data.begin() + offset + size);
+        }
+        offset += size;
+    }
+
+    subscription.lastData.swap(data);
+    subscription.lastReadable.swap(readable);
+    subscription.primed = true;
+
+    if (changed.empty()) return {};
+    return BinaryProtocol::EncodeBulkRead(subscription.id, changed, values, BINARY_FLAG_WATCH);
+}
+
+} // namespace InternalEngine
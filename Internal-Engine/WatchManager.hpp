@@ -0,0 +1,81 @@
+#pragma once
+#include <windows.h>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include "MemoryEngine.hpp"
+#include "BinaryProtocol.hpp"
+
+namespace InternalEngine {
+
+class WebSocketConnection;
+
+// One watched value: a plain address, or a pointer chain re-resolved on every sample
+struct WatchEntry {
+    uintptr_t address = 0;
+    std::vector<uintptr_t> offsets;     // Empty for a plain address
+    size_t size = 4;
+    DataType type = DataType::INT32;
+};
+
+// 👁️ 서버 푸시 감시 목록
+// A dedicated thread samples every subscription at its own rate and sends its owner only the
+// values that changed since the previous sample. Change frames are BULK_UPDATE messages with
+// requestId = watch id and BINARY_FLAG_WATCH set; each entry's address field carries the
+// entry's index in the subscription (pointer chains have no stable address). The first sample
+// sends every entry, and an entry that becomes unreadable is sent once with valueSize 0.
+class WatchManager {
+public:
+    static const uint32_t DEFAULT_RATE_HZ = 60;
+    static const uint32_t MAX_RATE_HZ = 1000;
+
+    WatchManager();
+    ~WatchManager();
+
+    // Returns the new watch id (0 without an owner); frames go to owner, and its watches are
+    // dropped on disconnect
+    uint32_t Subscribe(std::vector<WatchEntry> entries, uint32_t rateHz, WebSocketConnection* owner);
+    bool Unsubscribe(uint32_t watchId);
+    // Also waits for a send to owner already under way (called before owner is freed)
+    void UnsubscribeOwner(WebSocketConnection* owner);
+
+    size_t GetSubscriptionCount() const;
+
+    // Stops the sampling thread (called before the WebSocket server goes away)
+    void Stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Subscription {
+        uint32_t id = 0;
+        WebSocketConnection* owner = nullptr;
+        std::vector<WatchEntry> entries;
+        Clock::duration interval;
+        Clock::time_point nextSample;
+
+        // Previous sample, in the packed layout MemoryEngine::ReadBulk produces
+        std::vector<BulkReadEntry> reads;
+        std::vector<uint8_t> lastData;
+        std::vector<uint8_t> lastReadable;
+        bool primed = false;
+    };
+
+    void SampleLoop();
+    std::vector<uint8_t> Sample(Subscription& subscription);
+
+    mutable std::mutex mutex;
+    std::mutex sendMutex;           // Held while a round's frames are sent
+    std::condition_variable wakeup;
+    std::unordered_map<uint32_t, Subscription> subscriptions;
+    uint32_t nextWatchId = 1;
+
+    std::thread sampler;
+    bool running = false;
+};
+
+} // namespace InternalEngine
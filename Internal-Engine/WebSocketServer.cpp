@@ -1,11 +1,15 @@
 #include "WebSocketServer.hpp"
 #include "CommandRouter.hpp"
+#include "Deflate.hpp"
+#include "EngineMetrics.hpp"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <regex>
 #include <wincrypt.h>
 #include <iostream>
+#include <climits>
+#include <cstring>
 
 // WebSocket handshake with proper crypto
 #pragma comment(lib, "crypt32.lib")
@@ -18,61 +22,175 @@ WebSocketServer* g_WebSocketServer = nullptr;
 // WebSocket magic string for handshake
 const std::string WEBSOCKET_MAGIC = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 
+// winsock.h has no SD_* names (they live in winsock2.h)
+#ifndef SD_BOTH
+#define SD_BOTH 0x02
+#endif
+
+// The I/O thread wakes at least this often to resume throttled clients and reap closed ones
+static const long IO_POLL_INTERVAL_MS = 20;
+static const size_t RECV_CHUNK_SIZE = 64 * 1024;
+static const size_t MAX_HANDSHAKE_SIZE = 8192;
+
+// A client that sent CLOSE gets this long to take the reply before its socket is shut down
+static const ULONGLONG CLOSE_LINGER_MS = 1000;
+
 // WebSocketConnection Implementation
 WebSocketConnection::WebSocketConnection(SOCKET socket, const std::string& clientAddr)
     : clientSocket(socket), clientAddress(clientAddr), state(WebSocketState::OPEN) {
+    // Blocking sends wait while the send buffer is full - that is the backpressure for
+    // streamed frames - but never longer than SEND_TIMEOUT_MS
+    DWORD timeout = SEND_TIMEOUT_MS;
+    setsockopt(clientSocket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
 }
 
 WebSocketConnection::~WebSocketConnection() {
     Close();
+    closesocket(clientSocket);
 }
 
 bool WebSocketConnection::SendText(const std::string& text) {
-    std::vector<uint8_t> payload(text.begin(), text.end());
-    return SendFrame(WebSocketOpcode::TEXT, payload);
+    return SendFrame(WebSocketOpcode::TEXT, reinterpret_cast<const uint8_t*>(text.data()), text.size());
 }
 
 bool WebSocketConnection::SendBinary(const std::vector<uint8_t>& data) {
-    return SendFrame(WebSocketOpcode::BINARY, data);
+    return SendFrame(WebSocketOpcode::BINARY, data.data(), data.size());
 }
 
 bool WebSocketConnection::SendPing() {
-    return SendFrame(WebSocketOpcode::PING, {});
+    return SendFrame(WebSocketOpcode::PING, nullptr, 0);
 }
 
 bool WebSocketConnection::SendPong() {
-    return SendFrame(WebSocketOpcode::PONG, {});
+    return SendFrame(WebSocketOpcode::PONG, nullptr, 0);
 }
 
 void WebSocketConnection::Close() {
-    if (state != WebSocketState::CLOSED) {
-        state = WebSocketState::CLOSED;
-        if (clientSocket != INVALID_SOCKET) {
-            closesocket(clientSocket);
-            clientSocket = INVALID_SOCKET;
-        }
+    // shutdown() wakes a send blocked on another thread; the handle itself is only closed
+    // with the connection, so it cannot be reused by a new client while a worker holds it
+    if (state.exchange(WebSocketState::CLOSED) != WebSocketState::CLOSED) {
+        shutdown(clientSocket, SD_BOTH);
+    }
+}
+
+void WebSocketConnection::BeginClosing() {
+    WebSocketState expected = WebSocketState::OPEN;
+    state.compare_exchange_strong(expected, WebSocketState::CLOSING);
+}
+
+bool WebSocketConnection::QueueFrame(WebSocketOpcode opcode, const uint8_t* payload, size_t size) {
+    if (state == WebSocketState::CLOSED) return false;
+    
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if (pendingOutput.size() + size > MAX_PENDING_OUTPUT) {
+        Close();
+        return false;
+    }
+    BuildFrame(pendingOutput, opcode, payload, size, false);
+    hasPendingOutput = true;
+    return true;
+}
+
+void WebSocketConnection::FlushPending() {
+    // A sender holding the lock writes the queue itself once its frame is out
+    std::unique_lock<std::mutex> lock(sendMutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        WritePending();
     }
 }
 
-bool WebSocketConnection::SendFrame(WebSocketOpcode opcode, const std::vector<uint8_t>& payload) {
+void WebSocketConnection::WritePending() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if (pendingOutput.empty()) return;
+        pendingOutput.swap(pendingWrite);
+        hasPendingOutput = false;
+    }
+    
+    // Only reached by the I/O thread once select() reported the socket writable, or by a
+    // sender that already owns the stream; queued frames are small
+    bool sent = state != WebSocketState::CLOSED && SendAll(pendingWrite.data(), pendingWrite.size());
+    if (sent) {
+        EngineMetrics::FrameSent(pendingWrite.size(), 0);
+    }
+    pendingWrite.clear();
+    if (!sent) {
+        Close();
+    }
+}
+
+bool WebSocketConnection::SendFrame(WebSocketOpcode opcode, const uint8_t* payload, size_t size) {
     if (state != WebSocketState::OPEN) return false;
     
+    // Compressed outside the send lock so other senders are not held up; the buffer is
+    // per thread and kept between messages
+    static thread_local std::vector<uint8_t> compressed;
+    bool useCompressed = false;
+    bool dataFrame = opcode == WebSocketOpcode::TEXT || opcode == WebSocketOpcode::BINARY;
+    if (compressionWindowBits != 0 && dataFrame && size >= COMPRESSION_THRESHOLD) {
+        compressed.clear();
+        Deflate::Compress(payload, size, compressed, compressionWindowBits);
+        useCompressed = compressed.size() < size;
+    }
+    
     std::lock_guard<std::mutex> lock(sendMutex);
     
-    auto frame = CreateFrame(opcode, payload);
-    int sent = send(clientSocket, reinterpret_cast<const char*>(frame.data()), static_cast<int>(frame.size()), 0);
+    frameBuffer.clear();
+    if (useCompressed) {
+        BuildFrame(frameBuffer, opcode, compressed.data(), compressed.size(), true);
+    } else {
+        BuildFrame(frameBuffer, opcode, payload, size, false);
+    }
+    if (compressed.capacity() > MAX_RETAINED_FRAME_BUFFER) {
+        std::vector<uint8_t>().swap(compressed);
+    }
+    // A send that blocks on a full send buffer shows up as a stall in the metrics
+    uint64_t sendStart = EngineMetrics::Now();
+    bool sent = SendAll(frameBuffer.data(), frameBuffer.size());
+    if (sent) {
+        EngineMetrics::FrameSent(frameBuffer.size(), EngineMetrics::MicrosSince(sendStart));
+    }
     
-    return sent == static_cast<int>(frame.size());
+    // Keep the buffer for the next frame unless a large result made it balloon
+    if (frameBuffer.capacity() > MAX_RETAINED_FRAME_BUFFER) {
+        std::vector<uint8_t>().swap(frameBuffer);
+    }
+    if (sent) {
+        // Frames the I/O thread queued while this one was going out
+        if (hasPendingOutput) {
+            WritePending();
+        }
+        return true;
+    }
+    
+    // A partially written frame leaves the stream unusable
+    Close();
+    return false;
+}
+
+bool WebSocketConnection::SendAll(const uint8_t* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        int chunk = static_cast<int>(min(size - total, static_cast<size_t>(INT_MAX)));
+        int sent = send(clientSocket, reinterpret_cast<const char*>(data + total), chunk, 0);
+        if (sent == SOCKET_ERROR || sent == 0) {
+            return false;
+        }
+        total += static_cast<size_t>(sent);
+    }
+    return true;
 }
 
-std::vector<uint8_t> WebSocketConnection::CreateFrame(WebSocketOpcode opcode, const std::vector<uint8_t>& payload) {
-    std::vector<uint8_t> frame;
+// Header and payload are appended to frame (frameBuffer or the pending queue), which keeps
+// its capacity between sends
+void WebSocketConnection::BuildFrame(std::vector<uint8_t>& frame, WebSocketOpcode opcode, const uint8_t* payload,
+                                     size_t payloadLen, bool compressed) {
+    frame.reserve(frame.size() + payloadLen + 10);
     
-    // First byte: FIN=1, opcode
-    frame.push_back(0x80 | static_cast<uint8_t>(opcode));
+    // First byte: FIN=1, RSV1 for a permessage-deflate message, opcode
+    frame.push_back(static_cast<uint8_t>(0x80 | (compressed ? 0x40 : 0) | static_cast<uint8_t>(opcode)));
     
     // Payload length encoding
-    size_t payloadLen = payload.size();
     if (payloadLen < 126) {
         frame.push_back(static_cast<uint8_t>(payloadLen));
     } else if (payloadLen <= 65535) {
@@ -87,9 +205,139 @@ std::vector<uint8_t> WebSocketConnection::CreateFrame(WebSocketOpcode opcode, co
     }
     
     // Payload
-    frame.insert(frame.end(), payload.begin(), payload.end());
+    frame.insert(frame.end(), payload, payload + payloadLen);
+}
+
+// 📥 소켓 입력 버퍼
+// Growable ring buffer; frames are parsed straight out of it instead of one recv per field
+class ByteRing {
+public:
+    size_t Size() const { return size; }
+    
+    uint8_t At(size_t offset) const {
+        return buffer[(head + offset) & (buffer.size() - 1)];
+    }
+    
+    void Write(const uint8_t* data, size_t length) {
+        Reserve(size + length);
+        size_t mask = buffer.size() - 1;
+        size_t tail = (head + size) & mask;
+        size_t first = min(length, buffer.size() - tail);
+        memcpy(buffer.data() + tail, data, first);
+        memcpy(buffer.data(), data + first, length - first);
+        size += length;
+    }
+    
+    void Peek(size_t offset, uint8_t* out, size_t length) const {
+        size_t mask = buffer.size() - 1;
+        size_t start = (head + offset) & mask;
+        size_t first = min(length, buffer.size() - start);
+        memcpy(out, buffer.data() + start, first);
+        memcpy(out + first, buffer.data(), length - first);
+    }
+    
+    void Consume(size_t length) {
+        size -= length;
+        head = size == 0 ? 0 : (head + length) & (buffer.size() - 1);
+    }
+    
+private:
+    // Capacity stays a power of two so positions wrap with a mask
+    void Reserve(size_t needed) {
+        if (needed <= buffer.size()) return;
+        size_t capacity = buffer.empty() ? 4096 : buffer.size();
+        while (capacity < needed) capacity *= 2;
+        
+        std::vector<uint8_t> grown(capacity);
+        if (size > 0) Peek(0, grown.data(), size);
+        buffer.swap(grown);
+        head = 0;
+    }
+    
+    std::vector<uint8_t> buffer;
+    size_t head = 0;
+    size_t size = 0;
+};
+
+struct WebSocketServer::ClientState {
+    SOCKET socket = INVALID_SOCKET;
+    std::string address;
+    std::string handshake;                          // Request bytes until the upgrade completes
+    ByteRing input;
+    WebSocketConnection* connection = nullptr;      // Owned by connections once upgraded
+    std::atomic<size_t> inFlight{0};
+    bool closing = false;
+    ULONGLONG closeDeadline = 0;                    // Graceful close: shut down by then at the latest
+};
+
+enum class FrameParse {
+    Incomplete,
+    Ready,
+    Invalid
+};
+
+// Parses one complete frame from the front of input; frameSize is the bytes it occupies
+static FrameParse TryParseFrame(const ByteRing& input, WebSocketFrame& frame, size_t& frameSize) {
+    if (input.Size() < 2) return FrameParse::Incomplete;
+    
+    uint8_t first = input.At(0);
+    uint8_t second = input.At(1);
+    size_t position = 2;
+    
+    uint64_t payloadLen = second & 0x7F;
+    if (payloadLen == 126) {
+        if (input.Size() < 4) return FrameParse::Incomplete;
+        payloadLen = (static_cast<uint64_t>(input.At(2)) << 8) | input.At(3);
+        position = 4;
+    } else if (payloadLen == 127) {
+        if (input.Size() < 10) return FrameParse::Incomplete;
+        payloadLen = 0;
+        for (size_t i = 0; i < 8; i++) {
+            payloadLen = (payloadLen << 8) | input.At(2 + i);
+        }
+        position = 10;
+    }
+    if (payloadLen > WebSocketServer::MAX_FRAME_SIZE) return FrameParse::Invalid;
+    
+    bool masked = (second & 0x80) != 0;
+    uint8_t mask[4] = {0};
+    if (masked) {
+        if (input.Size() < position + 4) return FrameParse::Incomplete;
+        input.Peek(position, mask, 4);
+        position += 4;
+    }
+    
+    if (input.Size() - position < payloadLen) return FrameParse::Incomplete;
+    
+    frame.opcode = static_cast<WebSocketOpcode>(first & 0x0F);
+    frame.masked = masked;
+    frame.compressed = (first & 0x40) != 0;
+    frame.payloadLength = payloadLen;
+    frame.payload.resize(static_cast<size_t>(payloadLen));
+    if (payloadLen > 0) {
+        input.Peek(position, frame.payload.data(), frame.payload.size());
+        if (masked) {
+            for (size_t i = 0; i < frame.payload.size(); i++) {
+                frame.payload[i] ^= mask[i & 3];
+            }
+        }
+    }
     
-    return frame;
+    frameSize = position + static_cast<size_t>(payloadLen);
+    return FrameParse::Ready;
+}
+
+// permessage-deflate message -> original payload (RFC 7692 7.2.2: append 00 00 FF FF, inflate)
+static bool InflateMessage(std::vector<uint8_t>& payload) {
+    static const uint8_t TAIL[4] = { 0x00, 0x00, 0xFF, 0xFF };
+    payload.insert(payload.end(), TAIL, TAIL + 4);
+    
+    std::vector<uint8_t> inflated;
+    if (!Deflate::Inflate(payload.data(), payload.size(), inflated, WebSocketServer::MAX_FRAME_SIZE)) {
+        return false;
+    }
+    payload.swap(inflated);
+    return true;
 }
 
 // WebSocketServer Implementation
@@ -138,12 +386,13 @@ bool WebSocketServer::Start(int port) {
     
     running = true;
     stopping = false;
+    workersStopping = false;
     
-    // Start accept thread
-    acceptThread = std::thread(&WebSocketServer::AcceptLoop, this);
-    
-    // Start message processor thread for performance
-    messageProcessor = std::thread(&WebSocketServer::ProcessMessages, this);
+    // Command workers first so the I/O thread can hand frames off immediately
+    for (size_t i = 0; i < COMMAND_WORKER_COUNT; i++) {
+        workerThreads.emplace_back(&WebSocketServer::WorkerLoop, this);
+    }
+    ioThread = std::thread(&WebSocketServer::IoLoop, this);
     
     return true;
 }
@@ -154,21 +403,24 @@ void WebSocketServer::Stop() {
     stopping = true;
     running = false;
     
-    // Close server socket
+    // The I/O thread notices within one poll interval and closes every client
+    if (ioThread.joinable()) {
+        ioThread.join();
+    }
+    
     if (serverSocket != INVALID_SOCKET) {
         closesocket(serverSocket);
         serverSocket = INVALID_SOCKET;
     }
     
-    // Wait for threads to finish
-    if (acceptThread.joinable()) {
-        acceptThread.join();
-    }
-    
-    if (messageProcessor.joinable()) {
-        messageProcessor.join();
+    // Queued commands are dropped; running ones fail fast on their closed sockets
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        workersStopping = true;
+        EngineMetrics::CommandsDropped(tasks.size());
+        tasks.clear();
     }
-    
+    tasksReady.notify_all();
     for (auto& worker : workerThreads) {
         if (worker.joinable()) {
             worker.join();
@@ -176,6 +428,16 @@ void WebSocketServer::Stop() {
     }
     workerThreads.clear();
     
+    // Teardowns no worker got to still owe their disconnect notification
+    for (auto& client : teardowns) {
+        FinalizeClient(*client);
+    }
+    teardowns.clear();
+    for (auto& client : clients) {
+        FinalizeClient(*client);
+    }
+    clients.clear();
+    
     // Close all connections
     {
         std::lock_guard<std::mutex> lock(connectionsMutex);
@@ -183,56 +445,264 @@ void WebSocketServer::Stop() {
     }
 }
 
-void WebSocketServer::AcceptLoop() {
+void WebSocketServer::IoLoop() {
     while (running && !stopping) {
-        sockaddr_in clientAddr;
-        int clientAddrLen = sizeof(clientAddr);
+        fd_set readSet;
+        fd_set writeSet;
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        FD_SET(serverSocket, &readSet);
         
-        SOCKET clientSocket = accept(serverSocket, reinterpret_cast<sockaddr*>(&clientAddr), &clientAddrLen);
-        
-        if (clientSocket == INVALID_SOCKET) {
-            if (running) {
-                // Accept error, but continue if server is still running
-                Sleep(10);
+        for (const auto& client : clients) {
+            // Throttled clients stay unread (TCP backpressure) until their commands drain
+            if (!client->closing && client->inFlight < MAX_INFLIGHT_PER_CLIENT) {
+                FD_SET(client->socket, &readSet);
+            }
+            if (client->connection && client->connection->HasPendingOutput()) {
+                FD_SET(client->socket, &writeSet);
             }
+        }
+        
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = IO_POLL_INTERVAL_MS * 1000;
+        
+        int ready = select(0, &readSet, &writeSet, nullptr, &timeout);
+        if (ready == SOCKET_ERROR) {
+            Sleep(10);
             continue;
         }
         
-        // Get client address string (Windows compatible)
-        std::string clientAddrString = std::string(inet_ntoa(clientAddr.sin_addr)) + ":" + std::to_string(ntohs(clientAddr.sin_port));
+        if (ready > 0 && FD_ISSET(serverSocket, &readSet)) {
+            AcceptClient();
+        }
         
-        // Process client in separate thread for high performance
-        workerThreads.emplace_back(&WebSocketServer::ProcessClient, this, clientSocket, clientAddrString);
+        for (size_t i = 0; i < clients.size(); i++) {
+            auto& client = clients[i];
+            if (ready > 0 && client->connection && FD_ISSET(client->socket, &writeSet)) {
+                client->connection->FlushPending();
+            }
+            if (ready > 0 && !client->closing && FD_ISSET(client->socket, &readSet)) {
+                ReadClient(client);
+            }
+            
+            // Frames left buffered while the client was throttled
+            if (!client->closing && client->connection) {
+                ParseFrames(client);
+            }
+        }
+        
+        // A graceful close ends once its reply is written; closed clients are reaped once no
+        // worker still uses them. The disconnect notification waits on the publishers (which may
+        // be mid-send to another, slow client), so it runs on a worker instead of stalling I/O.
+        ULONGLONG now = GetTickCount64();
+        for (auto it = clients.begin(); it != clients.end();) {
+            WebSocketConnection* connection = (*it)->connection;
+            if ((*it)->closing && connection && !connection->IsClosed() &&
+                (!connection->HasPendingOutput() || now >= (*it)->closeDeadline)) {
+                connection->Close();
+            }
+            if ((*it)->closing && (*it)->inFlight == 0 && (!connection || connection->IsClosed())) {
+                if (connection) {
+                    {
+                        std::lock_guard<std::mutex> lock(tasksMutex);
+                        teardowns.push_back(*it);
+                    }
+                    tasksReady.notify_one();
+                } else {
+                    FinalizeClient(**it);
+                }
+                it = clients.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    for (auto& client : clients) {
+        BeginClose(*client);
     }
 }
 
-void WebSocketServer::ProcessClient(SOCKET clientSocket, const std::string& clientAddr) {
-    // Perform WebSocket handshake
-    if (!PerformHandshake(clientSocket)) {
+void WebSocketServer::AcceptClient() {
+    sockaddr_in clientAddr;
+    int clientAddrLen = sizeof(clientAddr);
+    
+    SOCKET clientSocket = accept(serverSocket, reinterpret_cast<sockaddr*>(&clientAddr), &clientAddrLen);
+    if (clientSocket == INVALID_SOCKET) {
+        return;
+    }
+    
+    if (clients.size() >= MAX_CLIENTS) {
+        OutputDebugStringA("[WebSocket] Too many clients - connection refused\n");
         closesocket(clientSocket);
         return;
     }
     
-    // Create connection object
-    auto connection = std::make_unique<WebSocketConnection>(clientSocket, clientAddr);
-    WebSocketConnection* connPtr = connection.get();
+    // Get client address string (Windows compatible)
+    auto client = std::make_shared<ClientState>();
+    client->socket = clientSocket;
+    client->address = std::string(inet_ntoa(clientAddr.sin_addr)) + ":" + std::to_string(ntohs(clientAddr.sin_port));
+    clients.push_back(std::move(client));
+}
+
+void WebSocketServer::ReadClient(const std::shared_ptr<ClientState>& client) {
+    // The socket is readable, so this returns without blocking
+    static thread_local std::vector<char> chunk(RECV_CHUNK_SIZE);
+    int received = recv(client->socket, chunk.data(), static_cast<int>(chunk.size()), 0);
+    if (received <= 0) {
+        BeginClose(*client);
+        return;
+    }
+    
+    if (client->connection) {
+        client->input.Write(reinterpret_cast<const uint8_t*>(chunk.data()), static_cast<size_t>(received));
+        return;
+    }
+    
+    // Still upgrading: collect the HTTP request up to the blank line
+    client->handshake.append(chunk.data(), static_cast<size_t>(received));
+    size_t headerEnd = client->handshake.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) {
+        if (client->handshake.size() > MAX_HANDSHAKE_SIZE) {
+            BeginClose(*client);
+        }
+        return;
+    }
     
-    // Add to connections list
+    std::string request = client->handshake.substr(0, headerEnd + 4);
+    std::string leftover = client->handshake.substr(headerEnd + 4);
+    std::string().swap(client->handshake);
+    
+    size_t deflateWindowBits = 0;
+    if (!PerformHandshake(client->socket, request, deflateWindowBits)) {
+        BeginClose(*client);
+        return;
+    }
+    
+    // Create connection object
+    auto connection = std::make_unique<WebSocketConnection>(client->socket, client->address);
+    connection->EnableCompression(deflateWindowBits);
+    client->connection = connection.get();
     {
         std::lock_guard<std::mutex> lock(connectionsMutex);
         connections.push_back(std::move(connection));
     }
+    EngineMetrics::ConnectionOpened();
     
     // Notify connection handler
     if (connectionHandler) {
-        connectionHandler(connPtr, true);
+        connectionHandler(client->connection, true);
     }
     
-    // Process messages from this client
-    while (running && connPtr->IsConnected()) {
-        try {
-            WebSocketFrame frame = ReadFrame(clientSocket);
-            
+    // A client may pipeline its first frame right behind the request
+    if (!leftover.empty()) {
+        client->input.Write(reinterpret_cast<const uint8_t*>(leftover.data()), leftover.size());
+    }
+}
+
+void WebSocketServer::ParseFrames(const std::shared_ptr<ClientState>& client) {
+    while (!client->closing && client->inFlight < MAX_INFLIGHT_PER_CLIENT) {
+        WebSocketFrame frame;
+        size_t frameSize = 0;
+        FrameParse result = TryParseFrame(client->input, frame, frameSize);
+        if (result == FrameParse::Incomplete) return;
+        if (result == FrameParse::Invalid) {
+            BeginClose(*client);
+            return;
+        }
+        client->input.Consume(frameSize);
+        EngineMetrics::FrameReceived(frameSize);
+        
+        // Only data frames of a connection that negotiated permessage-deflate may be compressed
+        if (frame.compressed) {
+            bool dataFrame = frame.opcode == WebSocketOpcode::TEXT || frame.opcode == WebSocketOpcode::BINARY;
+            if (!dataFrame || !client->connection->IsCompressionEnabled() || !InflateMessage(frame.payload)) {
+                BeginClose(*client);
+                return;
+            }
+            frame.compressed = false;
+            frame.payloadLength = frame.payload.size();
+        }
+        
+        // Control commands (e.g. command.cancel) must not wait behind the commands they target
+        if (frame.opcode == WebSocketOpcode::TEXT && controlHandler) {
+            std::string response;
+            try {
+                response = controlHandler(std::string(frame.payload.begin(), frame.payload.end()), client->connection);
+            } catch (...) {
+                BeginClose(*client);
+                return;
+            }
+            if (!response.empty()) {
+                client->connection->QueueFrame(WebSocketOpcode::TEXT, reinterpret_cast<const uint8_t*>(response.data()),
+                                               response.size());
+                continue;
+            }
+        }
+        
+        switch (frame.opcode) {
+            case WebSocketOpcode::TEXT:
+            case WebSocketOpcode::BINARY: {
+                // Commands run on the worker pool; the client's inFlight count keeps it alive
+                client->inFlight++;
+                auto shared = client;
+                auto task = std::make_shared<WebSocketFrame>(std::move(frame));
+                {
+                    std::lock_guard<std::mutex> lock(tasksMutex);
+                    tasks.push_back([this, shared, task]() { ExecuteFrame(shared, *task); });
+                    EngineMetrics::CommandQueued();
+                }
+                tasksReady.notify_one();
+                break;
+            }
+            case WebSocketOpcode::PING:
+                // The PONG echoes the PING's application data
+                client->connection->QueueFrame(WebSocketOpcode::PONG, frame.payload.data(), frame.payload.size());
+                break;
+            case WebSocketOpcode::CLOSE:
+                // The reply echoes the status code, if the client sent one
+                client->connection->QueueFrame(WebSocketOpcode::CLOSE, frame.payload.data(),
+                                               min(frame.payload.size(), static_cast<size_t>(2)));
+                BeginClose(*client, true);
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+void WebSocketServer::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        std::shared_ptr<ClientState> teardown;
+        {
+            std::unique_lock<std::mutex> lock(tasksMutex);
+            tasksReady.wait(lock, [this] { return workersStopping || !tasks.empty() || !teardowns.empty(); });
+            if (workersStopping) return;
+            if (!teardowns.empty()) {
+                teardown = std::move(teardowns.front());
+                teardowns.pop_front();
+            } else {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                EngineMetrics::CommandDequeued();
+            }
+        }
+        if (teardown) {
+            FinalizeClient(*teardown);
+            continue;
+        }
+        task();
+        EngineMetrics::CommandFinished();
+    }
+}
+
+void WebSocketServer::ExecuteFrame(const std::shared_ptr<ClientState>& client, const WebSocketFrame& frame) {
+    WebSocketConnection* connPtr = client->connection;
+    
+    try {
+        if (connPtr->IsConnected()) {
             if (frame.opcode == WebSocketOpcode::TEXT && messageHandler) {
                 std::string message(frame.payload.begin(), frame.payload.end());
                 
@@ -241,38 +711,133 @@ void WebSocketServer::ProcessClient(SOCKET clientSocket, const std::string& clie
                 if (!response.empty()) {
                     connPtr->SendText(response);
                 }
-            } else if (frame.opcode == WebSocketOpcode::PING) {
-                connPtr->SendPong();
-            } else if (frame.opcode == WebSocketOpcode::CLOSE) {
-                break;
+            } else if (frame.opcode == WebSocketOpcode::BINARY && binaryHandler) {
+                // Binary protocol commands skip JSON entirely
+                std::vector<uint8_t> response = binaryHandler(frame.payload, connPtr);
+                if (!response.empty()) {
+                    connPtr->SendBinary(response);
+                }
             }
-        } catch (...) {
-            // Connection error, break the loop
-            break;
         }
+    } catch (...) {
+        // Handler failure: drop the connection like a read error did before
+        connPtr->Close();
     }
     
-    // Notify disconnection
-    if (connectionHandler) {
-        connectionHandler(connPtr, false);
-    }
+    client->inFlight--;
+}
+
+void WebSocketServer::BeginClose(ClientState& client, bool graceful) {
+    if (client.closing) return;
+    client.closing = true;
     
-    // Remove from connections list
-    RemoveConnection(connPtr);
+    if (client.connection) {
+        if (closingHandler) {
+            closingHandler(client.connection);
+        }
+        if (graceful) {
+            client.connection->BeginClosing();
+            client.closeDeadline = GetTickCount64() + CLOSE_LINGER_MS;
+        } else {
+            client.connection->Close();
+        }
+    } else {
+        shutdown(client.socket, SD_BOTH);
+    }
 }
 
-bool WebSocketServer::PerformHandshake(SOCKET clientSocket) {
-    // Read HTTP request
-    char buffer[4096];
-    int received = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
-    if (received <= 0) {
-        OutputDebugStringA("[WebSocket] Failed to receive handshake request\n");
-        return false;
+void WebSocketServer::FinalizeClient(ClientState& client) {
+    if (client.connection) {
+        // Notify disconnection
+        if (connectionHandler) {
+            connectionHandler(client.connection, false);
+        }
+        
+        // Remove from connections list (closes the socket)
+        RemoveConnection(client.connection);
+        client.connection = nullptr;
+        EngineMetrics::ConnectionClosed();
+    } else if (client.socket != INVALID_SOCKET) {
+        closesocket(client.socket);
     }
-    
-    buffer[received] = '\0';
-    std::string request(buffer);
-    
+    client.socket = INVALID_SOCKET;
+}
+
+static std::string TrimSpaces(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+// Values of every header line called name (case-insensitive), joined with ','
+static std::string FindHeaderValues(const std::string& request, const std::string& name) {
+    std::string values;
+    size_t lineStart = request.find("\r\n");
+    while (lineStart != std::string::npos) {
+        lineStart += 2;
+        size_t lineEnd = request.find("\r\n", lineStart);
+        if (lineEnd == std::string::npos || lineEnd == lineStart) break;
+        
+        if (lineEnd - lineStart > name.size() && request[lineStart + name.size()] == ':' &&
+            _strnicmp(request.c_str() + lineStart, name.c_str(), name.size()) == 0) {
+            if (!values.empty()) values += ',';
+            values += TrimSpaces(request.substr(lineStart + name.size() + 1, lineEnd - lineStart - name.size() - 1));
+        }
+        lineStart = lineEnd;
+    }
+    return values;
+}
+
+// Accepts the first permessage-deflate offer whose parameters we understand (RFC 7692 7.1).
+// Context takeover is always turned off both ways; a server_max_window_bits request limits
+// how far back our matches may reach and is echoed in the response.
+static bool NegotiateDeflate(const std::string& offers, std::string& accepted, size_t& windowBits) {
+    std::stringstream offerList(offers);
+    std::string offer;
+    while (std::getline(offerList, offer, ',')) {
+        std::stringstream parts(offer);
+        std::string token;
+        if (!std::getline(parts, token, ';') || TrimSpaces(token) != "permessage-deflate") continue;
+        
+        bool valid = true;
+        bool windowRequested = false;
+        size_t bits = Deflate::MAX_WINDOW_BITS;
+        while (valid && std::getline(parts, token, ';')) {
+            std::string name = TrimSpaces(token);
+            std::string value;
+            size_t equals = name.find('=');
+            if (equals != std::string::npos) {
+                value = TrimSpaces(name.substr(equals + 1));
+                name = TrimSpaces(name.substr(0, equals));
+                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                    value = value.substr(1, value.size() - 2);
+                }
+            }
+            
+            if (name == "server_max_window_bits") {
+                int requested = atoi(value.c_str());
+                valid = requested >= 8 && requested <= static_cast<int>(Deflate::MAX_WINDOW_BITS);
+                bits = static_cast<size_t>(requested);
+                windowRequested = true;
+            } else if (name != "client_max_window_bits" && name != "server_no_context_takeover" &&
+                       name != "client_no_context_takeover") {
+                valid = false;
+            }
+        }
+        if (!valid) continue;
+        
+        accepted = "permessage-deflate; server_no_context_takeover; client_no_context_takeover";
+        if (windowRequested) {
+            accepted += "; server_max_window_bits=" + std::to_string(bits);
+        }
+        windowBits = bits;
+        return true;
+    }
+    return false;
+}
+
+bool WebSocketServer::PerformHandshake(SOCKET clientSocket, const std::string& request, size_t& deflateWindowBits) {
     // Debug: Log the request
     std::cout << "[WebSocket] Handshake request received" << std::endl;
     OutputDebugStringA(("[WebSocket] Received request:\n" + request + "\n").c_str());
@@ -334,13 +899,24 @@ bool WebSocketServer::PerformHandshake(SOCKET clientSocket) {
     OutputDebugStringA(("[WebSocket] Combined string: '" + combined + "'\n").c_str());
     OutputDebugStringA(("[WebSocket] Accept key: '" + acceptKey + "'\n").c_str());
     
+    // Compression is only used when the client offered it
+    std::string extensions;
+    deflateWindowBits = 0;
+    if (!NegotiateDeflate(FindHeaderValues(request, "Sec-WebSocket-Extensions"), extensions, deflateWindowBits)) {
+        extensions.clear();
+        deflateWindowBits = 0;
+    }
+    
     // Send handshake response
     std::string response = 
         "HTTP/1.1 101 Switching Protocols\r\n"
         "Upgrade: websocket\r\n"
         "Connection: Upgrade\r\n"
-        "Sec-WebSocket-Accept: " + acceptKey + "\r\n"
-        "\r\n";
+        "Sec-WebSocket-Accept: " + acceptKey + "\r\n";
+    if (!extensions.empty()) {
+        response += "Sec-WebSocket-Extensions: " + extensions + "\r\n";
+    }
+    response += "\r\n";
     
     // Debug: Log the response
     OutputDebugStringA(("[WebSocket] Sending response:\n" + response + "\n").c_str());
@@ -412,72 +988,6 @@ std::string WebSocketServer::GenerateWebSocketKey(const std::string& clientKey)
     return SimpleBase64Encode(binaryHash);
 }
 
-WebSocketFrame WebSocketServer::ReadFrame(SOCKET clientSocket) {
-    WebSocketFrame frame;
-    
-    // Read first two bytes
-    uint8_t header[2];
-    if (recv(clientSocket, reinterpret_cast<char*>(header), 2, 0) != 2) {
-        throw std::runtime_error("Failed to read frame header");
-    }
-    
-    frame.opcode = static_cast<WebSocketOpcode>(header[0] & 0x0F);
-    frame.masked = (header[1] & 0x80) != 0;
-    
-    // Read payload length
-    uint64_t payloadLen = header[1] & 0x7F;
-    if (payloadLen == 126) {
-        uint8_t extLen[2];
-        if (recv(clientSocket, reinterpret_cast<char*>(extLen), 2, 0) != 2) {
-            throw std::runtime_error("Failed to read extended length");
-        }
-        payloadLen = (extLen[0] << 8) | extLen[1];
-    } else if (payloadLen == 127) {
-        uint8_t extLen[8];
-        if (recv(clientSocket, reinterpret_cast<char*>(extLen), 8, 0) != 8) {
-            throw std::runtime_error("Failed to read extended length");
-        }
-        payloadLen = 0;
-        for (int i = 0; i < 8; i++) {
-            payloadLen = (payloadLen << 8) | extLen[i];
-        }
-    }
-    
-    frame.payloadLength = payloadLen;
-    
-    // Read mask if present
-    uint8_t mask[4] = {0};
-    if (frame.masked) {
-        if (recv(clientSocket, reinterpret_cast<char*>(mask), 4, 0) != 4) {
-            throw std::runtime_error("Failed to read mask");
-        }
-    }
-    
-    // Read payload
-    frame.payload.resize(static_cast<size_t>(payloadLen));
-    if (payloadLen > 0) {
-        int totalReceived = 0;
-        while (totalReceived < static_cast<int>(payloadLen)) {
-            int received = recv(clientSocket, 
-                              reinterpret_cast<char*>(frame.payload.data()) + totalReceived, 
-                              static_cast<int>(payloadLen) - totalReceived, 0);
-            if (received <= 0) {
-                throw std::runtime_error("Failed to read payload");
-            }
-            totalReceived += received;
-        }
-        
-        // Unmask payload if needed
-        if (frame.masked) {
-            for (size_t i = 0; i < frame.payload.size(); i++) {
-                frame.payload[i] ^= mask[i % 4];
-            }
-        }
-    }
-    
-    return frame;
-}
-
 void WebSocketServer::BroadcastText(const std::string& text) {
     std::lock_guard<std::mutex> lock(connectionsMutex);
     for (auto& conn : connections) {
@@ -523,19 +1033,6 @@ std::vector<WebSocketConnection*> WebSocketServer::GetConnections() const {
     return result;
 }
 
-void WebSocketServer::ProcessMessages() {
-    while (running) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        
-        std::lock_guard<std::mutex> lock(queueMutex);
-        while (!messageQueue.empty()) {
-            std::string message = messageQueue.front();
-            messageQueue.pop();
-            BroadcastText(message);
-        }
-    }
-}
-
 void WebSocketServer::RemoveConnection(WebSocketConnection* conn) {
     std::lock_guard<std::mutex> lock(connectionsMutex);
     connections.erase(
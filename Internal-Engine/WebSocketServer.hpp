@@ -6,8 +6,10 @@
 #include <vector>
 #include <functional>
 #include <atomic>
-#include <queue>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <condition_variable>
 #include <unordered_map>
 
 #include <winsock.h>
@@ -37,6 +39,7 @@ enum class WebSocketState {
 struct WebSocketFrame {
     WebSocketOpcode opcode;
     bool masked;
+    bool compressed = false;    // RSV1: permessage-deflate message
     uint64_t payloadLength;
     std::vector<uint8_t> payload;
 };
@@ -44,6 +47,19 @@ struct WebSocketFrame {
 // WebSocket connection
 class WebSocketConnection {
 public:
+    // A send that cannot make progress this long (client not reading) drops the connection
+    static const DWORD SEND_TIMEOUT_MS = 5000;
+    
+    // The reusable frame buffer is released after a frame larger than this
+    static const size_t MAX_RETAINED_FRAME_BUFFER = 1024 * 1024;
+    
+    // permessage-deflate: smaller messages are sent as they are
+    static const size_t COMPRESSION_THRESHOLD = 1024;
+    
+    // A client that lets this much queued output pile up (e.g. PINGs it never reads the
+    // PONGs of) is dropped
+    static const size_t MAX_PENDING_OUTPUT = 64 * 1024;
+
     WebSocketConnection(SOCKET socket, const std::string& clientAddr);
     ~WebSocketConnection();
     
@@ -53,24 +69,75 @@ public:
     bool SendPong();
     void Close();
     
+    // Frames sent from the I/O thread (PONG, CLOSE, control command replies) are queued
+    // uncompressed instead of sent: the I/O thread writes the queue when the socket is
+    // writable and the send lock is free, and a sender writes it right after its own frame.
+    bool QueueFrame(WebSocketOpcode opcode, const uint8_t* payload, size_t size);
+    bool HasPendingOutput() const { return hasPendingOutput; }
+    void FlushPending();
+    
+    // Refuses further frames but leaves the socket open until Close(), so a queued CLOSE
+    // reply can still go out
+    void BeginClosing();
+    
     bool IsConnected() const { return state == WebSocketState::OPEN; }
+    bool IsClosed() const { return state == WebSocketState::CLOSED; }
     std::string GetClientAddress() const { return clientAddress; }
     
+    // Set once after the handshake negotiated permessage-deflate (0 = off)
+    void EnableCompression(size_t windowBits) { compressionWindowBits = windowBits; }
+    bool IsCompressionEnabled() const { return compressionWindowBits != 0; }
+    
 private:
     SOCKET clientSocket;
     std::string clientAddress;
-    WebSocketState state;
+    std::atomic<WebSocketState> state;
     std::mutex sendMutex;
+    std::vector<uint8_t> frameBuffer;   // Guarded by sendMutex
+    size_t compressionWindowBits = 0;
+    
+    std::mutex pendingMutex;
+    std::vector<uint8_t> pendingOutput;     // Guarded by pendingMutex
+    std::vector<uint8_t> pendingWrite;      // Guarded by sendMutex
+    std::atomic<bool> hasPendingOutput{false};
     
-    bool SendFrame(WebSocketOpcode opcode, const std::vector<uint8_t>& payload);
-    std::vector<uint8_t> CreateFrame(WebSocketOpcode opcode, const std::vector<uint8_t>& payload);
+    bool SendFrame(WebSocketOpcode opcode, const uint8_t* payload, size_t size);
+    bool SendAll(const uint8_t* data, size_t size);
+    void WritePending();    // sendMutex must be held
+    
+    // Appends one frame (header and payload) to frame
+    static void BuildFrame(std::vector<uint8_t>& frame, WebSocketOpcode opcode, const uint8_t* payload,
+                           size_t payloadLen, bool compressed);
 };
 
 // High-performance WebSocket server for DLL
+// One I/O thread multiplexes the listening socket and every client with select(), buffers
+// input per client and parses frames out of that buffer. TEXT/BINARY commands run on a
+// fixed pool of command workers, so a slow scan never stalls another client's traffic;
+// control frames (PING/CLOSE) and control commands (see SetControlHandler) are answered on
+// the I/O thread without blocking it: their replies are queued on the connection and written
+// once the socket is writable. A client's CLOSE is answered before its socket is shut down.
+// Disconnect notifications also run on the workers, since they may wait on a publisher.
+// Clients offering permessage-deflate get it without context takeover in either direction:
+// every message is compressed on its own, and only messages of COMPRESSION_THRESHOLD bytes
+// or more that actually shrink are sent compressed.
 class WebSocketServer {
 public:
+    // select() is limited to FD_SETSIZE sockets, one of which is the listener
+    static const size_t MAX_CLIENTS = FD_SETSIZE - 1;
+    static const size_t COMMAND_WORKER_COUNT = 4;
+    
+    // A client with this many commands queued or running is not read until one finishes
+    static const size_t MAX_INFLIGHT_PER_CLIENT = 16;
+    
+    // Larger frames drop the connection instead of growing its input buffer
+    static const size_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+    
+
     using MessageHandler = std::function<std::string(const std::string& message, WebSocketConnection* conn)>;
+    using BinaryHandler = std::function<std::vector<uint8_t>(const std::vector<uint8_t>& message, WebSocketConnection* conn)>;
     using ConnectionHandler = std::function<void(WebSocketConnection* conn, bool connected)>;
+    using ClosingHandler = std::function<void(WebSocketConnection* conn)>;
     
     WebSocketServer();
     ~WebSocketServer();
@@ -82,8 +149,17 @@ public:
     
     // Event handlers
     void SetMessageHandler(MessageHandler handler) { messageHandler = handler; }
+    void SetBinaryHandler(BinaryHandler handler) { binaryHandler = handler; }
     void SetConnectionHandler(ConnectionHandler handler) { connectionHandler = handler; }
     
+    // Tried on the I/O thread for every TEXT frame before it is queued; a non-empty response
+    // is queued for sending right away and the frame is not queued. Must be quick and must not block.
+    void SetControlHandler(MessageHandler handler) { controlHandler = handler; }
+    
+    // Called on the I/O thread when a client starts closing, before its running commands
+    // finish (the disconnect notification only comes once they have)
+    void SetClosingHandler(ClosingHandler handler) { closingHandler = handler; }
+    
     // Broadcasting
     void BroadcastText(const std::string& text);
     void BroadcastBinary(const std::vector<uint8_t>& data);
@@ -97,33 +173,47 @@ public:
     void StreamMemoryUpdate(const std::string& address, const std::string& newValue);
     
 private:
+    struct ClientState;
+    
     SOCKET serverSocket;
     std::atomic<bool> running;
     std::atomic<bool> stopping;
     
-    std::thread acceptThread;
+    std::thread ioThread;
+    std::vector<std::shared_ptr<ClientState>> clients;    // I/O thread only
+    
+    // Command workers
     std::vector<std::thread> workerThreads;
+    std::deque<std::function<void()>> tasks;
+    std::deque<std::shared_ptr<ClientState>> teardowns;    // Reaped clients awaiting FinalizeClient; taken first
+    std::mutex tasksMutex;
+    std::condition_variable tasksReady;
+    bool workersStopping = false;
     
     std::vector<std::unique_ptr<WebSocketConnection>> connections;
     mutable std::mutex connectionsMutex;
     
     MessageHandler messageHandler;
+    BinaryHandler binaryHandler;
     ConnectionHandler connectionHandler;
-    
-    // Performance optimization
-    std::queue<std::string> messageQueue;
-    std::mutex queueMutex;
-    std::thread messageProcessor;
-    
-    void AcceptLoop();
-    void ProcessClient(SOCKET clientSocket, const std::string& clientAddr);
-    void ProcessMessages();
-    
-    bool PerformHandshake(SOCKET clientSocket);
-    WebSocketFrame ReadFrame(SOCKET clientSocket);
+    MessageHandler controlHandler;
+    ClosingHandler closingHandler;
+    
+    void IoLoop();
+    void WorkerLoop();
+    void AcceptClient();
+    void ReadClient(const std::shared_ptr<ClientState>& client);
+    void ParseFrames(const std::shared_ptr<ClientState>& client);
+    void ExecuteFrame(const std::shared_ptr<ClientState>& client, const WebSocketFrame& frame);
+    // graceful leaves the socket open until the queued CLOSE reply is written (or times out)
+    void BeginClose(ClientState& client, bool graceful = false);
+    // Notifies the disconnect and frees the connection; runs on a worker (or in Stop), never on the I/O thread
+    void FinalizeClient(ClientState& client);
+    
+    // deflateWindowBits receives the negotiated permessage-deflate window (0 = not negotiated)
+    bool PerformHandshake(SOCKET clientSocket, const std::string& request, size_t& deflateWindowBits);
     std::string GenerateWebSocketKey(const std::string& clientKey);
     
-    void CleanupConnections();
     void RemoveConnection(WebSocketConnection* conn);
 };
 
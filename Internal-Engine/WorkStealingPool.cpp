@@ -0,0 +1,188 @@
+#include "WorkStealingPool.hpp"
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <condition_variable>
+#include <system_error>
+#include <algorithm>
+
+namespace InternalEngine {
+
+namespace {
+
+struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+
+    bool PopFront(size_t& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+    bool StealBack(size_t& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+};
+
+// One Run. Helpers claim worker slots 1..workerCount-1; slot 0 is the caller.
+struct Job {
+    const WorkStealingPool::Task* task = nullptr;
+    size_t workerCount = 0;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    size_t nextSlot = 1;            // Guarded by g_poolMutex
+    size_t activeHelpers = 0;       // Guarded by g_poolMutex
+
+    std::mutex errorMutex;
+    std::exception_ptr firstError;
+};
+
+// Never destroyed: parked threads still wait on these when a process exits without Shutdown
+// (a static std::thread that is still joinable would call std::terminate)
+std::mutex& g_poolMutex = *new std::mutex();
+std::condition_variable& g_workAvailable = *new std::condition_variable();
+std::condition_variable& g_helperLeft = *new std::condition_variable();
+std::deque<Job*>& g_openJobs = *new std::deque<Job*>();    // Runs that still have free helper slots
+std::vector<std::thread>& g_threads = *new std::vector<std::thread>();
+bool g_stopping = false;
+
+void WorkerLoop(Job& job, size_t workerIndex) {
+    size_t taskIndex = 0;
+    for (;;) {
+        bool found = job.queues[workerIndex]->PopFront(taskIndex);
+
+        // Own queue drained - try to steal from the other workers
+        for (size_t offset = 1; !found && offset < job.workerCount; offset++) {
+            found = job.queues[(workerIndex + offset) % job.workerCount]->StealBack(taskIndex);
+        }
+
+        // Tasks never spawn new tasks, so empty queues everywhere means we are done
+        if (!found) return;
+
+        try {
+            (*job.task)(taskIndex, workerIndex);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.errorMutex);
+            if (!job.firstError) job.firstError = std::current_exception();
+        }
+    }
+}
+
+void PoolThread() {
+    std::unique_lock<std::mutex> lock(g_poolMutex);
+    for (;;) {
+        g_workAvailable.wait(lock, [] { return g_stopping || !g_openJobs.empty(); });
+        if (g_stopping) return;
+
+        Job* job = g_openJobs.front();
+        size_t slot = job->nextSlot++;
+        if (job->nextSlot >= job->workerCount) g_openJobs.pop_front();
+        job->activeHelpers++;
+
+        lock.unlock();
+        WorkerLoop(*job, slot);
+        lock.lock();
+
+        // The caller waits for this before the job (and its captures) go away
+        if (--job->activeHelpers == 0) g_helperLeft.notify_all();
+    }
+}
+
+// Caller holds g_poolMutex. A thread that cannot be created just leaves the pool smaller.
+void EnsureThreads(size_t helperCount) {
+    if (g_threads.capacity() < WorkStealingPool::MAX_THREADS) g_threads.reserve(WorkStealingPool::MAX_THREADS);
+    while (!g_stopping && g_threads.size() < helperCount) {
+        try {
+            g_threads.emplace_back(PoolThread);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+}
+
+} // namespace
+
+size_t WorkStealingPool::ResolveThreadCount(size_t requested) {
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    size_t limit = hardwareThreads == 0 ? 1 : hardwareThreads;
+    if (limit > MAX_THREADS) limit = MAX_THREADS;
+    return (requested == 0 || requested > limit) ? limit : requested;
+}
+
+void WorkStealingPool::Run(size_t taskCount, size_t threadCount, const Task& task) {
+    if (taskCount == 0) return;
+
+    size_t workerCount = ResolveThreadCount(threadCount);
+    if (workerCount > taskCount) workerCount = taskCount;
+
+    // Single worker: run inline without any scheduling overhead
+    if (workerCount <= 1) {
+        for (size_t i = 0; i < taskCount; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    // Contiguous initial distribution keeps neighbouring chunks on the same worker
+    Job job;
+    job.task = &task;
+    job.workerCount = workerCount;
+    job.queues.reserve(workerCount);
+    for (size_t w = 0; w < workerCount; w++) {
+        auto queue = std::make_unique<WorkerQueue>();
+        size_t begin = taskCount * w / workerCount;
+        size_t end = taskCount * (w + 1) / workerCount;
+        for (size_t i = begin; i < end; i++) {
+            queue->tasks.push_back(i);
+        }
+        job.queues.push_back(std::move(queue));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        EnsureThreads(workerCount - 1);
+        if (!g_threads.empty()) {
+            g_openJobs.push_back(&job);
+        }
+    }
+    g_workAvailable.notify_all();
+
+    WorkerLoop(job, 0);
+
+    // Every queue is empty: close the job to new helpers and wait for the ones inside it
+    {
+        std::unique_lock<std::mutex> lock(g_poolMutex);
+        auto open = std::find(g_openJobs.begin(), g_openJobs.end(), &job);
+        if (open != g_openJobs.end()) g_openJobs.erase(open);
+        g_helperLeft.wait(lock, [&] { return job.activeHelpers == 0; });
+    }
+
+    if (job.firstError) {
+        std::rethrow_exception(job.firstError);
+    }
+}
+
+void WorkStealingPool::Shutdown() {
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        g_stopping = true;
+        threads.swap(g_threads);
+    }
+    g_workAvailable.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+namespace InternalEngine {
+
+// Fork-join work-stealing scheduler for scan workloads
+// Each worker owns a contiguous block of task indices and pops from the front;
+// idle workers steal from the back of other workers' queues.
+// Workers are persistent threads started on demand (at most one per hardware thread) and
+// shared by every Run in flight; a Run whose helpers are all busy elsewhere still finishes
+// on the calling thread alone, so nested and concurrent Runs cannot deadlock.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t taskIndex, size_t workerIndex)>;
+
+    // Upper bound on workers per Run, whatever the hardware reports
+    static const size_t MAX_THREADS = 64;
+
+    // Runs taskCount tasks on up to threadCount workers and blocks until all are done.
+    // The calling thread participates as worker 0. The first exception thrown by a task
+    // is rethrown after all workers have left the run.
+    static void Run(size_t taskCount, size_t threadCount, const Task& task);
+
+    // 0 = one worker per hardware thread; always clamped to the hardware threads and MAX_THREADS
+    static size_t ResolveThreadCount(size_t requested);
+
+    // Joins the pool threads (idle ones exit at once); later Runs execute on the caller only
+    static void Shutdown();
+};
+
+} // namespace InternalEngine
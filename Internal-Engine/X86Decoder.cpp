@@ -0,0 +1,1540 @@
+#include "X86Decoder.hpp"
+#include <windows.h>
+#include <cstring>
+
+namespace InternalEngine {
+
+// Opcode attributes (what Decode needs)
+static const uint32_t A_MODRM = 1u << 0;
+static const uint32_t A_IMM8 = 1u << 1;
+static const uint32_t A_IMM16 = 1u << 2;
+static const uint32_t A_IMMZ = 1u << 3;         // 16 or 32 bits by operand size
+static const uint32_t A_IMMV = 1u << 4;         // 16, 32 or 64 bits by operand size (mov r, imm)
+static const uint32_t A_MOFFS = 1u << 5;        // Address-sized offset
+static const uint32_t A_REL8 = 1u << 6;
+static const uint32_t A_RELZ = 1u << 7;
+static const uint32_t A_DEFAULT64 = 1u << 8;    // 64-bit operand size by default in 64-bit mode
+static const uint32_t A_INVALID = 1u << 9;
+static const uint32_t A_INVALID64 = 1u << 10;   // Not encodable in 64-bit mode
+static const uint32_t A_GROUP3 = 1u << 11;      // F6/F7: immediate only for /0 and /1
+static const uint32_t A_JUMP = 1u << 12;
+static const uint32_t A_CALL = 1u << 13;
+static const uint32_t A_RET = 1u << 14;
+static const uint32_t A_CONDITIONAL = 1u << 15;
+static const uint32_t A_SIMD = 1u << 16;        // Mnemonic depends on the mandatory prefix
+static const uint32_t A_NDS = 1u << 17;         // VEX form takes vvvv as the first source
+
+// Operand kinds (what Format needs), Intel manual notation
+enum Operand : uint8_t {
+    O_NONE,
+    O_Eb, O_Ew, O_Ed, O_Ev, O_Ey, O_Ry,     // ModRM r/m
+    O_Gb, O_Gw, O_Gv, O_Gy,                 // ModRM reg
+    O_M,                                    // Memory without a size (lea, prefetch, ...)
+    O_Sw, O_Cd, O_Dd,
+    O_V, O_W,                               // Vector reg / vector r/m
+    O_ST,                                   // x87 memory or st(i)
+    O_Ib, O_Ibs, O_Iw, O_Iz, O_Iv, O_Ap,
+    O_Jb, O_Jz,
+    O_Ob, O_Ov,
+    O_AL, O_AX, O_rAX, O_eAX, O_CL, O_DX, O_ONE,
+    O_By,                                   // General-purpose register in VEX.vvvv
+    O_Zb, O_Zv,                             // Register in the low opcode bits
+    O_SEG                                   // Segment register in opcode bits 3-5
+};
+
+// Mnemonics that depend on ModRM.reg, a condition code or the operand size
+enum Group : uint8_t {
+    G_NONE,
+    G_ALU, G_SHIFT, G_UNARY, G_INCDEC, G_FF, G_POP, G_MOV,
+    G_JCC, G_SETCC, G_CMOVCC, G_X87,
+    G_0F00, G_0F01, G_0FBA, G_0FC7, G_0FAE, G_0F18, G_PSHIFT
+};
+
+struct OpcodeText {
+    const char* mnemonic;
+    uint8_t group;
+    uint8_t operands[3];
+};
+
+// Attributes and text are separate arrays so decoding only walks the 1 KB attribute half
+struct OpcodeMapTable {
+    uint32_t attributes[256];
+    OpcodeText text[256];
+};
+
+struct SimdNameTable {
+    const char* names[256][4];      // By mandatory prefix: none, 66, F3, F2
+};
+
+static constexpr const char* kAluNames[8] = { "add", "or", "adc", "sbb", "and", "sub", "xor", "cmp" };
+static constexpr const char* kShiftNames[8] = { "rol", "ror", "rcl", "rcr", "shl", "shr", "sal", "sar" };
+static constexpr const char* kUnaryNames[8] = { "test", "test", "not", "neg", "mul", "imul", "div", "idiv" };
+static constexpr const char* kConditionNames[16] = {
+    "o", "no", "b", "ae", "e", "ne", "be", "a", "s", "ns", "p", "np", "l", "ge", "le", "g"
+};
+
+static constexpr uint32_t OperandAttributes(uint8_t operand) {
+    switch (operand) {
+        case O_Eb: case O_Ew: case O_Ed: case O_Ev: case O_Ey: case O_Ry:
+        case O_Gb: case O_Gw: case O_Gv: case O_Gy: case O_M:
+        case O_Sw: case O_Cd: case O_Dd: case O_V: case O_W: case O_ST:
+            return A_MODRM;
+        case O_Ib: case O_Ibs: return A_IMM8;
+        case O_Iw: return A_IMM16;
+        case O_Iz: return A_IMMZ;
+        case O_Iv: return A_IMMV;
+        case O_Ap: return A_IMMZ | A_IMM16;
+        case O_Jb: return A_REL8;
+        case O_Jz: return A_RELZ;
+        case O_Ob: case O_Ov: return A_MOFFS;
+        default: return 0;
+    }
+}
+
+// Length attributes are derived from the operand kinds, so the text and the decoder agree
+static constexpr void Define(OpcodeMapTable& table, int first, int last, const char* mnemonic,
+                             uint8_t op1 = O_NONE, uint8_t op2 = O_NONE, uint8_t op3 = O_NONE, uint8_t group = G_NONE) {
+    for (int i = first; i <= last; i++) {
+        table.attributes[i] = OperandAttributes(op1) | OperandAttributes(op2) | OperandAttributes(op3);
+        table.text[i] = OpcodeText{ mnemonic, group, { op1, op2, op3 } };
+    }
+}
+
+static constexpr void DefineGroup(OpcodeMapTable& table, int first, int last, uint8_t group,
+                                  uint8_t op1 = O_NONE, uint8_t op2 = O_NONE, uint8_t op3 = O_NONE) {
+    Define(table, first, last, nullptr, op1, op2, op3, group);
+}
+
+static constexpr void Mark(OpcodeMapTable& table, int first, int last, uint32_t attributes) {
+    for (int i = first; i <= last; i++) {
+        table.attributes[i] |= attributes;
+    }
+}
+
+static constexpr void Invalid(OpcodeMapTable& table, int first, int last) {
+    Define(table, first, last, nullptr);
+    Mark(table, first, last, A_INVALID);
+}
+
+static constexpr OpcodeMapTable BuildPrimaryMap() {
+    OpcodeMapTable table{};
+    Invalid(table, 0x00, 0xFF);
+
+    for (int i = 0; i < 8; i++) {
+        int base = i * 8;
+        Define(table, base + 0, base + 0, kAluNames[i], O_Eb, O_Gb);
+        Define(table, base + 1, base + 1, kAluNames[i], O_Ev, O_Gv);
+        Define(table, base + 2, base + 2, kAluNames[i], O_Gb, O_Eb);
+        Define(table, base + 3, base + 3, kAluNames[i], O_Gv, O_Ev);
+        Define(table, base + 4, base + 4, kAluNames[i], O_AL, O_Ib);
+        Define(table, base + 5, base + 5, kAluNames[i], O_rAX, O_Iz);
+    }
+    const int segmentPushes[4] = { 0x06, 0x0E, 0x16, 0x1E };
+    const int segmentPops[3] = { 0x07, 0x17, 0x1F };
+    for (int op : segmentPushes) Define(table, op, op, "push", O_SEG);
+    for (int op : segmentPops) Define(table, op, op, "pop", O_SEG);
+    Define(table, 0x27, 0x27, "daa");
+    Define(table, 0x2F, 0x2F, "das");
+    Define(table, 0x37, 0x37, "aaa");
+    Define(table, 0x3F, 0x3F, "aas");
+    const int legacyOnly[11] = { 0x06, 0x07, 0x0E, 0x16, 0x17, 0x1E, 0x1F, 0x27, 0x2F, 0x37, 0x3F };
+    for (int op : legacyOnly) Mark(table, op, op, A_INVALID64);
+
+    // 0x40-0x4F are REX prefixes in 64-bit mode and never get here
+    Define(table, 0x40, 0x47, "inc", O_Zv);
+    Define(table, 0x48, 0x4F, "dec", O_Zv);
+    Define(table, 0x50, 0x57, "push", O_Zv);
+    Define(table, 0x58, 0x5F, "pop", O_Zv);
+    Mark(table, 0x50, 0x5F, A_DEFAULT64);
+    Define(table, 0x60, 0x60, "pusha");
+    Define(table, 0x61, 0x61, "popa");
+    Define(table, 0x62, 0x62, "bound", O_Gv, O_M);
+    Mark(table, 0x60, 0x62, A_INVALID64);
+    Define(table, 0x63, 0x63, "movsxd", O_Gv, O_Ed);
+    Define(table, 0x68, 0x68, "push", O_Iz);
+    Define(table, 0x69, 0x69, "imul", O_Gv, O_Ev, O_Iz);
+    Define(table, 0x6A, 0x6A, "push", O_Ibs);
+    Define(table, 0x6B, 0x6B, "imul", O_Gv, O_Ev, O_Ibs);
+    Mark(table, 0x68, 0x68, A_DEFAULT64);
+    Mark(table, 0x6A, 0x6A, A_DEFAULT64);
+    Define(table, 0x6C, 0x6C, "insb");
+    Define(table, 0x6D, 0x6D, "ins");
+    Define(table, 0x6E, 0x6E, "outsb");
+    Define(table, 0x6F, 0x6F, "outs");
+
+    DefineGroup(table, 0x70, 0x7F, G_JCC, O_Jb);
+    Mark(table, 0x70, 0x7F, A_JUMP | A_CONDITIONAL | A_DEFAULT64);
+
+    DefineGroup(table, 0x80, 0x80, G_ALU, O_Eb, O_Ib);
+    DefineGroup(table, 0x81, 0x81, G_ALU, O_Ev, O_Iz);
+    DefineGroup(table, 0x82, 0x82, G_ALU, O_Eb, O_Ib);
+    DefineGroup(table, 0x83, 0x83, G_ALU, O_Ev, O_Ibs);
+    Mark(table, 0x82, 0x82, A_INVALID64);
+    Define(table, 0x84, 0x84, "test", O_Eb, O_Gb);
+    Define(table, 0x85, 0x85, "test", O_Ev, O_Gv);
+    Define(table, 0x86, 0x86, "xchg", O_Eb, O_Gb);
+    Define(table, 0x87, 0x87, "xchg", O_Ev, O_Gv);
+    Define(table, 0x88, 0x88, "mov", O_Eb, O_Gb);
+    Define(table, 0x89, 0x89, "mov", O_Ev, O_Gv);
+    Define(table, 0x8A, 0x8A, "mov", O_Gb, O_Eb);
+    Define(table, 0x8B, 0x8B, "mov", O_Gv, O_Ev);
+    Define(table, 0x8C, 0x8C, "mov", O_Ev, O_Sw);
+    Define(table, 0x8D, 0x8D, "lea", O_Gv, O_M);
+    Define(table, 0x8E, 0x8E, "mov", O_Sw, O_Ew);
+    DefineGroup(table, 0x8F, 0x8F, G_POP, O_Ev);
+    Mark(table, 0x8F, 0x8F, A_DEFAULT64);
+
+    Define(table, 0x90, 0x90, "nop");
+    Define(table, 0x91, 0x97, "xchg", O_Zv, O_rAX);
+    Define(table, 0x98, 0x98, "cwde");
+    Define(table, 0x99, 0x99, "cdq");
+    Define(table, 0x9A, 0x9A, "call", O_Ap);
+    Mark(table, 0x9A, 0x9A, A_INVALID64 | A_CALL);
+    Define(table, 0x9B, 0x9B, "fwait");
+    Define(table, 0x9C, 0x9C, "pushf");
+    Define(table, 0x9D, 0x9D, "popf");
+    Mark(table, 0x9C, 0x9D, A_DEFAULT64);
+    Define(table, 0x9E, 0x9E, "sahf");
+    Define(table, 0x9F, 0x9F, "lahf");
+
+    Define(table, 0xA0, 0xA0, "mov", O_AL, O_Ob);
+    Define(table, 0xA1, 0xA1, "mov", O_rAX, O_Ov);
+    Define(table, 0xA2, 0xA2, "mov", O_Ob, O_AL);
+    Define(table, 0xA3, 0xA3, "mov", O_Ov, O_rAX);
+    Define(table, 0xA4, 0xA4, "movsb");
+    Define(table, 0xA5, 0xA5, "movs");
+    Define(table, 0xA6, 0xA6, "cmpsb");
+    Define(table, 0xA7, 0xA7, "cmps");
+    Define(table, 0xA8, 0xA8, "test", O_AL, O_Ib);
+    Define(table, 0xA9, 0xA9, "test", O_rAX, O_Iz);
+    Define(table, 0xAA, 0xAA, "stosb");
+    Define(table, 0xAB, 0xAB, "stos");
+    Define(table, 0xAC, 0xAC, "lodsb");
+    Define(table, 0xAD, 0xAD, "lods");
+    Define(table, 0xAE, 0xAE, "scasb");
+    Define(table, 0xAF, 0xAF, "scas");
+    Define(table, 0xB0, 0xB7, "mov", O_Zb, O_Ib);
+    Define(table, 0xB8, 0xBF, "mov", O_Zv, O_Iv);
+
+    DefineGroup(table, 0xC0, 0xC0, G_SHIFT, O_Eb, O_Ib);
+    DefineGroup(table, 0xC1, 0xC1, G_SHIFT, O_Ev, O_Ib);
+    Define(table, 0xC2, 0xC2, "ret", O_Iw);
+    Define(table, 0xC3, 0xC3, "ret");
+    Mark(table, 0xC2, 0xC3, A_RET | A_DEFAULT64);
+    Define(table, 0xC4, 0xC4, "les", O_Gv, O_M);
+    Define(table, 0xC5, 0xC5, "lds", O_Gv, O_M);
+    Mark(table, 0xC4, 0xC5, A_INVALID64);
+    DefineGroup(table, 0xC6, 0xC6, G_MOV, O_Eb, O_Ib);
+    DefineGroup(table, 0xC7, 0xC7, G_MOV, O_Ev, O_Iz);
+    Define(table, 0xC8, 0xC8, "enter", O_Iw, O_Ib);
+    Define(table, 0xC9, 0xC9, "leave");
+    Mark(table, 0xC8, 0xC9, A_DEFAULT64);
+    Define(table, 0xCA, 0xCA, "retf", O_Iw);
+    Define(table, 0xCB, 0xCB, "retf");
+    Mark(table, 0xCA, 0xCB, A_RET);
+    Define(table, 0xCC, 0xCC, "int3");
+    Define(table, 0xCD, 0xCD, "int", O_Ib);
+    Define(table, 0xCE, 0xCE, "into");
+    Mark(table, 0xCE, 0xCE, A_INVALID64);
+    Define(table, 0xCF, 0xCF, "iret");
+
+    DefineGroup(table, 0xD0, 0xD0, G_SHIFT, O_Eb, O_ONE);
+    DefineGroup(table, 0xD1, 0xD1, G_SHIFT, O_Ev, O_ONE);
+    DefineGroup(table, 0xD2, 0xD2, G_SHIFT, O_Eb, O_CL);
+    DefineGroup(table, 0xD3, 0xD3, G_SHIFT, O_Ev, O_CL);
+    Define(table, 0xD4, 0xD4, "aam", O_Ib);
+    Define(table, 0xD5, 0xD5, "aad", O_Ib);
+    Mark(table, 0xD4, 0xD5, A_INVALID64);
+    Define(table, 0xD7, 0xD7, "xlatb");
+    DefineGroup(table, 0xD8, 0xDF, G_X87, O_ST);
+
+    Define(table, 0xE0, 0xE0, "loopne", O_Jb);
+    Define(table, 0xE1, 0xE1, "loope", O_Jb);
+    Define(table, 0xE2, 0xE2, "loop", O_Jb);
+    Define(table, 0xE3, 0xE3, "jecxz", O_Jb);
+    Mark(table, 0xE0, 0xE3, A_JUMP | A_CONDITIONAL | A_DEFAULT64);
+    Define(table, 0xE4, 0xE4, "in", O_AL, O_Ib);
+    Define(table, 0xE5, 0xE5, "in", O_eAX, O_Ib);
+    Define(table, 0xE6, 0xE6, "out", O_Ib, O_AL);
+    Define(table, 0xE7, 0xE7, "out", O_Ib, O_eAX);
+    Define(table, 0xE8, 0xE8, "call", O_Jz);
+    Mark(table, 0xE8, 0xE8, A_CALL | A_DEFAULT64);
+    Define(table, 0xE9, 0xE9, "jmp", O_Jz);
+    Define(table, 0xEA, 0xEA, "jmp", O_Ap);
+    Define(table, 0xEB, 0xEB, "jmp", O_Jb);
+    Mark(table, 0xE9, 0xEB, A_JUMP | A_DEFAULT64);
+    Mark(table, 0xEA, 0xEA, A_INVALID64);
+    Define(table, 0xEC, 0xEC, "in", O_AL, O_DX);
+    Define(table, 0xED, 0xED, "in", O_eAX, O_DX);
+    Define(table, 0xEE, 0xEE, "out", O_DX, O_AL);
+    Define(table, 0xEF, 0xEF, "out", O_DX, O_eAX);
+
+    Define(table, 0xF1, 0xF1, "int1");
+    Define(table, 0xF4, 0xF4, "hlt");
+    Define(table, 0xF5, 0xF5, "cmc");
+    DefineGroup(table, 0xF6, 0xF6, G_UNARY, O_Eb);
+    DefineGroup(table, 0xF7, 0xF7, G_UNARY, O_Ev);
+    Mark(table, 0xF6, 0xF7, A_GROUP3);
+    Define(table, 0xF8, 0xF8, "clc");
+    Define(table, 0xF9, 0xF9, "stc");
+    Define(table, 0xFA, 0xFA, "cli");
+    Define(table, 0xFB, 0xFB, "sti");
+    Define(table, 0xFC, 0xFC, "cld");
+    Define(table, 0xFD, 0xFD, "std");
+    DefineGroup(table, 0xFE, 0xFE, G_INCDEC, O_Eb);
+    DefineGroup(table, 0xFF, 0xFF, G_FF, O_Ev);
+    return table;
+}
+
+static constexpr OpcodeMapTable BuildMap0F() {
+    OpcodeMapTable table{};
+    Invalid(table, 0x00, 0xFF);
+
+    DefineGroup(table, 0x00, 0x00, G_0F00, O_Ew);
+    DefineGroup(table, 0x01, 0x01, G_0F01, O_M);
+    Define(table, 0x02, 0x02, "lar", O_Gv, O_Ew);
+    Define(table, 0x03, 0x03, "lsl", O_Gv, O_Ew);
+    Define(table, 0x05, 0x05, "syscall");
+    Define(table, 0x06, 0x06, "clts");
+    Define(table, 0x07, 0x07, "sysret");
+    Define(table, 0x08, 0x08, "invd");
+    Define(table, 0x09, 0x09, "wbinvd");
+    Define(table, 0x0B, 0x0B, "ud2");
+    Define(table, 0x0D, 0x0D, "prefetchw", O_M);
+
+    Define(table, 0x10, 0x10, nullptr, O_V, O_W);
+    Define(table, 0x11, 0x11, nullptr, O_W, O_V);
+    Define(table, 0x12, 0x12, nullptr, O_V, O_W);
+    Define(table, 0x13, 0x13, nullptr, O_W, O_V);
+    Define(table, 0x14, 0x16, nullptr, O_V, O_W);
+    Define(table, 0x17, 0x17, nullptr, O_W, O_V);
+    Mark(table, 0x10, 0x17, A_SIMD);
+    Mark(table, 0x12, 0x12, A_NDS);
+    Mark(table, 0x14, 0x16, A_NDS);
+    DefineGroup(table, 0x18, 0x18, G_0F18, O_M);
+    Define(table, 0x19, 0x1F, "nop", O_Ev);
+    Define(table, 0x20, 0x20, "mov", O_Ry, O_Cd);
+    Define(table, 0x21, 0x21, "mov", O_Ry, O_Dd);
+    Define(table, 0x22, 0x22, "mov", O_Cd, O_Ry);
+    Define(table, 0x23, 0x23, "mov", O_Dd, O_Ry);
+
+    Define(table, 0x28, 0x28, nullptr, O_V, O_W);
+    Define(table, 0x29, 0x29, nullptr, O_W, O_V);
+    Define(table, 0x2A, 0x2A, nullptr, O_V, O_Ey);
+    Define(table, 0x2B, 0x2B, nullptr, O_W, O_V);
+    Define(table, 0x2C, 0x2D, nullptr, O_Gy, O_W);
+    Define(table, 0x2E, 0x2F, nullptr, O_V, O_W);
+    Mark(table, 0x28, 0x2F, A_SIMD);
+    Define(table, 0x30, 0x30, "wrmsr");
+    Define(table, 0x31, 0x31, "rdtsc");
+    Define(table, 0x32, 0x32, "rdmsr");
+    Define(table, 0x33, 0x33, "rdpmc");
+    Define(table, 0x34, 0x34, "sysenter");
+    Define(table, 0x35, 0x35, "sysexit");
+    Define(table, 0x37, 0x37, "getsec");
+
+    DefineGroup(table, 0x40, 0x4F, G_CMOVCC, O_Gv, O_Ev);
+    Define(table, 0x50, 0x50, nullptr, O_Gy, O_W);
+    Define(table, 0x51, 0x5F, nullptr, O_V, O_W);
+    Define(table, 0x60, 0x6D, nullptr, O_V, O_W);
+    Define(table, 0x6E, 0x6E, nullptr, O_V, O_Ey);
+    Define(table, 0x6F, 0x6F, nullptr, O_V, O_W);
+    Define(table, 0x70, 0x70, nullptr, O_V, O_W, O_Ib);
+    DefineGroup(table, 0x71, 0x73, G_PSHIFT, O_W, O_Ib);
+    Define(table, 0x74, 0x76, nullptr, O_V, O_W);
+    Define(table, 0x77, 0x77, nullptr);
+    Define(table, 0x7C, 0x7D, nullptr, O_V, O_W);
+    Define(table, 0x7E, 0x7E, nullptr, O_Ey, O_V);
+    Define(table, 0x7F, 0x7F, nullptr, O_W, O_V);
+    Mark(table, 0x50, 0x7F, A_SIMD);
+    Mark(table, 0x54, 0x59, A_NDS);
+    Mark(table, 0x5C, 0x5F, A_NDS);
+    Mark(table, 0x60, 0x6D, A_NDS);
+    Mark(table, 0x74, 0x76, A_NDS);
+    Mark(table, 0x7C, 0x7D, A_NDS);
+    Define(table, 0x78, 0x78, "vmread", O_Ey, O_Gy);
+    Define(table, 0x79, 0x79, "vmwrite", O_Gy, O_Ey);
+
+    DefineGroup(table, 0x80, 0x8F, G_JCC, O_Jz);
+    Mark(table, 0x80, 0x8F, A_JUMP | A_CONDITIONAL | A_DEFAULT64);
+    DefineGroup(table, 0x90, 0x9F, G_SETCC, O_Eb);
+
+    Define(table, 0xA0, 0xA0, "push", O_SEG);
+    Define(table, 0xA1, 0xA1, "pop", O_SEG);
+    Define(table, 0xA2, 0xA2, "cpuid");
+    Define(table, 0xA3, 0xA3, "bt", O_Ev, O_Gv);
+    Define(table, 0xA4, 0xA4, "shld", O_Ev, O_Gv, O_Ib);
+    Define(table, 0xA5, 0xA5, "shld", O_Ev, O_Gv, O_CL);
+    Define(table, 0xA8, 0xA8, "push", O_SEG);
+    Define(table, 0xA9, 0xA9, "pop", O_SEG);
+    Mark(table, 0xA0, 0xA1, A_DEFAULT64);
+    Mark(table, 0xA8, 0xA9, A_DEFAULT64);
+    Define(table, 0xAA, 0xAA, "rsm");
+    Define(table, 0xAB, 0xAB, "bts", O_Ev, O_Gv);
+    Define(table, 0xAC, 0xAC, "shrd", O_Ev, O_Gv, O_Ib);
+    Define(table, 0xAD, 0xAD, "shrd", O_Ev, O_Gv, O_CL);
+    DefineGroup(table, 0xAE, 0xAE, G_0FAE, O_M);
+    Define(table, 0xAF, 0xAF, "imul", O_Gv, O_Ev);
+
+    Define(table, 0xB0, 0xB0, "cmpxchg", O_Eb, O_Gb);
+    Define(table, 0xB1, 0xB1, "cmpxchg", O_Ev, O_Gv);
+    Define(table, 0xB2, 0xB2, "lss", O_Gv, O_M);
+    Define(table, 0xB3, 0xB3, "btr", O_Ev, O_Gv);
+    Define(table, 0xB4, 0xB4, "lfs", O_Gv, O_M);
+    Define(table, 0xB5, 0xB5, "lgs", O_Gv, O_M);
+    Define(table, 0xB6, 0xB6, "movzx", O_Gv, O_Eb);
+    Define(table, 0xB7, 0xB7, "movzx", O_Gv, O_Ew);
+    Define(table, 0xB8, 0xB8, "popcnt", O_Gv, O_Ev);
+    Define(table, 0xB9, 0xB9, "ud1", O_Gv, O_Ev);
+    DefineGroup(table, 0xBA, 0xBA, G_0FBA, O_Ev, O_Ib);
+    Define(table, 0xBB, 0xBB, "btc", O_Ev, O_Gv);
+    Define(table, 0xBC, 0xBC, "bsf", O_Gv, O_Ev);
+    Define(table, 0xBD, 0xBD, "bsr", O_Gv, O_Ev);
+    Define(table, 0xBE, 0xBE, "movsx", O_Gv, O_Eb);
+    Define(table, 0xBF, 0xBF, "movsx", O_Gv, O_Ew);
+
+    Define(table, 0xC0, 0xC0, "xadd", O_Eb, O_Gb);
+    Define(table, 0xC1, 0xC1, "xadd", O_Ev, O_Gv);
+    Define(table, 0xC2, 0xC2, nullptr, O_V, O_W, O_Ib);
+    Define(table, 0xC3, 0xC3, "movnti", O_Ey, O_Gy);
+    Define(table, 0xC4, 0xC4, nullptr, O_V, O_Ey, O_Ib);
+    Define(table, 0xC5, 0xC5, nullptr, O_Gy, O_W, O_Ib);
+    Define(table, 0xC6, 0xC6, nullptr, O_V, O_W, O_Ib);
+    Mark(table, 0xC2, 0xC2, A_SIMD | A_NDS);
+    Mark(table, 0xC4, 0xC6, A_SIMD);
+    Mark(table, 0xC4, 0xC4, A_NDS);
+    Mark(table, 0xC6, 0xC6, A_NDS);
+    DefineGroup(table, 0xC7, 0xC7, G_0FC7, O_M);
+    Define(table, 0xC8, 0xCF, "bswap", O_Zv);
+
+    Define(table, 0xD0, 0xFE, nullptr, O_V, O_W);
+    Define(table, 0xD6, 0xD6, nullptr, O_W, O_V);
+    Define(table, 0xD7, 0xD7, nullptr, O_Gy, O_W);
+    Define(table, 0xE7, 0xE7, nullptr, O_W, O_V);
+    Mark(table, 0xD0, 0xFE, A_SIMD);
+    Mark(table, 0xD0, 0xD5, A_NDS);
+    Mark(table, 0xD8, 0xE5, A_NDS);
+    Mark(table, 0xE8, 0xF6, A_NDS);
+    Mark(table, 0xF8, 0xFE, A_NDS);
+    Define(table, 0xFF, 0xFF, "ud0", O_Gv, O_Ev);
+    return table;
+}
+
+static constexpr void Simd(SimdNameTable& table, int op, const char* none, const char* p66,
+                           const char* pF3 = nullptr, const char* pF2 = nullptr) {
+    table.names[op][0] = none;
+    table.names[op][1] = p66;
+    table.names[op][2] = pF3;
+    table.names[op][3] = pF2;
+}
+
+// MMX and SSE2 integer forms share the mnemonic
+static constexpr void SimdInteger(SimdNameTable& table, int op, const char* name) {
+    Simd(table, op, name, name);
+}
+
+static constexpr SimdNameTable BuildSimdNames() {
+    SimdNameTable table{};
+    Simd(table, 0x10, "movups", "movupd", "movss", "movsd");
+    Simd(table, 0x11, "movups", "movupd", "movss", "movsd");
+    Simd(table, 0x12, "movlps", "movlpd", "movsldup", "movddup");
+    Simd(table, 0x13, "movlps", "movlpd");
+    Simd(table, 0x14, "unpcklps", "unpcklpd");
+    Simd(table, 0x15, "unpckhps", "unpckhpd");
+    Simd(table, 0x16, "movhps", "movhpd", "movshdup");
+    Simd(table, 0x17, "movhps", "movhpd");
+    Simd(table, 0x28, "movaps", "movapd");
+    Simd(table, 0x29, "movaps", "movapd");
+    Simd(table, 0x2A, "cvtpi2ps", "cvtpi2pd", "cvtsi2ss", "cvtsi2sd");
+    Simd(table, 0x2B, "movntps", "movntpd");
+    Simd(table, 0x2C, "cvttps2pi", "cvttpd2pi", "cvttss2si", "cvttsd2si");
+    Simd(table, 0x2D, "cvtps2pi", "cvtpd2pi", "cvtss2si", "cvtsd2si");
+    Simd(table, 0x2E, "ucomiss", "ucomisd");
+    Simd(table, 0x2F, "comiss", "comisd");
+    Simd(table, 0x50, "movmskps", "movmskpd");
+    Simd(table, 0x51, "sqrtps", "sqrtpd", "sqrtss", "sqrtsd");
+    Simd(table, 0x52, "rsqrtps", nullptr, "rsqrtss");
+    Simd(table, 0x53, "rcpps", nullptr, "rcpss");
+    Simd(table, 0x54, "andps", "andpd");
+    Simd(table, 0x55, "andnps", "andnpd");
+    Simd(table, 0x56, "orps", "orpd");
+    Simd(table, 0x57, "xorps", "xorpd");
+    Simd(table, 0x58, "addps", "addpd", "addss", "addsd");
+    Simd(table, 0x59, "mulps", "mulpd", "mulss", "mulsd");
+    Simd(table, 0x5A, "cvtps2pd", "cvtpd2ps", "cvtss2sd", "cvtsd2ss");
+    Simd(table, 0x5B, "cvtdq2ps", "cvtps2dq", "cvttps2dq");
+    Simd(table, 0x5C, "subps", "subpd", "subss", "subsd");
+    Simd(table, 0x5D, "minps", "minpd", "minss", "minsd");
+    Simd(table, 0x5E, "divps", "divpd", "divss", "divsd");
+    Simd(table, 0x5F, "maxps", "maxpd", "maxss", "maxsd");
+
+    const char* const unpack[12] = {
+        "punpcklbw", "punpcklwd", "punpckldq", "packsswb", "pcmpgtb", "pcmpgtw",
+        "pcmpgtd", "packuswb", "punpckhbw", "punpckhwd", "punpckhdq", "packssdw"
+    };
+    for (int i = 0; i < 12; i++) SimdInteger(table, 0x60 + i, unpack[i]);
+    Simd(table, 0x6C, nullptr, "punpcklqdq");
+    Simd(table, 0x6D, nullptr, "punpckhqdq");
+    SimdInteger(table, 0x6E, "movd");
+    Simd(table, 0x6F, "movq", "movdqa", "movdqu");
+    Simd(table, 0x70, "pshufw", "pshufd", "pshufhw", "pshuflw");
+    SimdInteger(table, 0x74, "pcmpeqb");
+    SimdInteger(table, 0x75, "pcmpeqw");
+    SimdInteger(table, 0x76, "pcmpeqd");
+    Simd(table, 0x77, "emms", nullptr);
+    Simd(table, 0x7C, nullptr, "haddpd", nullptr, "haddps");
+    Simd(table, 0x7D, nullptr, "hsubpd", nullptr, "hsubps");
+    Simd(table, 0x7E, "movd", "movd", "movq");
+    Simd(table, 0x7F, "movq", "movdqa", "movdqu");
+
+    Simd(table, 0xC2, "cmpps", "cmppd", "cmpss", "cmpsd");
+    SimdInteger(table, 0xC4, "pinsrw");
+    SimdInteger(table, 0xC5, "pextrw");
+    Simd(table, 0xC6, "shufps", "shufpd");
+
+    Simd(table, 0xD0, nullptr, "addsubpd", nullptr, "addsubps");
+    const char* const integer[48] = {
+        nullptr, "psrlw", "psrld", "psrlq", "paddq", "pmullw", nullptr, "pmovmskb",
+        "psubusb", "psubusw", "pminub", "pand", "paddusb", "paddusw", "pmaxub", "pandn",
+        "pavgb", "psraw", "psrad", "pavgw", "pmulhuw", "pmulhw", nullptr, "movntq",
+        "psubsb", "psubsw", "pminsw", "por", "paddsb", "paddsw", "pmaxsw", "pxor",
+        nullptr, "psllw", "pslld", "psllq", "pmuludq", "pmaddwd", "psadbw", "maskmovq",
+        "psubb", "psubw", "psubd", "psubq", "paddb", "paddw", "paddd", nullptr
+    };
+    for (int i = 0; i < 48; i++) {
+        if (integer[i]) SimdInteger(table, 0xD0 + i, integer[i]);
+    }
+    Simd(table, 0xD6, nullptr, "movq");
+    Simd(table, 0xE6, nullptr, "cvttpd2dq", "cvtdq2pd", "cvtpd2dq");
+    Simd(table, 0xE7, "movntq", "movntdq");
+    Simd(table, 0xF0, nullptr, nullptr, nullptr, "lddqu");
+    Simd(table, 0xF7, "maskmovq", "maskmovdqu");
+    return table;
+}
+
+static constexpr OpcodeMapTable kPrimaryMap = BuildPrimaryMap();
+static constexpr OpcodeMapTable kMap0F = BuildMap0F();
+static constexpr SimdNameTable kSimdNames = BuildSimdNames();
+
+// Three-byte maps: every opcode has ModRM (0F 3A adds imm8); names for the common ones only
+static const char* Map0F38Name(uint8_t op, unsigned prefix) {
+    if (prefix == 3) {
+        if (op == 0xF0 || op == 0xF1) return "crc32";
+        return nullptr;
+    }
+    if (prefix == 0 && (op == 0xF0 || op == 0xF1)) return "movbe";
+    switch (op) {
+        case 0x00: return "pshufb";
+        case 0x01: return "phaddw";
+        case 0x02: return "phaddd";
+        case 0x04: return "pmaddubsw";
+        case 0x08: return "psignb";
+        case 0x0B: return "pmulhrsw";
+        case 0x10: return "pblendvb";
+        case 0x17: return "ptest";
+        case 0x1C: return "pabsb";
+        case 0x1D: return "pabsw";
+        case 0x1E: return "pabsd";
+        case 0x20: return "pmovsxbw";
+        case 0x21: return "pmovsxbd";
+        case 0x23: return "pmovsxwd";
+        case 0x25: return "pmovsxdq";
+        case 0x28: return "pmuldq";
+        case 0x29: return "pcmpeqq";
+        case 0x2B: return "packusdw";
+        case 0x30: return "pmovzxbw";
+        case 0x31: return "pmovzxbd";
+        case 0x33: return "pmovzxwd";
+        case 0x35: return "pmovzxdq";
+        case 0x37: return "pcmpgtq";
+        case 0x38: return "pminsb";
+        case 0x39: return "pminsd";
+        case 0x3A: return "pminuw";
+        case 0x3B: return "pminud";
+        case 0x3C: return "pmaxsb";
+        case 0x3D: return "pmaxsd";
+        case 0x3E: return "pmaxuw";
+        case 0x3F: return "pmaxud";
+        case 0x40: return "pmulld";
+        case 0xDB: return "aesimc";
+        case 0xDC: return "aesenc";
+        case 0xDD: return "aesenclast";
+        case 0xDE: return "aesdec";
+        case 0xDF: return "aesdeclast";
+        default: return nullptr;
+    }
+}
+
+static const char* Map0F3AName(uint8_t op) {
+    switch (op) {
+        case 0x08: return "roundps";
+        case 0x09: return "roundpd";
+        case 0x0A: return "roundss";
+        case 0x0B: return "roundsd";
+        case 0x0C: return "blendps";
+        case 0x0D: return "blendpd";
+        case 0x0E: return "pblendw";
+        case 0x0F: return "palignr";
+        case 0x14: return "pextrb";
+        case 0x15: return "pextrw";
+        case 0x16: return "pextrd";
+        case 0x17: return "extractps";
+        case 0x20: return "pinsrb";
+        case 0x21: return "insertps";
+        case 0x22: return "pinsrd";
+        case 0x40: return "dpps";
+        case 0x41: return "dppd";
+        case 0x44: return "pclmulqdq";
+        case 0x60: return "pcmpestrm";
+        case 0x61: return "pcmpestri";
+        case 0x62: return "pcmpistrm";
+        case 0x63: return "pcmpistri";
+        case 0xDF: return "aeskeygenassist";
+        default: return nullptr;
+    }
+}
+
+static uint64_t ReadUnsigned(const uint8_t* code, size_t size) {
+    uint64_t value = 0;
+    memcpy(&value, code, size);     // x86 is little-endian
+    return value;
+}
+
+static int64_t SignExtend(uint64_t value, size_t size) {
+    switch (size) {
+        case 1: return static_cast<int8_t>(value);
+        case 2: return static_cast<int16_t>(value);
+        case 4: return static_cast<int32_t>(value);
+        default: return static_cast<int64_t>(value);
+    }
+}
+
+bool X86Decoder::Decode(const uint8_t* code, size_t available, uintptr_t address, bool is64bit, X86Instruction& instruction) {
+    instruction = X86Instruction();
+    instruction.address = address;
+    if (is64bit) instruction.flags |= X86_FLAG_64BIT;
+
+    const size_t limit = min(available, MAX_INSTRUCTION_LENGTH);
+    size_t pos = 0;
+    uint8_t rex = 0;
+
+    // Legacy prefixes; a REX prefix only counts when nothing follows it but the opcode
+    bool prefix = true;
+    while (prefix && pos < limit) {
+        uint8_t byte = code[pos];
+        if (is64bit && (byte & 0xF0) == 0x40) {
+            rex = byte;
+            pos++;
+            continue;
+        }
+        switch (byte) {
+            case 0x66: instruction.prefixes |= X86_PREFIX_OPERAND_SIZE; break;
+            case 0x67: instruction.prefixes |= X86_PREFIX_ADDRESS_SIZE; break;
+            case 0xF0: instruction.prefixes |= X86_PREFIX_LOCK; break;
+            case 0xF2: instruction.prefixes = (instruction.prefixes & ~X86_PREFIX_REP) | X86_PREFIX_REPNE; break;
+            case 0xF3: instruction.prefixes = (instruction.prefixes & ~X86_PREFIX_REPNE) | X86_PREFIX_REP; break;
+            case 0x26: instruction.segment = 1; break;
+            case 0x2E: instruction.segment = 2; break;
+            case 0x36: instruction.segment = 3; break;
+            case 0x3E: instruction.segment = 4; break;
+            case 0x64: instruction.segment = 5; break;
+            case 0x65: instruction.segment = 6; break;
+            default: prefix = false; continue;
+        }
+        rex = 0;
+        pos++;
+    }
+    if (pos >= limit) return false;
+
+    uint8_t opcode = code[pos++];
+    uint32_t attributes = 0;
+    X86OpcodeMap map = X86OpcodeMap::Primary;
+    bool broadcast = false;     // EVEX.b
+
+    if (opcode == 0x0F) {
+        if (pos >= limit) return false;
+        opcode = code[pos++];
+        if (opcode == 0x38 || opcode == 0x3A) {
+            map = opcode == 0x38 ? X86OpcodeMap::Map0F38 : X86OpcodeMap::Map0F3A;
+            if (pos >= limit) return false;
+            opcode = code[pos++];
+            attributes = map == X86OpcodeMap::Map0F38 ? A_MODRM : (A_MODRM | A_IMM8);
+        } else {
+            map = X86OpcodeMap::Map0F;
+            attributes = kMap0F.attributes[opcode];
+        }
+    } else if ((opcode == 0xC5 || opcode == 0xC4 || opcode == 0x62) && pos < limit &&
+               (is64bit || (code[pos] & 0xC0) == 0xC0)) {
+        // VEX / EVEX (outside 64-bit mode only when the next byte cannot be a memory ModRM)
+        if (rex || (instruction.prefixes & (X86_PREFIX_OPERAND_SIZE | X86_PREFIX_LOCK | X86_PREFIX_REP | X86_PREFIX_REPNE))) {
+            return false;
+        }
+        size_t payload = opcode == 0xC5 ? 1 : (opcode == 0xC4 ? 2 : 3);
+        if (pos + payload >= limit) return false;
+        const uint8_t* p = &code[pos];
+
+        uint8_t select = 1;
+        uint8_t vvvv = 0;
+        uint8_t vvvvHigh = 0;
+        uint8_t pp = 0;
+        bool wide = false;
+        if (opcode == 0xC5) {
+            rex = 0x40 | ((p[0] & 0x80) ? 0 : 0x04);
+            vvvv = (p[0] >> 3) & 0x0F;
+            instruction.vectorLength = (p[0] >> 2) & 1;
+            pp = p[0] & 3;
+        } else {
+            rex = 0x40 | ((p[0] & 0x80) ? 0 : 0x04) | ((p[0] & 0x40) ? 0 : 0x02) | ((p[0] & 0x20) ? 0 : 0x01);
+            select = opcode == 0xC4 ? (p[0] & 0x1F) : (p[0] & 0x07);
+            wide = (p[1] & 0x80) != 0;
+            vvvv = (p[1] >> 3) & 0x0F;
+            pp = p[1] & 3;
+            instruction.vectorLength = opcode == 0xC4 ? ((p[1] >> 2) & 1) : ((p[2] >> 5) & 3);
+            if (opcode == 0x62) {
+                broadcast = (p[2] & 0x10) != 0;
+                if (is64bit) {
+                    instruction.registerHigh = ((p[0] & 0x10) ? 0 : 1) | ((p[0] & 0x40) ? 0 : 2);
+                    vvvvHigh = (p[2] & 0x08) ? 0 : 0x10;
+                }
+            }
+        }
+        if (select < 1 || select > 3) return false;
+        if (!is64bit) rex = 0x40;
+        if (wide) rex |= 0x08;
+
+        instruction.vex = static_cast<uint8_t>(payload + 1);
+        instruction.vexPrefix = pp;
+        instruction.vexRegister = ((~vvvv) & 0x0F) | vvvvHigh;
+        pos += payload;
+        opcode = code[pos++];
+
+        map = static_cast<X86OpcodeMap>(select);
+        if (map == X86OpcodeMap::Map0F) {
+            attributes = kMap0F.attributes[opcode];
+        } else {
+            attributes = map == X86OpcodeMap::Map0F38 ? A_MODRM : (A_MODRM | A_IMM8);
+        }
+    } else {
+        attributes = kPrimaryMap.attributes[opcode];
+    }
+
+    if ((attributes & A_INVALID) || (is64bit && (attributes & A_INVALID64))) {
+        return false;
+    }
+
+    instruction.opcode = opcode;
+    instruction.map = map;
+    instruction.rex = rex;
+
+    bool operand16 = (instruction.prefixes & X86_PREFIX_OPERAND_SIZE) != 0;
+    if (rex & 0x08) {
+        instruction.operandSize = 8;
+    } else if (operand16) {
+        instruction.operandSize = 2;
+    } else {
+        instruction.operandSize = (is64bit && (attributes & A_DEFAULT64)) ? 8 : 4;
+    }
+    bool address16 = (instruction.prefixes & X86_PREFIX_ADDRESS_SIZE) != 0;
+    instruction.addressSize = is64bit ? (address16 ? 4 : 8) : (address16 ? 2 : 4);
+
+    if (attributes & A_MODRM) {
+        if (pos >= limit) return false;
+        uint8_t modrm = code[pos++];
+        instruction.modrm = modrm;
+        instruction.flags |= X86_FLAG_MODRM;
+
+        uint8_t mod = modrm >> 6;
+        uint8_t reg = (modrm >> 3) & 7;
+        uint8_t rm = modrm & 7;
+        size_t dispSize = 0;
+
+        if (mod != 3) {
+            if (instruction.addressSize == 2) {
+                if (mod == 0 && rm == 6) dispSize = 2;
+            } else if (rm == 4) {
+                if (pos >= limit) return false;
+                instruction.sib = code[pos++];
+                instruction.flags |= X86_FLAG_SIB;
+                if (mod == 0 && (instruction.sib & 7) == 5) dispSize = 4;
+            } else if (mod == 0 && rm == 5) {
+                dispSize = 4;
+                if (is64bit) instruction.flags |= X86_FLAG_RIP_RELATIVE;
+            }
+            if (mod == 1) dispSize = 1;
+            if (mod == 2) dispSize = instruction.addressSize == 2 ? 2 : 4;
+
+            if (dispSize) {
+                if (pos + dispSize > limit) return false;
+                instruction.dispOffset = static_cast<uint8_t>(pos);
+                instruction.dispSize = static_cast<uint8_t>(dispSize);
+                instruction.displacement = static_cast<int32_t>(SignExtend(ReadUnsigned(&code[pos], dispSize), dispSize));
+                pos += dispSize;
+
+                // EVEX disp8*N: scaled by the full vector, or by the element when broadcasting
+                if (instruction.vex == 4 && dispSize == 1) {
+                    instruction.displacement *= broadcast ? ((rex & 0x08) ? 8 : 4) : (16 << instruction.vectorLength);
+                }
+            }
+        }
+
+        if ((attributes & A_GROUP3) && reg < 2) {
+            attributes |= (opcode & 1) ? A_IMMZ : A_IMM8;
+        }
+
+        // FF /2 /4 /6: near call, jmp and push default to 64-bit operands
+        if (map == X86OpcodeMap::Primary && opcode == 0xFF) {
+            if (is64bit && !(rex & 0x08) && (reg == 2 || reg == 4 || (reg == 6 && !operand16))) {
+                instruction.operandSize = 8;
+            }
+            if (reg == 2 || reg == 3) attributes |= A_CALL;
+            if (reg == 4 || reg == 5) attributes |= A_JUMP;
+            if (reg == 7) return false;
+        }
+    }
+
+    // Immediates in encoding order; the first goes to immediate, a second to immediate2
+    size_t immSize = 0;
+    size_t imm2Size = 0;
+    auto addImmediate = [&](size_t size) {
+        if (immSize == 0) immSize = size; else imm2Size = size;
+    };
+    if (attributes & A_IMMV) addImmediate(instruction.operandSize);
+    if (attributes & A_IMMZ) addImmediate(instruction.operandSize == 2 ? 2 : 4);
+    if (attributes & A_MOFFS) addImmediate(instruction.addressSize);
+    if (attributes & A_RELZ) addImmediate((is64bit || !operand16) ? 4 : 2);
+    if (attributes & A_IMM16) addImmediate(2);
+    if (attributes & (A_IMM8 | A_REL8)) addImmediate(1);
+
+    if (pos + immSize + imm2Size > limit) return false;
+    if (immSize) {
+        instruction.immOffset = static_cast<uint8_t>(pos);
+        instruction.immSize = static_cast<uint8_t>(immSize);
+        instruction.immediate = ReadUnsigned(&code[pos], immSize);
+        pos += immSize;
+    }
+    if (imm2Size) {
+        instruction.immediate2 = static_cast<uint16_t>(ReadUnsigned(&code[pos], imm2Size));
+        pos += imm2Size;
+    }
+    instruction.length = static_cast<uint8_t>(pos);
+
+    uintptr_t next = address + pos;
+    if (attributes & (A_REL8 | A_RELZ)) {
+        instruction.flags |= X86_FLAG_RELATIVE;
+        instruction.target = next + static_cast<uintptr_t>(SignExtend(instruction.immediate, immSize));
+        if (!is64bit) instruction.target &= 0xFFFFFFFF;
+    }
+    if (instruction.flags & X86_FLAG_RIP_RELATIVE) {
+        instruction.target = next + static_cast<uintptr_t>(static_cast<intptr_t>(instruction.displacement));
+        if (instruction.addressSize == 4) instruction.target &= 0xFFFFFFFF;
+    }
+
+    if (attributes & A_JUMP) instruction.flags |= X86_FLAG_JUMP;
+    if (attributes & A_CALL) instruction.flags |= X86_FLAG_CALL;
+    if (attributes & A_RET) instruction.flags |= X86_FLAG_RET;
+    if (attributes & A_CONDITIONAL) instruction.flags |= X86_FLAG_CONDITIONAL;
+    return true;
+}
+
+size_t X86Decoder::DecodeRange(const uint8_t* code, size_t size, uintptr_t address, bool is64bit,
+                               std::vector<X86Instruction>& instructions, size_t maxCount) {
+    size_t offset = 0;
+    size_t count = 0;
+
+    while (offset < size && count < maxCount) {
+        X86Instruction instruction;
+        if (!Decode(code + offset, size - offset, address + offset, is64bit, instruction)) {
+            // Emit the byte on its own and resynchronize on the next one
+            instruction = X86Instruction();
+            instruction.address = address + offset;
+            instruction.length = 1;
+            instruction.opcode = code[offset];
+            instruction.flags = X86_FLAG_INVALID | (is64bit ? X86_FLAG_64BIT : 0);
+        }
+        instructions.push_back(instruction);
+        offset += instruction.length;
+        count++;
+    }
+    return offset;
+}
+
+size_t X86Decoder::GetLength(const uint8_t* code, size_t available) {
+    X86Instruction instruction;
+    if (!Decode(code, available, reinterpret_cast<uintptr_t>(code), sizeof(void*) == 8, instruction)) {
+        return 0;
+    }
+    return instruction.length;
+}
+
+// 🖨️ 텍스트 변환
+
+// Appends into a fixed buffer; output past the capacity is dropped
+class TextBuilder {
+public:
+    TextBuilder(char* buffer, size_t capacity) : buffer(buffer), capacity(capacity) {
+        buffer[0] = '\0';
+    }
+
+    void Append(char c) {
+        if (length + 1 < capacity) {
+            buffer[length++] = c;
+            buffer[length] = '\0';
+        }
+    }
+
+    void Append(const char* text) {
+        while (*text) Append(*text++);
+    }
+
+    void AppendDecimal(unsigned value) {
+        char digits[10];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value);
+        while (count) Append(digits[--count]);
+    }
+
+    void AppendHex(uint64_t value) {
+        static const char hex[] = "0123456789ABCDEF";
+        char digits[16];
+        int count = 0;
+        do {
+            digits[count++] = hex[value & 0xF];
+            value >>= 4;
+        } while (value);
+        Append("0x");
+        while (count) Append(digits[--count]);
+    }
+
+    void AppendSignedHex(int64_t value) {
+        if (value < 0) {
+            Append('-');
+            AppendHex(0 - static_cast<uint64_t>(value));
+        } else {
+            AppendHex(static_cast<uint64_t>(value));
+        }
+    }
+
+    size_t Length() const { return length; }
+
+private:
+    char* buffer;
+    size_t capacity;
+    size_t length = 0;
+};
+
+static const char* const kRegisters64[16] = {
+    "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"
+};
+static const char* const kRegisters32[16] = {
+    "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi", "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d"
+};
+static const char* const kRegisters16[16] = {
+    "ax", "cx", "dx", "bx", "sp", "bp", "si", "di", "r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w"
+};
+static const char* const kRegisters8[16] = {
+    "al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil", "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b"
+};
+static const char* const kRegisters8Legacy[8] = { "al", "cl", "dl", "bl", "ah", "ch", "dh", "bh" };
+static const char* const kSegments[8] = { "es", "cs", "ss", "ds", "fs", "gs", "?", "?" };
+static const char* const kAddress16[8] = { "bx+si", "bx+di", "bp+si", "bp+di", "si", "di", "bp", "bx" };
+
+static const char* const kX87MemoryNames[8][8] = {
+    { "fadd", "fmul", "fcom", "fcomp", "fsub", "fsubr", "fdiv", "fdivr" },
+    { "fld", "???", "fst", "fstp", "fldenv", "fldcw", "fnstenv", "fnstcw" },
+    { "fiadd", "fimul", "ficom", "ficomp", "fisub", "fisubr", "fidiv", "fidivr" },
+    { "fild", "fisttp", "fist", "fistp", "???", "fld", "???", "fstp" },
+    { "fadd", "fmul", "fcom", "fcomp", "fsub", "fsubr", "fdiv", "fdivr" },
+    { "fld", "fisttp", "fst", "fstp", "frstor", "???", "fnsave", "fnstsw" },
+    { "fiadd", "fimul", "ficom", "ficomp", "fisub", "fisubr", "fidiv", "fidivr" },
+    { "fild", "fisttp", "fist", "fistp", "fbld", "fild", "fbstp", "fistp" }
+};
+
+static void AppendRegister(TextBuilder& out, unsigned reg, unsigned size, bool hasRex) {
+    reg &= 15;
+    switch (size) {
+        case 1: out.Append(hasRex ? kRegisters8[reg] : kRegisters8Legacy[reg & 7]); break;
+        case 2: out.Append(kRegisters16[reg]); break;
+        case 4: out.Append(kRegisters32[reg]); break;
+        default: out.Append(kRegisters64[reg]); break;
+    }
+}
+
+static void AppendSizePrefix(TextBuilder& out, unsigned size) {
+    switch (size) {
+        case 1: out.Append("byte ptr "); break;
+        case 2: out.Append("word ptr "); break;
+        case 4: out.Append("dword ptr "); break;
+        case 8: out.Append("qword ptr "); break;
+        case 16: out.Append("xmmword ptr "); break;
+        case 32: out.Append("ymmword ptr "); break;
+        case 64: out.Append("zmmword ptr "); break;
+        default: break;
+    }
+}
+
+static void AppendMemory(TextBuilder& out, const X86Instruction& instruction, unsigned size) {
+    AppendSizePrefix(out, size);
+    if (instruction.segment) {
+        out.Append(kSegments[instruction.segment - 1]);
+        out.Append(':');
+    }
+    out.Append('[');
+
+    if (instruction.flags & X86_FLAG_RIP_RELATIVE) {
+        out.AppendHex(instruction.target);
+        out.Append(']');
+        return;
+    }
+
+    uint8_t mod = instruction.modrm >> 6;
+    uint8_t rm = instruction.modrm & 7;
+    bool hasBase = false;
+
+    if (instruction.addressSize == 2) {
+        if (!(mod == 0 && rm == 6)) {
+            out.Append(kAddress16[rm]);
+            hasBase = true;
+        }
+    } else {
+        unsigned registerSize = instruction.addressSize;
+        if (instruction.flags & X86_FLAG_SIB) {
+            unsigned base = (instruction.sib & 7) | ((instruction.rex & 1) << 3);
+            unsigned index = ((instruction.sib >> 3) & 7) | ((instruction.rex & 2) << 2);
+            unsigned scale = 1u << (instruction.sib >> 6);
+            if (!(mod == 0 && (instruction.sib & 7) == 5)) {
+                AppendRegister(out, base, registerSize, true);
+                hasBase = true;
+            }
+            if (index != 4) {
+                if (hasBase) out.Append('+');
+                AppendRegister(out, index, registerSize, true);
+                if (scale > 1) {
+                    out.Append('*');
+                    out.AppendDecimal(scale);
+                }
+                hasBase = true;
+            }
+        } else if (!(mod == 0 && rm == 5)) {
+            AppendRegister(out, rm | ((instruction.rex & 1) << 3), registerSize, true);
+            hasBase = true;
+        }
+    }
+
+    if (instruction.dispSize) {
+        if (!hasBase) {
+            uint64_t mask = instruction.addressSize == 8 ? ~0ull : ((1ull << (instruction.addressSize * 8)) - 1);
+            out.AppendHex(static_cast<uint64_t>(static_cast<int64_t>(instruction.displacement)) & mask);
+        } else if (instruction.displacement != 0) {
+            if (instruction.displacement > 0) out.Append('+');
+            out.AppendSignedHex(instruction.displacement);
+        }
+    } else if (!hasBase) {
+        out.Append('0');
+    }
+    out.Append(']');
+}
+
+// 0 = mm, 1 = xmm, 2 = ymm, 3 = zmm
+static unsigned VectorKind(const X86Instruction& instruction, unsigned prefix) {
+    if (instruction.vex) return 1 + instruction.vectorLength;
+    uint8_t op = instruction.opcode;
+    bool mmxRange = (op >= 0x60 && op <= 0x7F && op != 0x77) || op >= 0xD0 || op == 0xC4 || op == 0xC5 ||
+                    op == 0x2A || op == 0x2C || op == 0x2D;
+    if (instruction.map == X86OpcodeMap::Map0F && prefix == 0 && mmxRange) return 0;
+    if (instruction.map != X86OpcodeMap::Map0F && prefix == 0 && op <= 0x1E) return 0;  // SSSE3 MMX forms
+    return 1;
+}
+
+static void AppendVector(TextBuilder& out, unsigned kind, unsigned reg) {
+    static const char* const names[4] = { "mm", "xmm", "ymm", "zmm" };
+    out.Append(names[kind]);
+    out.AppendDecimal(kind == 0 ? (reg & 7) : reg);
+}
+
+// Memory size of a vector r/m operand: scalar forms read one element
+static unsigned VectorMemorySize(const X86Instruction& instruction, unsigned kind, unsigned prefix) {
+    if (kind == 0) return 8;
+    if (instruction.map == X86OpcodeMap::Map0F) {
+        switch (instruction.opcode) {
+            case 0x10: case 0x11: case 0x2A: case 0x2C: case 0x2D: case 0x51: case 0x52: case 0x53:
+            case 0x58: case 0x59: case 0x5A: case 0x5C: case 0x5D: case 0x5E: case 0x5F: case 0xC2:
+                if (prefix == 2) return 4;
+                if (prefix == 3) return 8;
+                break;
+            case 0x2E: case 0x2F:
+                return prefix == 1 ? 8 : 4;
+            case 0x12: case 0x13: case 0x16: case 0x17: case 0xD6:
+                return 8;
+            case 0x7E:
+                if (prefix == 2) return 8;
+                break;
+            default:
+                break;
+        }
+    }
+    return 16u << (kind - 1);
+}
+
+// Mandatory prefix of a SIMD opcode: 0 none, 1 66, 2 F3, 3 F2
+static unsigned MandatoryPrefix(const X86Instruction& instruction) {
+    if (instruction.vex) return instruction.vexPrefix;
+    if (instruction.prefixes & X86_PREFIX_REP) return 2;
+    if (instruction.prefixes & X86_PREFIX_REPNE) return 3;
+    if (instruction.prefixes & X86_PREFIX_OPERAND_SIZE) return 1;
+    return 0;
+}
+
+struct OperandContext {
+    const X86Instruction& instruction;
+    unsigned vectorKind;
+    unsigned vectorMemorySize;
+    unsigned immediateIndex;
+};
+
+static uint64_t NextImmediate(OperandContext& context) {
+    return context.immediateIndex++ == 0 ? context.instruction.immediate : context.instruction.immediate2;
+}
+
+static void AppendOperand(TextBuilder& out, uint8_t operand, OperandContext& context) {
+    const X86Instruction& instruction = context.instruction;
+    bool hasRex = instruction.rex != 0;
+    bool registerForm = (instruction.modrm >> 6) == 3;
+    unsigned reg = ((instruction.modrm >> 3) & 7) | ((instruction.rex & 4) << 1);
+    unsigned rm = (instruction.modrm & 7) | ((instruction.rex & 1) << 3);
+    unsigned low = (instruction.opcode & 7) | ((instruction.rex & 1) << 3);
+    unsigned size = instruction.operandSize;
+    unsigned wideSize = (instruction.rex & 8) ? 8 : 4;
+
+    switch (operand) {
+        case O_Eb: registerForm ? AppendRegister(out, rm, 1, hasRex) : AppendMemory(out, instruction, 1); break;
+        case O_Ew: registerForm ? AppendRegister(out, rm, 2, hasRex) : AppendMemory(out, instruction, 2); break;
+        case O_Ed: registerForm ? AppendRegister(out, rm, 4, hasRex) : AppendMemory(out, instruction, 4); break;
+        case O_Ev: registerForm ? AppendRegister(out, rm, size, hasRex) : AppendMemory(out, instruction, size); break;
+        case O_Ey: registerForm ? AppendRegister(out, rm, wideSize, hasRex) : AppendMemory(out, instruction, wideSize); break;
+        case O_Ry: AppendRegister(out, rm, (instruction.flags & X86_FLAG_64BIT) ? 8 : 4, hasRex); break;
+        case O_Gb: AppendRegister(out, reg, 1, hasRex); break;
+        case O_Gw: AppendRegister(out, reg, 2, hasRex); break;
+        case O_Gv: AppendRegister(out, reg, size, hasRex); break;
+        case O_Gy: AppendRegister(out, reg, wideSize, hasRex); break;
+        case O_M: registerForm ? AppendRegister(out, rm, size, hasRex) : AppendMemory(out, instruction, 0); break;
+        case O_Sw: out.Append(kSegments[(instruction.modrm >> 3) & 7]); break;
+        case O_Cd: out.Append("cr"); out.AppendDecimal(reg); break;
+        case O_Dd: out.Append("dr"); out.AppendDecimal(reg); break;
+        case O_V: AppendVector(out, context.vectorKind, reg | ((instruction.registerHigh & 1) << 4)); break;
+        case O_W:
+            if (registerForm) {
+                AppendVector(out, context.vectorKind, rm | ((instruction.registerHigh & 2) << 3));
+            } else {
+                AppendMemory(out, instruction, context.vectorMemorySize);
+            }
+            break;
+        case O_ST:
+            if (registerForm) {
+                out.Append("st(");
+                out.AppendDecimal(instruction.modrm & 7);
+                out.Append(')');
+            } else {
+                AppendMemory(out, instruction, 0);
+            }
+            break;
+        case O_Ib: out.AppendHex(NextImmediate(context) & 0xFF); break;
+        case O_Ibs: out.AppendSignedHex(static_cast<int8_t>(NextImmediate(context))); break;
+        case O_Iw: out.AppendHex(NextImmediate(context) & 0xFFFF); break;
+        case O_Iz:
+            if (size == 8) {
+                out.AppendSignedHex(static_cast<int32_t>(NextImmediate(context)));
+            } else {
+                out.AppendHex(NextImmediate(context));
+            }
+            break;
+        case O_Iv: out.AppendHex(NextImmediate(context)); break;
+        case O_Ap:
+            out.AppendHex(instruction.immediate2);
+            out.Append(':');
+            out.AppendHex(instruction.immediate);
+            break;
+        case O_Jb: case O_Jz: out.AppendHex(instruction.target); break;
+        case O_Ob: case O_Ov:
+            AppendSizePrefix(out, operand == O_Ob ? 1 : size);
+            if (instruction.segment) {
+                out.Append(kSegments[instruction.segment - 1]);
+                out.Append(':');
+            }
+            out.Append('[');
+            out.AppendHex(instruction.immediate);
+            out.Append(']');
+            break;
+        case O_AL: out.Append("al"); break;
+        case O_AX: out.Append("ax"); break;
+        case O_By: AppendRegister(out, instruction.vexRegister, wideSize, true); break;
+        case O_rAX: AppendRegister(out, 0, size, false); break;
+        case O_eAX: AppendRegister(out, 0, size == 2 ? 2 : 4, false); break;
+        case O_CL: out.Append("cl"); break;
+        case O_DX: out.Append("dx"); break;
+        case O_ONE: out.Append('1'); break;
+        case O_Zb: AppendRegister(out, low, 1, hasRex); break;
+        case O_Zv: AppendRegister(out, low, size, hasRex); break;
+        case O_SEG: out.Append(kSegments[(instruction.opcode >> 3) & 7]); break;
+        default: break;
+    }
+}
+
+// Register forms of D8-DF; hasOperand = false for the ones without st(i)
+static const char* X87RegisterName(uint8_t op, uint8_t modrm, bool& hasOperand) {
+    static const char* const d9[32] = {
+        "fchs", "fabs", nullptr, nullptr, "ftst", "fxam", nullptr, nullptr,
+        "fld1", "fldl2t", "fldl2e", "fldpi", "fldlg2", "fldln2", "fldz", nullptr,
+        "f2xm1", "fyl2x", "fptan", "fpatan", "fxtract", "fprem1", "fdecstp", "fincstp",
+        "fprem", "fyl2xp1", "fsqrt", "fsincos", "frndint", "fscale", "fsin", "fcos"
+    };
+    static const char* const dc[8] = { "fadd", "fmul", "fcom", "fcomp", "fsubr", "fsub", "fdivr", "fdiv" };
+    static const char* const de[8] = { "faddp", "fmulp", nullptr, nullptr, "fsubrp", "fsubp", "fdivrp", "fdivp" };
+    static const char* const da[8] = { "fcmovb", "fcmove", "fcmovbe", "fcmovu", nullptr, nullptr, nullptr, nullptr };
+    static const char* const db[8] = { "fcmovnb", "fcmovne", "fcmovnbe", "fcmovnu", nullptr, "fucomi", "fcomi", nullptr };
+    static const char* const dd[8] = { "ffree", nullptr, "fst", "fstp", "fucom", "fucomp", nullptr, nullptr };
+    static const char* const df[8] = { nullptr, nullptr, nullptr, nullptr, nullptr, "fucomip", "fcomip", nullptr };
+
+    unsigned reg = (modrm >> 3) & 7;
+    switch (op) {
+        case 0xD8: return kX87MemoryNames[0][reg];
+        case 0xD9:
+            if (reg == 0) return "fld";
+            if (reg == 1) return "fxch";
+            hasOperand = false;
+            if (modrm == 0xD0) return "fnop";
+            return modrm >= 0xE0 ? d9[modrm - 0xE0] : nullptr;
+        case 0xDA:
+            if (modrm == 0xE9) { hasOperand = false; return "fucompp"; }
+            return da[reg];
+        case 0xDB:
+            if (modrm == 0xE2 || modrm == 0xE3) { hasOperand = false; return modrm == 0xE2 ? "fnclex" : "fninit"; }
+            return db[reg];
+        case 0xDC: return dc[reg];
+        case 0xDD: return dd[reg];
+        case 0xDE:
+            if (modrm == 0xD9) { hasOperand = false; return "fcompp"; }
+            return de[reg];
+        case 0xDF:
+            if (modrm == 0xE0) { hasOperand = false; return "fnstsw"; }
+            return df[reg];
+        default: return nullptr;
+    }
+}
+
+// Suffix by operand size for string and conversion instructions
+static const char* SizedName(unsigned size, const char* name16, const char* name32, const char* name64) {
+    return size == 2 ? name16 : (size == 8 ? name64 : name32);
+}
+
+void X86Decoder::Format(const X86Instruction& instruction, X86Text& text) {
+    TextBuilder mnemonic(text.mnemonic, sizeof(text.mnemonic));
+    TextBuilder operands(text.operands, sizeof(text.operands));
+
+    if (instruction.length == 0 || (instruction.flags & X86_FLAG_INVALID)) {
+        mnemonic.Append("db");
+        operands.AppendHex(instruction.opcode);
+        return;
+    }
+
+    const uint8_t op = instruction.opcode;
+    const unsigned reg = (instruction.modrm >> 3) & 7;
+    const bool registerForm = (instruction.modrm >> 6) == 3;
+    const bool is64bit = (instruction.flags & X86_FLAG_64BIT) != 0;
+    const unsigned size = instruction.operandSize;
+    const unsigned prefix = MandatoryPrefix(instruction);
+
+    OpcodeText entry = { nullptr, G_NONE, { O_V, O_W, O_NONE } };
+    uint32_t attributes = 0;
+    bool simd = false;
+    bool nds = false;
+    const char* name = nullptr;
+
+    switch (instruction.map) {
+        case X86OpcodeMap::Primary:
+            entry = kPrimaryMap.text[op];
+            attributes = kPrimaryMap.attributes[op];
+            name = entry.mnemonic;
+            break;
+        case X86OpcodeMap::Map0F:
+            entry = kMap0F.text[op];
+            attributes = kMap0F.attributes[op];
+            simd = (attributes & A_SIMD) != 0;
+            nds = (attributes & A_NDS) != 0;
+            name = simd ? kSimdNames.names[op][prefix] : entry.mnemonic;
+            if (instruction.vex && !simd) {
+                entry = OpcodeText{ nullptr, G_NONE, { O_NONE, O_NONE, O_NONE } };   // Opmask instructions
+                name = nullptr;
+            }
+            break;
+        case X86OpcodeMap::Map0F38:
+            simd = true;
+            nds = instruction.vexRegister != 0;
+            name = Map0F38Name(op, prefix);
+            if (instruction.vex && op >= 0xF2 && op <= 0xF7) {
+                // BMI1/BMI2 general-purpose forms
+                simd = false;
+                nds = false;
+                entry.operands[0] = O_Gy;
+                entry.operands[1] = O_By;
+                entry.operands[2] = O_Ey;
+                switch (op) {
+                    case 0xF2: name = prefix == 0 ? "andn" : nullptr; break;
+                    case 0xF3: {
+                        static const char* const names[8] = { nullptr, "blsr", "blsmsk", "blsi", nullptr, nullptr, nullptr, nullptr };
+                        name = prefix == 0 ? names[reg] : nullptr;
+                        entry.operands[0] = O_By;
+                        entry.operands[1] = O_Ey;
+                        entry.operands[2] = O_NONE;
+                        break;
+                    }
+                    case 0xF5: name = prefix == 0 ? "bzhi" : (prefix == 2 ? "pext" : (prefix == 3 ? "pdep" : nullptr)); break;
+                    case 0xF6: name = prefix == 3 ? "mulx" : nullptr; break;
+                    case 0xF7: {
+                        static const char* const names[4] = { "bextr", "shlx", "sarx", "shrx" };
+                        name = names[prefix];
+                        break;
+                    }
+                    default: name = nullptr; break;
+                }
+                if ((op == 0xF5 && prefix == 0) || op == 0xF7) {
+                    entry.operands[1] = O_Ey;
+                    entry.operands[2] = O_By;
+                }
+            } else if (op == 0xF0 || op == 0xF1) {
+                simd = false;
+                entry.operands[0] = (op == 0xF0 && prefix != 3) ? O_Gv : O_Ev;
+                entry.operands[1] = (op == 0xF0 && prefix != 3) ? O_M : O_Gv;
+                if (prefix == 3) {
+                    entry.operands[0] = O_Gy;
+                    entry.operands[1] = op == 0xF0 ? O_Eb : O_Ev;
+                }
+            }
+            break;
+        case X86OpcodeMap::Map0F3A:
+            simd = true;
+            nds = instruction.vexRegister != 0;
+            entry.operands[2] = O_Ib;
+            name = Map0F3AName(op);
+            break;
+    }
+
+    uint8_t list[4] = {};
+    size_t count = 0;
+    for (uint8_t operand : entry.operands) {
+        if (operand != O_NONE) list[count++] = operand;
+    }
+
+    // ModRM.reg, condition code and operand-size dependent mnemonics
+    switch (entry.group) {
+        case G_ALU: name = kAluNames[reg]; break;
+        case G_SHIFT: name = kShiftNames[reg]; break;
+        case G_UNARY:
+            name = kUnaryNames[reg];
+            if (reg < 2) list[count++] = (op & 1) ? O_Iz : O_Ib;
+            break;
+        case G_INCDEC: name = reg == 0 ? "inc" : (reg == 1 ? "dec" : "???"); break;
+        case G_FF: {
+            static const char* const names[8] = { "inc", "dec", "call", "call far", "jmp", "jmp far", "push", "???" };
+            name = names[reg];
+            break;
+        }
+        case G_POP: name = reg == 0 ? "pop" : "???"; break;
+        case G_MOV: name = reg == 0 ? "mov" : "???"; break;
+        case G_JCC: mnemonic.Append('j'); name = kConditionNames[op & 15]; break;
+        case G_SETCC: mnemonic.Append("set"); name = kConditionNames[op & 15]; break;
+        case G_CMOVCC: mnemonic.Append("cmov"); name = kConditionNames[op & 15]; break;
+        case G_X87:
+            if (!registerForm) {
+                name = kX87MemoryNames[op - 0xD8][reg];
+            } else {
+                bool hasOperand = true;
+                name = X87RegisterName(op, instruction.modrm, hasOperand);
+                if (!hasOperand) count = 0;
+                if (op == 0xDF && instruction.modrm == 0xE0) list[count++] = O_AX;
+            }
+            break;
+        case G_0F00: {
+            static const char* const names[8] = { "sldt", "str", "lldt", "ltr", "verr", "verw", "???", "???" };
+            name = names[reg];
+            break;
+        }
+        case G_0F01:
+            if (registerForm) {
+                count = 0;
+                switch (instruction.modrm) {
+                    case 0xC1: name = "vmcall"; break;
+                    case 0xC2: name = "vmlaunch"; break;
+                    case 0xC3: name = "vmresume"; break;
+                    case 0xC4: name = "vmxoff"; break;
+                    case 0xC8: name = "monitor"; break;
+                    case 0xC9: name = "mwait"; break;
+                    case 0xCA: name = "clac"; break;
+                    case 0xCB: name = "stac"; break;
+                    case 0xD0: name = "xgetbv"; break;
+                    case 0xD1: name = "xsetbv"; break;
+                    case 0xD5: name = "xend"; break;
+                    case 0xD6: name = "xtest"; break;
+                    case 0xF8: name = "swapgs"; break;
+                    case 0xF9: name = "rdtscp"; break;
+                    default:
+                        if (reg == 4 || reg == 6) {
+                            name = reg == 4 ? "smsw" : "lmsw";
+                            list[count++] = O_Ew;
+                        }
+                        break;
+                }
+            } else {
+                static const char* const names[8] = { "sgdt", "sidt", "lgdt", "lidt", "smsw", "???", "lmsw", "invlpg" };
+                name = names[reg];
+            }
+            break;
+        case G_0FBA: {
+            static const char* const names[8] = { "???", "???", "???", "???", "bt", "bts", "btr", "btc" };
+            name = names[reg];
+            break;
+        }
+        case G_0FC7:
+            if (registerForm) {
+                name = reg == 6 ? "rdrand" : (reg == 7 ? "rdseed" : "???");
+                list[0] = O_Ev;
+            } else if (reg == 1) {
+                name = (instruction.rex & 8) ? "cmpxchg16b" : "cmpxchg8b";
+            }
+            break;
+        case G_0FAE:
+            if (registerForm) {
+                count = 0;
+                name = reg == 5 ? "lfence" : (reg == 6 ? "mfence" : (reg == 7 ? "sfence" : "???"));
+            } else {
+                static const char* const names[8] = { "fxsave", "fxrstor", "ldmxcsr", "stmxcsr", "xsave", "xrstor", "xsaveopt", "clflush" };
+                name = names[reg];
+            }
+            break;
+        case G_0F18: {
+            static const char* const names[4] = { "prefetchnta", "prefetcht0", "prefetcht1", "prefetcht2" };
+            name = reg < 4 ? names[reg] : "nop";
+            break;
+        }
+        case G_PSHIFT: {
+            static const char* const names[3][8] = {
+                { nullptr, nullptr, "psrlw", nullptr, "psraw", nullptr, "psllw", nullptr },
+                { nullptr, nullptr, "psrld", nullptr, "psrad", nullptr, "pslld", nullptr },
+                { nullptr, nullptr, "psrlq", "psrldq", nullptr, nullptr, "psllq", "pslldq" }
+            };
+            simd = true;
+            name = names[op - 0x71][reg];
+            break;
+        }
+        default:
+            break;
+    }
+
+    // Forms that differ from the table entry
+    if (instruction.map == X86OpcodeMap::Primary) {
+        switch (op) {
+            case 0x63:
+                if (!is64bit) {
+                    name = "arpl";
+                    list[0] = O_Ew;
+                    list[1] = O_Gw;
+                }
+                break;
+            case 0x6D: name = size == 2 ? "insw" : "insd"; break;
+            case 0x6F: name = size == 2 ? "outsw" : "outsd"; break;
+            case 0x90:
+                if (instruction.rex & 1) {
+                    name = "xchg";
+                    list[count++] = O_Zv;
+                    list[count++] = O_rAX;
+                } else if (instruction.prefixes & X86_PREFIX_REP) {
+                    name = "pause";
+                }
+                break;
+            case 0x98: name = SizedName(size, "cbw", "cwde", "cdqe"); break;
+            case 0x99: name = SizedName(size, "cwd", "cdq", "cqo"); break;
+            case 0x9C: name = SizedName(size, "pushf", "pushfd", "pushfq"); break;
+            case 0x9D: name = SizedName(size, "popf", "popfd", "popfq"); break;
+            case 0xA5: name = SizedName(size, "movsw", "movsd", "movsq"); break;
+            case 0xA7: name = SizedName(size, "cmpsw", "cmpsd", "cmpsq"); break;
+            case 0xAB: name = SizedName(size, "stosw", "stosd", "stosq"); break;
+            case 0xAD: name = SizedName(size, "lodsw", "lodsd", "lodsq"); break;
+            case 0xAF: name = SizedName(size, "scasw", "scasd", "scasq"); break;
+            case 0xCF: name = SizedName(size, "iret", "iretd", "iretq"); break;
+            case 0xE3: name = SizedName(instruction.addressSize, "jcxz", "jecxz", "jrcxz"); break;
+            case 0x60: name = size == 2 ? "pusha" : "pushad"; break;
+            case 0x61: name = size == 2 ? "popa" : "popad"; break;
+            default: break;
+        }
+    } else if (instruction.map == X86OpcodeMap::Map0F) {
+        switch (op) {
+            case 0x12: if (prefix == 0 && registerForm) name = "movhlps"; break;
+            case 0x16: if (prefix == 0 && registerForm) name = "movlhps"; break;
+            case 0x1E:
+                if (prefix == 2 && (instruction.modrm == 0xFA || instruction.modrm == 0xFB)) {
+                    name = instruction.modrm == 0xFA ? "endbr64" : "endbr32";
+                    count = 0;
+                }
+                break;
+            case 0xB8: if (prefix != 2) name = "???"; break;
+            case 0xBC: if (prefix == 2) name = "tzcnt"; break;
+            case 0xBD: if (prefix == 2) name = "lzcnt"; break;
+            case 0x6E: if (instruction.rex & 8) name = "movq"; break;
+            case 0x6F: case 0x7F:
+                // EVEX splits the integer moves by element size
+                if (instruction.vex == 4 && prefix != 0) {
+                    bool wide = (instruction.rex & 8) != 0;
+                    if (prefix == 1) name = wide ? "movdqa64" : "movdqa32";
+                    else if (prefix == 2) name = wide ? "movdqu64" : "movdqu32";
+                    else name = wide ? "movdqu16" : "movdqu8";
+                }
+                break;
+            case 0x7E:
+                if (prefix == 2) {
+                    list[0] = O_V;
+                    list[1] = O_W;
+                } else if (instruction.rex & 8) {
+                    name = "movq";
+                }
+                break;
+            case 0x77:
+                if (instruction.vex) name = instruction.vectorLength ? "zeroall" : "zeroupper";
+                break;
+            default: break;
+        }
+    }
+
+    // Prefixes that are part of the mnemonic
+    if (instruction.prefixes & X86_PREFIX_LOCK) mnemonic.Append("lock ");
+    bool stringOp = instruction.map == X86OpcodeMap::Primary && ((op >= 0xA4 && op <= 0xA7) || (op >= 0xAA && op <= 0xAF) || (op >= 0x6C && op <= 0x6F));
+    if (stringOp && (instruction.prefixes & (X86_PREFIX_REP | X86_PREFIX_REPNE))) {
+        bool compares = op == 0xA6 || op == 0xA7 || op == 0xAE || op == 0xAF;
+        if (instruction.prefixes & X86_PREFIX_REPNE) mnemonic.Append("repne ");
+        else mnemonic.Append(compares ? "repe " : "rep ");
+    }
+    if (simd && instruction.vex) mnemonic.Append('v');
+    mnemonic.Append(name ? name : "???");
+
+    // VEX forms with a vvvv source: shifts by immediate write vvvv, the rest read it second
+    if (instruction.vex && (nds || entry.group == G_PSHIFT) && count > 0 && count < 4) {
+        uint8_t insertAt = entry.group == G_PSHIFT ? 0 : 1;
+        for (size_t i = count; i > insertAt; i--) list[i] = list[i - 1];
+        list[insertAt] = O_NONE;
+        count++;
+    }
+
+    OperandContext context{ instruction, VectorKind(instruction, prefix), 0, 0 };
+    context.vectorMemorySize = VectorMemorySize(instruction, context.vectorKind, prefix);
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) operands.Append(", ");
+        if (list[i] == O_NONE) {
+            AppendVector(operands, context.vectorKind, instruction.vexRegister);
+        } else {
+            AppendOperand(operands, list[i], context);
+        }
+    }
+}
+
+} // namespace InternalEngine
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace InternalEngine {
+
+enum class X86OpcodeMap : uint8_t {
+    Primary,
+    Map0F,
+    Map0F38,
+    Map0F3A
+};
+
+static const uint32_t X86_FLAG_MODRM = 0x0001;
+static const uint32_t X86_FLAG_SIB = 0x0002;
+static const uint32_t X86_FLAG_RIP_RELATIVE = 0x0004;   // target = address the memory operand refers to
+static const uint32_t X86_FLAG_RELATIVE = 0x0008;       // Relative branch; target = destination
+static const uint32_t X86_FLAG_JUMP = 0x0010;
+static const uint32_t X86_FLAG_CALL = 0x0020;
+static const uint32_t X86_FLAG_RET = 0x0040;
+static const uint32_t X86_FLAG_CONDITIONAL = 0x0080;
+static const uint32_t X86_FLAG_INVALID = 0x0100;        // Undecodable byte (length 1, opcode = the byte)
+static const uint32_t X86_FLAG_64BIT = 0x0200;          // Decoded in 64-bit mode
+
+static const uint8_t X86_PREFIX_OPERAND_SIZE = 0x01;
+static const uint8_t X86_PREFIX_ADDRESS_SIZE = 0x02;
+static const uint8_t X86_PREFIX_LOCK = 0x04;
+static const uint8_t X86_PREFIX_REP = 0x08;             // F3
+static const uint8_t X86_PREFIX_REPNE = 0x10;           // F2
+
+// One decoded instruction. Plain data with every field the formatter needs, so a whole
+// function decodes into one vector without touching the heap per instruction.
+struct X86Instruction {
+    uintptr_t address = 0;
+    uintptr_t target = 0;           // See X86_FLAG_RELATIVE / X86_FLAG_RIP_RELATIVE
+    uint64_t immediate = 0;         // First immediate, zero-extended (rel8/rel32 included)
+    int32_t displacement = 0;
+    uint32_t flags = 0;
+    uint16_t immediate2 = 0;        // Second immediate (enter, far pointer selector)
+    uint8_t length = 0;
+    uint8_t opcode = 0;
+    X86OpcodeMap map = X86OpcodeMap::Primary;
+    uint8_t prefixes = 0;           // X86_PREFIX_*
+    uint8_t segment = 0;            // Override: 0 none, 1 es, 2 cs, 3 ss, 4 ds, 5 fs, 6 gs
+    uint8_t rex = 0;                // REX byte (VEX/EVEX R, X, B, W folded in)
+    uint8_t modrm = 0;
+    uint8_t sib = 0;
+    uint8_t operandSize = 0;        // 2, 4 or 8 bytes
+    uint8_t addressSize = 0;
+    uint8_t dispOffset = 0;         // Offsets from the first byte; 0 when absent
+    uint8_t dispSize = 0;
+    uint8_t immOffset = 0;
+    uint8_t immSize = 0;
+    uint8_t vex = 0;                // 0, 2 or 3 (VEX bytes), 4 (EVEX)
+    uint8_t vexPrefix = 0;          // Implied prefix: 0 none, 1 66, 2 F3, 3 F2
+    uint8_t vexRegister = 0;        // vvvv (EVEX V' included), already inverted
+    uint8_t vectorLength = 0;       // 0 = 128, 1 = 256, 2 = 512 bits
+    uint8_t registerHigh = 0;       // EVEX R' (bit 0) and X (bit 1): +16 for vector ModRM.reg / ModRM.rm
+};
+
+// Text of one instruction, formatted into fixed buffers
+struct X86Text {
+    char mnemonic[32];
+    char operands[128];
+};
+
+// 🧩 x86/x64 명령어 디코더
+// Lengths come from opcode attribute tables generated at compile time (one 32-bit entry per
+// opcode; ModRM, immediate, branch and validity bits), so decoding touches a few hundred
+// bytes of tables and never builds strings. Text is produced separately by Format and only
+// for the instructions that are actually displayed. Covers the general-purpose, x87 and
+// SSE/AVX encodings (VEX/EVEX for length); mnemonics of rare SIMD opcodes show as "???".
+class X86Decoder {
+public:
+    static const size_t MAX_INSTRUCTION_LENGTH = 15;
+
+    // Decodes the instruction at code (at most available bytes) as if it were located at
+    // address. Returns false for invalid or truncated encodings.
+    static bool Decode(const uint8_t* code, size_t available, uintptr_t address, bool is64bit, X86Instruction& instruction);
+
+    // Decodes [code, code + size) into instructions (appended) until maxCount instructions;
+    // undecodable bytes become one-byte X86_FLAG_INVALID entries. Returns the bytes consumed.
+    static size_t DecodeRange(const uint8_t* code, size_t size, uintptr_t address, bool is64bit,
+                              std::vector<X86Instruction>& instructions, size_t maxCount = SIZE_MAX);
+
+    // Length in the native mode, 0 if invalid (hook prologue sizing)
+    static size_t GetLength(const uint8_t* code, size_t available = MAX_INSTRUCTION_LENGTH);
+
+    // Intel-syntax mnemonic and operands (branch and RIP-relative targets shown absolute)
+    static void Format(const X86Instruction& instruction, X86Text& text);
+};
+
+} // namespace InternalEngine
@@ -8,6 +8,7 @@
 #include "HookManager.hpp"
 #include "CommandRouter.hpp"
 #include "WebSocketServer.hpp"
+#include "SignatureCache.hpp"
 // IPC Server removed - WebSocket-only architecture
 
 using namespace InternalEngine;
@@ -45,18 +46,42 @@ void InitializeEngine() {
         LogToConsole("Setting up WebSocket message handler...");
         g_WebSocketServer->SetMessageHandler([](const std::string& message, WebSocketConnection* conn) {
             if (g_CommandRouter) {
-                std::string response = g_CommandRouter->ExecuteCommand(message);
+                std::string response = g_CommandRouter->ExecuteCommand(message, conn);
                 return response;
             }
             return std::string("{\"error\": \"Command router not initialized\"}");
         });
         
+        g_WebSocketServer->SetBinaryHandler([](const std::vector<uint8_t>& message, WebSocketConnection* conn) {
+            if (g_CommandRouter) {
+                return g_CommandRouter->ExecuteBinaryCommand(message, conn);
+            }
+            return std::vector<uint8_t>();
+        });
+        
+        // command.cancel is answered on the I/O thread so it never queues behind the scan it stops
+        g_WebSocketServer->SetControlHandler([](const std::string& message, WebSocketConnection* conn) {
+            if (g_CommandRouter) {
+                return g_CommandRouter->ExecuteControlCommand(message, conn);
+            }
+            return std::string();
+        });
+        
+        g_WebSocketServer->SetClosingHandler([](WebSocketConnection* conn) {
+            if (g_CommandRouter) {
+                g_CommandRouter->CancelConnectionCommands(conn);
+            }
+        });
+        
         // Set up connection handler for monitoring
         g_WebSocketServer->SetConnectionHandler([](WebSocketConnection* conn, bool connected) {
             if (connected) {
                 LogToConsole("New WebSocket client connected: " + conn->GetClientAddress());
             } else {
                 LogToConsole("WebSocket client disconnected: " + conn->GetClientAddress());
+                if (g_CommandRouter) {
+                    g_CommandRouter->OnConnectionClosed(conn);
+                }
             }
         });
         
@@ -87,6 +112,11 @@ void InitializeEngine() {
 void CleanupEngine() {
     LogToConsole("=== Cleaning up Internal Engine ===");
     
+    // Background engine threads push through the WebSocket server - stop them first
+    if (g_CommandRouter) {
+        g_CommandRouter->Shutdown();
+    }
+    
     // Stop WebSocket server first (primary communication)
     if (g_WebSocketServer) {
         LogToConsole("Stopping WebSocket server...");
@@ -130,6 +160,10 @@ void CoreThread() {
     LogToConsole("Entering main loop...");
     while (g_Running) {
         Sleep(1000); // Check every second
+        
+        // Signature cache changes are written in batches, not after every lookup
+        std::string cacheError;
+        SignatureCache::FlushIfDue(cacheError);
     }
     
     LogToConsole("Exiting main loop...");
@@ -2,6 +2,7 @@ import React, { useState } from 'react'
 import { FiCopy, FiRefreshCw, FiEye, FiCode, FiSearch, FiNavigation, FiMessageSquare, FiCpu, FiCornerDownRight } from 'react-icons/fi'
 import { useEngineStore } from '../store/engineStore'
 import ContextMenu, { useContextMenu, ContextMenuItem } from './ContextMenu'
+import { dllConnection } from '../utils/directDllConnection'
 
 interface DisassemblyInstruction {
   address: string
@@ -16,6 +17,22 @@ interface DisassemblyInstruction {
   target?: string
 }
 
+// Byte views are kept live by a viewer subscription: the DLL pushes only the changed ranges
+const VIEWER_RATE_HZ = 30
+
+// Split a flat byte window into display rows, zero-padding the last one
+const toRows = (data: ArrayLike<number>, rows: number, bytesPerRow: number): number[][] => {
+  const rowData: number[][] = []
+  for (let i = 0; i < rows; i++) {
+    const row = new Array<number>(bytesPerRow).fill(0)
+    for (let j = 0; j < bytesPerRow && i * bytesPerRow + j < data.length; j++) {
+      row[j] = data[i * bytesPerRow + j]
+    }
+    rowData.push(row)
+  }
+  return rowData
+}
+
 export default function MemoryViewer() {
   const [address, setAddress] = React.useState('0x00400000')
   const processInfo = useEngineStore(state => state.processInfo)
@@ -48,6 +65,55 @@ export default function MemoryViewer() {
   const validateAddress = useEngineStore(state => state.validateAddress)
   const isConnected = useEngineStore(state => state.isConnected)
   
+  // Live viewer subscription; the generation drops subscribes that a newer load overtook
+  const viewerRef = React.useRef<number | null>(null)
+  const viewerGeneration = React.useRef(0)
+  
+  const stopViewer = () => {
+    viewerGeneration.current++
+    if (viewerRef.current !== null) {
+      dllConnection.unsubscribeViewer(viewerRef.current)
+      viewerRef.current = null
+    }
+  }
+  
+  const startViewer = async (totalBytes: number) => {
+    stopViewer()
+    const generation = viewerGeneration.current
+    const width = bytesPerRow
+    
+    const subscription = await dllConnection.subscribeViewer(address, totalBytes, VIEWER_RATE_HZ, {
+      onChange: ranges => setMemoryData(previous => {
+        const next = previous.slice()
+        const copied = new Set<number>()
+        for (const range of ranges) {
+          for (let i = 0; i < range.length; i++) {
+            const offset = range.offset + i
+            const row = Math.floor(offset / width)
+            if (row >= next.length) break
+            if (!copied.has(row)) {
+              next[row] = next[row].slice()
+              copied.add(row)
+            }
+            next[row][offset % width] = range.data ? range.data[i] : 0
+          }
+        }
+        return next
+      }),
+      onGap: () => {
+        if (generation === viewerGeneration.current) loadMemoryData()
+      }
+    })
+    
+    if (generation !== viewerGeneration.current) {
+      await dllConnection.unsubscribeViewer(subscription.subscriptionId)
+      return
+    }
+    viewerRef.current = subscription.subscriptionId
+    setMemoryData(toRows(subscription.data, rows, width))
+    setError(null)
+  }
+  
   const loadMemory = async () => {
     if (!isConnected) {
       setError('Not connected to engine')
@@ -74,6 +140,7 @@ export default function MemoryViewer() {
       const validation = await validateAddress(address, totalBytes)
       
       if (!validation.valid) {
+        stopViewer()
         setError(`Invalid memory address: ${address}`)
         setAddressInfo(null)
         setMemoryData([])
@@ -81,6 +148,7 @@ export default function MemoryViewer() {
       }
       
       if (!validation.readable) {
+        stopViewer()
         setError(`Memory address is not readable: ${address}`)
         setAddressInfo(validation)
         setMemoryData([])
@@ -89,22 +157,20 @@ export default function MemoryViewer() {
       
       setAddressInfo(validation)
       
+      if (dataType === 'bytes') {
+        try {
+          await startViewer(totalBytes)
+          return
+        } catch (error) {
+          console.warn('Viewer subscription failed, falling back to memory.read:', error)
+        }
+      }
+      stopViewer()
+      
       const data = await readMemory(address, totalBytes, dataType)
       
       if (Array.isArray(data) && data.length > 0) {
-        const rowData: number[][] = []
-        for (let i = 0; i < rows; i++) {
-          const startIdx = i * bytesPerRow
-          const endIdx = Math.min(startIdx + bytesPerRow, data.length)
-          const rowBytes = data.slice(startIdx, endIdx)
-          
-          while (rowBytes.length < bytesPerRow) {
-            rowBytes.push(0)
-          }
-          
-          rowData.push(rowBytes)
-        }
-        setMemoryData(rowData)
+        setMemoryData(toRows(data, rows, bytesPerRow))
         setError(null)
       } else {
         setError('Failed to read memory data')
@@ -112,6 +178,7 @@ export default function MemoryViewer() {
       }
     } catch (error) {
       console.error('Failed to read memory:', error)
+      stopViewer()
       setError(`Memory read error: ${error}`)
       setMemoryData([])
       setAddressInfo(null)
@@ -352,6 +419,12 @@ export default function MemoryViewer() {
     }
   }, [isConnected, bytesPerRow, rows, dataType, activeTab])
   
+  // The subscription only lives while the byte view is on screen
+  React.useEffect(() => {
+    if (!isConnected || activeTab !== 'memory') stopViewer()
+  }, [isConnected, activeTab])
+  React.useEffect(() => stopViewer, [])
+  
   const renderMemoryValue = (rowData: number[], format: 'hex' | 'ascii' | 'int' | 'float') => {
     switch (format) {
       case 'hex':
@@ -7,6 +7,7 @@ import {
 import { useEngineStore } from '../store/engineStore'
 import { useWindowManagerStore } from '../store/windowManager'
 import { dllConnection } from '../utils/directDllConnection'
+import { binaryProtocol } from '../utils/binaryProtocol'
 import ContextMenu, { useContextMenu, ContextMenuItem } from './ContextMenu'
 
 interface ScanResult {
@@ -267,6 +268,40 @@ export default function Scanner() {
     }
   }
   
+  // First scan with results streamed in binary batches - the list renders while the DLL scans
+  const runStreamingScan = async (scanData: any) => {
+    const streamed: ScanResult[] = []
+    let lastRender = 0
+    
+    setIsStreaming(true)
+    setScanResults([])
+    try {
+      const response = await dllConnection.streamScan(scanData, {
+        onResults: (batch) => {
+          for (let i = 0; i < batch.addresses.length; i++) {
+            const value = binaryProtocol.valueToString(batch.values[i], batch.type)
+            streamed.push({
+              address: `0x${batch.addresses[i].toString(16)}`,
+              value,
+              originalValue: value,
+              hasChanged: false
+            })
+          }
+          
+          // Re-render at most 4 times per second while batches keep coming
+          const now = performance.now()
+          if (now - lastRender > 250) {
+            lastRender = now
+            setScanResults(streamed.slice())
+          }
+        }
+      })
+      return { response, streamed }
+    } finally {
+      setIsStreaming(false)
+    }
+  }
+  
   const performScan = async () => {
     if (!isConnected) {
       alert('Not connected to target process')
@@ -295,13 +330,16 @@ export default function Scanner() {
         unrandomizer
       }
       
-      const response = await sendCommand(scanData)
+      const useStreaming = streamingEnabled && scanCount === 0 && dllConnection.isConnected()
+      const { response, streamed } = useStreaming
+        ? await runStreamingScan(scanData)
+        : { response: await sendCommand(scanData), streamed: [] as ScanResult[] }
       const scanTime = performance.now() - scanStartTime
       
       
       if (response.success) {
         // Process results with module info (already included from DLL)
-        const results = response.data.map((result: any) => ({
+        const results = response.data?.streamed ? streamed : response.data.map((result: any) => ({
           address: result.address,
           value: result.value,
           previousValue: scanCount > 0 ? result.previousValue : undefined,
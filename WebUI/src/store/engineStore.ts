@@ -91,6 +91,54 @@ interface EngineState {
   updateMonitoredValue: (address: string, newValue: string) => void
 }
 
+// Fixed-size monitored values are pushed by a DLL watch (watch.subscribe) instead of polled
+const WATCHABLE_TYPES = ['int32', 'int', 'int64', 'float', 'double', 'byte']
+const MONITOR_WATCH_RATE_HZ = 60
+let monitorWatch: { id: number, addresses: Set<string> } | null = null
+let monitorWatchTimer: ReturnType<typeof setTimeout> | null = null
+let monitorWatchGeneration = 0
+
+// Viewport scrolling changes the monitored set in bursts - resubscribe once it settles
+const scheduleMonitorWatchSync = (get: () => EngineState) => {
+  if (monitorWatchTimer) clearTimeout(monitorWatchTimer)
+  
+  monitorWatchTimer = setTimeout(async () => {
+    monitorWatchTimer = null
+    const generation = ++monitorWatchGeneration
+    
+    const previous = monitorWatch
+    monitorWatch = null
+    if (previous) await dllConnection.unsubscribeWatch(previous.id)
+    
+    const { monitoredValues, isConnected } = get()
+    const watched = Array.from(monitoredValues.entries()).filter(([, data]) => WATCHABLE_TYPES.includes(data.type))
+    if (!isConnected || watched.length === 0) return
+    
+    const addresses = watched.map(([address]) => address)
+    try {
+      const id = await dllConnection.subscribeWatch(
+        watched.map(([address, data]) => ({ address, type: data.type })),
+        MONITOR_WATCH_RATE_HZ,
+        changes => {
+          const { updateMonitoredValue } = get()
+          changes.forEach(({ index, value }) => {
+            if (value !== null && index < addresses.length) updateMonitoredValue(addresses[index], value)
+          })
+        }
+      )
+      
+      // A newer sync started while this one was subscribing
+      if (generation !== monitorWatchGeneration) {
+        await dllConnection.unsubscribeWatch(id)
+        return
+      }
+      monitorWatch = { id, addresses: new Set(addresses) }
+    } catch (error) {
+      console.warn('Watch subscription failed, falling back to polling:', error)
+    }
+  }, 150)
+}
+
 export const useEngineStore = create<EngineState>((set, get) => ({
   // Initial state - Direct WebSocket only
   isConnected: false,
@@ -188,8 +236,9 @@ export const useEngineStore = create<EngineState>((set, get) => ({
   disconnect: () => {
     console.log('🔌 Disconnecting from DLL WebSocket server...')
     
-    // Disconnect from DLL directly
+    // Disconnect from DLL directly (drops its watch subscriptions too)
     dllConnection.disconnect()
+    monitorWatch = null
     
     get().stopPolling()
     
@@ -522,7 +571,27 @@ export const useEngineStore = create<EngineState>((set, get) => ({
           const startIndex = (pollingCycleCount * batchSize) % monitoredArray.length;
           const currentBatch = monitoredArray.slice(startIndex, startIndex + batchSize);
           
-          for (const [monitoredAddress, monitoredData] of currentBatch) {
+          // Values covered by the monitor watch are pushed by the DLL; other fixed-size values
+          // go out in one binary bulk read instead of one JSON command each
+          const polled = currentBatch.filter(([address]) => !monitorWatch?.addresses.has(address));
+          const binaryBatch = polled.filter(([, data]) => WATCHABLE_TYPES.includes(data.type));
+          const jsonBatch = polled.filter(([, data]) => !WATCHABLE_TYPES.includes(data.type));
+          
+          if (binaryBatch.length > 0) {
+            readPromises.push(
+              dllConnection.readValuesBinary(binaryBatch.map(([address, data]) => ({ address, type: data.type })))
+                .then(values => {
+                  values.forEach((currentValue, i) => {
+                    if (currentValue !== null) {
+                      updateMonitoredValue(binaryBatch[i][0], currentValue);
+                    }
+                  });
+                })
+                .catch(() => {})
+            );
+          }
+          
+          for (const [monitoredAddress, monitoredData] of jsonBatch) {
             readPromises.push(
               readValue(monitoredAddress, monitoredData.type)
                 .then(currentValue => {
@@ -614,6 +683,7 @@ export const useEngineStore = create<EngineState>((set, get) => ({
     }
     
     set({ monitoredValues, valueUpdateCallbacks });
+    scheduleMonitorWatchSync(get);
   },
 
   stopMonitoring: (address: string) => {
@@ -623,6 +693,7 @@ export const useEngineStore = create<EngineState>((set, get) => ({
     valueUpdateCallbacks.delete(address);
     
     set({ monitoredValues, valueUpdateCallbacks });
+    scheduleMonitorWatchSync(get);
   },
 
   updateMonitoredValue: (address: string, newValue: string) => {
@@ -10,9 +10,17 @@ export enum BinaryOpcode {
   PROCESS_INFO = 0x06,
   MODULE_LIST = 0x07,
   PING = 0x08,
-  PONG = 0x09
+  PONG = 0x09,
+  SCAN_PROGRESS = 0x0A,
+  SCAN_RESULTS = 0x0B,
+  VIEWER_UPDATE = 0x0E
 }
 
+// Header flags
+export const BINARY_FLAG_FINAL = 0x01
+export const BINARY_FLAG_ERROR = 0x02
+export const BINARY_FLAG_WATCH = 0x04
+
 export enum DataType {
   INT32 = 0x01,
   INT64 = 0x02,
@@ -50,6 +58,33 @@ export interface ValueUpdate {
   value: Uint8Array
 }
 
+export interface ScanProgress {
+  streamId: number
+  chunksDone: number
+  chunksTotal: number
+  resultsFound: number
+  finished: boolean
+}
+
+export interface ScanResultBatch {
+  streamId: number
+  type: DataType
+  addresses: bigint[]
+  values: Uint8Array[]
+}
+
+export interface ViewerRange {
+  offset: number
+  length: number
+  data: Uint8Array | null // null: these bytes became unreadable
+}
+
+export interface ViewerUpdate {
+  subscriptionId: number
+  sequence: number
+  ranges: ViewerRange[]
+}
+
 export class BinaryProtocolClient {
   private requestIdCounter = 1
   private pendingRequests = new Map<number, (response: any) => void>()
@@ -57,7 +92,7 @@ export class BinaryProtocolClient {
   // Encode binary messages
   encodeMemoryRead(address: string, size: number, type: string): ArrayBuffer {
     const requestId = this.requestIdCounter++
-    const buffer = new ArrayBuffer(32) // Header + MemoryReadRequest
+    const buffer = new ArrayBuffer(29) // Header + MemoryReadRequest (packed)
     const view = new DataView(buffer)
     
     // Header
@@ -65,7 +100,7 @@ export class BinaryProtocolClient {
     view.setUint16(4, 0x0001, true) // version
     view.setUint8(6, BinaryOpcode.MEMORY_READ)
     view.setUint8(7, 0) // flags
-    view.setUint32(8, 16, true) // payload size
+    view.setUint32(8, 13, true) // payload size
     view.setUint32(12, requestId, true)
     
     // Payload
@@ -79,7 +114,7 @@ export class BinaryProtocolClient {
   
   encodeMemoryWrite(address: string, type: string, data: Uint8Array): ArrayBuffer {
     const requestId = this.requestIdCounter++
-    const buffer = new ArrayBuffer(32 + data.length) // Header + MemoryWriteRequest + data
+    const buffer = new ArrayBuffer(29 + data.length) // Header + MemoryWriteRequest (packed) + data
     const view = new DataView(buffer)
     
     // Header
@@ -87,7 +122,7 @@ export class BinaryProtocolClient {
     view.setUint16(4, 0x0001, true) // version
     view.setUint8(6, BinaryOpcode.MEMORY_WRITE)
     view.setUint8(7, 0) // flags
-    view.setUint32(8, 16 + data.length, true) // payload size
+    view.setUint32(8, 13 + data.length, true) // payload size
     view.setUint32(12, requestId, true)
     
     // Payload
@@ -103,6 +138,31 @@ export class BinaryProtocolClient {
     return buffer
   }
   
+  // BULK_UPDATE request: count u32, then count * MemoryReadRequest (address u64, size u32, type u8)
+  encodeBulkRead(entries: Array<{ address: string, size: number, type: string }>): ArrayBuffer {
+    const requestId = this.requestIdCounter++
+    const payloadSize = 4 + entries.length * 13
+    const buffer = new ArrayBuffer(16 + payloadSize)
+    const view = new DataView(buffer)
+    
+    this.writeHeader(view, BinaryOpcode.BULK_UPDATE, payloadSize, requestId)
+    view.setUint32(16, entries.length, true)
+    entries.forEach((entry, i) => {
+      const offset = 20 + i * 13
+      view.setBigUint64(offset, BigInt(entry.address), true)
+      view.setUint32(offset + 8, entry.size, true)
+      view.setUint8(offset + 12, this.stringToDataType(entry.type))
+    })
+    
+    return buffer
+  }
+  
+  encodePing(): ArrayBuffer {
+    const buffer = new ArrayBuffer(16)
+    this.writeHeader(new DataView(buffer), BinaryOpcode.PING, 0, this.requestIdCounter++)
+    return buffer
+  }
+  
   // Decode binary messages
   decodeHeader(buffer: ArrayBuffer): BinaryHeader | null {
     if (buffer.byteLength < 16) return null
@@ -123,7 +183,7 @@ export class BinaryProtocolClient {
   }
   
   decodeValueUpdate(buffer: ArrayBuffer, offset: number = 16): ValueUpdate | null {
-    if (buffer.byteLength < offset + 16) return null
+    if (buffer.byteLength < offset + 13) return null
     
     const view = new DataView(buffer, offset)
     const address = view.getBigUint64(0, true)
@@ -154,7 +214,85 @@ export class BinaryProtocolClient {
     return updates
   }
   
+  // SCAN_PROGRESS: chunksDone u32, chunksTotal u32, resultsFound u64
+  decodeScanProgress(buffer: ArrayBuffer): ScanProgress | null {
+    const header = this.decodeHeader(buffer)
+    if (!header || header.opcode !== BinaryOpcode.SCAN_PROGRESS || buffer.byteLength < 32) return null
+    
+    const view = new DataView(buffer, 16)
+    return {
+      streamId: header.requestId,
+      chunksDone: view.getUint32(0, true),
+      chunksTotal: view.getUint32(4, true),
+      resultsFound: Number(view.getBigUint64(8, true)),
+      finished: (header.flags & BINARY_FLAG_FINAL) !== 0
+    }
+  }
+  
+  // SCAN_RESULTS: count u32, type u8, reserved u8, valueSize u16, then count * (address u64 + value)
+  decodeScanResults(buffer: ArrayBuffer): ScanResultBatch | null {
+    const header = this.decodeHeader(buffer)
+    if (!header || header.opcode !== BinaryOpcode.SCAN_RESULTS || buffer.byteLength < 24) return null
+    
+    const view = new DataView(buffer, 16)
+    const count = view.getUint32(0, true)
+    const type = view.getUint8(4) as DataType
+    const valueSize = view.getUint16(6, true)
+    const stride = 8 + valueSize
+    
+    if (buffer.byteLength < 24 + count * stride) return null
+    
+    const addresses: bigint[] = new Array(count)
+    const values: Uint8Array[] = new Array(count)
+    for (let i = 0; i < count; i++) {
+      const offset = 24 + i * stride
+      addresses[i] = new DataView(buffer, offset, 8).getBigUint64(0, true)
+      values[i] = new Uint8Array(buffer, offset + 8, valueSize)
+    }
+    
+    return { streamId: header.requestId, type, addresses, values }
+  }
+  
+  // VIEWER_UPDATE: sequence u32, count u32, then count * (offset u32, length u32, bytes);
+  // the top bit of length marks an unreadable range, which carries no bytes
+  decodeViewerUpdate(buffer: ArrayBuffer): ViewerUpdate | null {
+    const header = this.decodeHeader(buffer)
+    if (!header || header.opcode !== BinaryOpcode.VIEWER_UPDATE || buffer.byteLength < 24) return null
+    
+    const view = new DataView(buffer)
+    const sequence = view.getUint32(16, true)
+    const count = view.getUint32(20, true)
+    
+    const ranges: ViewerRange[] = []
+    let offset = 24
+    for (let i = 0; i < count; i++) {
+      if (buffer.byteLength < offset + 8) return null
+      const rangeOffset = view.getUint32(offset, true)
+      const rawLength = view.getUint32(offset + 4, true)
+      offset += 8
+      
+      if ((rawLength & 0x80000000) !== 0) {
+        ranges.push({ offset: rangeOffset, length: rawLength & 0x7FFFFFFF, data: null })
+        continue
+      }
+      if (buffer.byteLength < offset + rawLength) return null
+      ranges.push({ offset: rangeOffset, length: rawLength, data: new Uint8Array(buffer, offset, rawLength) })
+      offset += rawLength
+    }
+    
+    return { subscriptionId: header.requestId, sequence, ranges }
+  }
+  
   // Utility functions
+  private writeHeader(view: DataView, opcode: BinaryOpcode, payloadSize: number, requestId: number): void {
+    view.setUint32(0, 0x494E544C, true) // magic
+    view.setUint16(4, 0x0001, true) // version
+    view.setUint8(6, opcode)
+    view.setUint8(7, 0) // flags
+    view.setUint32(8, payloadSize, true)
+    view.setUint32(12, requestId, true)
+  }
+  
   private stringToDataType(type: string): DataType {
     switch (type) {
       case 'int32': return DataType.INT32
@@ -3,6 +3,8 @@
  * This provides 50-80% performance improvement for real-time updates
  */
 
+import { binaryProtocol, BinaryOpcode, BINARY_FLAG_ERROR, BINARY_FLAG_WATCH, ScanProgress, ScanResultBatch, ValueUpdate, ViewerRange } from './binaryProtocol'
+
 export type ConnectionStatus = 'connecting' | 'connected' | 'error' | 'disconnected'
 
 export interface DllConnectionConfig {
@@ -25,6 +27,40 @@ export interface DllResponse {
   id?: string
 }
 
+export interface ScanStreamHandlers {
+  onResults?: (batch: ScanResultBatch) => void
+  onProgress?: (progress: ScanProgress) => void
+}
+
+export interface WatchEntry {
+  address: string
+  type: string
+  offsets?: string[]  // Pointer chain offsets (hex), resolved by the DLL on every sample
+}
+
+// {"type":"progress"} notification for a request sent with progress: true
+export interface CommandProgress {
+  commandId: string
+  done: number
+  total: number
+  found: number
+}
+
+// Changed entries of one watch sample; value is null when the entry became unreadable
+export type WatchChangeHandler = (changes: Array<{ index: number, value: string | null }>) => void
+
+// Changed byte ranges of a viewer window, offsets relative to the subscribed address
+export interface ViewerHandlers {
+  onChange: (ranges: ViewerRange[]) => void
+  onGap: () => void  // A frame was missed - the window must be resubscribed to resync
+}
+
+export interface ViewerSubscription {
+  subscriptionId: number
+  data: Uint8Array                             // First sample, zero-filled where unreadable
+  unreadable: Array<{ offset: number, length: number }>
+}
+
 export class DirectDllConnection {
   private ws: WebSocket | null = null
   private config: DllConnectionConfig
@@ -37,6 +73,18 @@ export class DirectDllConnection {
   private reconnectTimer: NodeJS.Timeout | null = null
   private reconnectCount = 0
   private requestId = 0
+  private nextStreamId = 1
+  private scanStreams = new Map<number, ScanStreamHandlers>()
+  private progressHandlers = new Map<string, (progress: CommandProgress) => void>()
+  private watchHandlers = new Map<number, { entries: WatchEntry[], onChange: WatchChangeHandler }>()
+  private unclaimedWatchFrames = new Map<number, ArrayBuffer[]>()
+  private viewerHandlers = new Map<number, ViewerHandlers & { sequence: number }>()
+  private unclaimedViewerFrames = new Map<number, ArrayBuffer[]>()
+  private pendingBinary = new Map<number, {
+    resolve: (response: ArrayBuffer) => void
+    reject: (error: Error) => void
+    timeout: NodeJS.Timeout
+  }>()
 
   // Event handlers
   public onStatusChange?: (status: ConnectionStatus) => void
@@ -76,8 +124,15 @@ export class DirectDllConnection {
           resolve()
         }
         
+        // Streamed scan results arrive as binary frames
+        this.ws.binaryType = 'arraybuffer'
+        
         this.ws.onmessage = (event) => {
-          this.handleMessage(event.data)
+          if (typeof event.data === 'string') {
+            this.handleMessage(event.data)
+          } else {
+            this.handleBinaryMessage(event.data as ArrayBuffer)
+          }
         }
         
         this.ws.onclose = (event) => {
@@ -116,7 +171,7 @@ export class DirectDllConnection {
     }
 
     return new Promise((resolve, reject) => {
-      const id = command.id || `req_${++this.requestId}_${Date.now()}`
+      const id = command.id || this.createCommandId()
       const commandWithId = { ...command, id }
 
       // Set up timeout
@@ -139,10 +194,224 @@ export class DirectDllConnection {
     })
   }
 
+  createCommandId(): string {
+    return `req_${++this.requestId}_${Date.now()}`
+  }
+
   /**
-   * High-performance bulk memory read for scan results
+   * Run a long command (memory.scan, pattern.scanall, pointer.find, pointer.scan, ...) with
+   * progress notifications. Pass command.id to be able to cancelCommand() it; a cancelled
+   * command resolves with success false and data.cancelled.
    */
-  async readBulkMemory(addresses: Array<{address: string, type: string}>): Promise<DllResponse> {
+  async sendCommandWithProgress(command: DllCommand, onProgress: (progress: CommandProgress) => void, timeoutMs = 300000): Promise<DllResponse> {
+    const id = command.id || this.createCommandId()
+    this.progressHandlers.set(id, onProgress)
+    try {
+      return await this.sendCommand({ ...command, id, progress: true }, timeoutMs)
+    } finally {
+      this.progressHandlers.delete(id)
+    }
+  }
+
+  /**
+   * Stop a running command of this connection at its next chunk boundary.
+   * Answered ahead of queued commands; resolves to whether the command was still running.
+   */
+  async cancelCommand(targetId: string): Promise<boolean> {
+    const response = await this.sendCommand({ command: 'command.cancel', targetId })
+    return response.success && response.data?.cancelled === true
+  }
+
+  /**
+   * Send a binary protocol message; resolves with the response carrying the same requestId
+   */
+  async sendBinary(message: ArrayBuffer, timeoutMs = 5000): Promise<ArrayBuffer> {
+    if (!this.isConnected()) {
+      throw new Error('Not connected to DLL')
+    }
+    
+    const header = binaryProtocol.decodeHeader(message)
+    if (!header) {
+      throw new Error('Invalid binary message')
+    }
+    
+    return new Promise((resolve, reject) => {
+      const timeout = setTimeout(() => {
+        this.pendingBinary.delete(header.requestId)
+        reject(new Error(`Binary command timeout: opcode ${header.opcode}`))
+      }, timeoutMs)
+      
+      this.pendingBinary.set(header.requestId, { resolve, reject, timeout })
+      
+      try {
+        this.ws!.send(message)
+      } catch (error) {
+        this.pendingBinary.delete(header.requestId)
+        clearTimeout(timeout)
+        reject(error as Error)
+      }
+    })
+  }
+
+  /**
+   * Read many fixed-size values in one binary BULK_UPDATE round trip (no JSON).
+   * Entries that could not be read come back as null.
+   */
+  async readValuesBinary(entries: Array<{ address: string, type: string }>): Promise<Array<string | null>> {
+    const sizeMap: { [key: string]: number } = { 'int32': 4, 'int': 4, 'int64': 8, 'float': 4, 'double': 8, 'byte': 1 }
+    const typeMap: { [key: string]: string } = { 'int': 'int32', 'byte': 'bytes' }
+    
+    const request = binaryProtocol.encodeBulkRead(entries.map(entry => ({
+      address: entry.address,
+      size: sizeMap[entry.type] || 4,
+      type: typeMap[entry.type] || entry.type
+    })))
+    
+    const response = await this.sendBinary(request)
+    const header = binaryProtocol.decodeHeader(response)
+    if (!header || (header.flags & BINARY_FLAG_ERROR) !== 0) {
+      throw new Error('Bulk read failed')
+    }
+    
+    const updates = binaryProtocol.decodeBulkUpdate(response)
+    return entries.map((entry, i) => this.formatBinaryValue(entry.type, updates[i]))
+  }
+
+  /**
+   * Subscribe to server-pushed changes of fixed-size values sampled at rate Hz.
+   * Only changed entries are delivered; the first delivery carries every readable entry.
+   */
+  async subscribeWatch(entries: WatchEntry[], rate: number, onChange: WatchChangeHandler): Promise<number> {
+    const response = await this.sendCommand({ command: 'watch.subscribe', addresses: entries, rate })
+    if (!response.success) {
+      throw new Error(response.error || 'watch.subscribe failed')
+    }
+    
+    const watchId = response.data.watchId as number
+    this.watchHandlers.set(watchId, { entries, onChange })
+    
+    // The first sample can arrive before the response that told us the id
+    const early = this.unclaimedWatchFrames.get(watchId)
+    this.unclaimedWatchFrames.delete(watchId)
+    early?.forEach(frame => this.dispatchWatchFrame(watchId, frame))
+    
+    return watchId
+  }
+
+  async unsubscribeWatch(watchId: number): Promise<void> {
+    this.watchHandlers.delete(watchId)
+    if (this.isConnected()) {
+      await this.sendCommand({ command: 'watch.unsubscribe', watchId }).catch(() => {})
+    }
+  }
+
+  private dispatchWatchFrame(watchId: number, buffer: ArrayBuffer): void {
+    const watch = this.watchHandlers.get(watchId)
+    if (!watch) return
+    
+    // In watch frames the address field is the entry index
+    const changes = binaryProtocol.decodeBulkUpdate(buffer).map(update => {
+      const index = Number(update.address)
+      const entry = watch.entries[index]
+      return { index, value: entry ? this.formatBinaryValue(entry.type, update) : null }
+    })
+    if (changes.length > 0) watch.onChange(changes)
+  }
+
+  /**
+   * Subscribe to a memory window sampled at rate Hz. The first sample comes back here; after
+   * that only changed byte ranges are pushed (VIEWER_UPDATE), nothing while memory is static.
+   */
+  async subscribeViewer(address: string, length: number, rate: number, handlers: ViewerHandlers): Promise<ViewerSubscription> {
+    const response = await this.sendCommand({ command: 'viewer.subscribe', address, length, rate })
+    if (!response.success) {
+      throw new Error(response.error || 'viewer.subscribe failed')
+    }
+    
+    const subscriptionId = response.data.subscriptionId as number
+    const binary = atob(response.data.data as string)
+    const data = new Uint8Array(binary.length)
+    for (let i = 0; i < binary.length; i++) data[i] = binary.charCodeAt(i)
+    const unreadable = (response.data.unreadable as number[][]).map(([offset, length]) => ({ offset, length }))
+    
+    const viewer = { ...handlers, sequence: response.data.sequence as number }
+    
+    // Diffs sampled before the response arrived are folded into the first sample
+    const early = this.unclaimedViewerFrames.get(subscriptionId) || []
+    this.unclaimedViewerFrames.delete(subscriptionId)
+    for (const frame of early) {
+      const update = binaryProtocol.decodeViewerUpdate(frame)
+      if (!update || update.sequence !== viewer.sequence + 1) break
+      viewer.sequence = update.sequence
+      for (const range of update.ranges) {
+        const end = range.offset + range.length
+        if (range.data) {
+          data.set(range.data, range.offset)
+          unreadable.splice(0, unreadable.length, ...unreadable.filter(r => r.offset < range.offset || r.offset + r.length > end))
+        } else {
+          data.fill(0, range.offset, end)
+          unreadable.push({ offset: range.offset, length: range.length })
+        }
+      }
+    }
+    this.viewerHandlers.set(subscriptionId, viewer)
+    
+    return { subscriptionId, data, unreadable }
+  }
+
+  async unsubscribeViewer(subscriptionId: number): Promise<void> {
+    this.viewerHandlers.delete(subscriptionId)
+    if (this.isConnected()) {
+      await this.sendCommand({ command: 'viewer.unsubscribe', subscriptionId }).catch(() => {})
+    }
+  }
+
+  private dispatchViewerFrame(subscriptionId: number, buffer: ArrayBuffer): void {
+    const viewer = this.viewerHandlers.get(subscriptionId)
+    const update = binaryProtocol.decodeViewerUpdate(buffer)
+    if (!viewer || !update || update.sequence <= viewer.sequence) return
+    
+    if (update.sequence !== viewer.sequence + 1) {
+      this.viewerHandlers.delete(subscriptionId)
+      viewer.onGap()
+      return
+    }
+    viewer.sequence = update.sequence
+    viewer.onChange(update.ranges)
+  }
+
+  private formatBinaryValue(type: string, update: ValueUpdate | undefined): string | null {
+    if (!update || update.value.length === 0) return null
+    if (type === 'byte') return update.value[0].toString()
+    const text = binaryProtocol.valueToString(update.value, update.type)
+    // Same precision as the DLL's std::to_string in memory.read_value
+    if (type === 'float' || type === 'double') return parseFloat(parseFloat(text).toFixed(6)).toString()
+    return text
+  }
+
+  /**
+   * Run a scan command with results streamed back in binary batches while it runs.
+   * The resolved response only carries a summary ({streamed, count, sent, complete}).
+   */
+  async streamScan(command: DllCommand, handlers: ScanStreamHandlers, batchSize = 1000): Promise<DllResponse> {
+    const streamId = this.nextStreamId++
+    if (this.nextStreamId > 0xFFFFFFFF) this.nextStreamId = 1
+    
+    this.scanStreams.set(streamId, handlers)
+    try {
+      // Long scans report progress instead of answering quickly - allow more time
+      return await this.sendCommand({ ...command, stream: true, streamId, batchSize }, 300000)
+    } finally {
+      this.scanStreams.delete(streamId)
+    }
+  }
+
+  /**
+   * High-performance bulk memory read for scan results.
+   * data.data is base64 of every value packed back to back in request order;
+   * data.readable holds one '0'/'1' per entry.
+   */
+  async readBulkMemory(addresses: Array<{address: string, type: string, size?: number}>): Promise<DllResponse> {
     return this.sendCommand({
       command: 'memory.read_bulk',
       addresses: addresses
@@ -174,6 +443,17 @@ export class DirectDllConnection {
       reject(new Error('Connection closed'))
     })
     this.pendingRequests.clear()
+    
+    this.pendingBinary.forEach(({ reject, timeout }) => {
+      clearTimeout(timeout)
+      reject(new Error('Connection closed'))
+    })
+    this.pendingBinary.clear()
+    this.progressHandlers.clear()
+    this.watchHandlers.clear()
+    this.unclaimedWatchFrames.clear()
+    this.viewerHandlers.clear()
+    this.unclaimedViewerFrames.clear()
 
     if (this.ws) {
       this.ws.close()
@@ -259,6 +539,9 @@ export class DirectDllConnection {
       // Handle real-time updates
       if (message.type) {
         switch (message.type) {
+          case 'progress':
+            this.progressHandlers.get(message.commandId)?.(message)
+            break
           case 'scan_results':
             console.log('📊 Real-time scan results update received')
             this.onRealTimeUpdate?.(message)
@@ -277,6 +560,67 @@ export class DirectDllConnection {
     }
   }
 
+  private handleBinaryMessage(buffer: ArrayBuffer): void {
+    const header = binaryProtocol.decodeHeader(buffer)
+    if (!header) return
+    
+    // Server-pushed watch changes (broadcast to every client)
+    if (header.opcode === BinaryOpcode.BULK_UPDATE && (header.flags & BINARY_FLAG_WATCH) !== 0) {
+      if (this.watchHandlers.has(header.requestId)) {
+        this.dispatchWatchFrame(header.requestId, buffer)
+      } else {
+        // Other clients' watches land here too - keep only a few recent ids
+        const frames = this.unclaimedWatchFrames.get(header.requestId) || []
+        frames.push(buffer)
+        this.unclaimedWatchFrames.delete(header.requestId)
+        this.unclaimedWatchFrames.set(header.requestId, frames.length > 8 ? [frames[0], ...frames.slice(-7)] : frames)
+        if (this.unclaimedWatchFrames.size > 16) {
+          this.unclaimedWatchFrames.delete(this.unclaimedWatchFrames.keys().next().value!)
+        }
+      }
+      return
+    }
+    
+    // Server-pushed viewer diffs (also broadcast)
+    if (header.opcode === BinaryOpcode.VIEWER_UPDATE) {
+      if (this.viewerHandlers.has(header.requestId)) {
+        this.dispatchViewerFrame(header.requestId, buffer)
+      } else {
+        const frames = this.unclaimedViewerFrames.get(header.requestId) || []
+        frames.push(buffer)
+        this.unclaimedViewerFrames.delete(header.requestId)
+        // Dropping frames leaves a sequence gap, which makes the subscriber resync
+        this.unclaimedViewerFrames.set(header.requestId, frames.slice(0, 8))
+        if (this.unclaimedViewerFrames.size > 16) {
+          this.unclaimedViewerFrames.delete(this.unclaimedViewerFrames.keys().next().value!)
+        }
+      }
+      return
+    }
+    
+    // Direct responses to sendBinary
+    if (header.opcode !== BinaryOpcode.SCAN_RESULTS && header.opcode !== BinaryOpcode.SCAN_PROGRESS) {
+      const pending = this.pendingBinary.get(header.requestId)
+      if (pending) {
+        this.pendingBinary.delete(header.requestId)
+        clearTimeout(pending.timeout)
+        pending.resolve(buffer)
+      }
+      return
+    }
+    
+    const handlers = this.scanStreams.get(header.requestId)
+    if (!handlers) return
+    
+    if (header.opcode === BinaryOpcode.SCAN_RESULTS) {
+      const batch = binaryProtocol.decodeScanResults(buffer)
+      if (batch) handlers.onResults?.(batch)
+    } else if (header.opcode === BinaryOpcode.SCAN_PROGRESS) {
+      const progress = binaryProtocol.decodeScanProgress(buffer)
+      if (progress) handlers.onProgress?.(progress)
+    }
+  }
+
   private handleDisconnection(): void {
     // Auto-reconnect if enabled
     if (this.reconnectCount < this.config.reconnectAttempts) {